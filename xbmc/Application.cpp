@@ -1511,6 +1511,9 @@ void CApplication::Render()
   if(!CServiceBroker::GetRenderSystem()->BeginRender())
     return;
 
+  // load background loaded images to the GPU, spread over several frames
+  CServiceBroker::GetGUI()->GetLargeTextureManager().UploadTextures(CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiTextureUploadTime);
+
   // render gui layer
   if (m_renderGUI && !m_skipGuiRender)
   {
@@ -1540,12 +1543,14 @@ void CApplication::Render()
   CServiceBroker::GetGUI()->GetWindowManager().RenderEx();
 
   CServiceBroker::GetRenderSystem()->EndRender();
+  CServiceBroker::GetRenderSystem()->ResetDrawCalls();
 
   // reset our info cache - we do this at the end of Render so that it is
   // fresh for the next process(), or after a windowclose animation (where process()
   // isn't called)
   CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
   infoMgr.ResetCache();
+  infoMgr.ResetConditionEvaluations();
   infoMgr.GetInfoProviders().GetGUIControlsInfoProvider().ResetContainerMovingCache();
 
   if (hasRendered)
@@ -4152,7 +4157,7 @@ void CApplication::ProcessSlow()
 
   CServiceBroker::GetGUI()->GetLargeTextureManager().CleanupUnusedImages();
 
-  CServiceBroker::GetGUI()->GetTextureManager().FreeUnusedTextures(5000);
+  CServiceBroker::GetGUI()->GetTextureManager().FreeUnusedTextures(5000, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiTextureMemSize);
 
 #ifdef HAS_DVD_DRIVE
   // checks whats in the DVD drive and tries to autostart the content (xbox games, dvd, cdda, avi files...)
@@ -17,6 +17,7 @@
 #include "cores/playercorefactory/PlayerCoreFactory.h"
 #include "guilib/GUIComponent.h"
 #include "guilib/GUIWindowManager.h"
+#include "rendering/RenderSystem.h"
 #include "settings/MediaSettings.h"
 
 std::shared_ptr<IPlayer> CApplicationPlayer::GetInternal() const
@@ -825,7 +826,11 @@ void CApplicationPlayer::Render(bool clear, uint32_t alpha, bool gui)
 {
   std::shared_ptr<IPlayer> player = GetInternal();
   if (player)
+  {
+    // the renderers draw with their own shaders, the GUI queued so far goes below the video
+    CServiceBroker::GetRenderSystem()->FlushBatches();
     player->Render(clear, alpha, gui);
+  }
 }
 
 void CApplicationPlayer::FlushRenderer()
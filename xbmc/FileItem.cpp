@@ -1640,8 +1640,9 @@ void CFileItem::UpdateInfo(const CFileItem &item, bool replaceLabels /*=true*/)
     SetLabel(item.GetLabel());
   if (replaceLabels && !item.GetLabel2().empty())
     SetLabel2(item.GetLabel2());
-  if (!item.GetArt().empty())
-    SetArt(item.GetArt());
+  const ArtMap &art = item.GetArt();
+  if (!art.empty())
+    SetArt(art);
   AppendProperties(item);
 }
 
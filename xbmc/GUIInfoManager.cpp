@@ -902,6 +902,23 @@ const infomap player_times[] =   {{ "seektime",         PLAYER_SEEKTIME },
 ///     @skinning_v17 **[New Infolabel]** \link Player_Process_videodar `Player.Process(videodar)`\endlink
 ///     <p>
 ///   }
+///   \table_row3{   <b>`Player.Process(videothreading)`</b>,
+///                  \anchor Player_Process_videothreading
+///                  _string_,
+///     @return The threading of the software video decoder, e.g. "frame x 12". Empty for hardware
+///     decoders and single threaded decoding.
+///     <p><hr>
+///     @skinning_v18 **[New Infolabel]** \link Player_Process_videothreading `Player.Process(videothreading)`\endlink
+///     <p>
+///   }
+///   \table_row3{   <b>`Player.Process(videodecodetime)`</b>,
+///                  \anchor Player_Process_videodecodetime
+///                  _string_,
+///     @return The time in milliseconds the software video decoder takes per frame.
+///     <p><hr>
+///     @skinning_v18 **[New Infolabel]** \link Player_Process_videodecodetime `Player.Process(videodecodetime)`\endlink
+///     <p>
+///   }
 ///   \table_row3{   <b>`Player.Process(audiodecoder)`</b>,
 ///                  \anchor Player_Process_audiodecoder
 ///                  _string_,
@@ -948,6 +965,8 @@ const infomap player_process[] =
   { "videofps", PLAYER_PROCESS_VIDEOFPS },
   { "videodar", PLAYER_PROCESS_VIDEODAR },
   { "videohwdecoder", PLAYER_PROCESS_VIDEOHWDECODER },
+  { "videothreading", PLAYER_PROCESS_VIDEOTHREADING },
+  { "videodecodetime", PLAYER_PROCESS_VIDEODECODETIME },
   { "audiodecoder", PLAYER_PROCESS_AUDIODECODER },
   { "audiochannels", PLAYER_PROCESS_AUDIOCHANNELS },
   { "audiosamplerate", PLAYER_PROCESS_AUDIOSAMPLERATE },
@@ -9438,9 +9457,9 @@ INFO::InfoPtr CGUIInfoManager::Register(const std::string &expression, int conte
   std::pair<INFOBOOLTYPE::iterator, bool> res;
 
   if (condition.find_first_of("|+[]!") != condition.npos)
-    res = m_bools.insert(std::make_shared<InfoExpression>(condition, context, m_refreshCounter));
+    res = m_bools.insert(std::make_shared<InfoExpression>(condition, context, m_refresh));
   else
-    res = m_bools.insert(std::make_shared<InfoSingle>(condition, context, m_refreshCounter));
+    res = m_bools.insert(std::make_shared<InfoSingle>(condition, context, m_refresh));
 
   if (res.second)
     res.first->get()->Initialize();
@@ -9485,6 +9504,55 @@ bool CGUIInfoManager::GetBool(int condition1, int contextWindow, const CGUIListI
   return (condition1 < 0) ? !bReturn : bReturn;
 }
 
+unsigned int CGUIInfoManager::GetBoolDependencies(int condition) const
+{
+  condition = std::abs(condition);
+  if (condition == SYSTEM_ALWAYS_TRUE || condition == SYSTEM_ALWAYS_FALSE)
+    return 0;
+
+  if (condition >= MULTI_INFO_START && condition <= MULTI_INFO_END)
+  {
+    const CGUIInfo& info = m_multiInfo[condition - MULTI_INFO_START];
+    switch (info.m_info)
+    {
+      case STRING_IS_EMPTY:
+        return GetLabelDependencies(info.GetData1());
+      case STRING_IS_EQUAL:
+      case STRING_STARTS_WITH:
+      case STRING_ENDS_WITH:
+      case STRING_CONTAINS:
+        if (info.GetData2() < 0) // compared with another info label
+          return GetLabelDependencies(info.GetData1()) | GetLabelDependencies(-info.GetData2());
+        return GetLabelDependencies(info.GetData1());
+      default:
+        break;
+    }
+
+    unsigned int dependencies;
+    if (m_infoProviders.GetDependencies(dependencies, info))
+      return dependencies;
+  }
+  else
+  {
+    unsigned int dependencies;
+    if (m_infoProviders.GetDependencies(dependencies, CGUIInfo(condition)))
+      return dependencies;
+  }
+
+  return 1 << INFO::INFO_SOURCE_FRAME;
+}
+
+unsigned int CGUIInfoManager::GetLabelDependencies(int info) const
+{
+  if (info >= MULTI_INFO_START && info <= MULTI_INFO_END)
+  {
+    unsigned int dependencies;
+    if (m_infoProviders.GetDependencies(dependencies, m_multiInfo[info - MULTI_INFO_START]))
+      return dependencies;
+  }
+  return 1 << INFO::INFO_SOURCE_FRAME;
+}
+
 bool CGUIInfoManager::GetMultiInfoBool(const CGUIInfo &info, int contextWindow, const CGUIListItem *item)
 {
   bool bReturn = false;
@@ -10020,8 +10088,12 @@ bool CGUIInfoManager::GetItemBool(const CGUIListItem *item, int contextWindow, i
 void CGUIInfoManager::ResetCache()
 {
   // mark our infobools as dirty
-  CSingleLock lock(m_critInfo);
-  ++m_refreshCounter;
+  m_refresh.Changed(INFO::INFO_SOURCE_FRAME);
+}
+
+void CGUIInfoManager::ResetConditionEvaluations()
+{
+  m_conditionEvaluations = m_refresh.ResetEvaluations();
 }
 
 void CGUIInfoManager::SetCurrentVideoTag(const CVideoInfoTag &tag)
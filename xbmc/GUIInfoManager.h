@@ -61,6 +61,20 @@ public:
   void Clear();
   void ResetCache();
 
+  /*! \brief Mark the conditions depending on a source of information as dirty
+   Called by whatever changes the information, e.g. skin settings or window properties.
+   \param source the source that changed
+   */
+  void InfoChanged(INFO::InfoSource source) { m_refresh.Changed(source); }
+
+  /*! \brief Start counting the conditions evaluated during the next frame
+   */
+  void ResetConditionEvaluations();
+
+  /*! \brief Get the number of conditions evaluated during the last frame
+   */
+  unsigned int GetConditionEvaluations() const { return m_conditionEvaluations; }
+
   // KODI::MESSAGING::IMessageTarget implementation
   int GetMessageMask() override;
   void OnApplicationMessage(KODI::MESSAGING::ThreadMessage* pMsg) override;
@@ -91,6 +105,12 @@ public:
   int TranslateString(const std::string &strCondition);
   int TranslateSingleString(const std::string &strCondition, bool &listItemDependent);
 
+  /*! \brief Get the sources of information a condition depends on
+   \param condition the condition as returned by TranslateSingleString()
+   \return the sources as flags, 1 << INFO::InfoSource
+   */
+  unsigned int GetBoolDependencies(int condition) const;
+
   std::string GetLabel(int info, int contextWindow = 0, std::string *fallback = nullptr) const;
   std::string GetImage(int info, int contextWindow, std::string *fallback = nullptr);
   bool GetInt(int &value, int info, int contextWindow = 0, const CGUIListItem *item = nullptr) const;
@@ -188,6 +208,7 @@ private:
 
   int ResolveMultiInfo(int info) const;
   bool IsListItemInfo(int info) const;
+  unsigned int GetLabelDependencies(int info) const;
 
   void SetCurrentSongTag(const MUSIC_INFO::CMusicInfoTag &tag);
   void SetCurrentVideoTag(const CVideoInfoTag &tag);
@@ -200,7 +221,8 @@ private:
 
   typedef std::set<INFO::InfoPtr, bool(*)(const INFO::InfoPtr&, const INFO::InfoPtr&)> INFOBOOLTYPE;
   INFOBOOLTYPE m_bools;
-  unsigned int m_refreshCounter = 0;
+  INFO::InfoRefresh m_refresh;
+  unsigned int m_conditionEvaluations = 0; ///< conditions evaluated during the last frame
   std::vector<INFO::CSkinVariableString> m_skinVariableStrings;
 
   CCriticalSection m_critInfo;
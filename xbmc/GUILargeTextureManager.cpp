@@ -17,6 +17,7 @@
 #include "utils/log.h"
 #include "windowing/GraphicContext.h"
 
+#include <algorithm>
 #include <cassert>
 
 CImageLoader::CImageLoader(const std::string &path, const bool useCache):
@@ -122,6 +123,17 @@ void CGUILargeTextureManager::CLargeTexture::SetTexture(CBaseTexture* texture)
   assert(!m_texture.size());
   if (texture)
     m_texture.Set(texture, texture->GetWidth(), texture->GetHeight());
+  else
+    m_uploaded = true;
+}
+
+void CGUILargeTextureManager::CLargeTexture::Upload()
+{
+  if (m_uploaded)
+    return;
+
+  CBaseTexture* texture = m_texture.m_textures[0];
+  m_uploaded = texture->LoadRowsToGPU(std::max(UPLOAD_SIZE / std::max(texture->GetPitch(), 1u), 1u));
 }
 
 CGUILargeTextureManager::CGUILargeTextureManager() = default;
@@ -143,6 +155,22 @@ void CGUILargeTextureManager::CleanupUnusedImages(bool immediately)
   }
 }
 
+void CGUILargeTextureManager::UploadTextures(unsigned int maxTime)
+{
+  CSingleLock lock(m_listSection);
+  const int64_t start = CurrentHostCounter();
+  const int64_t maxTicks = static_cast<int64_t>(maxTime) * CurrentHostFrequency() / 1000;
+  for (CLargeTexture *image : m_allocated)
+  {
+    while (!image->IsUploaded())
+    {
+      image->Upload();
+      if (maxTime && CurrentHostCounter() - start >= maxTicks)
+        return;
+    }
+  }
+}
+
 // if available, increment reference count, and return the image.
 // else, add to the queue list if appropriate.
 bool CGUILargeTextureManager::GetImage(const std::string &path, CTextureArray &texture, bool firstRequest, const bool useCache)
@@ -155,6 +183,8 @@ bool CGUILargeTextureManager::GetImage(const std::string &path, CTextureArray &t
     {
       if (firstRequest)
         image->AddRef();
+      if (!image->IsUploaded())
+        return true; // still loading
       texture = image->GetTexture();
       return texture.size() > 0;
     }
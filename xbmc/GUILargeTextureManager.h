@@ -103,6 +103,17 @@ public:
    */
   void CleanupUnusedImages(bool immediately = false);
 
+  /*!
+   \brief Load the textures of loaded images to the GPU.
+
+   Images are only handed out by GetImage() once their texture is on the GPU. Large textures are
+   loaded in parts, so that no frame spends more than the given time on them. At least one part is
+   loaded per call. Has to be called from the render thread.
+
+   \param maxTime the time to spend in ms, 0 to load all textures.
+   */
+  void UploadTextures(unsigned int maxTime);
+
 private:
   class CLargeTexture
   {
@@ -114,17 +125,21 @@ private:
     bool DecrRef(bool deleteImmediately);
     bool DeleteIfRequired(bool deleteImmediately = false);
     void SetTexture(CBaseTexture* texture);
+    void Upload();
 
     const std::string &GetPath() const { return m_path; };
     const CTextureArray &GetTexture() const { return m_texture; };
+    bool IsUploaded() const { return m_uploaded; };
 
   private:
     static const unsigned int TIME_TO_DELETE = 2000;
+    static const unsigned int UPLOAD_SIZE = 1024 * 1024; ///< the bytes loaded to the GPU at a time
 
     unsigned int m_refCount;
     std::string m_path;
     CTextureArray m_texture;
     unsigned int m_timeToDelete;
+    bool m_uploaded = false;
   };
 
   void QueueImage(const std::string &path, bool useCache = true);
@@ -67,6 +67,7 @@ protected:
   CInfoScanner() = default;
 
   std::set<std::string> m_pathsToScan; //!< Set of paths to scan
+  int m_dirtyPathId = -1; //!< Last changed directory covered by the scan, see CLibraryMonitor
   bool m_showDialog = false; //!< Whether or not to show progress bar dialog
   CGUIDialogProgressBarHandle* m_handle = nullptr; //!< Progress bar handle
   bool m_bRunning = false; //!< Whether or not scanner is running
@@ -0,0 +1,340 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "LibraryMonitor.h"
+
+#include "MediaSource.h"
+#include "ServiceBroker.h"
+#include "URL.h"
+#include "interfaces/AnnouncementManager.h"
+#include "music/MusicDatabase.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/MediaSourceSettings.h"
+#include "settings/SettingsComponent.h"
+#include "threads/SingleLock.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+#include "video/VideoDatabase.h"
+
+#if defined(HAVE_INOTIFY)
+#include "platform/linux/InotifyDirectoryWatcher.h"
+#endif
+
+#include <cstring>
+
+namespace
+{
+bool IsBelow(const std::string& path, const std::set<std::string>& roots)
+{
+  for (const auto& root : roots)
+  {
+    if (StringUtils::StartsWith(path, root))
+      return true;
+  }
+  return false;
+}
+}
+
+CLibraryMonitor& CLibraryMonitor::GetInstance()
+{
+  static CLibraryMonitor s_instance;
+  return s_instance;
+}
+
+CLibraryMonitor::~CLibraryMonitor() = default;
+
+void CLibraryMonitor::OnSettingsLoaded()
+{
+  const auto advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  if (!advancedSettings->m_bVideoLibraryWatchForChanges && !advancedSettings->m_bMusicLibraryWatchForChanges)
+    return;
+
+  {
+    CSingleLock lock(m_critSection);
+#if defined(HAVE_INOTIFY)
+    m_watcher.reset(new CInotifyDirectoryWatcher(*this));
+#endif
+    if (!m_watcher)
+    {
+      CLog::Log(LOGWARNING, "CLibraryMonitor: watching for changes isn't supported on this platform");
+      return;
+    }
+  }
+
+  CServiceBroker::GetAnnouncementManager()->AddAnnouncer(this);
+  UpdateWatches();
+}
+
+void CLibraryMonitor::OnSettingsUnloaded()
+{
+  std::unique_ptr<XFILE::IDirectoryWatcher> watcher;
+  {
+    CSingleLock lock(m_critSection);
+    if (!m_watcher)
+      return;
+
+    watcher = std::move(m_watcher);
+    m_roots.clear();
+    m_watched.clear();
+  }
+
+  CServiceBroker::GetAnnouncementManager()->RemoveAnnouncer(this);
+
+  // waits for the watcher thread, which may be calling back into us
+  watcher.reset();
+}
+
+void CLibraryMonitor::Announce(ANNOUNCEMENT::AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
+{
+  // a scan is the only way for new sources to get into the library
+  if ((flag & (ANNOUNCEMENT::VideoLibrary | ANNOUNCEMENT::AudioLibrary)) && strcmp(message, "OnScanFinished") == 0)
+    UpdateWatches();
+}
+
+void CLibraryMonitor::OnWatchAdded(const std::string& root)
+{
+  // changes made before the watch was in place are unknown, so the next scan has to check everything
+  const std::vector<std::string> libraries = RecordChanges({ { root, true } });
+
+  CSingleLock lock(m_critSection);
+  for (const auto& library : libraries)
+  {
+    if (m_roots[library].find(root) != m_roots[library].end())
+    {
+      m_watched[library].insert(root);
+      CLog::Log(LOGDEBUG, "CLibraryMonitor: recording changes in %s for the %s library",
+                CURL::GetRedacted(root).c_str(), library.c_str());
+    }
+  }
+}
+
+void CLibraryMonitor::OnWatchLost(const std::string& root, bool removed)
+{
+  if (!removed)
+  {
+    RecordChanges({ { root, true } });
+    return;
+  }
+
+  CLog::Log(LOGDEBUG, "CLibraryMonitor: no longer recording changes in %s", CURL::GetRedacted(root).c_str());
+
+  CSingleLock lock(m_critSection);
+  for (auto& watched : m_watched)
+    watched.second.erase(root);
+}
+
+void CLibraryMonitor::OnDirectoriesChanged(const std::set<std::string>& directories)
+{
+  std::map<std::string, bool> paths;
+  for (const auto& directory : directories)
+    paths.insert(std::make_pair(directory, false));
+
+  RecordChanges(paths);
+}
+
+int CLibraryMonitor::GetPathsToScan(const std::string& library, CDatabase& database, std::set<std::string>& paths)
+{
+  std::vector<std::string> watchedRoots;
+  {
+    CSingleLock lock(m_critSection);
+    auto watched = m_watched.find(library);
+    if (watched == m_watched.end() || watched->second.empty())
+      return -1;
+
+    watchedRoots.assign(watched->second.begin(), watched->second.end());
+  }
+
+  std::map<std::string, bool> dirtyPaths;
+  int lastId = -1;
+  if (!database.GetDirtyPaths(dirtyPaths, lastId))
+    return -1;
+
+  std::set<std::string> pathsToScan;
+  GetPathsToScan(paths, watchedRoots, dirtyPaths, pathsToScan);
+
+  CLog::Log(LOGDEBUG, "CLibraryMonitor: scanning %zu of %zu paths of the %s library, %zu directories changed",
+            pathsToScan.size(), paths.size(), library.c_str(), dirtyPaths.size());
+
+  paths.swap(pathsToScan);
+  return lastId;
+}
+
+void CLibraryMonitor::GetPathsToScan(const std::set<std::string>& paths,
+                                     const std::vector<std::string>& watchedRoots,
+                                     const std::map<std::string, bool>& dirtyPaths,
+                                     std::set<std::string>& pathsToScan)
+{
+  const std::set<std::string> roots(watchedRoots.begin(), watchedRoots.end());
+
+  // we don't know what changed anywhere else
+  for (const auto& path : paths)
+  {
+    if (!IsBelow(path, roots))
+      pathsToScan.insert(path);
+  }
+
+  for (const auto& dirtyPath : dirtyPaths)
+  {
+    if (!IsBelow(dirtyPath.first, roots))
+      continue;
+
+    if (dirtyPath.second)
+    {
+      // changes may have been missed, check every path below it
+      for (auto it = paths.lower_bound(dirtyPath.first);
+           it != paths.end() && StringUtils::StartsWith(*it, dirtyPath.first); ++it)
+        pathsToScan.insert(*it);
+      continue;
+    }
+
+    // scanning a path also checks the directories below it
+    std::string path = dirtyPath.first;
+    while (paths.find(path) == paths.end())
+    {
+      const std::string parent = URIUtils::GetParentPath(path);
+      if (parent.empty() || parent == path || !IsBelow(parent, roots))
+      {
+        path = dirtyPath.first;
+        break;
+      }
+      path = parent;
+    }
+    pathsToScan.insert(path);
+  }
+}
+
+void CLibraryMonitor::UpdateWatches()
+{
+  const auto advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+
+  std::map<std::string, std::set<std::string>> roots;
+  if (advancedSettings->m_bVideoLibraryWatchForChanges)
+    GetSourceRoots("video", roots["video"]);
+  if (advancedSettings->m_bMusicLibraryWatchForChanges)
+    GetSourceRoots("music", roots["music"]);
+
+  std::set<std::string> oldRoots;
+  std::set<std::string> newRoots;
+  for (const auto& library : roots)
+    newRoots.insert(library.second.begin(), library.second.end());
+
+  CSingleLock lock(m_critSection);
+  if (!m_watcher)
+    return;
+
+  for (const auto& library : m_roots)
+  {
+    oldRoots.insert(library.second.begin(), library.second.end());
+
+    // stop recording changes for roots that are no longer sources of the library
+    std::set<std::string>& watched = m_watched[library.first];
+    for (auto it = watched.begin(); it != watched.end();)
+    {
+      if (roots[library.first].find(*it) == roots[library.first].end())
+        it = watched.erase(it);
+      else
+        ++it;
+    }
+  }
+  m_roots = roots;
+
+  for (const auto& root : oldRoots)
+  {
+    if (newRoots.find(root) == newRoots.end())
+      m_watcher->RemoveWatch(root);
+  }
+  for (const auto& root : newRoots)
+  {
+    if (oldRoots.find(root) == oldRoots.end())
+      m_watcher->AddWatch(root);
+  }
+}
+
+void CLibraryMonitor::GetSourceRoots(const std::string& library, std::set<std::string>& roots) const
+{
+  VECSOURCES* sources = CMediaSourceSettings::GetInstance().GetSources(library);
+  if (!sources)
+    return;
+
+  for (const auto& source : *sources)
+  {
+    std::vector<std::string> paths(source.vecPaths);
+    if (paths.empty())
+      paths.push_back(source.strPath);
+
+    for (auto path : paths)
+    {
+      // only plain local paths can be watched
+      if (!URIUtils::IsHD(path) || !CURL(path).GetProtocol().empty())
+        continue;
+
+      URIUtils::AddSlashAtEnd(path);
+      roots.insert(path);
+    }
+  }
+}
+
+std::vector<std::string> CLibraryMonitor::RecordChanges(const std::map<std::string, bool>& paths)
+{
+  std::map<std::string, std::set<std::string>> roots;
+  {
+    CSingleLock lock(m_critSection);
+    roots = m_roots;
+  }
+
+  std::vector<std::string> libraries;
+  for (const auto& library : roots)
+  {
+    std::map<std::string, bool> changes;
+    for (const auto& path : paths)
+    {
+      if (IsBelow(path.first, library.second))
+        changes.insert(path);
+    }
+    if (changes.empty())
+      continue;
+
+    if (AddDirtyPaths(library.first, changes))
+    {
+      libraries.push_back(library.first);
+      continue;
+    }
+
+    // without a record of the changes these roots have to be scanned in full again
+    CLog::Log(LOGERROR, "CLibraryMonitor: failed to record changes for the %s library", library.first.c_str());
+
+    CSingleLock lock(m_critSection);
+    std::set<std::string>& watched = m_watched[library.first];
+    for (auto it = watched.begin(); it != watched.end();)
+    {
+      auto change = changes.lower_bound(*it);
+      if (change != changes.end() && StringUtils::StartsWith(change->first, *it))
+        it = watched.erase(it);
+      else
+        ++it;
+    }
+  }
+  return libraries;
+}
+
+bool CLibraryMonitor::AddDirtyPaths(const std::string& library, const std::map<std::string, bool>& paths)
+{
+  if (library == "video")
+  {
+    CVideoDatabase database;
+    if (!database.Open())
+      return false;
+    return database.AddDirtyPaths(paths);
+  }
+
+  CMusicDatabase database;
+  if (!database.Open())
+    return false;
+  return database.AddDirtyPaths(paths);
+}
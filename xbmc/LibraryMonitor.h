@@ -0,0 +1,101 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "filesystem/IDirectoryWatcher.h"
+#include "interfaces/IAnnouncer.h"
+#include "settings/lib/ISettingsHandler.h"
+#include "threads/CriticalSection.h"
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+class CDatabase;
+
+/*!
+ \brief Watches the local sources of the video and music libraries for changes.
+
+ Directories that changed are recorded in the dirtypath table of the library's database, so a
+ library update only has to rescan those instead of hashing every path of the library. Sources
+ that can't be watched, and sources whose changes may have been missed (e.g. those made while
+ Kodi wasn't running), are scanned as before.
+
+ Enabled with \<watchforchanges\> in the \<videolibrary\> and \<musiclibrary\> sections of
+ advancedsettings.xml. Only changes made through the local system are seen, so network shares
+ mounted from a server that is modified by other hosts shouldn't be used with it.
+ */
+class CLibraryMonitor : public ISettingsHandler,
+                        public ANNOUNCEMENT::IAnnouncer,
+                        public XFILE::IDirectoryWatcherCallback
+{
+public:
+  /*!
+   \brief Gets the singleton instance of the library monitor.
+   */
+  static CLibraryMonitor& GetInstance();
+
+  // implementation of ISettingsHandler
+  void OnSettingsLoaded() override;
+  void OnSettingsUnloaded() override;
+
+  // implementation of IAnnouncer
+  void Announce(ANNOUNCEMENT::AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data) override;
+
+  // implementation of IDirectoryWatcherCallback
+  void OnWatchAdded(const std::string& root) override;
+  void OnWatchLost(const std::string& root, bool removed) override;
+  void OnDirectoriesChanged(const std::set<std::string>& directories) override;
+
+  /*!
+   \brief Reduce the paths a library update has to scan to those that changed.
+   \param library "video" or "music".
+   \param database The opened database of the library.
+   \param paths [in/out] All paths of the library, replaced by the paths that have to be scanned.
+   \return The id to pass to CDatabase::ClearDirtyPaths() once the scan completed, -1 if there is nothing to clear.
+   */
+  int GetPathsToScan(const std::string& library, CDatabase& database, std::set<std::string>& paths);
+
+  /*!
+   \brief Get the paths to scan for the changed directories below the watched roots.
+   Paths that aren't below a watched root are always scanned. A changed directory that isn't a path
+   of the library itself is scanned from the nearest path above it.
+   \param paths All paths of the library.
+   \param watchedRoots The roots changes are recorded for.
+   \param dirtyPaths The changed directories, mapped to whether everything below them has to be scanned.
+   \param pathsToScan [out] The paths that have to be scanned.
+   */
+  static void GetPathsToScan(const std::set<std::string>& paths,
+                             const std::vector<std::string>& watchedRoots,
+                             const std::map<std::string, bool>& dirtyPaths,
+                             std::set<std::string>& pathsToScan);
+
+private:
+  CLibraryMonitor() = default;
+  ~CLibraryMonitor() override;
+  CLibraryMonitor(const CLibraryMonitor&) = delete;
+  CLibraryMonitor& operator=(const CLibraryMonitor&) = delete;
+
+  void UpdateWatches();
+  void GetSourceRoots(const std::string& library, std::set<std::string>& roots) const;
+
+  /*!
+   \brief Record the changes in the databases of the libraries they belong to.
+   \return The libraries the changes were recorded for.
+   */
+  std::vector<std::string> RecordChanges(const std::map<std::string, bool>& paths);
+  static bool AddDirtyPaths(const std::string& library, const std::map<std::string, bool>& paths);
+
+  CCriticalSection m_critSection;
+  std::unique_ptr<XFILE::IDirectoryWatcher> m_watcher;
+  std::map<std::string, std::set<std::string>> m_roots;   ///< roots to watch by library
+  std::map<std::string, std::set<std::string>> m_watched; ///< roots changes are recorded for by library
+};
@@ -21,6 +21,8 @@
 #include "utils/URIUtils.h"
 #include "utils/log.h"
 
+#include <algorithm>
+
 using namespace XFILE;
 
 CTextureCache &CTextureCache::GetInstance()
@@ -37,9 +39,15 @@ CTextureCache::~CTextureCache() = default;
 
 void CTextureCache::Initialize()
 {
-  CSingleLock lock(m_databaseSection);
-  if (!m_database.IsOpen())
-    m_database.Open();
+  {
+    CSingleLock lock(m_databaseSection);
+    if (!m_database.IsOpen())
+      m_database.Open();
+  }
+
+  unsigned int maxAge = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageVariantMaxAge;
+  if (maxAge)
+    AddJob(new CTextureVariantCleanupJob(maxAge));
 }
 
 void CTextureCache::Deinitialize()
@@ -75,6 +83,11 @@ bool CTextureCache::HasCachedImage(const std::string &url)
 
 std::string CTextureCache::GetCachedImage(const std::string &image, CTextureDetails &details, bool trackUsage)
 {
+  std::string original;
+  unsigned int size;
+  if (CTextureUtils::GetImageVariant(image, original, size))
+    return GetCachedVariant(original, size, details, trackUsage);
+
   std::string url = CTextureUtils::UnwrapImageURL(image);
   if (url.empty())
     return "";
@@ -91,6 +104,47 @@ std::string CTextureCache::GetCachedImage(const std::string &image, CTextureDeta
   return "";
 }
 
+std::string CTextureCache::GetCachedVariant(const std::string &image, unsigned int size, CTextureDetails &details, bool trackUsage)
+{
+  std::string url = CTextureUtils::UnwrapImageURL(image);
+  if (url.empty())
+    return "";
+  if (IsCachedImage(url))
+    return url;
+
+  if (!GetCachedTexture(url, details))
+    return ""; // not even the image is cached
+
+  std::vector<CTextureDetails> variants;
+  {
+    CSingleLock lock(m_databaseSection);
+    m_database.GetCachedVariants(details.id, variants);
+  }
+
+  // the smallest variant at least as large as asked for, the image itself otherwise
+  const CTextureDetails original(details);
+  bool exact = false;
+  for (const auto& variant : variants)
+  {
+    if (variant.size >= size)
+    {
+      exact = variant.size == size;
+      details.file = variant.file;
+      details.width = variant.width;
+      details.height = variant.height;
+      details.size = variant.size;
+      break;
+    }
+  }
+
+  if (!exact && std::max(details.width, details.height) > size)
+    AddJob(new CTextureVariantJob(original, size));
+
+  if (trackUsage)
+    IncrementUseCount(details);
+  return GetCachedPath(details.file);
+}
+
 bool CTextureCache::CanCacheImageURL(const CURL &url)
 {
   return url.GetUserName().empty() || url.GetUserName() == "music" ||
@@ -112,6 +166,12 @@ void CTextureCache::BackgroundCacheImage(const std::string &url)
   if (url.empty())
     return;
 
+  // variants are cached once their image is
+  std::string original;
+  unsigned int size;
+  if (CTextureUtils::GetImageVariant(url, original, size))
+    return BackgroundCacheImage(original);
+
   CTextureDetails details;
   std::string path(GetCachedImage(url, details));
   if (!path.empty() && details.hash.empty())
@@ -127,6 +187,11 @@ void CTextureCache::BackgroundCacheImage(const std::string &url)
 
 std::string CTextureCache::CacheImage(const std::string &image, CBaseTexture **texture /* = NULL */, CTextureDetails *details /* = NULL */)
 {
+  std::string original;
+  unsigned int size;
+  if (CTextureUtils::GetImageVariant(image, original, size))
+    return CacheImage(original, texture, details);
+
   std::string url = CTextureUtils::UnwrapImageURL(image);
   if (url.empty())
     return "";
@@ -176,6 +241,9 @@ void CTextureCache::ClearCachedImage(const std::string &url, bool deleteSource /
   //! @todo This can be removed when the texture cache covers everything.
   std::string path = deleteSource ? url : "";
   std::string cachedFile;
+  CTextureDetails details;
+  if (GetCachedTexture(url, details))
+    ClearCachedVariants(details.id);
   if (ClearCachedTexture(url, cachedFile))
     path = GetCachedPath(cachedFile);
   if (CFile::Exists(path))
@@ -187,6 +255,7 @@ void CTextureCache::ClearCachedImage(const std::string &url, bool deleteSource /
 
 bool CTextureCache::ClearCachedImage(int id)
 {
+  ClearCachedVariants(id);
   std::string cachedFile;
   if (ClearCachedTexture(id, cachedFile))
   {
@@ -201,6 +270,22 @@ bool CTextureCache::ClearCachedImage(int id)
   return false;
 }
 
+void CTextureCache::ClearCachedVariants(int textureID)
+{
+  std::vector<CTextureDetails> variants;
+  {
+    CSingleLock lock(m_databaseSection);
+    m_database.GetCachedVariants(textureID, variants);
+  }
+  // the database removes the variants together with their texture
+  for (const auto& variant : variants)
+  {
+    std::string path = GetCachedPath(variant.file);
+    if (CFile::Exists(path))
+      CFile::Delete(path);
+  }
+}
+
 bool CTextureCache::GetCachedTexture(const std::string &url, CTextureDetails &details)
 {
   CSingleLock lock(m_databaseSection);
@@ -266,7 +351,18 @@ void CTextureCache::OnCachingComplete(bool success, CTextureCacheJob *job)
     if (job->m_oldHash == job->m_details.hash)
       SetCachedTextureValid(job->m_url, job->m_details.updateable);
     else
+    {
+      // the variants of the old image are out of date
+      CTextureDetails details;
+      if (GetCachedTexture(job->m_url, details))
+      {
+        ClearCachedVariants(details.id);
+        // the format of the cached image changed, e.g. after toggling <imagecachepacked>
+        if (details.file != job->m_details.file && CFile::Exists(GetCachedPath(details.file)))
+          CFile::Delete(GetCachedPath(details.file));
+      }
       AddCachedTexture(job->m_url, job->m_details);
+    }
   }
 
   { // remove from our processing list
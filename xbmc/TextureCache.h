@@ -166,6 +166,21 @@ private:
    */
   std::string GetCachedImage(const std::string &image, CTextureDetails &details, bool trackUsage = false);
 
+  /*! \brief retrieve the cached variant of the given image closest to the given size
+   Starts caching the variant of that size if it doesn't exist yet and the image is larger.
+   \param image url of the image
+   \param size the size of the variant \sa CTextureUtils::GetSizedImageURL
+   \param details [out] the details of the variant, or of the image if no larger variant exists.
+   \param trackUsage whether this call should track usage of the variant
+   \return cached url of the variant, empty if the image isn't cached
+   */
+  std::string GetCachedVariant(const std::string &image, unsigned int size, CTextureDetails &details, bool trackUsage);
+
+  /*! \brief delete the cached variants of a texture
+   \param textureID database id of the texture
+   */
+  void ClearCachedVariants(int textureID);
+
   /*! \brief Get an image from the database
    Thread-safe wrapper of CTextureDatabase::GetCachedTexture
    \param image url of the original image
@@ -22,10 +22,13 @@
 #include "FileItem.h"
 #include "music/MusicThumbLoader.h"
 #include "music/tags/MusicInfoTag.h"
+#include "XBDateTime.h"
 #if defined(TARGET_RASPBERRY_PI)
 #include "cores/omxplayer/OMXImage.h"
 #endif
 
+#include <memory>
+
 CTextureCacheJob::CTextureCacheJob(const std::string &url, const std::string &oldHash):
   m_url(url),
   m_oldHash(oldHash),
@@ -95,7 +98,9 @@ bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
   CBaseTexture *texture = LoadImage(image, width, height, additional_info, true);
   if (texture)
   {
-    if (texture->HasAlpha())
+    if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageCachePacked)
+      m_details.file = m_cachePath + ".xbt";
+    else if (texture->HasAlpha())
       m_details.file = m_cachePath + ".png";
     else
       m_details.file = m_cachePath + ".jpg";
@@ -275,3 +280,69 @@ bool CTextureUseCountJob::DoWork()
   }
   return true;
 }
+
+CTextureVariantJob::CTextureVariantJob(const CTextureDetails &original, unsigned int size) :
+  m_original(original),
+  m_size(size)
+{
+}
+
+bool CTextureVariantJob::operator==(const CJob* job) const
+{
+  if (strcmp(job->GetType(), GetType()) == 0)
+  {
+    const CTextureVariantJob* variantJob = dynamic_cast<const CTextureVariantJob*>(job);
+    if (variantJob && variantJob->m_original.id == m_original.id && variantJob->m_size == m_size)
+      return true;
+  }
+  return false;
+}
+
+bool CTextureVariantJob::DoWork()
+{
+  // the cached image is already oriented and no larger than the cache resolution, so it's a lot
+  // quicker to scale down than the source
+  std::unique_ptr<CBaseTexture> texture(CBaseTexture::LoadFromFile(CTextureCache::GetCachedPath(m_original.file), m_size, m_size, true));
+  if (!texture)
+    return false;
+
+  CTextureDetails variant(m_original);
+  variant.size = m_size;
+  variant.width = variant.height = m_size;
+  variant.file = CTextureUtils::GetVariantFile(m_original.file, m_size);
+  if (!CPicture::CacheTexture(texture.get(), variant.width, variant.height, CTextureCache::GetCachedPath(variant.file)))
+    return false;
+
+  CLog::Log(LOGDEBUG, "Cached %ux%u variant of '%s' to '%s'", variant.width, variant.height, m_original.file.c_str(), variant.file.c_str());
+
+  CTextureDatabase db;
+  if (!db.Open())
+    return false;
+  return db.AddCachedVariant(variant);
+}
+
+CTextureVariantCleanupJob::CTextureVariantCleanupJob(unsigned int maxAge) : m_maxAge(maxAge)
+{
+}
+
+bool CTextureVariantCleanupJob::DoWork()
+{
+  CTextureDatabase db;
+  if (!db.Open())
+    return false;
+
+  std::vector<CTextureDetails> variants;
+  if (!db.GetUnusedVariants(CDateTime::GetCurrentDateTime() - CDateTimeSpan(m_maxAge, 0, 0, 0), variants))
+    return false;
+
+  for (const auto& variant : variants)
+  {
+    std::string path = CTextureCache::GetCachedPath(variant.file);
+    if (XFILE::CFile::Exists(path))
+      XFILE::CFile::Delete(path);
+    db.ClearCachedVariant(variant.id, variant.size);
+  }
+  if (!variants.empty())
+    CLog::Log(LOGDEBUG, "%s - removed %u image variants unused for %u days", __FUNCTION__, static_cast<unsigned int>(variants.size()), m_maxAge);
+  return true;
+}
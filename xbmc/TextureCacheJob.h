@@ -28,6 +28,7 @@ public:
   {
     id = -1;
     width = height = 0;
+    size = 1;
     updateable = false;
   };
   bool operator==(const CTextureDetails &right) const
@@ -41,6 +42,7 @@ public:
   std::string  hash;
   unsigned int width;
   unsigned int height;
+  unsigned int size; ///< 1 for the cached image, the size asked for for variants \sa CTextureUtils::GetSizedImageURL
   bool         updateable;
 };
 
@@ -129,3 +131,40 @@ public:
 private:
   std::vector<CTextureDetails> m_textures;
 };
+
+/* \brief Job class for caching a smaller variant of a cached texture
+ */
+class CTextureVariantJob : public CJob
+{
+public:
+  /*!
+   \param original the details of the cached texture.
+   \param size the size the variant has to fit into.
+   */
+  CTextureVariantJob(const CTextureDetails &original, unsigned int size);
+
+  const char* GetType() const override { return "cachevariant"; };
+  bool operator==(const CJob *job) const override;
+  bool DoWork() override;
+
+private:
+  CTextureDetails m_original;
+  unsigned int m_size;
+};
+
+/* \brief Job class for removing the variants of textures that weren't used for a while
+ */
+class CTextureVariantCleanupJob : public CJob
+{
+public:
+  /*!
+   \param maxAge the number of days after which unused variants are removed.
+   */
+  explicit CTextureVariantCleanupJob(unsigned int maxAge);
+
+  const char* GetType() const override { return "cleanupvariants"; };
+  bool DoWork() override;
+
+private:
+  unsigned int m_maxAge;
+};
@@ -8,11 +8,15 @@
 
 #include "TextureDatabase.h"
 
+#include "ServiceBroker.h"
 #include "URL.h"
 #include "XBDateTime.h"
 #include "dbwrappers/dataset.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
 #include "utils/DatabaseUtils.h"
 #include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
 #include "utils/Variant.h"
 #include "utils/log.h"
 
@@ -141,6 +145,50 @@ std::string CTextureUtils::UnwrapImageURL(const std::string &image)
   return image;
 }
 
+std::string CTextureUtils::GetSizedImageURL(const std::string &image, unsigned int size)
+{
+  unsigned int variant = 128;
+  while (variant < size)
+    variant *= 2;
+
+  std::string original;
+  unsigned int originalSize;
+  if (image.empty() || GetImageVariant(image, original, originalSize) ||
+      variant >= CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageRes)
+    return image;
+
+  CURL url;
+  url.SetProtocol("image");
+  url.SetHostName(image);
+  url.SetFileName("transform");
+  url.SetOptions(StringUtils::Format("?size=%u", variant));
+  return url.Get();
+}
+
+bool CTextureUtils::GetImageVariant(const std::string &url, std::string &image, unsigned int &size)
+{
+  if (!StringUtils::StartsWith(url, "image://"))
+    return false;
+
+  // any other option makes it an image of its own
+  CURL imageURL(url);
+  if (!imageURL.GetUserName().empty() || imageURL.GetFileName() != "transform" ||
+      !StringUtils::IsNaturalNumber(imageURL.GetOption("size")))
+    return false;
+
+  size = strtoul(imageURL.GetOption("size").c_str(), nullptr, 10);
+  if (size <= 1 || imageURL.GetOptions() != StringUtils::Format("?size=%u", size))
+    return false;
+
+  image = imageURL.GetHostName();
+  return !image.empty();
+}
+
+std::string CTextureUtils::GetVariantFile(const std::string &file, unsigned int size)
+{
+  return URIUtils::ReplaceExtension(file, StringUtils::Format("-%u%s", size, URIUtils::GetExtension(file).c_str()));
+}
+
 CTextureDatabase::CTextureDatabase() = default;
 
 CTextureDatabase::~CTextureDatabase() = default;
@@ -232,10 +280,87 @@ void CTextureDatabase::UpdateTables(int version)
 
 bool CTextureDatabase::IncrementUseCount(const CTextureDetails &details)
 {
-  std::string sql = PrepareSQL("UPDATE sizes SET usecount=usecount+1, lastusetime=CURRENT_TIMESTAMP WHERE idtexture=%u AND width=%u AND height=%u", details.id, details.width, details.height);
+  std::string sql = PrepareSQL("UPDATE sizes SET usecount=usecount+1, lastusetime=CURRENT_TIMESTAMP WHERE idtexture=%u AND size=%u", details.id, details.size);
   return ExecuteQuery(sql);
 }
 
+bool CTextureDatabase::GetCachedVariants(int textureID, std::vector<CTextureDetails> &variants)
+{
+  try
+  {
+    if (!m_pDB)
+      return false;
+    if (!m_pDS)
+      return false;
+
+    std::string sql = PrepareSQL("SELECT cachedurl, size, width, height FROM texture JOIN sizes ON (texture.id=sizes.idtexture AND sizes.size>1) WHERE id=%i ORDER BY size", textureID);
+    m_pDS->query(sql);
+    while (!m_pDS->eof())
+    {
+      CTextureDetails variant;
+      variant.id = textureID;
+      variant.size = m_pDS->fv(1).get_asInt();
+      variant.file = CTextureUtils::GetVariantFile(m_pDS->fv(0).get_asString(), variant.size);
+      variant.width = m_pDS->fv(2).get_asInt();
+      variant.height = m_pDS->fv(3).get_asInt();
+      variants.push_back(variant);
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s, failed on texture id %i", __FUNCTION__, textureID);
+  }
+  return false;
+}
+
+bool CTextureDatabase::AddCachedVariant(const CTextureDetails &variant)
+{
+  std::string sql = PrepareSQL("DELETE FROM sizes WHERE idtexture=%i AND size=%u", variant.id, variant.size);
+  if (!ExecuteQuery(sql))
+    return false;
+  sql = PrepareSQL("INSERT INTO sizes (idtexture, size, usecount, lastusetime, width, height) VALUES(%i, %u, 1, CURRENT_TIMESTAMP, %u, %u)", variant.id, variant.size, variant.width, variant.height);
+  return ExecuteQuery(sql);
+}
+
+bool CTextureDatabase::ClearCachedVariant(int textureID, unsigned int size)
+{
+  std::string sql = PrepareSQL("DELETE FROM sizes WHERE idtexture=%i AND size=%u", textureID, size);
+  return ExecuteQuery(sql);
+}
+
+bool CTextureDatabase::GetUnusedVariants(const CDateTime &before, std::vector<CTextureDetails> &variants)
+{
+  try
+  {
+    if (!m_pDB)
+      return false;
+    if (!m_pDS)
+      return false;
+
+    std::string sql = PrepareSQL("SELECT id, cachedurl, size FROM texture JOIN sizes ON (texture.id=sizes.idtexture AND sizes.size>1) WHERE lastusetime<'%s'", before.GetAsDBDateTime().c_str());
+    m_pDS->query(sql);
+    while (!m_pDS->eof())
+    {
+      CTextureDetails variant;
+      variant.id = m_pDS->fv(0).get_asInt();
+      variant.size = m_pDS->fv(2).get_asInt();
+      variant.file = CTextureUtils::GetVariantFile(m_pDS->fv(1).get_asString(), variant.size);
+      variants.push_back(variant);
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s, failed", __FUNCTION__);
+  }
+  return false;
+}
+
 bool CTextureDatabase::GetCachedTexture(const std::string &url, CTextureDetails &details)
 {
   try
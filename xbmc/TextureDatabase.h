@@ -15,6 +15,7 @@
 #include <string>
 #include <vector>
 
+class CDateTime;
 class CVariant;
 
 class CTextureRule : public CDatabaseQueryRule
@@ -53,6 +54,31 @@ public:
    \return the unwrapped URL, or the original URL if unwrapping is inappropriate.
    */
   static std::string UnwrapImageURL(const std::string &image);
+
+  /*! \brief retrieve a wrapped URL for a smaller variant of an image
+   Variants are cached for powers of two from 128, each fitting into a square of that size, and
+   only for sizes smaller than the cache resolution.
+   \param image url of the image
+   \param size the size the image is drawn at, in the larger dimension
+   \return the wrapped URL of the variant, or image if no variant is needed
+   \sa GetImageVariant
+   */
+  static std::string GetSizedImageURL(const std::string &image, unsigned int size);
+
+  /*! \brief split a URL from GetSizedImageURL into the image and the size of the variant
+   \param url the url to check
+   \param image [out] url of the image
+   \param size [out] the size of the variant
+   \return true if the url is a variant of an image, false otherwise
+   */
+  static bool GetImageVariant(const std::string &url, std::string &image, unsigned int &size);
+
+  /*! \brief retrieve the cache file of a variant of a cached image
+   \param file the cache file of the image
+   \param size the size of the variant
+   \return the cache file of the variant, relative to the cache path
+   */
+  static std::string GetVariantFile(const std::string &file, unsigned int size);
 };
 
 class CTextureDatabase : public CDatabase, public IDatabaseQueryRuleFactory
@@ -69,6 +95,22 @@ public:
   bool ClearCachedTexture(int textureID, std::string &cacheFile);
   bool IncrementUseCount(const CTextureDetails &details);
 
+  /*! \brief Get the variants cached for a texture
+   \param textureID the id of the texture
+   \param variants [out] the variants, smallest first
+   \return true if the variants could be retrieved, false otherwise
+   */
+  bool GetCachedVariants(int textureID, std::vector<CTextureDetails> &variants);
+  bool AddCachedVariant(const CTextureDetails &variant);
+  bool ClearCachedVariant(int textureID, unsigned int size);
+
+  /*! \brief Get the variants that weren't used since the given time
+   \param before the time
+   \param variants [out] the variants
+   \return true if the variants could be retrieved, false otherwise
+   */
+  bool GetUnusedVariants(const CDateTime &before, std::vector<CTextureDetails> &variants);
+
   /*! \brief Invalidate a previously cached texture
    Invalidates the texture hash, and sets the texture update time to the current time so that
    next texture load it will be re-cached.
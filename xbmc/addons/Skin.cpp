@@ -9,6 +9,7 @@
 #include "Skin.h"
 #include "AddonManager.h"
 #include "ServiceBroker.h"
+#include "GUIInfoManager.h"
 #include "Util.h"
 #include "dialogs/GUIDialogKaiToast.h"
 // fallback for new skin resolution code
@@ -45,6 +46,17 @@ using KODI::MESSAGING::HELPERS::DialogResponse;
 
 std::shared_ptr<ADDON::CSkinInfo> g_SkinInfo;
 
+namespace
+{
+void SkinSettingsChanged()
+{
+  // conditions depending on skin settings are only evaluated again after a change
+  CGUIComponent* gui = CServiceBroker::GetGUI();
+  if (gui)
+    gui->GetInfoManager().InfoChanged(INFO::INFO_SOURCE_SKIN_SETTINGS);
+}
+}
+
 namespace ADDON
 {
 
@@ -585,6 +597,7 @@ void CSkinInfo::SetString(int setting, const std::string &label)
   {
     it->second->value = label;
     m_settingsUpdateHandler->TriggerSave();
+    SkinSettingsChanged();
     return;
   }
 
@@ -629,6 +642,7 @@ void CSkinInfo::SetBool(int setting, bool set)
   {
     it->second->value = set;
     m_settingsUpdateHandler->TriggerSave();
+    SkinSettingsChanged();
     return;
   }
 
@@ -645,6 +659,7 @@ void CSkinInfo::Reset(const std::string &setting)
     {
       it.second->value.clear();
       m_settingsUpdateHandler->TriggerSave();
+      SkinSettingsChanged();
       return;
     }
   }
@@ -656,6 +671,7 @@ void CSkinInfo::Reset(const std::string &setting)
     {
       it.second->value = false;
       m_settingsUpdateHandler->TriggerSave();
+      SkinSettingsChanged();
       return;
     }
   }
@@ -671,6 +687,7 @@ void CSkinInfo::Reset()
     it.second->value.clear();
 
   m_settingsUpdateHandler->TriggerSave();
+  SkinSettingsChanged();
 }
 
 std::set<CSkinSettingPtr> CSkinInfo::ParseSettings(const TiXmlElement* rootElement)
@@ -749,6 +766,7 @@ bool CSkinInfo::SettingsFromXML(const CXBMCTinyXML &doc, bool loadDefaults /* =
       CLog::Log(LOGWARNING, "CSkinInfo: ignoring setting of unknown type \"%s\"", setting->GetType().c_str());
   }
 
+  SkinSettingsChanged();
   return true;
 }
 
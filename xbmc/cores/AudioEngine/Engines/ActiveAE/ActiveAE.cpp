@@ -10,11 +10,13 @@
 
 using namespace AE;
 using namespace ActiveAE;
+#include "ActiveAESampleAllocator.h"
 #include "ActiveAESettings.h"
 #include "ActiveAESound.h"
 #include "ActiveAEStream.h"
 #include "ServiceBroker.h"
 #include "cores/AudioEngine/Interfaces/IAudioCallback.h"
+#include "cores/AudioEngine/Utils/AEKernels.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/Utils/AEStreamData.h"
 #include "cores/AudioEngine/Utils/AEStreamInfo.h"
@@ -946,6 +948,7 @@ void CActiveAE::StateMachine(int signal, Protocol *port, Message *msg)
         case CActiveAEControlProtocol::TIMEOUT:
           ResampleSounds();
           ClearDiscardedBuffers();
+          CActiveAESampleAllocator::GetInstance().Trim();
           if (m_extDrain)
           {
             if (m_extDrainTimer.IsTimePast())
@@ -1027,6 +1030,8 @@ void CActiveAE::Process()
   m_extDeferData = false;
   m_extKeepConfig = 0;
 
+  CActiveAESampleAllocator::GetInstance().SetProcessingThread(std::this_thread::get_id());
+
   // start sink
   m_sink.Start();
 
@@ -2086,15 +2091,7 @@ bool CActiveAE::RunStages()
 
               for(int j=0; j<out->pkt->planes; j++)
               {
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulArray((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
-#else
-                float* fbuffer = (float*) out->pkt->data[j]+i*nb_floats;
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  fbuffer[k] *= volume;
-                }
-#endif
+                CAEKernels::Get().gain((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
               }
             }
           }
@@ -2155,24 +2152,8 @@ bool CActiveAE::RunStages()
               {
                 float *dst = (float*)out->pkt->data[j]+i*nb_floats;
                 float *src = (float*)mix->pkt->data[j]+i*nb_floats;
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulAddArray(dst, src, volume, nb_floats);
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  if (fabs(dst[k]) > 1.0f)
-                  {
-                    needClamp = true;
-                    break;
-                  }
-                }
-#else
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  dst[k] += src[k] * volume;
-                  if (fabs(dst[k]) > 1.0f)
-                    needClamp = true;
-                }
-#endif
+                if (CAEKernels::Get().mixAdd(dst, src, volume, nb_floats) > 1.0f)
+                  needClamp = true;
               }
             }
             mix->Return();
@@ -2187,7 +2168,7 @@ bool CActiveAE::RunStages()
         int nb_floats = out->pkt->nb_samples * out->pkt->config.channels / out->pkt->planes;
         for (int i=0; i<out->pkt->planes; i++)
         {
-          CAEUtil::ClampArray((float*)out->pkt->data[i], nb_floats);
+          CAEKernels::Get().softClip((float*)out->pkt->data[i], nb_floats);
         }
       }
 
@@ -2555,12 +2536,7 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
       out = (float*)dstSample.data[j];
       sample_buffer = (float*)(it->sound->GetSound(false)->data[j]+start);
       int nb_floats = mix_samples * dstSample.config.channels / dstSample.planes;
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulAddArray(out, sample_buffer, volume, nb_floats);
-#else
-      for (int k = 0; k < nb_floats; ++k)
-        *out++ += *sample_buffer++ * volume;
-#endif
+      CAEKernels::Get().mixAdd(out, sample_buffer, volume, nb_floats);
     }
 
     it->samples_played += mix_samples;
@@ -2585,13 +2561,7 @@ void CActiveAE::Deamplify(CSoundPacket &dstSample)
     for(int j=0; j<dstSample.planes; j++)
     {
       float* buffer = reinterpret_cast<float*>(dstSample.data[j]);
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulArray(buffer, volume, nb_floats);
-#else
-      float *fbuffer = buffer;
-      for (int i = 0; i < nb_floats; i++)
-        *fbuffer++ *= volume;
-#endif
+      CAEKernels::Get().gain(buffer, volume, nb_floats);
     }
   }
 }
@@ -2936,21 +2906,28 @@ void CActiveAE::OnAppFocusChange(bool focus)
 
 uint8_t **CActiveAE::AllocSoundSample(SampleConfig &config, int &samples, int &bytes_per_sample, int &planes, int &linesize)
 {
-  uint8_t **buffer;
+  const size_t alignment = CActiveAESampleAllocator::ALIGNMENT;
   planes = av_sample_fmt_is_planar(config.fmt) ? config.channels : 1;
-  buffer = new uint8_t*[planes];
-
-  // align buffer to 16 in order to be compatible with sse in CAEConvert
-  av_samples_alloc(buffer, &linesize, config.channels,
-                                 samples, config.fmt, 16);
   bytes_per_sample = av_get_bytes_per_sample(config.fmt);
+
+  // the plane pointers are followed by the planes, each starting at a cache line
+  int size = av_samples_get_buffer_size(&linesize, config.channels, samples, config.fmt, alignment);
+  if (size < 0)
+    return nullptr;
+  size_t pointers = (planes * sizeof(uint8_t*) + alignment - 1) / alignment * alignment;
+  uint8_t *block = static_cast<uint8_t*>(CActiveAESampleAllocator::GetInstance().Allocate(pointers + size));
+  if (!block)
+    return nullptr;
+
+  uint8_t **buffer = reinterpret_cast<uint8_t**>(block);
+  av_samples_fill_arrays(buffer, &linesize, block + pointers, config.channels,
+                         samples, config.fmt, alignment);
   return buffer;
 }
 
 void CActiveAE::FreeSoundSample(uint8_t **data)
 {
-  av_freep(data);
-  delete [] data;
+  CActiveAESampleAllocator::GetInstance().Free(data);
 }
 
 bool CActiveAE::CompareFormat(AEAudioFormat &lhs, AEAudioFormat &rhs)
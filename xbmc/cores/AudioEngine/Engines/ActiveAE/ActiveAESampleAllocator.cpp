@@ -0,0 +1,203 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ActiveAESampleAllocator.h"
+
+#include "threads/SingleLock.h"
+#include "utils/MemUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+using namespace ActiveAE;
+
+struct CActiveAESampleAllocator::Slab
+{
+  uint8_t* memory;
+  size_t bytes;
+  int sizeClass;
+  unsigned int used;
+};
+
+// sits in the cache line in front of each block
+struct CActiveAESampleAllocator::BlockHeader
+{
+  Slab* slab; // nullptr for large blocks
+  BlockHeader* next;
+};
+
+static_assert(sizeof(void*) * 2 <= CActiveAESampleAllocator::ALIGNMENT, "block header too large");
+
+CActiveAESampleAllocator& CActiveAESampleAllocator::GetInstance()
+{
+  static CActiveAESampleAllocator allocator;
+  return allocator;
+}
+
+CActiveAESampleAllocator::CActiveAESampleAllocator() = default;
+
+CActiveAESampleAllocator::~CActiveAESampleAllocator()
+{
+  for (auto& slab : m_slabs)
+    KODI::MEMORY::AlignedFree(slab->memory);
+}
+
+size_t CActiveAESampleAllocator::GetClassSize(int sizeClass)
+{
+  const size_t base = static_cast<size_t>(4096) << (sizeClass / 4);
+  return base + (sizeClass % 4) * (base / 4);
+}
+
+int CActiveAESampleAllocator::GetSizeClass(size_t size)
+{
+  for (int sizeClass = 0; sizeClass < NUM_CLASSES; sizeClass++)
+  {
+    if (GetClassSize(sizeClass) >= size)
+      return sizeClass;
+  }
+  return -1;
+}
+
+size_t CActiveAESampleAllocator::GetBlockSize(size_t size)
+{
+  const int sizeClass = GetSizeClass(size + ALIGNMENT);
+  return sizeClass < 0 ? 0 : GetClassSize(sizeClass) - ALIGNMENT;
+}
+
+void* CActiveAESampleAllocator::Allocate(size_t size)
+{
+  CSingleLock lock(m_section);
+
+  int sizeClass = GetSizeClass(size + ALIGNMENT);
+  BlockHeader* header;
+  if (sizeClass < 0)
+  {
+    const size_t bytes = (size + 2 * ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    header = static_cast<BlockHeader*>(KODI::MEMORY::AlignedMalloc(bytes, ALIGNMENT));
+    if (!header)
+      return nullptr;
+    header->slab = nullptr;
+    CountHeapAllocation();
+  }
+  else
+  {
+    // a block of the next class is at most a quarter larger, which covers a change of the
+    // sample rate from 48 to 44.1 kHz
+    if (!m_freeBlocks[sizeClass] && sizeClass + 1 < NUM_CLASSES && m_freeBlocks[sizeClass + 1])
+      sizeClass++;
+    else if (!m_freeBlocks[sizeClass] && !AddSlab(sizeClass))
+      return nullptr;
+    header = m_freeBlocks[sizeClass];
+    m_freeBlocks[sizeClass] = header->next;
+    header->slab->used++;
+  }
+
+  m_stats.allocations++;
+  m_stats.blocksInUse++;
+  return reinterpret_cast<uint8_t*>(header) + ALIGNMENT;
+}
+
+void CActiveAESampleAllocator::Free(void* block)
+{
+  if (!block)
+    return;
+
+  CSingleLock lock(m_section);
+
+  BlockHeader* header = reinterpret_cast<BlockHeader*>(static_cast<uint8_t*>(block) - ALIGNMENT);
+  m_stats.blocksInUse--;
+  if (!header->slab)
+  {
+    KODI::MEMORY::AlignedFree(header);
+    return;
+  }
+
+  header->slab->used--;
+  header->next = m_freeBlocks[header->slab->sizeClass];
+  m_freeBlocks[header->slab->sizeClass] = header;
+}
+
+bool CActiveAESampleAllocator::AddSlab(int sizeClass)
+{
+  const size_t blockSize = GetClassSize(sizeClass);
+  const size_t blocks = std::max(SLAB_SIZE / blockSize, static_cast<size_t>(1));
+
+  std::unique_ptr<Slab> slab(new Slab);
+  slab->bytes = blocks * blockSize;
+  slab->sizeClass = sizeClass;
+  slab->used = 0;
+  slab->memory = static_cast<uint8_t*>(KODI::MEMORY::AlignedMalloc(slab->bytes, ALIGNMENT));
+  if (!slab->memory)
+  {
+    CLog::Log(LOGERROR, "CActiveAESampleAllocator::AddSlab - failed to allocate %zu bytes", slab->bytes);
+    return false;
+  }
+
+  for (size_t i = blocks; i > 0; i--)
+  {
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(slab->memory + (i - 1) * blockSize);
+    header->slab = slab.get();
+    header->next = m_freeBlocks[sizeClass];
+    m_freeBlocks[sizeClass] = header;
+  }
+
+  m_stats.slabs++;
+  m_stats.slabBytes += slab->bytes;
+  m_slabs.push_back(std::move(slab));
+  CountHeapAllocation();
+  return true;
+}
+
+void CActiveAESampleAllocator::CountHeapAllocation()
+{
+  m_stats.heapAllocations++;
+  if (std::this_thread::get_id() == m_processingThread)
+    m_stats.processingHeapAllocations++;
+}
+
+void CActiveAESampleAllocator::Trim()
+{
+  CSingleLock lock(m_section);
+
+  auto unused = std::partition(m_slabs.begin(), m_slabs.end(),
+                               [](const std::unique_ptr<Slab>& slab) { return slab->used > 0; });
+  if (unused == m_slabs.end())
+    return;
+
+  for (BlockHeader*& head : m_freeBlocks)
+  {
+    BlockHeader** link = &head;
+    while (*link)
+    {
+      if ((*link)->slab->used == 0)
+        *link = (*link)->next;
+      else
+        link = &(*link)->next;
+    }
+  }
+
+  for (auto it = unused; it != m_slabs.end(); ++it)
+  {
+    m_stats.slabs--;
+    m_stats.slabBytes -= (*it)->bytes;
+    KODI::MEMORY::AlignedFree((*it)->memory);
+  }
+  m_slabs.erase(unused, m_slabs.end());
+}
+
+void CActiveAESampleAllocator::SetProcessingThread(std::thread::id id)
+{
+  CSingleLock lock(m_section);
+  m_processingThread = id;
+}
+
+CActiveAESampleAllocator::Stats CActiveAESampleAllocator::GetStats()
+{
+  CSingleLock lock(m_section);
+  return m_stats;
+}
@@ -0,0 +1,93 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+namespace ActiveAE
+{
+
+/*!
+ * \brief Storage for the samples of sound packets, shared by all buffer pools.
+ *
+ * Blocks are cut from slabs and sorted into size classes a quarter of a power of two apart.
+ * Freed blocks are kept for the next block of their class or the class below, so the pools
+ * created after a format change reuse the storage of the ones they replace if the sizes are
+ * close. Slabs are only released by Trim().
+ */
+class CActiveAESampleAllocator
+{
+public:
+  //! blocks start at a cache line, which also satisfies every SIMD kernel
+  static constexpr size_t ALIGNMENT = 64;
+
+  struct Stats
+  {
+    unsigned int slabs = 0;
+    size_t slabBytes = 0;
+    unsigned int blocksInUse = 0;
+    uint64_t allocations = 0;
+    uint64_t heapAllocations = 0; //!< allocations which needed a new slab or a large block
+    uint64_t processingHeapAllocations = 0; //!< heap allocations on the processing thread
+  };
+
+  static CActiveAESampleAllocator& GetInstance();
+
+  CActiveAESampleAllocator();
+  ~CActiveAESampleAllocator();
+  CActiveAESampleAllocator(const CActiveAESampleAllocator&) = delete;
+  CActiveAESampleAllocator& operator=(const CActiveAESampleAllocator&) = delete;
+
+  /*!
+   * \brief Returns a block of at least size bytes aligned to ALIGNMENT, or nullptr
+   */
+  void* Allocate(size_t size);
+  void Free(void* block);
+
+  /*!
+   * \brief Releases the slabs none of whose blocks are in use
+   */
+  void Trim();
+
+  /*!
+   * \brief Heap allocations from this thread are counted separately, to verify that the engine
+   * doesn't allocate while it plays
+   */
+  void SetProcessingThread(std::thread::id id);
+  Stats GetStats();
+
+  //! the size of the blocks of the class of size, 0 for blocks too large for slabs
+  static size_t GetBlockSize(size_t size);
+
+private:
+  struct Slab;
+  struct BlockHeader;
+
+  static int GetSizeClass(size_t size);
+  static size_t GetClassSize(int sizeClass);
+  bool AddSlab(int sizeClass);
+  void CountHeapAllocation();
+
+  static constexpr int NUM_CLASSES = 44; //!< 4 KiB to 7 MiB
+  static constexpr size_t SLAB_SIZE = 256 * 1024;
+
+  CCriticalSection m_section;
+  std::vector<std::unique_ptr<Slab>> m_slabs;
+  BlockHeader* m_freeBlocks[NUM_CLASSES] = {};
+  std::thread::id m_processingThread;
+  Stats m_stats;
+};
+
+}
@@ -0,0 +1,419 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "cores/AudioEngine/AESinkFactory.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAE.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAESampleAllocator.h"
+#include "cores/AudioEngine/Interfaces/AESound.h"
+#include "cores/AudioEngine/Interfaces/AEStream.h"
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
+#include "cores/AudioEngine/Utils/AEStreamData.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "filesystem/File.h"
+#include "settings/Settings.h"
+#include "settings/SettingsComponent.h"
+#include "test/AllocationCounter.h"
+#include "threads/SingleLock.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#if defined(TARGET_WINDOWS)
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include <gtest/gtest.h>
+
+namespace
+{
+struct StreamConfig
+{
+  const char* name;
+  unsigned int sampleRate;
+  AEStdChLayout layout;
+  AEDataFormat format;
+  unsigned int options;
+  int resampleMode;
+  double resampleRatio;
+};
+
+// the first stream carries the bursts used to measure the latency, it is in the format of the
+// sink so that they arrive unchanged. The others take the resample, downmix and atempo paths.
+const StreamConfig streamConfigs[] = {
+  {"48 kHz 2.0 float", 48000, AE_CH_LAYOUT_2_0, AE_FMT_FLOAT, 0, 0, 1.0},
+  {"44.1 kHz 2.0 S16", 44100, AE_CH_LAYOUT_2_0, AE_FMT_S16NE, 0, 0, 1.0},
+  {"96 kHz 5.1 S32", 96000, AE_CH_LAYOUT_5_1, AE_FMT_S32NE, 0, 0, 1.0},
+  {"48 kHz 7.1 float planar, atempo", 48000, AE_CH_LAYOUT_7_1, AE_FMT_FLOATP, 0, 0, 1.1},
+  {"22.05 kHz 1.0 S16, resample mode", 22050, AE_CH_LAYOUT_1_0, AE_FMT_S16NE, AESTREAM_FORCE_RESAMPLE, 1, 1.01},
+};
+
+const float BURST_LEVEL = 0.9f;
+const float SIGNAL_LEVEL = 0.01f;
+const unsigned int BURST_FRAMES = 64;
+
+double GetProcessCPUTime()
+{
+#if defined(TARGET_WINDOWS)
+  FILETIME creation, exit, kernel, user;
+  if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+    return 0.0;
+  auto toSeconds = [](const FILETIME& time) {
+    return ((static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime) / 1e7;
+  };
+  return toSeconds(kernel) + toSeconds(user);
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0.0;
+  return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 + usage.ru_stime.tv_sec +
+         usage.ru_stime.tv_usec / 1e6;
+#endif
+}
+
+// a short click as 16 bit mono wav, for the gui sounds
+bool WriteClick(const std::string& file)
+{
+  const unsigned int sampleRate = 44100;
+  const unsigned int frames = sampleRate / 20;
+  std::vector<uint8_t> wav(44 + frames * 2);
+  auto put = [&wav](size_t pos, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; i++)
+      wav[pos + i] = static_cast<uint8_t>(value >> (8 * i));
+  };
+  memcpy(&wav[0], "RIFF", 4);
+  put(4, wav.size() - 8, 4);
+  memcpy(&wav[8], "WAVEfmt ", 8);
+  put(16, 16, 4);
+  put(20, 1, 2); // PCM
+  put(22, 1, 2); // channels
+  put(24, sampleRate, 4);
+  put(28, sampleRate * 2, 4);
+  put(32, 2, 2);
+  put(34, 16, 2);
+  memcpy(&wav[36], "data", 4);
+  put(40, frames * 2, 4);
+  for (unsigned int i = 0; i < frames; i++)
+    put(44 + i * 2, static_cast<uint16_t>(static_cast<int16_t>(std::sin(i * 0.2) * 3000 * (frames - i) / frames)), 2);
+
+  XFILE::CFile out;
+  return out.OpenForWrite(file, true) && out.Write(wav.data(), wav.size()) == static_cast<ssize_t>(wav.size());
+}
+
+class CTestStream
+{
+public:
+  CTestStream(IAE& ae, const StreamConfig& config, bool probe)
+    : m_ae(ae), m_probe(probe)
+  {
+    AEAudioFormat format;
+    format.m_dataFormat = config.format;
+    format.m_sampleRate = config.sampleRate;
+    format.m_channelLayout = config.layout;
+    m_stream = ae.MakeStream(format, config.options);
+    if (!m_stream)
+      return;
+    m_stream->SetResampleMode(config.resampleMode);
+    if (config.resampleRatio != 1.0)
+      m_stream->SetResampleRatio(config.resampleRatio);
+
+    m_format = config.format;
+    m_channels = format.m_channelLayout.Count();
+    m_planes = AE_IS_PLANAR(config.format) ? m_channels : 1;
+    m_chunkFrames = config.sampleRate / 100;
+    m_burstInterval = config.sampleRate / 2;
+    m_bytesPerSample = CAEUtil::DataFormatToBits(config.format) >> 3;
+    m_data.resize(m_planes);
+    for (auto& plane : m_data)
+      plane.resize(m_chunkFrames * m_channels / m_planes * m_bytesPerSample);
+  }
+
+  ~CTestStream()
+  {
+    if (m_stream)
+      m_ae.FreeStream(m_stream, false);
+  }
+
+  bool IsValid() const { return m_stream != nullptr; }
+
+  // adds all the data the stream takes, and the times the bursts were taken to bursts
+  void Feed(std::deque<std::chrono::steady_clock::time_point>& bursts)
+  {
+    const unsigned int chunkBytes = m_chunkFrames * m_channels * m_bytesPerSample;
+    while (m_stream->GetSpace() >= chunkBytes)
+    {
+      // a burst starts at every multiple of the interval
+      const unsigned int rest = m_position % m_burstInterval;
+      const unsigned int burstStart = rest ? m_burstInterval - rest : 0;
+      const bool burst = m_probe && burstStart < m_chunkFrames;
+      Generate(burst ? burstStart : m_chunkFrames);
+
+      std::vector<const uint8_t*> planes;
+      for (auto& plane : m_data)
+        planes.push_back(plane.data());
+      IAEStream::ExtData extData;
+      extData.pts = m_position * 1000.0 / m_stream->GetSampleRate();
+      const unsigned int added = m_stream->AddData(planes.data(), 0, m_chunkFrames, &extData);
+      if (burst && added > 0)
+        bursts.push_back(std::chrono::steady_clock::now());
+      m_position += m_chunkFrames;
+      if (added < m_chunkFrames)
+        break;
+    }
+  }
+
+private:
+  // fills a chunk with a quiet sine, and a burst from burstStart on
+  void Generate(unsigned int burstStart)
+  {
+    for (unsigned int i = 0; i < m_chunkFrames; i++)
+    {
+      float value = SIGNAL_LEVEL * static_cast<float>(std::sin((m_position + i) * 0.05));
+      if (i >= burstStart && i < burstStart + BURST_FRAMES)
+        value = BURST_LEVEL;
+      for (unsigned int j = 0; j < m_channels; j++)
+      {
+        const unsigned int plane = m_planes > 1 ? j : 0;
+        const unsigned int index = m_planes > 1 ? i : i * m_channels + j;
+        uint8_t* sample = m_data[plane].data() + index * m_bytesPerSample;
+        switch (m_format)
+        {
+          case AE_FMT_S16NE:
+          {
+            const int16_t s16 = static_cast<int16_t>(value * 32767);
+            memcpy(sample, &s16, sizeof(s16));
+            break;
+          }
+          case AE_FMT_S32NE:
+          {
+            const int32_t s32 = static_cast<int32_t>(value * 2147483647.0);
+            memcpy(sample, &s32, sizeof(s32));
+            break;
+          }
+          default:
+            memcpy(sample, &value, sizeof(value));
+            break;
+        }
+      }
+    }
+  }
+
+  IAE& m_ae;
+  IAEStream* m_stream = nullptr;
+  bool m_probe;
+  AEDataFormat m_format = AE_FMT_FLOAT;
+  unsigned int m_channels = 0;
+  unsigned int m_planes = 0;
+  unsigned int m_chunkFrames = 0;
+  unsigned int m_burstInterval = 0;
+  unsigned int m_bytesPerSample = 0;
+  uint64_t m_position = 0;
+  std::vector<std::vector<uint8_t>> m_data;
+};
+
+struct BenchmarkResult
+{
+  double cpuPerSecond = 0.0; //!< seconds of CPU time per second of audio
+  double allocationsPerSecond = 0.0;
+  uint64_t sampleHeapAllocations = 0; //!< by the engine thread, for sample storage
+  double audioSeconds = 0.0;
+  std::vector<double> latencies; //!< from AddData to the sink, in ms
+};
+
+class TestActiveAE : public ::testing::Test
+{
+protected:
+  TestActiveAE()
+  {
+    m_settings = CServiceBroker::GetSettingsComponent()->GetSettings();
+    m_config = m_settings->GetInt(CSettings::SETTING_AUDIOOUTPUT_CONFIG);
+    m_guiSoundMode = m_settings->GetInt(CSettings::SETTING_AUDIOOUTPUT_GUISOUNDMODE);
+    m_streamNoise = m_settings->GetBool(CSettings::SETTING_AUDIOOUTPUT_STREAMNOISE);
+
+    // a fixed 48 kHz stereo output, so that every run mixes the same way
+    m_settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_CONFIG, AE_CONFIG_FIXED);
+    m_settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_SAMPLERATE, 48000);
+    m_settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_CHANNELS, AE_CH_LAYOUT_2_0);
+    m_settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_GUISOUNDMODE, AE_SOUND_ALWAYS);
+    m_settings->SetBool(CSettings::SETTING_AUDIOOUTPUT_STREAMNOISE, false);
+
+    AE::CAESinkFactory::ClearSinks();
+    CAESinkNULL::Register();
+  }
+
+  ~TestActiveAE() override
+  {
+    CAESinkNULL::SetPacketCallback(nullptr);
+    AE::CAESinkFactory::ClearSinks();
+
+    m_settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_CONFIG, m_config);
+    m_settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_GUISOUNDMODE, m_guiSoundMode);
+    m_settings->SetBool(CSettings::SETTING_AUDIOOUTPUT_STREAMNOISE, m_streamNoise);
+  }
+
+  BenchmarkResult Run(unsigned int streamCount, bool guiSounds, double seconds)
+  {
+    BenchmarkResult result;
+    std::deque<std::chrono::steady_clock::time_point> bursts;
+    std::atomic<uint64_t> sinkFrames(0);
+    std::atomic<unsigned int> sinkRate(0);
+    CCriticalSection section;
+    bool inBurst = false;
+
+    CAESinkNULL::SetPacketCallback([&](const uint8_t* data, unsigned int frames, const AEAudioFormat& format) {
+      sinkFrames += frames;
+      sinkRate = format.m_sampleRate;
+      if (format.m_dataFormat != AE_FMT_FLOAT)
+        return;
+      const float* samples = reinterpret_cast<const float*>(data);
+      const unsigned int channels = format.m_channelLayout.Count();
+      for (unsigned int i = 0; i < frames; i++)
+      {
+        const bool loud = std::abs(samples[i * channels]) > BURST_LEVEL / 2;
+        if (loud && !inBurst)
+        {
+          CSingleLock lock(section);
+          if (!bursts.empty())
+          {
+            const std::chrono::duration<double, std::milli> latency = std::chrono::steady_clock::now() - bursts.front();
+            result.latencies.push_back(latency.count());
+            bursts.pop_front();
+          }
+        }
+        inBurst = loud;
+      }
+    });
+
+    std::unique_ptr<ActiveAE::CActiveAE> ae(new ActiveAE::CActiveAE());
+    ae->Start();
+
+    const std::string clickFile = "special://temp/activeae_click.wav";
+    IAESound* sound = nullptr;
+    if (guiSounds && WriteClick(clickFile))
+      sound = ae->MakeSound(clickFile);
+
+    std::vector<std::unique_ptr<CTestStream>> streams;
+    for (unsigned int i = 0; i < streamCount && i < sizeof(streamConfigs) / sizeof(streamConfigs[0]); i++)
+    {
+      streams.emplace_back(new CTestStream(*ae, streamConfigs[i], i == 0));
+      EXPECT_TRUE(streams.back()->IsValid()) << streamConfigs[i].name;
+    }
+
+    // the first half second fills the buffers and isn't measured
+    const auto start = std::chrono::steady_clock::now();
+    auto nextSound = start;
+    bool measuring = false;
+    double cpuStart = 0.0;
+    uint64_t allocationsStart = 0;
+    uint64_t sampleAllocationsStart = 0;
+    uint64_t framesStart = 0;
+    while (true)
+    {
+      const auto now = std::chrono::steady_clock::now();
+      const std::chrono::duration<double> elapsed = now - start;
+      if (!measuring && elapsed.count() >= 0.5)
+      {
+        measuring = true;
+        cpuStart = GetProcessCPUTime();
+        allocationsStart = GetAllocationCount();
+        sampleAllocationsStart =
+            ActiveAE::CActiveAESampleAllocator::GetInstance().GetStats().processingHeapAllocations;
+        framesStart = sinkFrames;
+        CSingleLock lock(section);
+        result.latencies.clear();
+      }
+      if (elapsed.count() >= 0.5 + seconds)
+        break;
+
+      {
+        CSingleLock lock(section);
+        for (auto& stream : streams)
+        {
+          if (stream->IsValid())
+            stream->Feed(bursts);
+        }
+      }
+
+      if (sound && now >= nextSound)
+      {
+        sound->Play();
+        nextSound = now + std::chrono::milliseconds(250);
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    const double cpu = GetProcessCPUTime() - cpuStart;
+    const uint64_t allocated = GetAllocationCount() - allocationsStart;
+    result.sampleHeapAllocations =
+        ActiveAE::CActiveAESampleAllocator::GetInstance().GetStats().processingHeapAllocations -
+        sampleAllocationsStart;
+    if (sinkRate > 0)
+      result.audioSeconds = static_cast<double>(sinkFrames - framesStart) / sinkRate;
+    if (result.audioSeconds > 0.0)
+    {
+      result.cpuPerSecond = cpu / result.audioSeconds;
+      result.allocationsPerSecond = allocated / result.audioSeconds;
+    }
+
+    streams.clear();
+    if (sound)
+      ae->FreeSound(sound);
+    ae->Shutdown();
+    ae.reset();
+    CAESinkNULL::SetPacketCallback(nullptr);
+    XFILE::CFile::Delete(clickFile);
+    return result;
+  }
+
+  std::shared_ptr<CSettings> m_settings;
+  int m_config;
+  int m_guiSoundMode;
+  bool m_streamNoise;
+};
+}
+
+TEST_F(TestActiveAE, NullSinkBenchmark)
+{
+  const double seconds = 2.0;
+  const unsigned int allStreams = sizeof(streamConfigs) / sizeof(streamConfigs[0]);
+
+  for (unsigned int streamCount : {1u, allStreams})
+  {
+    const bool guiSounds = streamCount > 1;
+    BenchmarkResult result = Run(streamCount, guiSounds, seconds);
+
+    // the sink plays in real time, less means the engine didn't keep up
+    EXPECT_GT(result.audioSeconds, seconds * 0.8) << streamCount << " streams";
+    ASSERT_FALSE(result.latencies.empty()) << streamCount << " streams";
+    // once the pools are set up, the engine takes all the storage it needs from them
+    EXPECT_EQ(0u, result.sampleHeapAllocations) << streamCount << " streams";
+
+    std::sort(result.latencies.begin(), result.latencies.end());
+    double average = 0.0;
+    for (double latency : result.latencies)
+      average += latency;
+    average /= result.latencies.size();
+
+    std::cout << streamCount << " streams" << (guiSounds ? " + gui sounds" : "") << ": "
+              << result.cpuPerSecond * 1000 << " ms CPU per s of audio, latency min "
+              << result.latencies.front() << " / avg " << average << " / max "
+              << result.latencies.back() << " ms, " << result.allocationsPerSecond
+              << " allocations per s\n";
+  }
+}
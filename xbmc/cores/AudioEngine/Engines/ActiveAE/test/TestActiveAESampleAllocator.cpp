@@ -0,0 +1,123 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAESampleAllocator.h"
+
+#include <cstring>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ActiveAE;
+
+TEST(TestActiveAESampleAllocator, Alignment)
+{
+  CActiveAESampleAllocator allocator;
+  std::vector<void*> blocks;
+  for (size_t size : {1, 100, 4000, 4096, 10000, 70000, 1000000, 20000000})
+  {
+    void* block = allocator.Allocate(size);
+    ASSERT_NE(nullptr, block) << size;
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(block) % CActiveAESampleAllocator::ALIGNMENT) << size;
+    memset(block, 0xaa, size);
+    blocks.push_back(block);
+  }
+  EXPECT_EQ(blocks.size(), allocator.GetStats().blocksInUse);
+
+  for (void* block : blocks)
+    allocator.Free(block);
+  EXPECT_EQ(0u, allocator.GetStats().blocksInUse);
+}
+
+TEST(TestActiveAESampleAllocator, BlockSize)
+{
+  for (size_t size = 1; size < 8000000; size = size * 3 / 2 + 1)
+  {
+    const size_t blockSize = CActiveAESampleAllocator::GetBlockSize(size);
+    if (blockSize == 0)
+      continue;
+    EXPECT_GE(blockSize, size);
+    // a quarter of a power of two apart, at most a third more than asked for
+    if (size > 4096)
+    {
+      EXPECT_LE(blockSize, size + size / 3 + CActiveAESampleAllocator::ALIGNMENT) << size;
+    }
+  }
+  EXPECT_EQ(0u, CActiveAESampleAllocator::GetBlockSize(100000000));
+}
+
+TEST(TestActiveAESampleAllocator, Reuse)
+{
+  CActiveAESampleAllocator allocator;
+
+  // a pool of 20 ms periods of 48 kHz 7.1 float
+  std::vector<void*> pool;
+  for (int i = 0; i < 8; i++)
+    pool.push_back(allocator.Allocate(960 * 8 * 4));
+  const CActiveAESampleAllocator::Stats first = allocator.GetStats();
+  std::set<void*> storage(pool.begin(), pool.end());
+  for (void* block : pool)
+    allocator.Free(block);
+
+  // after a format change to 44.1 kHz the periods are a little smaller and share the storage
+  pool.clear();
+  for (int i = 0; i < 8; i++)
+  {
+    pool.push_back(allocator.Allocate(882 * 8 * 4));
+    EXPECT_EQ(1u, storage.count(pool.back()));
+  }
+  const CActiveAESampleAllocator::Stats second = allocator.GetStats();
+  EXPECT_EQ(first.heapAllocations, second.heapAllocations);
+  EXPECT_EQ(first.slabs, second.slabs);
+  EXPECT_EQ(16u, second.allocations);
+
+  for (void* block : pool)
+    allocator.Free(block);
+}
+
+TEST(TestActiveAESampleAllocator, Trim)
+{
+  CActiveAESampleAllocator allocator;
+  void* kept = allocator.Allocate(5000);
+  std::vector<void*> blocks;
+  for (int i = 0; i < 4; i++)
+    blocks.push_back(allocator.Allocate(300000));
+  EXPECT_EQ(5u, allocator.GetStats().slabs);
+
+  for (void* block : blocks)
+    allocator.Free(block);
+  allocator.Trim();
+  EXPECT_EQ(1u, allocator.GetStats().slabs);
+
+  // the free blocks of the slab in use remain
+  const uint64_t heapAllocations = allocator.GetStats().heapAllocations;
+  allocator.Free(allocator.Allocate(5000));
+  EXPECT_EQ(heapAllocations, allocator.GetStats().heapAllocations);
+
+  allocator.Free(kept);
+  allocator.Trim();
+  EXPECT_EQ(0u, allocator.GetStats().slabs);
+  EXPECT_EQ(0u, allocator.GetStats().slabBytes);
+
+  allocator.Free(allocator.Allocate(5000));
+  EXPECT_EQ(heapAllocations + 1, allocator.GetStats().heapAllocations);
+}
+
+TEST(TestActiveAESampleAllocator, ProcessingThread)
+{
+  CActiveAESampleAllocator allocator;
+  allocator.Free(allocator.Allocate(1000));
+  EXPECT_EQ(0u, allocator.GetStats().processingHeapAllocations);
+
+  allocator.SetProcessingThread(std::this_thread::get_id());
+  allocator.Free(allocator.Allocate(1000));
+  EXPECT_EQ(0u, allocator.GetStats().processingHeapAllocations);
+  allocator.Free(allocator.Allocate(100000));
+  EXPECT_EQ(1u, allocator.GetStats().processingHeapAllocations);
+}
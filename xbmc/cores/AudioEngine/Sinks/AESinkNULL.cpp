@@ -0,0 +1,155 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AESinkNULL.h"
+
+#include "cores/AudioEngine/AESinkFactory.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace
+{
+const unsigned int PERIODS_PER_SECOND = 50;
+const unsigned int BUFFER_PERIODS = 4;
+}
+
+CCriticalSection CAESinkNULL::m_callbackSection;
+CAESinkNULL::PacketCallback CAESinkNULL::m_callback;
+
+void CAESinkNULL::Register()
+{
+  AE::AESinkRegEntry entry;
+  entry.sinkName = "NULL";
+  entry.createFunc = CAESinkNULL::Create;
+  entry.enumerateFunc = CAESinkNULL::EnumerateDevicesEx;
+  AE::CAESinkFactory::RegisterSink(entry);
+}
+
+IAESink* CAESinkNULL::Create(std::string &device, AEAudioFormat& desiredFormat)
+{
+  IAESink* sink = new CAESinkNULL();
+  if (sink->Initialize(desiredFormat, device))
+    return sink;
+
+  delete sink;
+  return nullptr;
+}
+
+void CAESinkNULL::EnumerateDevicesEx(AEDeviceInfoList &list, bool force)
+{
+  CAEDeviceInfo info;
+  info.m_deviceName = "default";
+  info.m_displayName = "Null";
+  info.m_displayNameExtra = "";
+  info.m_deviceType = AE_DEVTYPE_PCM;
+  info.m_channels = AE_CH_LAYOUT_7_1;
+  info.m_sampleRates = {44100, 48000, 88200, 96000, 176400, 192000};
+  info.m_dataFormats = {AE_FMT_FLOAT, AE_FMT_S32NE, AE_FMT_S16NE};
+  info.m_wantsIECPassthrough = false;
+  list.push_back(info);
+}
+
+void CAESinkNULL::SetPacketCallback(PacketCallback callback)
+{
+  CSingleLock lock(m_callbackSection);
+  m_callback = std::move(callback);
+}
+
+bool CAESinkNULL::Initialize(AEAudioFormat &format, std::string &device)
+{
+  if (format.m_dataFormat == AE_FMT_RAW)
+  {
+    CLog::Log(LOGERROR, "CAESinkNULL::Initialize - passthrough is not supported");
+    return false;
+  }
+
+  if (format.m_dataFormat != AE_FMT_FLOAT && format.m_dataFormat != AE_FMT_S32NE &&
+      format.m_dataFormat != AE_FMT_S16NE)
+    format.m_dataFormat = AE_FMT_FLOAT;
+  if (format.m_channelLayout.Count() == 0 || format.m_channelLayout.Count() > 8)
+    format.m_channelLayout = AE_CH_LAYOUT_2_0;
+  if (format.m_sampleRate == 0)
+    format.m_sampleRate = 48000;
+
+  format.m_frames = std::max(format.m_sampleRate / PERIODS_PER_SECOND, 1u);
+  format.m_frameSize = format.m_channelLayout.Count() * (CAEUtil::DataFormatToBits(format.m_dataFormat) >> 3);
+
+  m_format = format;
+  m_bufferFrames = format.m_frames * BUFFER_PERIODS;
+  m_bufferedFrames = 0.0;
+  m_lastUpdate = std::chrono::steady_clock::now();
+  return true;
+}
+
+void CAESinkNULL::Deinitialize()
+{
+  m_bufferedFrames = 0.0;
+}
+
+double CAESinkNULL::GetCacheTotal()
+{
+  return static_cast<double>(m_bufferFrames) / m_format.m_sampleRate;
+}
+
+unsigned int CAESinkNULL::AddPackets(uint8_t **data, unsigned int frames, unsigned int offset)
+{
+  frames = std::min(frames, m_bufferFrames);
+  WaitForSpace(frames);
+  m_bufferedFrames += frames;
+
+  CSingleLock lock(m_callbackSection);
+  if (m_callback)
+    m_callback(data[0] + offset * m_format.m_frameSize, frames, m_format);
+
+  return frames;
+}
+
+void CAESinkNULL::AddPause(unsigned int millis)
+{
+  const double frames = std::min(static_cast<double>(millis) * m_format.m_sampleRate / 1000,
+                                 static_cast<double>(m_bufferFrames));
+  WaitForSpace(frames);
+  m_bufferedFrames += frames;
+}
+
+void CAESinkNULL::GetDelay(AEDelayStatus& status)
+{
+  Update();
+  status.SetDelay(m_bufferedFrames / m_format.m_sampleRate);
+}
+
+void CAESinkNULL::Drain()
+{
+  Update();
+  std::this_thread::sleep_for(std::chrono::duration<double>(m_bufferedFrames / m_format.m_sampleRate));
+  m_bufferedFrames = 0.0;
+  m_lastUpdate = std::chrono::steady_clock::now();
+}
+
+void CAESinkNULL::Update()
+{
+  const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  const std::chrono::duration<double> elapsed = now - m_lastUpdate;
+  m_bufferedFrames = std::max(m_bufferedFrames - elapsed.count() * m_format.m_sampleRate, 0.0);
+  m_lastUpdate = now;
+}
+
+void CAESinkNULL::WaitForSpace(double frames)
+{
+  Update();
+  const double excess = m_bufferedFrames + frames - m_bufferFrames;
+  if (excess > 0.0)
+  {
+    std::this_thread::sleep_for(std::chrono::duration<double>(excess / m_format.m_sampleRate));
+    Update();
+  }
+}
@@ -0,0 +1,66 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "cores/AudioEngine/Interfaces/AESink.h"
+#include "cores/AudioEngine/Utils/AEDeviceInfo.h"
+#include "threads/CriticalSection.h"
+
+#include <chrono>
+#include <functional>
+#include <stdint.h>
+
+/*!
+ * \brief A sink without hardware, for headless setups, tests and benchmarks.
+ *
+ * It plays at the rate of the format it is opened with, from a fixed buffer of four 20 ms
+ * periods, so the engine sees the same timing on every machine. The samples are dropped after
+ * being passed to the packet callback.
+ */
+class CAESinkNULL : public IAESink
+{
+public:
+  const char *GetName() override { return "NULL"; }
+
+  CAESinkNULL() = default;
+  ~CAESinkNULL() override = default;
+
+  static void Register();
+  static IAESink* Create(std::string &device, AEAudioFormat &desiredFormat);
+  static void EnumerateDevicesEx(AEDeviceInfoList &list, bool force = false);
+
+  /*!
+   * \brief Called from the sink thread for each packet, with the frames in the format the sink
+   * was opened with. An empty callback removes it.
+   */
+  using PacketCallback = std::function<void(const uint8_t* data, unsigned int frames, const AEAudioFormat& format)>;
+  static void SetPacketCallback(PacketCallback callback);
+
+  bool Initialize(AEAudioFormat &format, std::string &device) override;
+  void Deinitialize() override;
+
+  double GetCacheTotal() override;
+  unsigned int AddPackets(uint8_t **data, unsigned int frames, unsigned int offset) override;
+  void AddPause(unsigned int millis) override;
+  void GetDelay(AEDelayStatus& status) override;
+  void Drain() override;
+
+private:
+  //! advances the playback position to now, it stops when the buffer runs empty
+  void Update();
+  void WaitForSpace(double frames);
+
+  AEAudioFormat m_format;
+  unsigned int m_bufferFrames = 0;
+  double m_bufferedFrames = 0.0;
+  std::chrono::steady_clock::time_point m_lastUpdate;
+
+  static CCriticalSection m_callbackSection;
+  static PacketCallback m_callback;
+};
@@ -0,0 +1,200 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AEKernels.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#include <immintrin.h>
+
+// the rest of the build doesn't use AVX2, these are only used if the CPU has it
+#if defined(__GNUC__)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+namespace
+{
+const CAEKernels::Kernels& reference = CAEKernels::GetReference();
+
+TARGET_AVX2 void Gain(float* data, float gain, unsigned int count)
+{
+  const __m256 g = _mm256_set1_ps(gain);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), g));
+  reference.gain(data + i, gain, count - i);
+}
+
+TARGET_AVX2 float MixAdd(float* dst, const float* src, float gain, unsigned int count)
+{
+  const __m256 g = _mm256_set1_ps(gain);
+  const __m256 sign = _mm256_set1_ps(-0.0f);
+  __m256 peak = _mm256_setzero_ps();
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m256 d = _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), g));
+    _mm256_storeu_ps(dst + i, d);
+    peak = _mm256_max_ps(peak, _mm256_andnot_ps(sign, d));
+  }
+  __m128 peak4 = _mm_max_ps(_mm256_castps256_ps128(peak), _mm256_extractf128_ps(peak, 1));
+  peak4 = _mm_max_ps(peak4, _mm_movehl_ps(peak4, peak4));
+  peak4 = _mm_max_ss(peak4, _mm_shuffle_ps(peak4, peak4, _MM_SHUFFLE(1, 1, 1, 1)));
+  const float tail = reference.mixAdd(dst + i, src + i, gain, count - i);
+  const float result = _mm_cvtss_f32(peak4);
+  return tail > result ? tail : result;
+}
+
+TARGET_AVX2 void SoftClip(float* data, unsigned int count)
+{
+  const __m256 min = _mm256_set1_ps(-3.0f);
+  const __m256 max = _mm256_set1_ps(3.0f);
+  const __m256 c27 = _mm256_set1_ps(27.0f);
+  const __m256 c9 = _mm256_set1_ps(9.0f);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(data + i), min), max);
+    const __m256 y = _mm256_mul_ps(x, x);
+    _mm256_storeu_ps(data + i, _mm256_div_ps(_mm256_mul_ps(x, _mm256_add_ps(c27, y)),
+                                             _mm256_add_ps(c27, _mm256_mul_ps(c9, y))));
+  }
+  reference.softClip(data + i, count - i);
+}
+
+TARGET_AVX2 void FloatToS16(int16_t* dst, const float* src, unsigned int count)
+{
+  const __m256 scale = _mm256_set1_ps(32768.0f);
+  const __m256 min = _mm256_set1_ps(-32768.0f);
+  const __m256 max = _mm256_set1_ps(32767.0f);
+  unsigned int i = 0;
+  for (; i + 16 <= count; i += 16)
+  {
+    const __m256 a = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale), min), max);
+    const __m256 b = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i + 8), scale), min), max);
+    // packs works per 128 bit lane, which leaves the quarters in the order a0 b0 a1 b1
+    const __m256i packed = _mm256_packs_epi32(_mm256_cvtps_epi32(a), _mm256_cvtps_epi32(b));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_permute4x64_epi64(packed, 0xD8));
+  }
+  reference.floatToS16(dst + i, src + i, count - i);
+}
+
+TARGET_AVX2 void FloatToS32(int32_t* dst, const float* src, unsigned int count)
+{
+  const __m256 scale = _mm256_set1_ps(2147483648.0f);
+  const __m256 min = _mm256_set1_ps(-2147483648.0f);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m256 x = _mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale), min);
+    // the conversion gives INT32_MIN for anything too large, which flips to INT32_MAX
+    const __m256i overflow = _mm256_castps_si256(_mm256_cmp_ps(x, scale, _CMP_GE_OQ));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_xor_si256(_mm256_cvtps_epi32(x), overflow));
+  }
+  reference.floatToS32(dst + i, src + i, count - i);
+}
+
+TARGET_AVX2 void S16ToFloat(float* dst, const int16_t* src, unsigned int count)
+{
+  const __m256 scale = _mm256_set1_ps(1.0f / 32768.0f);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m256i x = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(x), scale));
+  }
+  reference.s16ToFloat(dst + i, src + i, count - i);
+}
+
+TARGET_AVX2 void S32ToFloat(float* dst, const int32_t* src, unsigned int count)
+{
+  const __m256 scale = _mm256_set1_ps(1.0f / 2147483648.0f);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(x), scale));
+  }
+  reference.s32ToFloat(dst + i, src + i, count - i);
+}
+
+TARGET_AVX2 void Interleave(float* dst, const float* const* src, unsigned int channels, unsigned int frames)
+{
+  if (channels != 2)
+  {
+    reference.interleave(dst, src, channels, frames);
+    return;
+  }
+
+  unsigned int i = 0;
+  for (; i + 8 <= frames; i += 8)
+  {
+    const __m256 left = _mm256_loadu_ps(src[0] + i);
+    const __m256 right = _mm256_loadu_ps(src[1] + i);
+    // per lane: lo = l0 r0 l1 r1 | l4 r4 l5 r5, hi = l2 r2 l3 r3 | l6 r6 l7 r7
+    const __m256 lo = _mm256_unpacklo_ps(left, right);
+    const __m256 hi = _mm256_unpackhi_ps(left, right);
+    _mm256_storeu_ps(dst + i * 2, _mm256_permute2f128_ps(lo, hi, 0x20));
+    _mm256_storeu_ps(dst + i * 2 + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+  }
+  const float* tail[] = {src[0] + i, src[1] + i};
+  reference.interleave(dst + i * 2, tail, 2, frames - i);
+}
+
+TARGET_AVX2 void Deinterleave(float* const* dst, const float* src, unsigned int channels, unsigned int frames)
+{
+  if (channels != 2)
+  {
+    reference.deinterleave(dst, src, channels, frames);
+    return;
+  }
+
+  unsigned int i = 0;
+  for (; i + 8 <= frames; i += 8)
+  {
+    const __m256 a = _mm256_loadu_ps(src + i * 2);
+    const __m256 b = _mm256_loadu_ps(src + i * 2 + 8);
+    // a0 a1 b0 b1 and a2 a3 b2 b3 in quarters, so that the shuffles pick frames in order
+    const __m256 lo = _mm256_permute2f128_ps(a, b, 0x20);
+    const __m256 hi = _mm256_permute2f128_ps(a, b, 0x31);
+    _mm256_storeu_ps(dst[0] + i, _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm256_storeu_ps(dst[1] + i, _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+  float* const tail[] = {dst[0] + i, dst[1] + i};
+  reference.deinterleave(tail, src + i * 2, 2, frames - i);
+}
+
+const CAEKernels::Kernels avx2Kernels = {
+  "AVX2",
+  Gain,
+  MixAdd,
+  SoftClip,
+  FloatToS16,
+  FloatToS32,
+  S16ToFloat,
+  S32ToFloat,
+  Interleave,
+  Deinterleave,
+};
+}
+
+const CAEKernels::Kernels* CAEKernels::GetAVX2()
+{
+  return &avx2Kernels;
+}
+
+#else
+
+const CAEKernels::Kernels* CAEKernels::GetAVX2()
+{
+  return nullptr;
+}
+
+#endif
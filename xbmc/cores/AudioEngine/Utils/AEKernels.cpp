@@ -0,0 +1,137 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AEKernels.h"
+
+#include "ServiceBroker.h"
+#include "utils/CPUInfo.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+void Gain(float* data, float gain, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+    data[i] *= gain;
+}
+
+float MixAdd(float* dst, const float* src, float gain, unsigned int count)
+{
+  float peak = 0.0f;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    dst[i] += src[i] * gain;
+    peak = std::max(peak, std::fabs(dst[i]));
+  }
+  return peak;
+}
+
+void SoftClip(float* data, unsigned int count)
+{
+  // a rational function approximating tanh, based on its pade approximation with tweaked
+  // coefficients, see http://www.musicdsp.org/showone.php?id=238. It reaches 1 at 3.
+  for (unsigned int i = 0; i < count; i++)
+  {
+    const float x = std::min(std::max(data[i], -3.0f), 3.0f);
+    const float y = x * x;
+    data[i] = x * (27.0f + y) / (27.0f + 9.0f * y);
+  }
+}
+
+void FloatToS16(int16_t* dst, const float* src, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+  {
+    const float sample = std::min(std::max(src[i] * 32768.0f, -32768.0f), 32767.0f);
+    dst[i] = static_cast<int16_t>(std::lrint(sample));
+  }
+}
+
+void FloatToS32(int32_t* dst, const float* src, unsigned int count)
+{
+  // INT32_MAX isn't a float, so it's the only value not rounded
+  for (unsigned int i = 0; i < count; i++)
+  {
+    const float sample = std::max(src[i] * 2147483648.0f, -2147483648.0f);
+    dst[i] = sample >= 2147483648.0f ? INT32_MAX : static_cast<int32_t>(std::lrint(sample));
+  }
+}
+
+void S16ToFloat(float* dst, const int16_t* src, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+    dst[i] = static_cast<float>(src[i]) * (1.0f / 32768.0f);
+}
+
+void S32ToFloat(float* dst, const int32_t* src, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+    dst[i] = static_cast<float>(src[i]) * (1.0f / 2147483648.0f);
+}
+
+void Interleave(float* dst, const float* const* src, unsigned int channels, unsigned int frames)
+{
+  for (unsigned int i = 0; i < frames; i++)
+  {
+    for (unsigned int j = 0; j < channels; j++)
+      *dst++ = src[j][i];
+  }
+}
+
+void Deinterleave(float* const* dst, const float* src, unsigned int channels, unsigned int frames)
+{
+  for (unsigned int i = 0; i < frames; i++)
+  {
+    for (unsigned int j = 0; j < channels; j++)
+      dst[j][i] = *src++;
+  }
+}
+
+const CAEKernels::Kernels referenceKernels = {
+  "reference",
+  Gain,
+  MixAdd,
+  SoftClip,
+  FloatToS16,
+  FloatToS32,
+  S16ToFloat,
+  S32ToFloat,
+  Interleave,
+  Deinterleave,
+};
+}
+
+const CAEKernels::Kernels& CAEKernels::Get()
+{
+  static const Kernels& kernels = []() -> const Kernels& {
+    const std::shared_ptr<CCPUInfo> cpuInfo = CServiceBroker::GetCPUInfo();
+    const Kernels& selected = Select(cpuInfo ? cpuInfo->GetCPUFeatures() : 0);
+    CLog::Log(LOGINFO, "CAEKernels::%s - using %s kernels", __FUNCTION__, selected.name);
+    return selected;
+  }();
+  return kernels;
+}
+
+const CAEKernels::Kernels& CAEKernels::Select(unsigned int cpuFeatures)
+{
+  if ((cpuFeatures & CPU_FEATURE_AVX2) && GetAVX2())
+    return *GetAVX2();
+  if ((cpuFeatures & CPU_FEATURE_SSE2) && GetSSE2())
+    return *GetSSE2();
+  if ((cpuFeatures & CPU_FEATURE_NEON) && GetNEON())
+    return *GetNEON();
+  return referenceKernels;
+}
+
+const CAEKernels::Kernels& CAEKernels::GetReference()
+{
+  return referenceKernels;
+}
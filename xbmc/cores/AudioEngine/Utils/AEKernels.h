@@ -0,0 +1,56 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*!
+ * \brief The sample kernels of the audio engine, picked at runtime for the instructions the CPU
+ * supports.
+ *
+ * All implementations give bit exact results of the reference (scalar) kernels, except for
+ * denormals which ARMv7 NEON flushes to zero. Buffers don't need to be aligned.
+ */
+class CAEKernels
+{
+public:
+  struct Kernels
+  {
+    const char* name;
+    //! data[i] *= gain
+    void (*gain)(float* data, float gain, unsigned int count);
+    //! dst[i] += src[i] * gain, returns the largest absolute value written to dst
+    float (*mixAdd)(float* dst, const float* src, float gain, unsigned int count);
+    //! tanh-like soft clipping of samples to [-1, 1]
+    void (*softClip)(float* data, unsigned int count);
+    //! float to S16 and S32, rounding to nearest and saturating
+    void (*floatToS16)(int16_t* dst, const float* src, unsigned int count);
+    void (*floatToS32)(int32_t* dst, const float* src, unsigned int count);
+    void (*s16ToFloat)(float* dst, const int16_t* src, unsigned int count);
+    void (*s32ToFloat)(float* dst, const int32_t* src, unsigned int count);
+    //! planes of frames samples each to channels interleaved samples per frame, and back
+    void (*interleave)(float* dst, const float* const* src, unsigned int channels, unsigned int frames);
+    void (*deinterleave)(float* const* dst, const float* src, unsigned int channels, unsigned int frames);
+  };
+
+  /*!
+   * \brief The kernels for this CPU. Picked on the first call, which has to happen after the CPU
+   * info is registered with the service broker.
+   */
+  static const Kernels& Get();
+
+  /*! \brief The best kernels for the given CPU_FEATURE_* flags. */
+  static const Kernels& Select(unsigned int cpuFeatures);
+
+  static const Kernels& GetReference();
+  //! the kernels using these instructions, nullptr if they aren't built for this architecture
+  static const Kernels* GetSSE2();
+  static const Kernels* GetAVX2();
+  static const Kernels* GetNEON();
+};
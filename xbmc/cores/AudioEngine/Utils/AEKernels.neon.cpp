@@ -0,0 +1,198 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AEKernels.h"
+
+#if defined(HAS_NEON) || defined(__aarch64__)
+
+#include <arm_neon.h>
+
+namespace
+{
+const CAEKernels::Kernels& reference = CAEKernels::GetReference();
+
+float MaxAcross(float32x4_t v)
+{
+#if defined(__aarch64__)
+  return vmaxvq_f32(v);
+#else
+  float32x2_t max = vpmax_f32(vget_low_f32(v), vget_high_f32(v));
+  max = vpmax_f32(max, max);
+  return vget_lane_f32(max, 0);
+#endif
+}
+
+// rounds to nearest even like lrint, ARMv7 only has a conversion that truncates
+int32x4_t RoundToInt(float32x4_t v)
+{
+#if defined(__aarch64__)
+  return vcvtnq_s32_f32(v);
+#else
+  // adding 1.5 * 2^23 leaves no fraction bits. Larger values are whole numbers already.
+  const float32x4_t magic = vdupq_n_f32(12582912.0f);
+  const float32x4_t rounded = vsubq_f32(vaddq_f32(v, magic), magic);
+  const uint32x4_t small = vcltq_f32(vabsq_f32(v), vdupq_n_f32(4194304.0f));
+  return vcvtq_s32_f32(vbslq_f32(small, rounded, v));
+#endif
+}
+
+void Gain(float* data, float gain, unsigned int count)
+{
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vmulq_n_f32(vld1q_f32(data + i), gain));
+  reference.gain(data + i, gain, count - i);
+}
+
+float MixAdd(float* dst, const float* src, float gain, unsigned int count)
+{
+  float32x4_t peak = vdupq_n_f32(0.0f);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    // multiply and add separately, a fused multiply-add would round differently
+    const float32x4_t d = vaddq_f32(vld1q_f32(dst + i), vmulq_n_f32(vld1q_f32(src + i), gain));
+    vst1q_f32(dst + i, d);
+    peak = vmaxq_f32(peak, vabsq_f32(d));
+  }
+  const float tail = reference.mixAdd(dst + i, src + i, gain, count - i);
+  const float result = MaxAcross(peak);
+  return tail > result ? tail : result;
+}
+
+void SoftClip(float* data, unsigned int count)
+{
+  unsigned int i = 0;
+#if defined(__aarch64__)
+  // ARMv7 has no division, only estimates which aren't exact
+  const float32x4_t min = vdupq_n_f32(-3.0f);
+  const float32x4_t max = vdupq_n_f32(3.0f);
+  const float32x4_t c27 = vdupq_n_f32(27.0f);
+  for (; i + 4 <= count; i += 4)
+  {
+    const float32x4_t x = vminq_f32(vmaxq_f32(vld1q_f32(data + i), min), max);
+    const float32x4_t y = vmulq_f32(x, x);
+    vst1q_f32(data + i, vdivq_f32(vmulq_f32(x, vaddq_f32(c27, y)), vaddq_f32(c27, vmulq_n_f32(y, 9.0f))));
+  }
+#endif
+  reference.softClip(data + i, count - i);
+}
+
+void FloatToS16(int16_t* dst, const float* src, unsigned int count)
+{
+  const float32x4_t min = vdupq_n_f32(-32768.0f);
+  const float32x4_t max = vdupq_n_f32(32767.0f);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const float32x4_t a = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(src + i), 32768.0f), min), max);
+    const float32x4_t b = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(src + i + 4), 32768.0f), min), max);
+    vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(RoundToInt(a)), vqmovn_s32(RoundToInt(b))));
+  }
+  reference.floatToS16(dst + i, src + i, count - i);
+}
+
+void FloatToS32(int32_t* dst, const float* src, unsigned int count)
+{
+  // the conversion saturates, so values too large give INT32_MAX as wanted
+  const float32x4_t min = vdupq_n_f32(-2147483648.0f);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    const float32x4_t x = vmaxq_f32(vmulq_n_f32(vld1q_f32(src + i), 2147483648.0f), min);
+    vst1q_s32(dst + i, RoundToInt(x));
+  }
+  reference.floatToS32(dst + i, src + i, count - i);
+}
+
+void S16ToFloat(float* dst, const int16_t* src, unsigned int count)
+{
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const int16x8_t x = vld1q_s16(src + i);
+    vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(x))), 1.0f / 32768.0f));
+    vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(x))), 1.0f / 32768.0f));
+  }
+  reference.s16ToFloat(dst + i, src + i, count - i);
+}
+
+void S32ToFloat(float* dst, const int32_t* src, unsigned int count)
+{
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(src + i)), 1.0f / 2147483648.0f));
+  reference.s32ToFloat(dst + i, src + i, count - i);
+}
+
+void Interleave(float* dst, const float* const* src, unsigned int channels, unsigned int frames)
+{
+  if (channels != 2)
+  {
+    reference.interleave(dst, src, channels, frames);
+    return;
+  }
+
+  unsigned int i = 0;
+  for (; i + 4 <= frames; i += 4)
+  {
+    float32x4x2_t frame;
+    frame.val[0] = vld1q_f32(src[0] + i);
+    frame.val[1] = vld1q_f32(src[1] + i);
+    vst2q_f32(dst + i * 2, frame);
+  }
+  const float* tail[] = {src[0] + i, src[1] + i};
+  reference.interleave(dst + i * 2, tail, 2, frames - i);
+}
+
+void Deinterleave(float* const* dst, const float* src, unsigned int channels, unsigned int frames)
+{
+  if (channels != 2)
+  {
+    reference.deinterleave(dst, src, channels, frames);
+    return;
+  }
+
+  unsigned int i = 0;
+  for (; i + 4 <= frames; i += 4)
+  {
+    const float32x4x2_t frame = vld2q_f32(src + i * 2);
+    vst1q_f32(dst[0] + i, frame.val[0]);
+    vst1q_f32(dst[1] + i, frame.val[1]);
+  }
+  float* const tail[] = {dst[0] + i, dst[1] + i};
+  reference.deinterleave(tail, src + i * 2, 2, frames - i);
+}
+
+const CAEKernels::Kernels neonKernels = {
+  "NEON",
+  Gain,
+  MixAdd,
+  SoftClip,
+  FloatToS16,
+  FloatToS32,
+  S16ToFloat,
+  S32ToFloat,
+  Interleave,
+  Deinterleave,
+};
+}
+
+const CAEKernels::Kernels* CAEKernels::GetNEON()
+{
+  return &neonKernels;
+}
+
+#else
+
+const CAEKernels::Kernels* CAEKernels::GetNEON()
+{
+  return nullptr;
+}
+
+#endif
@@ -0,0 +1,193 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AEKernels.h"
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+
+#include <emmintrin.h>
+
+// builds without -msse2 still get these, they are only used if the CPU has SSE2
+#if defined(__GNUC__) && !defined(__SSE2__)
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#else
+#define TARGET_SSE2
+#endif
+
+namespace
+{
+const CAEKernels::Kernels& reference = CAEKernels::GetReference();
+
+TARGET_SSE2 void Gain(float* data, float gain, unsigned int count)
+{
+  const __m128 g = _mm_set1_ps(gain);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), g));
+  reference.gain(data + i, gain, count - i);
+}
+
+TARGET_SSE2 float MixAdd(float* dst, const float* src, float gain, unsigned int count)
+{
+  const __m128 g = _mm_set1_ps(gain);
+  const __m128 sign = _mm_set1_ps(-0.0f);
+  __m128 peak = _mm_setzero_ps();
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    const __m128 d = _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), g));
+    _mm_storeu_ps(dst + i, d);
+    peak = _mm_max_ps(peak, _mm_andnot_ps(sign, d));
+  }
+  peak = _mm_max_ps(peak, _mm_movehl_ps(peak, peak));
+  peak = _mm_max_ss(peak, _mm_shuffle_ps(peak, peak, _MM_SHUFFLE(1, 1, 1, 1)));
+  const float tail = reference.mixAdd(dst + i, src + i, gain, count - i);
+  const float result = _mm_cvtss_f32(peak);
+  return tail > result ? tail : result;
+}
+
+TARGET_SSE2 void SoftClip(float* data, unsigned int count)
+{
+  const __m128 min = _mm_set1_ps(-3.0f);
+  const __m128 max = _mm_set1_ps(3.0f);
+  const __m128 c27 = _mm_set1_ps(27.0f);
+  const __m128 c9 = _mm_set1_ps(9.0f);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    const __m128 x = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(data + i), min), max);
+    const __m128 y = _mm_mul_ps(x, x);
+    _mm_storeu_ps(data + i, _mm_div_ps(_mm_mul_ps(x, _mm_add_ps(c27, y)), _mm_add_ps(c27, _mm_mul_ps(c9, y))));
+  }
+  reference.softClip(data + i, count - i);
+}
+
+TARGET_SSE2 void FloatToS16(int16_t* dst, const float* src, unsigned int count)
+{
+  const __m128 scale = _mm_set1_ps(32768.0f);
+  const __m128 min = _mm_set1_ps(-32768.0f);
+  const __m128 max = _mm_set1_ps(32767.0f);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m128 a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i), scale), min), max);
+    const __m128 b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 4), scale), min), max);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+  }
+  reference.floatToS16(dst + i, src + i, count - i);
+}
+
+TARGET_SSE2 void FloatToS32(int32_t* dst, const float* src, unsigned int count)
+{
+  const __m128 scale = _mm_set1_ps(2147483648.0f);
+  const __m128 min = _mm_set1_ps(-2147483648.0f);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    const __m128 x = _mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i), scale), min);
+    // the conversion gives INT32_MIN for anything too large, which flips to INT32_MAX
+    const __m128i overflow = _mm_castps_si128(_mm_cmpge_ps(x, scale));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_xor_si128(_mm_cvtps_epi32(x), overflow));
+  }
+  reference.floatToS32(dst + i, src + i, count - i);
+}
+
+TARGET_SSE2 void S16ToFloat(float* dst, const int16_t* src, unsigned int count)
+{
+  const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i a = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+    const __m128i b = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(a), scale));
+    _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(b), scale));
+  }
+  reference.s16ToFloat(dst + i, src + i, count - i);
+}
+
+TARGET_SSE2 void S32ToFloat(float* dst, const int32_t* src, unsigned int count)
+{
+  const __m128 scale = _mm_set1_ps(1.0f / 2147483648.0f);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(x), scale));
+  }
+  reference.s32ToFloat(dst + i, src + i, count - i);
+}
+
+TARGET_SSE2 void Interleave(float* dst, const float* const* src, unsigned int channels, unsigned int frames)
+{
+  if (channels != 2)
+  {
+    reference.interleave(dst, src, channels, frames);
+    return;
+  }
+
+  unsigned int i = 0;
+  for (; i + 4 <= frames; i += 4)
+  {
+    const __m128 left = _mm_loadu_ps(src[0] + i);
+    const __m128 right = _mm_loadu_ps(src[1] + i);
+    _mm_storeu_ps(dst + i * 2, _mm_unpacklo_ps(left, right));
+    _mm_storeu_ps(dst + i * 2 + 4, _mm_unpackhi_ps(left, right));
+  }
+  const float* tail[] = {src[0] + i, src[1] + i};
+  reference.interleave(dst + i * 2, tail, 2, frames - i);
+}
+
+TARGET_SSE2 void Deinterleave(float* const* dst, const float* src, unsigned int channels, unsigned int frames)
+{
+  if (channels != 2)
+  {
+    reference.deinterleave(dst, src, channels, frames);
+    return;
+  }
+
+  unsigned int i = 0;
+  for (; i + 4 <= frames; i += 4)
+  {
+    const __m128 a = _mm_loadu_ps(src + i * 2);
+    const __m128 b = _mm_loadu_ps(src + i * 2 + 4);
+    _mm_storeu_ps(dst[0] + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(dst[1] + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+  float* const tail[] = {dst[0] + i, dst[1] + i};
+  reference.deinterleave(tail, src + i * 2, 2, frames - i);
+}
+
+const CAEKernels::Kernels sse2Kernels = {
+  "SSE2",
+  Gain,
+  MixAdd,
+  SoftClip,
+  FloatToS16,
+  FloatToS32,
+  S16ToFloat,
+  S32ToFloat,
+  Interleave,
+  Deinterleave,
+};
+}
+
+const CAEKernels::Kernels* CAEKernels::GetSSE2()
+{
+  return &sse2Kernels;
+}
+
+#else
+
+const CAEKernels::Kernels* CAEKernels::GetSSE2()
+{
+  return nullptr;
+}
+
+#endif
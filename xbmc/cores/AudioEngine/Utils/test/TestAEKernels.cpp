@@ -0,0 +1,231 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Utils/AEKernels.h"
+#include "utils/CPUInfo.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// the kernels this CPU can run, besides the reference
+std::vector<const CAEKernels::Kernels*> GetAvailable()
+{
+  const unsigned int features = CCPUInfo::GetCPUInfo()->GetCPUFeatures();
+  std::vector<const CAEKernels::Kernels*> available;
+  if (CAEKernels::GetSSE2() && (features & CPU_FEATURE_SSE2))
+    available.push_back(CAEKernels::GetSSE2());
+  if (CAEKernels::GetAVX2() && (features & CPU_FEATURE_AVX2))
+    available.push_back(CAEKernels::GetAVX2());
+  if (CAEKernels::GetNEON() && (features & CPU_FEATURE_NEON))
+    available.push_back(CAEKernels::GetNEON());
+  return available;
+}
+
+// samples mostly in range, with some clipping, large values and ties of the integer conversions
+std::vector<float> CreateSamples(unsigned int count, unsigned int seed)
+{
+  static const float special[] = {0.0f, -0.0f, 1.0f, -1.0f, 0.5f / 32768.0f, 1.5f / 32768.0f,
+                                  -2.5f / 32768.0f, 32767.5f / 32768.0f, 2.0f, -2.0f, 3.5f, -3.5f,
+                                  1e10f, -1e10f, 0.999999f, -0.999999f};
+  std::vector<float> samples(count);
+  for (unsigned int i = 0; i < count; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    if ((seed >> 28) == 0)
+      samples[i] = special[(seed >> 16) % (sizeof(special) / sizeof(special[0]))];
+    else
+      samples[i] = static_cast<float>(static_cast<int>((seed >> 8) & 0xffff) - 0x8000) / 16384.0f;
+  }
+  return samples;
+}
+
+// sizes around the vector widths, and starting one sample in so buffers aren't aligned
+const unsigned int sizes[] = {0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 1024, 4099};
+
+template<class T>
+void ExpectBitExact(const std::vector<T>& expected, const std::vector<T>& actual, const char* kernels, const char* kernel, unsigned int count)
+{
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); i++)
+    ASSERT_EQ(0, memcmp(&expected[i], &actual[i], sizeof(T)))
+        << kernels << " " << kernel << " count " << count << " at " << i << ": " << expected[i]
+        << " != " << actual[i];
+}
+}
+
+TEST(TestAEKernels, Select)
+{
+  EXPECT_STREQ(CAEKernels::GetReference().name, CAEKernels::Select(0).name);
+  const CAEKernels::Kernels& selected = CAEKernels::Select(CCPUInfo::GetCPUInfo()->GetCPUFeatures());
+  if (!GetAvailable().empty())
+  {
+    EXPECT_STRNE(CAEKernels::GetReference().name, selected.name);
+  }
+}
+
+TEST(TestAEKernels, Float)
+{
+  const CAEKernels::Kernels& reference = CAEKernels::GetReference();
+  for (const CAEKernels::Kernels* kernels : GetAvailable())
+  {
+    for (unsigned int count : sizes)
+    {
+      const std::vector<float> src = CreateSamples(count + 1, count);
+      const std::vector<float> dst = CreateSamples(count + 1, count + 1);
+
+      std::vector<float> expected(dst), actual(dst);
+      reference.gain(expected.data() + 1, 0.7f, count);
+      kernels->gain(actual.data() + 1, 0.7f, count);
+      ExpectBitExact(expected, actual, kernels->name, "gain", count);
+
+      expected = dst;
+      actual = dst;
+      const float expectedPeak = reference.mixAdd(expected.data() + 1, src.data() + 1, 0.3f, count);
+      const float actualPeak = kernels->mixAdd(actual.data() + 1, src.data() + 1, 0.3f, count);
+      ExpectBitExact(expected, actual, kernels->name, "mixAdd", count);
+      EXPECT_EQ(expectedPeak, actualPeak) << kernels->name << " mixAdd count " << count;
+
+      expected = dst;
+      actual = dst;
+      reference.softClip(expected.data() + 1, count);
+      kernels->softClip(actual.data() + 1, count);
+      ExpectBitExact(expected, actual, kernels->name, "softClip", count);
+      for (unsigned int i = 1; i <= count; i++)
+        ASSERT_LE(std::abs(actual[i]), 1.0f) << kernels->name << " softClip " << dst[i];
+    }
+  }
+}
+
+TEST(TestAEKernels, Convert)
+{
+  const CAEKernels::Kernels& reference = CAEKernels::GetReference();
+  for (const CAEKernels::Kernels* kernels : GetAvailable())
+  {
+    for (unsigned int count : sizes)
+    {
+      const std::vector<float> samples = CreateSamples(count + 1, count);
+
+      std::vector<int16_t> expectedS16(count + 1), actualS16(count + 1);
+      reference.floatToS16(expectedS16.data() + 1, samples.data() + 1, count);
+      kernels->floatToS16(actualS16.data() + 1, samples.data() + 1, count);
+      ExpectBitExact(expectedS16, actualS16, kernels->name, "floatToS16", count);
+
+      std::vector<int32_t> expectedS32(count + 1), actualS32(count + 1);
+      reference.floatToS32(expectedS32.data() + 1, samples.data() + 1, count);
+      kernels->floatToS32(actualS32.data() + 1, samples.data() + 1, count);
+      ExpectBitExact(expectedS32, actualS32, kernels->name, "floatToS32", count);
+
+      std::vector<float> expected(count + 1), actual(count + 1);
+      reference.s16ToFloat(expected.data() + 1, expectedS16.data() + 1, count);
+      kernels->s16ToFloat(actual.data() + 1, expectedS16.data() + 1, count);
+      ExpectBitExact(expected, actual, kernels->name, "s16ToFloat", count);
+
+      // every bit is used by S32, which converts to float with rounding
+      for (unsigned int i = 1; i <= count; i++)
+        expectedS32[i] = static_cast<int32_t>(i * 2654435761u);
+      reference.s32ToFloat(expected.data() + 1, expectedS32.data() + 1, count);
+      kernels->s32ToFloat(actual.data() + 1, expectedS32.data() + 1, count);
+      ExpectBitExact(expected, actual, kernels->name, "s32ToFloat", count);
+    }
+
+    // the ends of the ranges
+    const float limits[] = {1.0f, -1.0f, 1.1f, -1.1f, 32767.0f / 32768.0f, -32767.5f / 32768.0f,
+                            0.99999994f, -0.99999994f, 1e30f, -1e30f, 0.0f, 0.0f, 0.0f, 0.0f,
+                            0.0f, 0.0f};
+    std::vector<int16_t> s16(16);
+    std::vector<int32_t> s32(16);
+    kernels->floatToS16(s16.data(), limits, 16);
+    kernels->floatToS32(s32.data(), limits, 16);
+    EXPECT_EQ(32767, s16[0]) << kernels->name;
+    EXPECT_EQ(-32768, s16[1]) << kernels->name;
+    EXPECT_EQ(32767, s16[2]) << kernels->name;
+    EXPECT_EQ(-32768, s16[3]) << kernels->name;
+    EXPECT_EQ(INT32_MAX, s32[0]) << kernels->name;
+    EXPECT_EQ(INT32_MIN, s32[1]) << kernels->name;
+    EXPECT_EQ(INT32_MAX, s32[8]) << kernels->name;
+    EXPECT_EQ(INT32_MIN, s32[9]) << kernels->name;
+  }
+}
+
+TEST(TestAEKernels, Interleave)
+{
+  const CAEKernels::Kernels& reference = CAEKernels::GetReference();
+  for (const CAEKernels::Kernels* kernels : GetAvailable())
+  {
+    for (unsigned int channels : {1u, 2u, 6u})
+    {
+      for (unsigned int frames : sizes)
+      {
+        std::vector<std::vector<float>> planes;
+        std::vector<const float*> src;
+        for (unsigned int j = 0; j < channels; j++)
+        {
+          planes.push_back(CreateSamples(frames + 1, frames * 8 + j));
+          src.push_back(planes.back().data() + 1);
+        }
+
+        std::vector<float> expected(frames * channels + 1), actual(frames * channels + 1);
+        reference.interleave(expected.data() + 1, src.data(), channels, frames);
+        kernels->interleave(actual.data() + 1, src.data(), channels, frames);
+        ExpectBitExact(expected, actual, kernels->name, "interleave", frames);
+
+        std::vector<std::vector<float>> result(channels, std::vector<float>(frames + 1));
+        std::vector<float*> dst;
+        for (unsigned int j = 0; j < channels; j++)
+          dst.push_back(result[j].data() + 1);
+        kernels->deinterleave(dst.data(), actual.data() + 1, channels, frames);
+        for (unsigned int j = 0; j < channels; j++)
+        {
+          result[j][0] = planes[j][0];
+          ExpectBitExact(planes[j], result[j], kernels->name, "deinterleave", frames);
+        }
+      }
+    }
+  }
+}
+
+TEST(TestAEKernels, Throughput)
+{
+  // a mix of 20 ms at 48 kHz 7.1, the size the engine works with
+  const unsigned int count = 960 * 8;
+  const int runs = 2000;
+  const std::vector<float> src = CreateSamples(count, 1);
+  std::vector<float> dst(count);
+  std::vector<int16_t> s16(count);
+
+  std::vector<const CAEKernels::Kernels*> all = GetAvailable();
+  all.insert(all.begin(), &CAEKernels::GetReference());
+  for (const CAEKernels::Kernels* kernels : all)
+  {
+    float peak = 0.0f;
+    auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < runs; run++)
+    {
+      std::fill(dst.begin(), dst.end(), 0.0f);
+      peak += kernels->mixAdd(dst.data(), src.data(), 0.5f, count);
+    }
+    const std::chrono::duration<double> mix = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int run = 0; run < runs; run++)
+      kernels->floatToS16(s16.data(), src.data(), count);
+    const std::chrono::duration<double> convert = std::chrono::steady_clock::now() - start;
+    EXPECT_GT(peak, 0.0f);
+
+    std::cout << kernels->name << ": mixAdd " << count * runs / mix.count() / 1e6
+              << " Msamples/s, floatToS16 " << count * runs / convert.count() / 1e6 << " Msamples/s\n";
+  }
+}
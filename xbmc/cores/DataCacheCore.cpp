@@ -187,6 +187,34 @@ float CDataCacheCore::GetVideoDAR()
   return m_playerVideoInfo.dar;
 }
 
+void CDataCacheCore::SetVideoDecoderThreading(std::string threading)
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  m_playerVideoInfo.decoderThreading = threading;
+}
+
+std::string CDataCacheCore::GetVideoDecoderThreading()
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  return m_playerVideoInfo.decoderThreading;
+}
+
+void CDataCacheCore::SetVideoDecodeTime(float ms)
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  m_playerVideoInfo.decodeTime = ms;
+}
+
+float CDataCacheCore::GetVideoDecodeTime()
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  return m_playerVideoInfo.decodeTime;
+}
+
 // player audio info
 void CDataCacheCore::SetAudioDecoderName(std::string name)
 {
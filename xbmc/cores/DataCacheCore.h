@@ -48,6 +48,10 @@ public:
   float GetVideoFps();
   void SetVideoDAR(float dar);
   float GetVideoDAR();
+  void SetVideoDecoderThreading(std::string threading);
+  std::string GetVideoDecoderThreading();
+  void SetVideoDecodeTime(float ms);
+  float GetVideoDecodeTime();
 
   // player audio info
   void SetAudioDecoderName(std::string name);
@@ -141,6 +145,8 @@ protected:
     int height;
     float fps;
     float dar;
+    std::string decoderThreading;
+    float decodeTime;
   } m_playerVideoInfo;
 
   CCriticalSection m_audioPlayerSection;
@@ -21,6 +21,8 @@
 #include "utils/log.h"
 #include "cores/VideoPlayer/VideoRenderers/RenderManager.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include <algorithm>
 #include <memory>
 
 extern "C" {
@@ -30,6 +32,7 @@ extern "C" {
 #include <libavfilter/buffersink.h>
 #include <libavfilter/buffersrc.h>
 #include <libavutil/pixdesc.h>
+#include <libavutil/imgutils.h>
 }
 
 #ifndef TARGET_POSIX
@@ -300,6 +303,83 @@ enum AVPixelFormat CDVDVideoCodecFFmpeg::GetFormat(struct AVCodecContext * avctx
   return avcodec_default_get_format(avctx, fmt);
 }
 
+int CDVDVideoCodecFFmpeg::FFGetBuffer(AVCodecContext* avctx, AVFrame* frame, int flags)
+{
+  ICallbackHWAccel* cb = static_cast<ICallbackHWAccel*>(avctx->opaque);
+  CDVDVideoCodecFFmpeg* ctx = dynamic_cast<CDVDVideoCodecFFmpeg*>(cb);
+
+  // decode straight into buffers of the renderer if it offers them, the planes have to be
+  // laid out the way it uploads them
+  std::shared_ptr<IVideoBufferPool> pool = ctx->m_processInfo.GetRenderBufferPool();
+  const AVPixelFormat format = static_cast<AVPixelFormat>(frame->format);
+  if (!pool || !(avctx->codec->capabilities & AV_CODEC_CAP_DR1) ||
+      (format != AV_PIX_FMT_YUV420P && format != AV_PIX_FMT_YUVJ420P &&
+       format != AV_PIX_FMT_YUV420P9 && format != AV_PIX_FMT_YUV420P10 &&
+       format != AV_PIX_FMT_YUV420P12 && format != AV_PIX_FMT_YUV420P14 &&
+       format != AV_PIX_FMT_YUV420P16))
+    return avcodec_default_get_buffer2(avctx, frame, flags);
+
+  int width = frame->width;
+  int height = frame->height;
+  int strideAlign[AV_NUM_DATA_POINTERS];
+  int linesizes[4];
+  avcodec_align_dimensions2(avctx, &width, &height, strideAlign);
+
+  // NOTE: do not align linesizes individually, see avcodec_default_get_buffer2
+  int unaligned;
+  do
+  {
+    if (av_image_fill_linesizes(linesizes, format, width) < 0)
+      return avcodec_default_get_buffer2(avctx, frame, flags);
+    width += width & ~(width - 1);
+
+    unaligned = 0;
+    for (int i = 0; i < 4; i++)
+      unaligned |= linesizes[i] % strideAlign[i];
+  } while (unaligned);
+
+  // planes start at 64 bytes and keep the padding ffmpeg's own pool has
+  const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(format);
+  int offsets[YuvImage::MAX_PLANES];
+  int size = 0;
+  for (int i = 0; i < YuvImage::MAX_PLANES; i++)
+  {
+    const int planeHeight = i ? AV_CEIL_RSHIFT(height, desc->log2_chroma_h) : height;
+    offsets[i] = size;
+    size += FFALIGN(linesizes[i] * planeHeight + 16 + 64 - 1, 64);
+  }
+
+  if (!pool->IsCompatible(format, size))
+    pool->Configure(format, size);
+
+  CVideoBuffer* buffer = pool->Get();
+  if (!buffer)
+    return avcodec_default_get_buffer2(avctx, frame, flags);
+
+  uint8_t* data = buffer->GetMemPtr();
+  AVBufferRef* buf = av_buffer_create(data, size, FFReleaseBuffer, buffer, 0);
+  if (!buf)
+  {
+    buffer->Release();
+    return AVERROR(ENOMEM);
+  }
+
+  for (int i = 0; i < AV_NUM_DATA_POINTERS; i++)
+  {
+    frame->data[i] = i < YuvImage::MAX_PLANES ? data + offsets[i] : nullptr;
+    frame->linesize[i] = i < YuvImage::MAX_PLANES ? linesizes[i] : 0;
+    frame->buf[i] = i == 0 ? buf : nullptr;
+  }
+  frame->extended_data = frame->data;
+
+  return 0;
+}
+
+void CDVDVideoCodecFFmpeg::FFReleaseBuffer(void* opaque, uint8_t* data)
+{
+  static_cast<CVideoBuffer*>(opaque)->Release();
+}
+
 CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg(CProcessInfo &processInfo)
 : CDVDVideoCodec(processInfo), m_postProc(processInfo)
 {
@@ -364,16 +444,36 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     }
     else
     {
-      int num_threads = CServiceBroker::GetCPUInfo()->GetCPUCount() * 3 / 2;
-      num_threads = std::max(1, std::min(num_threads, 16));
-      m_pCodecContext->thread_count = num_threads;
+      CDVDVideoCodecFFmpegThreading::StreamInfo info;
+      info.codec = hints.codec;
+      info.profile = hints.profile;
+      info.width = hints.width;
+      info.height = hints.height;
+      info.frameThreads = (pCodec->capabilities & AV_CODEC_CAP_FRAME_THREADS) != 0;
+      info.sliceThreads = (pCodec->capabilities & AV_CODEC_CAP_SLICE_THREADS) != 0;
+
+      // keep the threading chosen while playing when the context is opened again
+      const CDVDVideoCodecFFmpegThreading::StreamInfo& current = m_threading.GetStreamInfo();
+      if (!m_threading.IsInitialized() || current.codec != info.codec ||
+          current.width != info.width || current.height != info.height)
+        m_threading.Init(info, CServiceBroker::GetCPUInfo()->GetCPUCount());
+
+      if (m_threading.GetThreadType())
+        m_pCodecContext->thread_type = m_threading.GetThreadType();
+      m_pCodecContext->thread_count = m_threading.GetThreadCount();
       m_pCodecContext->thread_safe_callbacks = 1;
+      m_pCodecContext->get_buffer2 = FFGetBuffer;
       m_decoderState = STATE_SW_MULTI;
-      CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - open frame threaded with %d threads", num_threads);
+      m_processInfo.SetVideoDecoderThreading(m_threading.GetDescription());
+      CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - open %s threaded",
+                m_threading.GetDescription().c_str());
     }
   }
   else
+  {
+    m_pCodecContext->get_buffer2 = FFGetBuffer;
     m_decoderState = STATE_SW_SINGLE;
+  }
 
   // if we don't do this, then some codecs seem to fail.
   m_pCodecContext->coded_height = hints.height;
@@ -451,6 +551,8 @@ void CDVDVideoCodecFFmpeg::Dispose()
   SAFE_RELEASE(m_pHardware);
 
   FilterClose();
+  ClearPackets(m_retunePackets);
+  ClearPackets(m_replayPackets);
 }
 
 void CDVDVideoCodecFFmpeg::SetFilters()
@@ -542,14 +644,19 @@ bool CDVDVideoCodecFFmpeg::AddData(const DemuxPacket &packet)
   if (!m_pCodecContext)
     return true;
 
+  // packets to decode again after a change of threading come before anything else, an empty
+  // packet doesn't make them obsolete
   if (!packet.pData)
-    return true;
+    return SendReplayPackets();
 
   if (m_eof)
   {
     Reset();
   }
 
+  if (!SendReplayPackets())
+    return false;
+
   if (packet.recoveryPoint)
     m_started = true;
 
@@ -565,7 +672,9 @@ bool CDVDVideoCodecFFmpeg::AddData(const DemuxPacket &packet)
   avpkt.side_data = static_cast<AVPacketSideData*>(packet.pSideData);
   avpkt.side_data_elems = packet.iSideDataElems;
 
+  int64_t start = CurrentHostCounter();
   int ret = avcodec_send_packet(m_pCodecContext, &avpkt);
+  m_decodeTicks += CurrentHostCounter() - start;
 
   // try again
   if (ret == AVERROR(EAGAIN))
@@ -586,6 +695,26 @@ bool CDVDVideoCodecFFmpeg::AddData(const DemuxPacket &packet)
     }
   }
 
+  // keep the packets a new context has to decode again from the keyframe at which threading
+  // changes. the keyframe comes out at most a frame per thread and the reorder delay later.
+  if (m_decoderState == STATE_SW_MULTI && m_threading.HasChange())
+  {
+    RetunePacket copy;
+    copy.packet = av_packet_alloc();
+    copy.reorderedOpaque = m_pCodecContext->reordered_opaque;
+    if (copy.packet && av_packet_ref(copy.packet, &avpkt) == 0)
+      m_retunePackets.push_back(copy);
+    else
+      av_packet_free(&copy.packet);
+
+    const size_t maxPackets = 2 * CDVDVideoCodecFFmpegThreading::MAX_THREADS + 16;
+    while (m_retunePackets.size() > maxPackets)
+    {
+      av_packet_free(&m_retunePackets.front().packet);
+      m_retunePackets.pop_front();
+    }
+  }
+
   m_iLastKeyframe++;
   // put a limit on convergence count to avoid huge mem usage on streams without keyframes
   if (m_iLastKeyframe > 300)
@@ -598,7 +727,11 @@ bool CDVDVideoCodecFFmpeg::AddData(const DemuxPacket &packet)
 
 CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPicture)
 {
-  if (!m_startedInput)
+  if (!m_pCodecContext)
+  {
+    return VC_ERROR;
+  }
+  else if (!m_startedInput)
   {
     return VC_BUFFER;
   }
@@ -641,8 +774,9 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
       return ret;
   }
 
-  // process ffmpeg
-  if (m_codecControlFlags & DVD_CODEC_CTRL_DRAIN)
+  // process ffmpeg, the packets to decode again after a change of threading go before the end of
+  // the stream. if the decoder doesn't take them all yet, its frames are received first.
+  if ((m_codecControlFlags & DVD_CODEC_CTRL_DRAIN) && SendReplayPackets())
   {
     AVPacket avpkt;
     av_init_packet(&avpkt);
@@ -653,7 +787,9 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
     avcodec_send_packet(m_pCodecContext, &avpkt);
   }
 
+  int64_t start = CurrentHostCounter();
   int ret = avcodec_receive_frame(m_pCodecContext, m_pDecodedFrame);
+  m_decodeTicks += CurrentHostCounter() - start;
 
   if (m_decoderState == STATE_HW_FAILED && !m_pHardware)
     return VC_REOPEN;
@@ -721,6 +857,24 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
   // here we got a frame
   int64_t framePTS = m_pDecodedFrame->best_effort_timestamp;
 
+  // after a change of threading, the frames before the keyframe came out of the old context.
+  // more frames may be ready, VC_BUFFER would end a drain.
+  if (m_retuneSkipPts != AV_NOPTS_VALUE)
+  {
+    if (framePTS != AV_NOPTS_VALUE && framePTS < m_retuneSkipPts)
+    {
+      av_frame_unref(m_pDecodedFrame);
+      return VC_NONE;
+    }
+    m_retuneSkipPts = AV_NOPTS_VALUE;
+  }
+
+  if (m_decoderState == STATE_SW_MULTI && m_pDecodedFrame->key_frame && m_threading.HasChange() &&
+      ApplyThreading(framePTS))
+  {
+    return m_pCodecContext ? VC_NONE : VC_ERROR;
+  }
+
   if (m_pCodecContext->skip_frame > AVDISCARD_DEFAULT)
   {
     if (m_dropCtrl.m_state == CDropControl::VALID &&
@@ -793,6 +947,9 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
   // process filters for sw decoding
   else
   {
+    if (m_decoderState == STATE_SW_MULTI)
+      UpdateThreading();
+
     SetFilters();
 
     bool need_scale = std::find(m_formats.begin(),
@@ -887,6 +1044,12 @@ void CDVDVideoCodecFFmpeg::Reset()
   m_filters = "";
   FilterClose();
   m_dropCtrl.Reset(false);
+
+  ClearPackets(m_retunePackets);
+  ClearPackets(m_replayPackets);
+  m_retuneSkipPts = AV_NOPTS_VALUE;
+  m_decodeTicks = 0;
+  m_threading.ResetMeasurement();
 }
 
 void CDVDVideoCodecFFmpeg::Reopen()
@@ -898,6 +1061,96 @@ void CDVDVideoCodecFFmpeg::Reopen()
   }
 }
 
+void CDVDVideoCodecFFmpeg::UpdateThreading()
+{
+  // only the time the player waits for ffmpeg counts, the other threads of the process don't. slice
+  // threads finish a frame within the call, frame threads hold the player up once all are busy.
+  const double decodeTime = static_cast<double>(m_decodeTicks) / CurrentHostFrequency();
+  m_decodeTicks = 0;
+
+  // dropped and drained frames don't tell how long decoding takes while playing
+  if (m_pCodecContext->skip_frame > AVDISCARD_DEFAULT ||
+      (m_codecControlFlags & DVD_CODEC_CTRL_DRAIN))
+    return;
+
+  double duration = 0.0;
+  if (m_hints.fpsrate > 0 && m_hints.fpsscale > 0)
+    duration = static_cast<double>(m_hints.fpsscale) / m_hints.fpsrate;
+  else if (m_dropCtrl.m_state == CDropControl::VALID)
+    duration = static_cast<double>(m_dropCtrl.m_diffPTS) / AV_TIME_BASE;
+
+  if (m_threading.AddFrame(decodeTime, duration))
+    m_processInfo.SetVideoDecodeTime(static_cast<float>(m_threading.GetDecodeTime() * 1000));
+}
+
+bool CDVDVideoCodecFFmpeg::ApplyThreading(int64_t keyframePts)
+{
+  if (keyframePts == AV_NOPTS_VALUE)
+    return false;
+
+  // decoding starts again at the packet of the keyframe. if it came before the change was
+  // asked for, the next keyframe is taken.
+  auto it = std::find_if(m_retunePackets.begin(), m_retunePackets.end(),
+                         [keyframePts](const RetunePacket& entry)
+                         {
+                           return entry.packet->pts == keyframePts ||
+                                  (entry.packet->pts == AV_NOPTS_VALUE &&
+                                   entry.packet->dts == keyframePts);
+                         });
+  if (it == m_retunePackets.end())
+    return false;
+
+  std::deque<RetunePacket> replay(it, m_retunePackets.end());
+  m_retunePackets.erase(it, m_retunePackets.end());
+
+  m_threading.ApplyChange();
+  CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg::ApplyThreading - reopening with %s at keyframe, "
+            "%d packets to decode again", m_threading.GetDescription().c_str(),
+            static_cast<int>(replay.size()));
+
+  Dispose();
+  if (!Open(m_hints, m_options))
+  {
+    CLog::Log(LOGERROR, "CDVDVideoCodecFFmpeg::ApplyThreading - failed to reopen codec");
+    ClearPackets(replay);
+    Dispose();
+    return true;
+  }
+
+  m_replayPackets = std::move(replay);
+  m_retuneSkipPts = keyframePts;
+  m_decodeTicks = 0;
+  m_filters.clear();
+  return true;
+}
+
+bool CDVDVideoCodecFFmpeg::SendReplayPackets()
+{
+  while (!m_replayPackets.empty())
+  {
+    RetunePacket& entry = m_replayPackets.front();
+    m_pCodecContext->reordered_opaque = entry.reorderedOpaque;
+
+    int64_t start = CurrentHostCounter();
+    int ret = avcodec_send_packet(m_pCodecContext, entry.packet);
+    m_decodeTicks += CurrentHostCounter() - start;
+
+    if (ret == AVERROR(EAGAIN))
+      return false;
+
+    av_packet_free(&entry.packet);
+    m_replayPackets.pop_front();
+  }
+  return true;
+}
+
+void CDVDVideoCodecFFmpeg::ClearPackets(std::deque<RetunePacket>& packets)
+{
+  for (auto& entry : packets)
+    av_packet_free(&entry.packet);
+  packets.clear();
+}
+
 bool CDVDVideoCodecFFmpeg::GetPictureCommon(VideoPicture* pVideoPicture)
 {
   if (!m_pFrame)
@@ -11,7 +11,9 @@
 #include "cores/VideoPlayer/DVDCodecs/DVDCodecs.h"
 #include "cores/VideoPlayer/DVDStreamInfo.h"
 #include "DVDVideoCodec.h"
+#include "DVDVideoCodecFFmpegThreading.h"
 #include "DVDVideoPPFFmpeg.h"
+#include <deque>
 #include <string>
 #include <vector>
 
@@ -48,6 +50,8 @@ public:
 protected:
   void Dispose();
   static enum AVPixelFormat GetFormat(struct AVCodecContext * avctx, const AVPixelFormat * fmt);
+  static int FFGetBuffer(AVCodecContext* avctx, AVFrame* frame, int flags);
+  static void FFReleaseBuffer(void* opaque, uint8_t* data);
 
   int  FilterOpen(const std::string& filters, bool scale);
   void FilterClose();
@@ -59,6 +63,16 @@ protected:
   bool HasHardware() { return m_pHardware != nullptr; };
   void SetHardware(IHardwareDecoder *hardware);
 
+  struct RetunePacket
+  {
+    AVPacket* packet;
+    int64_t reorderedOpaque;
+  };
+  void UpdateThreading();
+  bool ApplyThreading(int64_t keyframePts);
+  bool SendReplayPackets();
+  static void ClearPackets(std::deque<RetunePacket>& packets);
+
   AVFrame* m_pFrame = nullptr;;
   AVFrame* m_pDecodedFrame = nullptr;;
   AVCodecContext* m_pCodecContext = nullptr;;
@@ -99,6 +113,13 @@ protected:
   CDVDStreamInfo m_hints;
   CDVDCodecOptions m_options;
 
+  // software decoding threads, changed at a keyframe if decoding can't keep up
+  CDVDVideoCodecFFmpegThreading m_threading;
+  int64_t m_decodeTicks = 0; //!< time spent in avcodec since the previous frame, in host ticks
+  std::deque<RetunePacket> m_retunePackets; //!< packets sent while a change is pending
+  std::deque<RetunePacket> m_replayPackets; //!< packets from the keyframe on, for the new context
+  int64_t m_retuneSkipPts = AV_NOPTS_VALUE;
+
   struct CDropControl
   {
     CDropControl();
@@ -0,0 +1,154 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DVDVideoCodecFFmpegThreading.h"
+
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// streams with less work than this use slice threading, frame threading keeps a context and
+// delays the output by a frame for every thread
+const double LIGHT_WORK = 0.25;
+// a window is at least this long, so single slow frames don't count
+const int WINDOW_FRAMES = 30;
+const double WINDOW_DURATION = 2.0;
+}
+
+constexpr double CDVDVideoCodecFFmpegThreading::MAX_LOAD;
+constexpr int CDVDVideoCodecFFmpegThreading::MAX_THREADS;
+constexpr int CDVDVideoCodecFFmpegThreading::MAX_CHANGES;
+
+double CDVDVideoCodecFFmpegThreading::GetWork(const StreamInfo& info)
+{
+  double work;
+  switch (info.codec)
+  {
+    case AV_CODEC_ID_H264:
+      work = info.profile == FF_PROFILE_H264_HIGH_10 ||
+             info.profile == FF_PROFILE_H264_HIGH_10_INTRA ||
+             info.profile == FF_PROFILE_H264_HIGH_422 ||
+             info.profile == FF_PROFILE_H264_HIGH_444_PREDICTIVE ? 1.3 : 1.0;
+      break;
+    case AV_CODEC_ID_HEVC:
+      work = info.profile == FF_PROFILE_HEVC_MAIN_10 || info.profile == FF_PROFILE_HEVC_REXT ? 2.0 : 1.5;
+      break;
+    case AV_CODEC_ID_VP9:
+      // profiles 2 and 3 are 10 and 12 bit
+      work = info.profile >= FF_PROFILE_VP9_2 ? 2.0 : 1.5;
+      break;
+    case AV_CODEC_ID_AV1:
+      work = info.profile > FF_PROFILE_AV1_MAIN ? 2.5 : 2.0;
+      break;
+    default:
+      work = 0.6;
+      break;
+  }
+
+  if (info.width > 0 && info.height > 0)
+    work *= static_cast<double>(info.width) * info.height / (1920 * 1080);
+  return work;
+}
+
+void CDVDVideoCodecFFmpegThreading::Init(const StreamInfo& info, int cpuCount)
+{
+  m_info = info;
+  m_cpuCount = std::max(cpuCount, 1);
+  m_changes = 0;
+  ResetMeasurement();
+  m_decodeTime = 0.0;
+
+  const double work = GetWork(info);
+  const int maxThreads = std::min(MAX_THREADS, std::max(m_cpuCount * 3 / 2, 1));
+  int threads = static_cast<int>(std::ceil(m_cpuCount * 0.75 * work));
+  threads = std::max(std::min(threads, maxThreads), std::min(2, maxThreads));
+
+  if (info.sliceThreads && (!info.frameThreads || work < LIGHT_WORK))
+    m_threadType = FF_THREAD_SLICE;
+  else if (info.frameThreads)
+    m_threadType = FF_THREAD_FRAME;
+  else
+  {
+    m_threadType = 0;
+    threads = 1;
+  }
+
+  m_threadCount = threads;
+  m_changeType = m_threadType;
+  m_changeCount = m_threadCount;
+
+  CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpegThreading::Init - work %.2f, using %s", work,
+            GetDescription().c_str());
+}
+
+std::string CDVDVideoCodecFFmpegThreading::GetDescription() const
+{
+  if (m_threadType == FF_THREAD_FRAME)
+    return StringUtils::Format("frame x %d", m_threadCount);
+  else if (m_threadType == FF_THREAD_SLICE)
+    return StringUtils::Format("slice x %d", m_threadCount);
+  return "";
+}
+
+bool CDVDVideoCodecFFmpegThreading::AddFrame(double decodeTime, double duration)
+{
+  if (duration <= 0.0)
+    return false;
+
+  m_windowDecodeTime += decodeTime;
+  m_windowDuration += duration;
+  m_windowFrames++;
+  if (m_windowFrames < WINDOW_FRAMES || m_windowDuration < WINDOW_DURATION)
+    return false;
+
+  const double load = m_windowDecodeTime / m_windowDuration;
+  m_decodeTime = m_windowDecodeTime / m_windowFrames;
+  ResetMeasurement();
+
+  if (load < MAX_LOAD || HasChange() || m_changes >= MAX_CHANGES || m_threadType == 0)
+    return true;
+
+  const int maxThreads = std::min(MAX_THREADS, m_cpuCount * 2);
+  if (m_threadType == FF_THREAD_SLICE && m_info.frameThreads)
+  {
+    // slice threading doesn't help streams with a single slice per frame
+    m_changeType = FF_THREAD_FRAME;
+    m_changeCount = std::min(std::max(m_threadCount, m_cpuCount), maxThreads);
+  }
+  else if (m_threadCount < maxThreads)
+    m_changeCount = std::min(m_threadCount + std::max(2, m_threadCount / 2), maxThreads);
+  else
+    return true;
+
+  CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpegThreading::AddFrame - decoding takes %.0f%% of the time, "
+            "changing to %s x %d", load * 100, m_changeType == FF_THREAD_FRAME ? "frame" : "slice",
+            m_changeCount);
+  return true;
+}
+
+void CDVDVideoCodecFFmpegThreading::ResetMeasurement()
+{
+  m_windowDecodeTime = 0.0;
+  m_windowDuration = 0.0;
+  m_windowFrames = 0;
+}
+
+void CDVDVideoCodecFFmpegThreading::ApplyChange()
+{
+  if (!HasChange())
+    return;
+
+  m_threadType = m_changeType;
+  m_threadCount = m_changeCount;
+  m_changes++;
+  ResetMeasurement();
+}
@@ -0,0 +1,84 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <string>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+/*!
+ * \brief Picks frame or slice threading and the number of threads for software decoding.
+ *
+ * The first choice depends on how much work a frame of the stream is, estimated from codec,
+ * profile and resolution. While playing, the decoder reports how long each frame kept the player
+ * waiting in ffmpeg. If that is most of the time of the frames, more threads are asked for, or
+ * frame threading if slice threading was used. The decoder applies a change when it gets to the
+ * next keyframe.
+ */
+class CDVDVideoCodecFFmpegThreading
+{
+public:
+  struct StreamInfo
+  {
+    AVCodecID codec = AV_CODEC_ID_NONE;
+    int profile = FF_PROFILE_UNKNOWN;
+    int width = 0;
+    int height = 0;
+    bool frameThreads = false; //!< the decoder supports frame threading
+    bool sliceThreads = false; //!< the decoder supports slice threading
+  };
+
+  void Init(const StreamInfo& info, int cpuCount);
+  bool IsInitialized() const { return m_threadCount > 0; }
+  const StreamInfo& GetStreamInfo() const { return m_info; }
+
+  int GetThreadType() const { return m_threadType; }
+  int GetThreadCount() const { return m_threadCount; }
+  std::string GetDescription() const;
+
+  /*!
+   * \brief Adds the time a frame spent in the decoder and the time it is shown, in seconds
+   *
+   * The decode time is wall time inside avcodec_send_packet() and avcodec_receive_frame(), so it
+   * already accounts for the threads working in parallel.
+   * \return true if a measurement window is complete, GetDecodeTime() is updated then
+   */
+  bool AddFrame(double decodeTime, double duration);
+  void ResetMeasurement();
+
+  //! average decode time per frame of the last complete window, in seconds
+  double GetDecodeTime() const { return m_decodeTime; }
+
+  bool HasChange() const { return m_changeType != m_threadType || m_changeCount != m_threadCount; }
+  void ApplyChange();
+
+  //! the share of the time of the frames spent decoding before more threads are used
+  static constexpr double MAX_LOAD = 0.85;
+  static constexpr int MAX_THREADS = 16;
+  static constexpr int MAX_CHANGES = 3;
+
+protected:
+  //! work per frame relative to 8 bit 1080p H.264
+  static double GetWork(const StreamInfo& info);
+
+  StreamInfo m_info;
+  int m_cpuCount = 1;
+  int m_threadType = 0;
+  int m_threadCount = 0;
+  int m_changeType = 0;
+  int m_changeCount = 0;
+  int m_changes = 0;
+
+  double m_windowDecodeTime = 0.0;
+  double m_windowDuration = 0.0;
+  int m_windowFrames = 0;
+  double m_decodeTime = 0.0;
+};
@@ -11,11 +11,56 @@
 #include "cores/VideoPlayer/Interface/Addon/DemuxPacket.h"
 #include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 
 #include <math.h>
 
-CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m_owner(owner)
+CDVDMessageRing::CDVDMessageRing(size_t capacity)
+{
+  size_t size = 1;
+  while (size < capacity)
+    size <<= 1;
+  m_items.resize(size);
+}
+
+void CDVDMessageRing::push_front(CDVDMsg* msg, int priority)
+{
+  if (m_size == m_items.size())
+    Grow();
+
+  at(m_size) = DVDMessageListItem(msg, priority);
+  m_size++;
+}
+
+void CDVDMessageRing::push_back(CDVDMsg* msg, int priority)
+{
+  if (m_size == m_items.size())
+    Grow();
+
+  m_back = (m_back - 1) & (m_items.size() - 1);
+  m_size++;
+  at(0) = DVDMessageListItem(msg, priority);
+}
+
+void CDVDMessageRing::pop_back()
+{
+  at(0) = DVDMessageListItem();
+  m_back = (m_back + 1) & (m_items.size() - 1);
+  m_size--;
+}
+
+void CDVDMessageRing::Grow()
+{
+  std::vector<DVDMessageListItem> items(m_items.size() * 2);
+  for (size_t i = 0; i < m_size; i++)
+    items[i] = std::move(at(i));
+
+  m_items.swap(items);
+  m_back = 0;
+}
+
+CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_owner(owner), m_messages(256)
 {
   m_iDataSize     = 0;
   m_bAbortRequest = false;
@@ -70,7 +115,7 @@ void CDVDMessageQueue::Abort()
   m_bAbortRequest = true;
 
   // inform waiter for abort action
-  m_hEvent.Set();
+  m_cond.notifyAll();
 }
 
 void CDVDMessageQueue::End()
@@ -132,9 +177,9 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
     }
 
     if (front)
-      m_messages.emplace_front(pMsg, priority);
+      m_messages.push_front(pMsg, priority);
     else
-      m_messages.emplace_back(pMsg, priority);
+      m_messages.push_back(pMsg, priority);
   }
 
   if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET) && priority == 0)
@@ -153,7 +198,8 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
   pMsg->Release();
 
   // inform waiter for new packet
-  m_hEvent.Set();
+  if (m_waiters > 0)
+    m_cond.notifyAll();
 
   return MSGQ_OK;
 }
@@ -172,45 +218,49 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
     return MSGQ_NOT_INITIALIZED;
   }
 
+  XbmcThreads::EndTime timeout(iTimeoutInMilliSeconds);
   while (!m_bAbortRequest)
   {
-    std::list<DVDMessageListItem> &msgs = (priority > 0 || !m_prioMessages.empty()) ? m_prioMessages : m_messages;
-
-    if (!msgs.empty() && (msgs.back().priority >= priority || m_drain))
+    const bool prio = priority > 0 || !m_prioMessages.empty();
+    DVDMessageListItem* item = nullptr;
+    if (prio && !m_prioMessages.empty())
+      item = &m_prioMessages.back();
+    else if (!prio && !m_messages.empty())
+      item = &m_messages.back();
+
+    if (item && (item->priority >= priority || m_drain))
     {
-      DVDMessageListItem& item(msgs.back());
-      priority = item.priority;
+      priority = item->priority;
 
-      if (item.message->IsType(CDVDMsg::DEMUXER_PACKET) && item.priority == 0)
+      if (item->message->IsType(CDVDMsg::DEMUXER_PACKET) && item->priority == 0)
       {
-        DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(item.message)->GetPacket();
+        DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(item->message)->GetPacket();
         if (packet)
         {
           m_iDataSize -= packet->iSize;
         }
       }
 
-      *pMsg = item.message->Acquire();
-      msgs.pop_back();
+      *pMsg = item->message->Acquire();
+      if (prio)
+        m_prioMessages.pop_back();
+      else
+        m_messages.pop_back();
       UpdateTimeBack();
       ret = MSGQ_OK;
       break;
     }
-    else if (!iTimeoutInMilliSeconds)
+    else if (timeout.IsTimePast())
     {
       ret = MSGQ_TIMEOUT;
       break;
     }
     else
     {
-      m_hEvent.Reset();
-      lock.Leave();
-
       // wait for a new message
-      if (!m_hEvent.WaitMSec(iTimeoutInMilliSeconds))
-        return MSGQ_TIMEOUT;
-
-      lock.Enter();
+      m_waiters++;
+      m_cond.wait(lock, timeout.MillisLeft());
+      m_waiters--;
     }
   }
 
@@ -272,11 +322,10 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
     return 0;
 
   unsigned count = 0;
-  for (const auto &item : m_messages)
-  {
+  m_messages.for_each([type, &count](const DVDMessageListItem &item){
     if(item.message->IsType(type))
       count++;
-  }
+  });
   for (const auto &item : m_prioMessages)
   {
     if(item.message->IsType(type))
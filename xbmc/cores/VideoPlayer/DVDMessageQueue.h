@@ -9,13 +9,14 @@
 #pragma once
 
 #include "DVDMessage.h"
+#include "threads/Condition.h"
 #include "threads/CriticalSection.h"
-#include "threads/Event.h"
 
 #include <algorithm>
 #include <atomic>
 #include <list>
 #include <string>
+#include <vector>
 
 struct DVDMessageListItem
 {
@@ -30,6 +31,12 @@ struct DVDMessageListItem
     priority = 0;
   }
   DVDMessageListItem(const DVDMessageListItem&) = delete;
+  DVDMessageListItem(DVDMessageListItem&& other) noexcept
+  {
+    message = other.message;
+    priority = other.priority;
+    other.message = NULL;
+  }
  ~DVDMessageListItem()
   {
     if(message)
@@ -37,11 +44,68 @@ struct DVDMessageListItem
   }
 
   DVDMessageListItem& operator=(const DVDMessageListItem&) = delete;
+  DVDMessageListItem& operator=(DVDMessageListItem&& other) noexcept
+  {
+    std::swap(message, other.message);
+    std::swap(priority, other.priority);
+    return *this;
+  }
 
   CDVDMsg* message;
   int priority;
 };
 
+/**
+ * Circular buffer of messages, ordered like the message lists of CDVDMessageQueue: new messages
+ * are put at the front and taken from the back. The buffer only grows when it is full and is
+ * never shrunk, so a steady flow of packets doesn't allocate.
+ */
+class CDVDMessageRing
+{
+public:
+  explicit CDVDMessageRing(size_t capacity);
+
+  bool empty() const { return m_size == 0; }
+  size_t size() const { return m_size; }
+
+  DVDMessageListItem& front() { return at(m_size - 1); }
+  DVDMessageListItem& back() { return at(0); }
+
+  void push_front(CDVDMsg* msg, int priority);
+  void push_back(CDVDMsg* msg, int priority);
+  void pop_back();
+
+  template<typename P>
+  void remove_if(P pred)
+  {
+    size_t kept = 0;
+    for (size_t i = 0; i < m_size; i++)
+    {
+      if (pred(at(i)))
+        at(i) = DVDMessageListItem();
+      else if (kept++ != i)
+        at(kept - 1) = std::move(at(i));
+    }
+    m_size = kept;
+  }
+
+  template<typename F>
+  void for_each(F func) const
+  {
+    for (size_t i = 0; i < m_size; i++)
+      func(at(i));
+  }
+
+private:
+  DVDMessageListItem& at(size_t i) { return m_items[(m_back + i) & (m_items.size() - 1)]; }
+  const DVDMessageListItem& at(size_t i) const { return m_items[(m_back + i) & (m_items.size() - 1)]; }
+  void Grow();
+
+  std::vector<DVDMessageListItem> m_items; ///< size is a power of two
+  size_t m_back = 0; ///< index of the oldest message
+  size_t m_size = 0;
+};
+
 enum MsgQueueReturnCode
 {
   MSGQ_OK = 1,
@@ -103,7 +167,8 @@ private:
   void UpdateTimeFront();
   void UpdateTimeBack();
 
-  CEvent m_hEvent;
+  XbmcThreads::ConditionVariable m_cond;
+  int m_waiters = 0; ///< threads waiting in Get(), Put() only signals if there are any
   mutable CCriticalSection m_section;
 
   std::atomic<bool> m_bAbortRequest;
@@ -118,7 +183,7 @@ private:
   int m_iMaxDataSize;
   std::string m_owner;
 
-  std::list<DVDMessageListItem> m_messages;
+  CDVDMessageRing m_messages;
   std::list<DVDMessageListItem> m_prioMessages;
 };
 
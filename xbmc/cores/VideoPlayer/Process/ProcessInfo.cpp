@@ -71,6 +71,8 @@ void CProcessInfo::ResetVideoCodecInfo()
   m_videoHeight = 0;
   m_videoFPS = 0.0;
   m_videoDAR = 0.0;
+  m_videoDecoderThreading.clear();
+  m_videoDecodeTime = 0.0;
   m_videoIsInterlaced = false;
   m_deintMethods.clear();
   m_deintMethods.push_back(EINTERLACEMETHOD::VS_INTERLACEMETHOD_NONE);
@@ -85,6 +87,8 @@ void CProcessInfo::ResetVideoCodecInfo()
     m_dataCache->SetVideoDimensions(m_videoWidth, m_videoHeight);
     m_dataCache->SetVideoFps(m_videoFPS);
     m_dataCache->SetVideoDAR(m_videoDAR);
+    m_dataCache->SetVideoDecoderThreading(m_videoDecoderThreading);
+    m_dataCache->SetVideoDecodeTime(m_videoDecodeTime);
     m_dataCache->SetStateSeeking(m_stateSeeking);
     m_dataCache->SetVideoStereoMode(m_videoStereoMode);
   }
@@ -219,6 +223,40 @@ float CProcessInfo::GetVideoDAR()
   return m_videoDAR;
 }
 
+void CProcessInfo::SetVideoDecoderThreading(const std::string &threading)
+{
+  CSingleLock lock(m_videoCodecSection);
+
+  m_videoDecoderThreading = threading;
+
+  if (m_dataCache)
+    m_dataCache->SetVideoDecoderThreading(m_videoDecoderThreading);
+}
+
+std::string CProcessInfo::GetVideoDecoderThreading()
+{
+  CSingleLock lock(m_videoCodecSection);
+
+  return m_videoDecoderThreading;
+}
+
+void CProcessInfo::SetVideoDecodeTime(float ms)
+{
+  CSingleLock lock(m_videoCodecSection);
+
+  m_videoDecodeTime = ms;
+
+  if (m_dataCache)
+    m_dataCache->SetVideoDecodeTime(m_videoDecodeTime);
+}
+
+float CProcessInfo::GetVideoDecodeTime()
+{
+  CSingleLock lock(m_videoCodecSection);
+
+  return m_videoDecodeTime;
+}
+
 void CProcessInfo::SetVideoInterlaced(bool interlaced)
 {
   CSingleLock lock(m_videoCodecSection);
@@ -437,6 +475,13 @@ void CProcessInfo::UpdateRenderInfo(CRenderInfo &info)
   }
 }
 
+std::shared_ptr<IVideoBufferPool> CProcessInfo::GetRenderBufferPool()
+{
+  CSingleLock lock(m_renderSection);
+
+  return m_renderInfo.video_buffer_pool;
+}
+
 void CProcessInfo::UpdateRenderBuffers(int queued, int discard, int free)
 {
   CSingleLock lock(m_renderSection);
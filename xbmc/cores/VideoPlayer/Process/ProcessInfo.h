@@ -48,6 +48,10 @@ public:
   float GetVideoFps();
   void SetVideoDAR(float dar);
   float GetVideoDAR();
+  void SetVideoDecoderThreading(const std::string &threading);
+  std::string GetVideoDecoderThreading();
+  void SetVideoDecodeTime(float ms);
+  float GetVideoDecodeTime();
   void SetVideoInterlaced(bool interlaced);
   bool GetVideoInterlaced();
   virtual EINTERLACEMETHOD GetFallbackDeintMethod();
@@ -76,6 +80,7 @@ public:
   void SetRenderClockSync(bool enabled);
   bool IsRenderClockSync();
   void UpdateRenderInfo(CRenderInfo &info);
+  std::shared_ptr<IVideoBufferPool> GetRenderBufferPool();
   void UpdateRenderBuffers(int queued, int discard, int free);
   void GetRenderBuffers(int &queued, int &discard, int &free);
   virtual std::vector<AVPixelFormat> GetRenderFormats();
@@ -126,6 +131,8 @@ protected:
   int m_videoHeight;
   float m_videoFPS;
   float m_videoDAR;
+  std::string m_videoDecoderThreading;
+  float m_videoDecodeTime;
   bool m_videoIsInterlaced;
   std::list<EINTERLACEMETHOD> m_deintMethods;
   EINTERLACEMETHOD m_deintMethodDefault;
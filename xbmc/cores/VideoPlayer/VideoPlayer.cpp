@@ -3155,6 +3155,10 @@ void CVideoPlayer::GetGeneralInfo(std::string& strGeneralInfo)
                                     , m_State.cache_level * 100);
       if (m_playSpeed == 0 || m_caching == CACHESTATE_FULL)
         strBuf += StringUtils::Format(" %d msec", DVD_TIME_TO_MSEC(m_State.cache_delay));
+      if (m_State.cache_saved > 0)
+        strBuf += StringUtils::Format(" hits:%2.0f%% saved:%s"
+                                      , m_State.cache_hitratio * 100
+                                      , StringUtils::SizeToString(m_State.cache_saved).c_str());
     }
 
     strGeneralInfo = StringUtils::Format("Player: a/v:% 6.3f, %s"
@@ -4683,9 +4687,15 @@ void CVideoPlayer::UpdatePlayState(double timeout)
     state.cache_bytes = status.forward;
     if(state.timeMax)
       state.cache_bytes += m_pInputStream->GetLength() * (int64_t) (GetQueueTime() / state.timeMax);
+    state.cache_saved = status.saved;
+    state.cache_hitratio = status.hitratio;
   }
   else
+  {
     state.cache_bytes = 0;
+    state.cache_saved = 0;
+    state.cache_hitratio = 0.0;
+  }
 
   state.timestamp = m_clock.GetAbsoluteClock();
 
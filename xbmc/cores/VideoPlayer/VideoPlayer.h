@@ -52,6 +52,8 @@ struct SPlayerState
     cantempo = false;
     caching = false;
     cache_bytes = 0;
+    cache_saved = 0;
+    cache_hitratio = 0.0;
     cache_level = 0.0;
     cache_delay = 0.0;
     cache_offset = 0.0;
@@ -83,6 +85,8 @@ struct SPlayerState
   bool caching;
 
   int64_t cache_bytes;   // number of bytes current's cached
+  uint64_t cache_saved;  // number of bytes served from cache instead of refetching them
+  double cache_hitratio; // fraction of seeks served from cache
   double cache_level;   // current estimated required cache level
   double cache_delay;   // time until cache is expected to reach estimated level
   double cache_offset;  // percentage of file ahead of current position
@@ -48,6 +48,8 @@
 //! screws up the alpha, an offset fixes this, there might still be a problem if stride + PBO_OFFSET
 //! is a multiple of 128 and deinterlacing is on
 #define PBO_OFFSET 16
+// nanoseconds to wait for the gpu to read a buffer the decoder gets back
+#define FENCE_TIMEOUT 100000000
 
 #define BUFFER_OFFSET(i) ((char *)NULL + (i))
 
@@ -96,6 +98,7 @@ CLinuxRendererGL::CPictureBuffer::CPictureBuffer()
   memset(&pbo   , 0, sizeof(pbo));
   videoBuffer = nullptr;
   loaded = false;
+  fence = GL_NONE;
 }
 
 CLinuxRendererGL::CPictureBuffer::~CPictureBuffer() = default;
@@ -238,6 +241,19 @@ bool CLinuxRendererGL::Configure(const VideoPicture &picture, float fps, unsigne
 
   m_pboSupported = CServiceBroker::GetRenderSystem()->IsExtSupported("GL_ARB_pixel_buffer_object");
 
+  // offer software decoders buffers to decode into, planar yuv is uploaded from them as it is
+  bool pooled = m_format == AV_PIX_FMT_YUV420P || m_format == AV_PIX_FMT_YUVJ420P ||
+                m_format == AV_PIX_FMT_YUV420P9 || m_format == AV_PIX_FMT_YUV420P10 ||
+                m_format == AV_PIX_FMT_YUV420P12 || m_format == AV_PIX_FMT_YUV420P14 ||
+                m_format == AV_PIX_FMT_YUV420P16;
+  if (!pooled && m_pboPool)
+  {
+    m_pboPool->Dispose();
+    m_pboPool.reset();
+  }
+  else if (pooled && !m_pboPool && m_pboSupported && CVideoBufferPoolPBO::IsSupported())
+    m_pboPool = std::make_shared<CVideoBufferPoolPBO>();
+
   // setup the background colour
   m_clearColour = CServiceBroker::GetWinSystem()->UseLimitedColor() ? (16.0f / 0xff) : 0.0f;
 
@@ -294,6 +310,15 @@ void CLinuxRendererGL::AddVideoPicture(const VideoPicture &picture, int index)
 void CLinuxRendererGL::ReleaseBuffer(int idx)
 {
   CPictureBuffer &buf = m_buffers[idx];
+  // the decoder writes into a pooled buffer once it has it back. the render manager doesn't ask
+  // NeedBuffer() when the gui isn't rendered, so the gpu may not have read it yet.
+  if (glIsSync(buf.fence))
+  {
+    if (glClientWaitSync(buf.fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT) == GL_TIMEOUT_EXPIRED)
+      CLog::Log(LOGWARNING, "CLinuxRendererGL::ReleaseBuffer - upload of buffer %d didn't finish", idx);
+    glDeleteSync(buf.fence);
+    buf.fence = GL_NONE;
+  }
   if (buf.videoBuffer)
   {
     buf.videoBuffer->Release();
@@ -301,6 +326,29 @@ void CLinuxRendererGL::ReleaseBuffer(int idx)
   }
 }
 
+bool CLinuxRendererGL::NeedBuffer(int idx)
+{
+  // the decoder must not get the buffer back before the gpu read it
+  CPictureBuffer &buf = m_buffers[idx];
+  if (glIsSync(buf.fence))
+  {
+    GLint state;
+    GLsizei length;
+    glGetSynciv(buf.fence, GL_SYNC_STATUS, 1, &length, &state);
+    if (state == GL_SIGNALED)
+    {
+      glDeleteSync(buf.fence);
+      buf.fence = GL_NONE;
+    }
+    else
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 void CLinuxRendererGL::GetPlaneTextureSize(CYuvPlane& plane)
 {
   /* texture is assumed to be bound */
@@ -965,6 +1013,12 @@ void CLinuxRendererGL::UnInit()
     DeleteTexture(i);
   }
 
+  if (m_pboPool)
+  {
+    m_pboPool->Dispose();
+    m_pboPool.reset();
+  }
+
   DeleteCLUT();
 
   // cleanup framebuffer object if it was in use
@@ -1778,6 +1832,17 @@ bool CLinuxRendererGL::UploadTexture(int index)
     m_buffers[index].videoBuffer->GetPlanes(src.plane);
     m_buffers[index].videoBuffer->GetStrides(src.stride);
 
+    if (m_pboPool)
+    {
+      m_pboPool->Update();
+      if (UploadPooledYV12Texture(index, src))
+      {
+        m_buffers[index].loaded = true;
+        CalculateTextureSourceRects(index, 3);
+        return true;
+      }
+    }
+
     UnBindPbo(m_buffers[index]);
 
     if (m_format == AV_PIX_FMT_NV12)
@@ -1797,7 +1862,7 @@ bool CLinuxRendererGL::UploadTexture(int index)
     {
       CVideoBuffer::CopyPicture(&dst, &src);
       BindPbo(m_buffers[index]);
-      ret = UploadYV12Texture(index);
+      ret = UploadYV12Texture(index, dst);
     }
 
     if (ret)
@@ -1964,10 +2029,55 @@ bool CLinuxRendererGL::CreateYV12Texture(int index)
   return true;
 }
 
-bool CLinuxRendererGL::UploadYV12Texture(int source)
+bool CLinuxRendererGL::UploadPooledYV12Texture(int index, const YuvImage& src)
+{
+  CPictureBuffer& buf = m_buffers[index];
+  const YuvImage& im = buf.image;
+
+  uintptr_t offsets[YuvImage::MAX_PLANES];
+  GLuint pbo = m_pboPool->GetPlaneOffsets(src.plane, offsets);
+  if (!pbo)
+    return false;
+
+  // rows are given to gl in pixels
+  for (int p = 0; p < YuvImage::MAX_PLANES; p++)
+  {
+    if (src.stride[p] <= 0 || src.stride[p] % im.bpp)
+      return false;
+  }
+
+  YuvImage pooled = im;
+  for (int p = 0; p < YuvImage::MAX_PLANES; p++)
+  {
+    pooled.plane[p] = reinterpret_cast<uint8_t*>(offsets[p]);
+    pooled.stride[p] = src.stride[p];
+  }
+
+  for (int f = 0; f < MAX_FIELDS; f++)
+  {
+    for (int p = 0; p < YuvImage::MAX_PLANES; p++)
+      buf.fields[f][p].pbo = pbo;
+  }
+
+  bool ret = UploadYV12Texture(index, pooled);
+
+  for (int f = 0; f < MAX_FIELDS; f++)
+  {
+    for (int p = 0; p < YuvImage::MAX_PLANES; p++)
+      buf.fields[f][p].pbo = buf.pbo[p];
+  }
+
+  if (glIsSync(buf.fence))
+    glDeleteSync(buf.fence);
+  buf.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  return ret;
+}
+
+bool CLinuxRendererGL::UploadYV12Texture(int source, const YuvImage& image)
 {
   CPictureBuffer& buf = m_buffers[source];
-  YuvImage* im = &buf.image;
+  const YuvImage* im = &image;
 
   bool deinterlacing;
   if (m_currentField == FIELD_FULL)
@@ -2652,6 +2762,7 @@ CRenderInfo CLinuxRendererGL::GetRenderInfo()
 {
   CRenderInfo info;
   info.max_buffer_size = NUM_BUFFERS;
+  info.video_buffer_pool = m_pboPool;
   return info;
 }
 
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "system_gl.h"
@@ -23,6 +24,7 @@
 #include "threads/Event.h"
 #include "VideoShaders/ShaderFormats.h"
 #include "utils/Geometry.h"
+#include "VideoBufferPBO.h"
 
 extern "C" {
 #include <libavutil/mastering_display_metadata.h>
@@ -81,6 +83,7 @@ public:
   bool Flush(bool saveBuffers) override;
   void SetBufferSize(int numBuffers) override { m_NumYV12Buffers = numBuffers; }
   void ReleaseBuffer(int idx) override;
+  bool NeedBuffer(int idx) override;
   void RenderUpdate(int index, int index2, bool clear, unsigned int flags, unsigned int alpha) override;
   void Update() override;
   bool RenderCapture(CRenderCapture* capture) override;
@@ -110,7 +113,8 @@ protected:
   virtual void DeleteTexture(int index);
   virtual bool CreateTexture(int index);
 
-  bool UploadYV12Texture(int index);
+  bool UploadYV12Texture(int index, const YuvImage& image);
+  bool UploadPooledYV12Texture(int index, const YuvImage& src);
   void DeleteYV12Texture(int index);
   bool CreateYV12Texture(int index);
 
@@ -193,6 +197,7 @@ protected:
 
     CVideoBuffer *videoBuffer;
     bool loaded;
+    GLsync fence; // set while the textures are uploaded from a buffer of the decoder
 
     AVColorPrimaries m_srcPrimaries;
     AVColorSpace m_srcColSpace;
@@ -222,6 +227,7 @@ protected:
   float m_clearColour = 0.0f;
   bool m_pboSupported = true;
   bool m_pboUsed = false;
+  std::shared_ptr<CVideoBufferPoolPBO> m_pboPool;
   bool m_nonLinStretch = false;
   bool m_nonLinStretchGui = false;
   float m_pixelRatio = 0.0f;
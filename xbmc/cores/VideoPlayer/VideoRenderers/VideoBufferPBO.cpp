@@ -0,0 +1,355 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "VideoBufferPBO.h"
+
+#include "ServiceBroker.h"
+#include "rendering/RenderSystem.h"
+#include "threads/SingleLock.h"
+#include "utils/TimeUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+// planes start at a cache line, which satisfies the stride alignment of the decoders too
+const uintptr_t ALIGNMENT = 64;
+// buffers are large, don't stall a single frame with too many
+const int MAX_ADD_PER_UPDATE = 4;
+// reading write combined memory is more than ten times slower than cached memory
+const int READ_CHECK_BYTES = 4 * 1024 * 1024;
+const int MAX_READ_SLOWDOWN = 4;
+
+// buffer objects of pools which went away, deleted on the render thread
+CCriticalSection orphanSection;
+std::vector<GLuint> orphans;
+}
+
+const int CVideoBufferPoolPBO::MAX_BUFFERS;
+const int CVideoBufferPoolPBO::MAX_BYTES;
+const int CVideoBufferPoolPBO::RETRY_UPDATES;
+const int CVideoBufferPoolPBO::MAX_FAILURES;
+
+//-----------------------------------------------------------------------------
+// CVideoBufferPBO
+//-----------------------------------------------------------------------------
+
+CVideoBufferPBO::CVideoBufferPBO(int id)
+: CVideoBuffer(id)
+{
+}
+
+bool CVideoBufferPBO::Alloc(AVPixelFormat format, int size)
+{
+#ifdef GL_MAP_PERSISTENT_BIT
+  const GLbitfield access = GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT |
+                            GL_MAP_COHERENT_BIT;
+  // the data starts at least an alignment into the buffer, a plane at offset 0 would be
+  // passed to glTexSubImage2D as a null pointer
+  const GLsizeiptr bytes = size + 2 * ALIGNMENT;
+
+  glGenBuffers(1, &m_pbo);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo);
+  // client storage asks for cached system memory, the decoder reads its reference frames
+  glBufferStorage(GL_PIXEL_UNPACK_BUFFER, bytes, nullptr, access | GL_CLIENT_STORAGE_BIT);
+  m_mapped = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes, access));
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+  if (!m_mapped)
+  {
+    glDeleteBuffers(1, &m_pbo);
+    m_pbo = 0;
+    return false;
+  }
+
+  uintptr_t data = (reinterpret_cast<uintptr_t>(m_mapped) + 2 * ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+  m_data = reinterpret_cast<uint8_t*>(data);
+  m_size = size;
+  m_pixFormat = format;
+  return true;
+#else
+  return false;
+#endif
+}
+
+void CVideoBufferPBO::Free()
+{
+  // deleting the buffer object unmaps it
+  if (m_pbo)
+    glDeleteBuffers(1, &m_pbo);
+  m_pbo = 0;
+  m_mapped = nullptr;
+  m_data = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+// CVideoBufferPoolPBO
+//-----------------------------------------------------------------------------
+
+CVideoBufferPoolPBO::~CVideoBufferPoolPBO()
+{
+  CSingleLock lock(m_critSection);
+  CSingleLock orphanLock(orphanSection);
+
+  // this may not be the render thread
+  for (auto buf : m_all)
+  {
+    if (!buf)
+      continue;
+    if (buf->m_pbo)
+      orphans.push_back(buf->m_pbo);
+    delete buf;
+  }
+}
+
+bool CVideoBufferPoolPBO::IsSupported()
+{
+#ifdef GL_MAP_PERSISTENT_BIT
+  return CServiceBroker::GetRenderSystem()->IsExtSupported("GL_ARB_buffer_storage");
+#else
+  return false;
+#endif
+}
+
+bool CVideoBufferPoolPBO::IsReadFast(const uint8_t* data, int size)
+{
+  const int bytes = std::min(size, READ_CHECK_BYTES);
+  if (bytes <= 0)
+    return true;
+
+  std::vector<uint8_t> cached(bytes, 1);
+  std::vector<uint8_t> copy(bytes);
+  // the fastest of a few reads, the first one may fault the pages in
+  auto measure = [&copy, bytes](const uint8_t* src)
+  {
+    int64_t fastest = 0;
+    for (int i = 0; i < 3; i++)
+    {
+      const int64_t start = CurrentHostCounter();
+      memcpy(copy.data(), src, bytes);
+      const int64_t ticks = CurrentHostCounter() - start;
+      if (i == 0 || ticks < fastest)
+        fastest = ticks;
+    }
+    return fastest;
+  };
+
+  const int64_t cachedTicks = measure(cached.data());
+  const int64_t ticks = measure(data);
+  CLog::Log(LOGDEBUG, "CVideoBufferPoolPBO::IsReadFast - reading %d bytes took %.2f ms, %.2f ms "
+            "from system memory", bytes, ticks * 1000.0 / CurrentHostFrequency(),
+            cachedTicks * 1000.0 / CurrentHostFrequency());
+  return ticks <= std::max<int64_t>(cachedTicks, 1) * MAX_READ_SLOWDOWN;
+}
+
+CVideoBuffer* CVideoBufferPoolPBO::Get()
+{
+  CSingleLock lock(m_critSection);
+
+  if (m_disposed || !m_configured)
+    return nullptr;
+
+  auto it = std::find_if(m_free.begin(), m_free.end(), [this](int id)
+  {
+    return m_all[id]->m_size == m_size && m_all[id]->GetFormat() == m_pixFormat;
+  });
+  if (it == m_free.end())
+  {
+    m_missed++;
+    return nullptr;
+  }
+
+  CVideoBufferPBO *buf = m_all[*it];
+  m_free.erase(it);
+  buf->Acquire(GetPtr());
+  return buf;
+}
+
+void CVideoBufferPoolPBO::Return(int id)
+{
+  CSingleLock lock(m_critSection);
+
+  m_free.push_back(id);
+}
+
+void CVideoBufferPoolPBO::Configure(AVPixelFormat format, int size)
+{
+  CSingleLock lock(m_critSection);
+
+  // buffers of another size may be mapped
+  if (m_pixFormat != format || m_size != size)
+  {
+    m_failures = 0;
+    m_retryUpdates = 0;
+  }
+  m_pixFormat = format;
+  m_size = size;
+  m_configured = true;
+  m_missed = 0;
+}
+
+bool CVideoBufferPoolPBO::IsConfigured()
+{
+  CSingleLock lock(m_critSection);
+
+  return m_configured;
+}
+
+bool CVideoBufferPoolPBO::IsCompatible(AVPixelFormat format, int size)
+{
+  CSingleLock lock(m_critSection);
+
+  return m_pixFormat == format && m_size == size;
+}
+
+void CVideoBufferPoolPBO::Update()
+{
+  DeleteOrphans();
+
+  CSingleLock lock(m_critSection);
+
+  if (m_disposed)
+    return;
+
+  for (auto it = m_free.begin(); it != m_free.end(); )
+  {
+    if (m_all[*it]->m_size != m_size || m_all[*it]->GetFormat() != m_pixFormat)
+    {
+      FreeBuffer(*it);
+      it = m_free.erase(it);
+    }
+    else
+      ++it;
+  }
+
+  // the decoder keeps its own buffers for a while after a buffer couldn't be mapped
+  if (m_retryUpdates > 0)
+  {
+    m_retryUpdates--;
+    m_missed = 0;
+    return;
+  }
+
+  const int count = std::count_if(m_all.begin(), m_all.end(),
+                                  [](CVideoBufferPBO *buf) { return buf != nullptr; });
+  const int maxBuffers = m_size > 0 ? std::min(MAX_BUFFERS, MAX_BYTES / m_size) : 0;
+  const int add = std::min(std::min(m_missed, MAX_ADD_PER_UPDATE), maxBuffers - count);
+  m_missed = 0;
+
+  for (int i = 0; i < add; i++)
+  {
+    auto slot = std::find(m_all.begin(), m_all.end(), nullptr);
+    int id = slot - m_all.begin();
+    CVideoBufferPBO *buf = CreateBuffer(id);
+    if (!buf->Alloc(m_pixFormat, m_size))
+    {
+      delete buf;
+      if (++m_failures >= MAX_FAILURES)
+      {
+        CLog::Log(LOGWARNING, "CVideoBufferPoolPBO::Update - failed to map a buffer of %d bytes "
+                  "%d times, decoders keep their own buffers", m_size, m_failures);
+        lock.Leave();
+        Dispose();
+        return;
+      }
+      CLog::Log(LOGDEBUG, "CVideoBufferPoolPBO::Update - failed to map a buffer of %d bytes, "
+                "trying again later", m_size);
+      m_retryUpdates = RETRY_UPDATES;
+      break;
+    }
+    m_failures = 0;
+
+    // decoders read their reference frames, write combined memory would slow them down
+    if (!m_readChecked)
+    {
+      m_readChecked = true;
+      if (!IsReadFast(buf->m_data, m_size))
+      {
+        CLog::Log(LOGWARNING, "CVideoBufferPoolPBO::Update - mapped buffers read slowly, "
+                  "decoders keep their own buffers");
+        buf->Free();
+        delete buf;
+        lock.Leave();
+        Dispose();
+        return;
+      }
+    }
+
+    if (slot == m_all.end())
+      m_all.push_back(buf);
+    else
+      *slot = buf;
+    m_free.push_back(id);
+  }
+}
+
+void CVideoBufferPoolPBO::Dispose()
+{
+  DeleteOrphans();
+
+  CSingleLock lock(m_critSection);
+
+  m_disposed = true;
+  for (int id : m_free)
+    FreeBuffer(id);
+  m_free.clear();
+}
+
+GLuint CVideoBufferPoolPBO::GetPlaneOffsets(uint8_t* const (&planes)[YuvImage::MAX_PLANES],
+                                            uintptr_t (&offsets)[YuvImage::MAX_PLANES])
+{
+  CSingleLock lock(m_critSection);
+
+  for (auto buf : m_all)
+  {
+    if (!buf || !buf->m_pbo)
+      continue;
+
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(buf->m_data);
+    const uintptr_t end = begin + buf->m_size;
+    const uintptr_t plane = reinterpret_cast<uintptr_t>(planes[0]);
+    if (plane < begin || plane >= end)
+      continue;
+
+    for (int p = 0; p < YuvImage::MAX_PLANES; p++)
+    {
+      const uintptr_t address = reinterpret_cast<uintptr_t>(planes[p]);
+      if (address < begin || address >= end)
+        return 0;
+      offsets[p] = address - reinterpret_cast<uintptr_t>(buf->m_mapped);
+    }
+    return buf->m_pbo;
+  }
+
+  return 0;
+}
+
+CVideoBufferPBO* CVideoBufferPoolPBO::CreateBuffer(int id)
+{
+  return new CVideoBufferPBO(id);
+}
+
+void CVideoBufferPoolPBO::FreeBuffer(int id)
+{
+  m_all[id]->Free();
+  delete m_all[id];
+  m_all[id] = nullptr;
+}
+
+void CVideoBufferPoolPBO::DeleteOrphans()
+{
+  CSingleLock lock(orphanSection);
+
+  if (!orphans.empty())
+  {
+    glDeleteBuffers(orphans.size(), orphans.data());
+    orphans.clear();
+  }
+}
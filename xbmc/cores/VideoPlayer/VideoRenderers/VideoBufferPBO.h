@@ -0,0 +1,119 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "cores/VideoPlayer/Process/VideoBuffer.h"
+#include "system_gl.h"
+#include "threads/CriticalSection.h"
+
+#include <deque>
+#include <stdint.h>
+#include <vector>
+
+/*!
+ * \brief Memory of a pixel buffer object which stays mapped while it is used.
+ *
+ * The buffer is mapped for reading too, decoders read their reference frames back. The driver
+ * may still give write combined memory, the pool checks how fast it reads.
+ */
+class CVideoBufferPBO : public CVideoBuffer
+{
+public:
+  explicit CVideoBufferPBO(int id);
+  uint8_t* GetMemPtr() override { return m_data; }
+
+protected:
+  friend class CVideoBufferPoolPBO;
+
+  // these need the gl context
+  virtual bool Alloc(AVPixelFormat format, int size);
+  virtual void Free();
+
+  GLuint m_pbo = 0;
+  uint8_t* m_mapped = nullptr;
+  uint8_t* m_data = nullptr;
+  int m_size = 0;
+};
+
+/*!
+ * \brief Buffers a software decoder decodes into and the renderer uploads from without copying.
+ *
+ * The renderer creates the pool and offers it with its render info. The decoder configures it
+ * with the format and size of its frames. Buffers can only be created on the render thread, so
+ * Get() returns nullptr if none is free and the decoder uses its own buffers for that frame.
+ * Update() adds as many buffers as the decoder missed since the last call, within MAX_BUFFERS
+ * and MAX_BYTES.
+ */
+class CVideoBufferPoolPBO : public IVideoBufferPool
+{
+public:
+  ~CVideoBufferPoolPBO() override;
+
+  //! persistently mapped buffers need GL 4.4 or GL_ARB_buffer_storage
+  static bool IsSupported();
+
+  CVideoBuffer* Get() override;
+  void Return(int id) override;
+  void Configure(AVPixelFormat format, int size) override;
+  bool IsConfigured() override;
+  bool IsCompatible(AVPixelFormat format, int size) override;
+
+  /*!
+   * \brief Frees the buffers of an old configuration and adds the missed ones, render thread only
+   *
+   * If a buffer can't be mapped, no buffers are added for RETRY_UPDATES calls. The pool is
+   * disposed after MAX_FAILURES failures in a row, or if the first buffer reads slowly.
+   */
+  void Update();
+
+  /*!
+   * \brief Frees the buffers and stops handing out new ones, render thread only
+   *
+   * Buffers still in use are deleted by the next pool which is updated after they came back.
+   */
+  void Dispose();
+
+  /*!
+   * \brief Finds the buffer which holds the planes
+   * \return the buffer object, with the offsets of the planes into it, or 0
+   */
+  GLuint GetPlaneOffsets(uint8_t* const (&planes)[YuvImage::MAX_PLANES],
+                         uintptr_t (&offsets)[YuvImage::MAX_PLANES]);
+
+  static const int MAX_BUFFERS = 32;
+  //! mapped memory of all buffers, 10 of 4k 10 bit frames
+  static const int MAX_BYTES = 256 * 1024 * 1024;
+  static const int RETRY_UPDATES = 250;
+  static const int MAX_FAILURES = 3;
+
+  /*!
+   * \brief Compares reading the memory with reading cached system memory
+   * \return false if it is so slow that decoders would be slower with it, like write combined
+   * memory
+   */
+  static bool IsReadFast(const uint8_t* data, int size);
+
+protected:
+  //! a new buffer, not allocated yet
+  virtual CVideoBufferPBO* CreateBuffer(int id);
+  void FreeBuffer(int id);
+  static void DeleteOrphans();
+
+  CCriticalSection m_critSection;
+  std::vector<CVideoBufferPBO*> m_all;
+  std::deque<int> m_free;
+  AVPixelFormat m_pixFormat = AV_PIX_FMT_NONE;
+  int m_size = 0;
+  bool m_configured = false;
+  bool m_disposed = false;
+  bool m_readChecked = false;
+  int m_missed = 0;
+  int m_failures = 0;
+  int m_retryUpdates = 0;
+};
@@ -0,0 +1,196 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "cores/VideoPlayer/DVDMessageQueue.h"
+#include "cores/VideoPlayer/Interface/Addon/DemuxPacket.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+CDVDMsg* CreatePacket(int size, double dts)
+{
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(0);
+  packet->iSize = size;
+  packet->dts = dts;
+  return new CDVDMsgDemuxerPacket(packet);
+}
+
+double GetDts(CDVDMsg* msg)
+{
+  if (!msg->IsType(CDVDMsg::DEMUXER_PACKET))
+    return DVD_NOPTS_VALUE;
+  return static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket()->dts;
+}
+}
+
+class TestDVDMessageQueue : public ::testing::Test
+{
+protected:
+  TestDVDMessageQueue() : queue("test") { queue.Init(); }
+  ~TestDVDMessageQueue() override { queue.End(); }
+
+  CDVDMessageQueue queue;
+};
+
+TEST_F(TestDVDMessageQueue, PacketsInOrder)
+{
+  // more than fit into the initial ring
+  const int count = 1000;
+  for (int i = 0; i < count; i++)
+    EXPECT_EQ(MSGQ_OK, queue.Put(CreatePacket(100, i * DVD_TIME_BASE / 10)));
+
+  EXPECT_EQ(count * 100, queue.GetDataSize());
+  EXPECT_EQ(99, queue.GetTimeSize());
+  EXPECT_EQ(static_cast<unsigned>(count), queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+
+  for (int i = 0; i < count; i++)
+  {
+    CDVDMsg* msg = nullptr;
+    ASSERT_EQ(MSGQ_OK, queue.Get(&msg, 0));
+    EXPECT_EQ(i * DVD_TIME_BASE / 10, GetDts(msg));
+    msg->Release();
+  }
+
+  CDVDMsg* msg = nullptr;
+  EXPECT_EQ(MSGQ_TIMEOUT, queue.Get(&msg, 0));
+  EXPECT_EQ(nullptr, msg);
+  EXPECT_EQ(0, queue.GetDataSize());
+}
+
+TEST_F(TestDVDMessageQueue, PriorityAndPutBack)
+{
+  queue.Put(CreatePacket(100, 1));
+  queue.Put(CreatePacket(100, 2));
+  queue.Put(new CDVDMsg(CDVDMsg::GENERAL_RESYNC), 1);
+
+  CDVDMsg* msg = nullptr;
+  int priority = 0;
+  ASSERT_EQ(MSGQ_OK, queue.Get(&msg, 0, priority));
+  EXPECT_TRUE(msg->IsType(CDVDMsg::GENERAL_RESYNC));
+  EXPECT_EQ(1, priority);
+  msg->Release();
+
+  priority = 0;
+  ASSERT_EQ(MSGQ_OK, queue.Get(&msg, 0, priority));
+  EXPECT_EQ(1, GetDts(msg));
+
+  // a message put back is the next one to get
+  queue.PutBack(msg);
+  priority = 0;
+  ASSERT_EQ(MSGQ_OK, queue.Get(&msg, 0, priority));
+  EXPECT_EQ(1, GetDts(msg));
+  msg->Release();
+
+  // only messages with at least the requested priority are returned
+  priority = 1;
+  EXPECT_EQ(MSGQ_TIMEOUT, queue.Get(&msg, 0, priority));
+}
+
+TEST_F(TestDVDMessageQueue, FlushKeepsOtherMessages)
+{
+  queue.Put(CreatePacket(100, 1));
+  queue.Put(new CDVDMsg(CDVDMsg::GENERAL_RESYNC));
+  queue.Put(CreatePacket(100, 2));
+  queue.Put(new CDVDMsg(CDVDMsg::GENERAL_RESET));
+  queue.Put(CreatePacket(100, 3));
+
+  queue.Flush();
+  EXPECT_EQ(0, queue.GetDataSize());
+  EXPECT_EQ(0u, queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+
+  CDVDMsg* msg = nullptr;
+  ASSERT_EQ(MSGQ_OK, queue.Get(&msg, 0));
+  EXPECT_TRUE(msg->IsType(CDVDMsg::GENERAL_RESYNC));
+  msg->Release();
+  ASSERT_EQ(MSGQ_OK, queue.Get(&msg, 0));
+  EXPECT_TRUE(msg->IsType(CDVDMsg::GENERAL_RESET));
+  msg->Release();
+  EXPECT_EQ(MSGQ_TIMEOUT, queue.Get(&msg, 0));
+}
+
+TEST_F(TestDVDMessageQueue, AbortWakesWaiter)
+{
+  std::thread aborter([this]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    queue.Abort();
+  });
+
+  CDVDMsg* msg = nullptr;
+  EXPECT_EQ(MSGQ_ABORT, queue.Get(&msg, 10000));
+  aborter.join();
+}
+
+TEST_F(TestDVDMessageQueue, Throughput)
+{
+  const int count = 200000;
+  queue.SetMaxDataSize(1000 * 1000);
+
+  auto start = std::chrono::steady_clock::now();
+  std::thread producer([this]() {
+    for (int i = 0; i < count; i++)
+    {
+      queue.Put(CreatePacket(1000, i));
+      // like the demuxer, back off while the queue is full
+      while (queue.IsFull())
+        std::this_thread::yield();
+    }
+  });
+
+  int received = 0;
+  while (received < count)
+  {
+    CDVDMsg* msg = nullptr;
+    ASSERT_EQ(MSGQ_OK, queue.Get(&msg, 1000));
+    EXPECT_EQ(received, GetDts(msg));
+    msg->Release();
+    received++;
+  }
+  producer.join();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  std::cout << "messages: " << count << ", "
+            << count * 1000000LL / std::max<long long>(1, std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count())
+            << " messages/s\n";
+}
+
+TEST_F(TestDVDMessageQueue, WakeupLatency)
+{
+  const int count = 1000;
+  std::atomic<long long> sent(0);
+  long long total = 0;
+
+  std::thread producer([this, &sent]() {
+    for (int i = 0; i < count; i++)
+    {
+      // give the consumer time to block in Get()
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+      sent = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+      queue.Put(CreatePacket(1000, i));
+    }
+  });
+
+  for (int i = 0; i < count; i++)
+  {
+    CDVDMsg* msg = nullptr;
+    ASSERT_EQ(MSGQ_OK, queue.Get(&msg, 1000));
+    total += std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count() - sent;
+    msg->Release();
+  }
+  producer.join();
+
+  std::cout << "wake-ups: " << count << ", average latency: " << total / count / 1000 << "us\n";
+}
@@ -0,0 +1,249 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "cores/VideoPlayer/DVDCodecs/DVDCodecs.h"
+#include "cores/VideoPlayer/DVDCodecs/Video/DVDVideoCodecFFmpeg.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "cores/VideoPlayer/DVDStreamInfo.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+#include "cores/VideoPlayer/Process/ProcessInfo.h"
+#include "cores/VideoPlayer/Process/VideoBuffer.h"
+#include "utils/CPUInfo.h"
+
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const int WIDTH = 64;
+const int HEIGHT = 48;
+const int FRAMES = 24;
+// 25 fps in DVD_TIME_BASE
+const double FRAME_TIME = 40000.0;
+
+// png frames are all keyframes and the decoder supports frame threading, the encoder is part of
+// the ffmpeg kodi builds
+std::vector<std::vector<uint8_t>> EncodeFrames(int count)
+{
+  std::vector<std::vector<uint8_t>> packets;
+
+  AVCodec* codec = avcodec_find_encoder(AV_CODEC_ID_PNG);
+  if (!codec)
+    return packets;
+
+  AVCodecContext* context = avcodec_alloc_context3(codec);
+  AVFrame* frame = av_frame_alloc();
+  AVPacket* packet = av_packet_alloc();
+  context->width = WIDTH;
+  context->height = HEIGHT;
+  context->pix_fmt = AV_PIX_FMT_RGB24;
+  context->time_base = {1, 25};
+
+  frame->width = WIDTH;
+  frame->height = HEIGHT;
+  frame->format = AV_PIX_FMT_RGB24;
+
+  if (avcodec_open2(context, codec, nullptr) == 0 && av_frame_get_buffer(frame, 0) == 0)
+  {
+    for (int i = 0; i < count; i++)
+    {
+      if (av_frame_make_writable(frame) < 0)
+        break;
+      for (int y = 0; y < HEIGHT; y++)
+        memset(frame->data[0] + y * frame->linesize[0], (i * 8 + y) & 0xff, WIDTH * 3);
+      frame->pts = i;
+
+      if (avcodec_send_frame(context, frame) < 0)
+        break;
+      while (avcodec_receive_packet(context, packet) == 0)
+      {
+        packets.emplace_back(packet->data, packet->data + packet->size);
+        av_packet_unref(packet);
+      }
+    }
+  }
+
+  av_packet_free(&packet);
+  av_frame_free(&frame);
+  avcodec_free_context(&context);
+  return packets;
+}
+
+class CTestVideoCodecFFmpeg : public CDVDVideoCodecFFmpeg
+{
+public:
+  explicit CTestVideoCodecFFmpeg(CProcessInfo& processInfo) : CDVDVideoCodecFFmpeg(processInfo) {}
+
+  const CDVDVideoCodecFFmpegThreading& GetThreading() const { return m_threading; }
+
+  // frames that take a second of cpu time ask for more threads at the next keyframe
+  bool RequestChange()
+  {
+    for (int i = 0; i < 100 && !m_threading.HasChange(); i++)
+      m_threading.AddFrame(1.0, FRAME_TIME / DVD_TIME_BASE);
+    return m_threading.HasChange();
+  }
+};
+}
+
+class TestDVDVideoCodecFFmpeg : public ::testing::Test
+{
+protected:
+  TestDVDVideoCodecFFmpeg()
+  {
+    CServiceBroker::RegisterCPUInfo(CCPUInfo::GetCPUInfo());
+    m_processInfo.reset(CProcessInfo::CreateInstance());
+    std::vector<AVPixelFormat> formats = {AV_PIX_FMT_RGB24};
+    m_processInfo->SetPixFormats(formats);
+    m_codec.reset(new CTestVideoCodecFFmpeg(*m_processInfo));
+  }
+
+  ~TestDVDVideoCodecFFmpeg() override
+  {
+    m_picture.Reset();
+    m_codec.reset();
+    m_processInfo.reset();
+    CServiceBroker::UnregisterCPUInfo();
+  }
+
+  // the first open is the one for hardware decoding, the player opens the codec again for
+  // multithreaded software decoding
+  bool Open()
+  {
+    CDVDStreamInfo hints;
+    hints.codec = AV_CODEC_ID_PNG;
+    hints.width = WIDTH;
+    hints.height = HEIGHT;
+    hints.fpsrate = 25;
+    hints.fpsscale = 1;
+    CDVDCodecOptions options;
+
+    if (!m_codec->Open(hints, options))
+      return false;
+    m_codec->Reopen();
+    return m_codec->GetThreading().IsInitialized();
+  }
+
+  bool AddPacket(const std::vector<uint8_t>& data, double pts)
+  {
+    DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(data.size());
+    memcpy(packet->pData, data.data(), data.size());
+    packet->iSize = data.size();
+    packet->pts = pts;
+    packet->dts = pts;
+
+    // like the player, get pictures until the decoder takes the packet
+    bool added = true;
+    while (!m_codec->AddData(*packet))
+    {
+      if (Receive() != CDVDVideoCodec::VC_BUFFER)
+      {
+        added = false;
+        break;
+      }
+    }
+
+    CDVDDemuxUtils::FreeDemuxPacket(packet);
+    return added;
+  }
+
+  // gets pictures until the decoder asks for data, like the player does
+  CDVDVideoCodec::VCReturn Receive()
+  {
+    while (true)
+    {
+      CDVDVideoCodec::VCReturn ret = m_codec->GetPicture(&m_picture);
+      if (ret == CDVDVideoCodec::VC_PICTURE)
+      {
+        m_pts.push_back(m_picture.pts);
+        m_threadings.push_back(m_processInfo->GetVideoDecoderThreading());
+      }
+      else if (ret != CDVDVideoCodec::VC_NONE)
+        return ret;
+    }
+  }
+
+  std::unique_ptr<CProcessInfo> m_processInfo;
+  std::unique_ptr<CTestVideoCodecFFmpeg> m_codec;
+  VideoPicture m_picture;
+  std::vector<double> m_pts;
+  std::vector<std::string> m_threadings;
+};
+
+TEST_F(TestDVDVideoCodecFFmpeg, ChangeThreadingWhilePlaying)
+{
+  const std::vector<std::vector<uint8_t>> packets = EncodeFrames(FRAMES);
+  if (packets.size() != FRAMES)
+  {
+    std::cout << "ffmpeg can't encode png, skipping test" << std::endl;
+    return;
+  }
+  ASSERT_TRUE(Open());
+  const std::string before = m_codec->GetThreading().GetDescription();
+  const int threads = m_codec->GetThreading().GetThreadCount();
+
+  for (int i = 0; i < FRAMES; i++)
+  {
+    if (i == FRAMES / 2)
+      ASSERT_TRUE(m_codec->RequestChange());
+    ASSERT_TRUE(AddPacket(packets[i], i * FRAME_TIME));
+    ASSERT_EQ(CDVDVideoCodec::VC_BUFFER, Receive());
+  }
+
+  m_codec->SetCodecControl(DVD_CODEC_CTRL_DRAIN);
+  EXPECT_EQ(CDVDVideoCodec::VC_EOF, Receive());
+
+  // every frame exactly once and in order, the ones of the keyframe on from the new context
+  ASSERT_EQ(static_cast<size_t>(FRAMES), m_pts.size());
+  for (int i = 0; i < FRAMES; i++)
+    EXPECT_DOUBLE_EQ(i * FRAME_TIME, m_pts[i]);
+
+  EXPECT_FALSE(m_codec->GetThreading().HasChange());
+  EXPECT_GT(m_codec->GetThreading().GetThreadCount(), threads);
+  EXPECT_EQ(before, m_threadings.front());
+  EXPECT_EQ(m_codec->GetThreading().GetDescription(), m_threadings.back());
+}
+
+TEST_F(TestDVDVideoCodecFFmpeg, ChangeThreadingWhileDraining)
+{
+  const std::vector<std::vector<uint8_t>> packets = EncodeFrames(FRAMES);
+  if (packets.size() != FRAMES)
+  {
+    std::cout << "ffmpeg can't encode png, skipping test" << std::endl;
+    return;
+  }
+  ASSERT_TRUE(Open());
+  const int threads = m_codec->GetThreading().GetThreadCount();
+
+  // the frame threads hold the last packets when the drain starts, the keyframe at which the
+  // context is opened again comes out while draining
+  for (int i = 0; i < FRAMES; i++)
+  {
+    if (i == FRAMES - 1)
+      ASSERT_TRUE(m_codec->RequestChange());
+    ASSERT_TRUE(AddPacket(packets[i], i * FRAME_TIME));
+  }
+
+  m_codec->SetCodecControl(DVD_CODEC_CTRL_DRAIN);
+  EXPECT_EQ(CDVDVideoCodec::VC_EOF, Receive());
+
+  ASSERT_EQ(static_cast<size_t>(FRAMES), m_pts.size());
+  for (int i = 0; i < FRAMES; i++)
+    EXPECT_DOUBLE_EQ(i * FRAME_TIME, m_pts[i]);
+  EXPECT_GT(m_codec->GetThreading().GetThreadCount(), threads);
+
+  // an empty packet after the drain doesn't start decoding again
+  DemuxPacket packet;
+  EXPECT_TRUE(m_codec->AddData(packet));
+  EXPECT_EQ(CDVDVideoCodec::VC_EOF, m_codec->GetPicture(&m_picture));
+}
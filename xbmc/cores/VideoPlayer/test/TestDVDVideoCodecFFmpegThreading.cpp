@@ -0,0 +1,151 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDCodecs/Video/DVDVideoCodecFFmpegThreading.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+CDVDVideoCodecFFmpegThreading::StreamInfo GetInfo(AVCodecID codec, int profile, int width, int height)
+{
+  CDVDVideoCodecFFmpegThreading::StreamInfo info;
+  info.codec = codec;
+  info.profile = profile;
+  info.width = width;
+  info.height = height;
+  info.frameThreads = true;
+  info.sliceThreads = true;
+  return info;
+}
+
+// feeds a window of 25 fps frames which spend load of their duration in the decoder
+bool AddWindow(CDVDVideoCodecFFmpegThreading& threading, double load)
+{
+  bool complete = false;
+  for (int i = 0; i < 50; i++)
+    complete = threading.AddFrame(0.04 * load, 0.04) || complete;
+  return complete;
+}
+}
+
+TEST(TestDVDVideoCodecFFmpegThreading, Init)
+{
+  CDVDVideoCodecFFmpegThreading threading;
+  EXPECT_FALSE(threading.IsInitialized());
+
+  threading.Init(GetInfo(AV_CODEC_ID_H264, FF_PROFILE_H264_HIGH, 1920, 1080), 4);
+  EXPECT_TRUE(threading.IsInitialized());
+  EXPECT_EQ(FF_THREAD_FRAME, threading.GetThreadType());
+  EXPECT_EQ(3, threading.GetThreadCount());
+  EXPECT_EQ("frame x 3", threading.GetDescription());
+  EXPECT_FALSE(threading.HasChange());
+
+  // heavy streams are limited to one and a half threads per cpu
+  threading.Init(GetInfo(AV_CODEC_ID_HEVC, FF_PROFILE_HEVC_MAIN_10, 3840, 2160), 4);
+  EXPECT_EQ(FF_THREAD_FRAME, threading.GetThreadType());
+  EXPECT_EQ(6, threading.GetThreadCount());
+
+  // light streams use slice threading and at least two threads
+  threading.Init(GetInfo(AV_CODEC_ID_MPEG2VIDEO, FF_PROFILE_UNKNOWN, 720, 576), 8);
+  EXPECT_EQ(FF_THREAD_SLICE, threading.GetThreadType());
+  EXPECT_EQ(2, threading.GetThreadCount());
+  EXPECT_EQ("slice x 2", threading.GetDescription());
+
+  threading.Init(GetInfo(AV_CODEC_ID_H264, FF_PROFILE_H264_HIGH, 1920, 1080), 1);
+  EXPECT_EQ(1, threading.GetThreadCount());
+}
+
+TEST(TestDVDVideoCodecFFmpegThreading, Capabilities)
+{
+  CDVDVideoCodecFFmpegThreading threading;
+  CDVDVideoCodecFFmpegThreading::StreamInfo info =
+      GetInfo(AV_CODEC_ID_MPEG2VIDEO, FF_PROFILE_UNKNOWN, 720, 576);
+
+  info.sliceThreads = false;
+  threading.Init(info, 4);
+  EXPECT_EQ(FF_THREAD_FRAME, threading.GetThreadType());
+
+  info.frameThreads = false;
+  threading.Init(info, 4);
+  EXPECT_EQ(0, threading.GetThreadType());
+  EXPECT_EQ(1, threading.GetThreadCount());
+  EXPECT_EQ("", threading.GetDescription());
+
+  // a decoder without threads never asks for more
+  EXPECT_TRUE(AddWindow(threading, 2.0));
+  EXPECT_FALSE(threading.HasChange());
+}
+
+TEST(TestDVDVideoCodecFFmpegThreading, Window)
+{
+  CDVDVideoCodecFFmpegThreading threading;
+  threading.Init(GetInfo(AV_CODEC_ID_H264, FF_PROFILE_H264_HIGH, 1920, 1080), 4);
+
+  // at least 30 frames
+  for (int i = 0; i < 29; i++)
+    EXPECT_FALSE(threading.AddFrame(0.1, 1.0));
+  EXPECT_TRUE(threading.AddFrame(0.1, 1.0));
+  EXPECT_DOUBLE_EQ(0.1, threading.GetDecodeTime());
+
+  // and at least 2 seconds
+  for (int i = 0; i < 49; i++)
+    EXPECT_FALSE(threading.AddFrame(0.01, 0.02));
+  EXPECT_FALSE(threading.AddFrame(0.01, 0.0));
+  EXPECT_TRUE(AddWindow(threading, 0.5));
+
+  threading.ResetMeasurement();
+  EXPECT_FALSE(threading.AddFrame(0.01, 0.04));
+}
+
+TEST(TestDVDVideoCodecFFmpegThreading, MoreThreads)
+{
+  CDVDVideoCodecFFmpegThreading threading;
+  threading.Init(GetInfo(AV_CODEC_ID_H264, FF_PROFILE_H264_HIGH, 1920, 1080), 4);
+
+  EXPECT_TRUE(AddWindow(threading, 0.5));
+  EXPECT_NEAR(0.02, threading.GetDecodeTime(), 1e-9);
+  EXPECT_FALSE(threading.HasChange());
+  EXPECT_TRUE(AddWindow(threading, 0.8));
+  EXPECT_FALSE(threading.HasChange());
+
+  EXPECT_TRUE(AddWindow(threading, 0.9));
+  EXPECT_TRUE(threading.HasChange());
+  // the change waits for the decoder
+  EXPECT_EQ(3, threading.GetThreadCount());
+  threading.ApplyChange();
+  EXPECT_FALSE(threading.HasChange());
+  EXPECT_EQ(FF_THREAD_FRAME, threading.GetThreadType());
+  EXPECT_EQ(5, threading.GetThreadCount());
+
+  // up to two threads per cpu
+  AddWindow(threading, 0.9);
+  threading.ApplyChange();
+  EXPECT_EQ(7, threading.GetThreadCount());
+  AddWindow(threading, 0.9);
+  threading.ApplyChange();
+  EXPECT_EQ(8, threading.GetThreadCount());
+
+  // and a limited number of changes
+  AddWindow(threading, 0.9);
+  EXPECT_FALSE(threading.HasChange());
+}
+
+TEST(TestDVDVideoCodecFFmpegThreading, SliceToFrame)
+{
+  CDVDVideoCodecFFmpegThreading threading;
+  threading.Init(GetInfo(AV_CODEC_ID_MPEG2VIDEO, FF_PROFILE_UNKNOWN, 720, 576), 4);
+  EXPECT_EQ(FF_THREAD_SLICE, threading.GetThreadType());
+
+  AddWindow(threading, 1.2);
+  EXPECT_TRUE(threading.HasChange());
+  threading.ApplyChange();
+  EXPECT_EQ(FF_THREAD_FRAME, threading.GetThreadType());
+  EXPECT_EQ(4, threading.GetThreadCount());
+  EXPECT_EQ("frame x 4", threading.GetDescription());
+}
@@ -0,0 +1,224 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/VideoRenderers/VideoBufferPBO.h"
+#include "threads/SingleLock.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const int WIDTH = 64;
+const int HEIGHT = 48;
+const int SIZE = WIDTH * HEIGHT * 3 / 2;
+
+// system memory instead of a mapped buffer object, tests don't have a gl context
+class CTestVideoBufferPBO : public CVideoBufferPBO
+{
+public:
+  CTestVideoBufferPBO(int id, bool fail)
+  : CVideoBufferPBO(id), m_fail(fail)
+  {
+  }
+
+protected:
+  bool Alloc(AVPixelFormat format, int size) override
+  {
+    if (m_fail)
+      return false;
+
+    // only what the pool reads, the buffers of the budget test are large
+    m_memory.resize(std::min(size, 4 * 1024 * 1024) + 128);
+    m_mapped = m_memory.data();
+    m_data = reinterpret_cast<uint8_t*>((reinterpret_cast<uintptr_t>(m_mapped) + 127) & ~63);
+    m_pbo = m_id + 1;
+    m_size = size;
+    m_pixFormat = format;
+    return true;
+  }
+
+  void Free() override
+  {
+    m_memory.clear();
+    m_pbo = 0;
+    m_mapped = nullptr;
+    m_data = nullptr;
+  }
+
+  bool m_fail;
+  std::vector<uint8_t> m_memory;
+};
+
+class CTestVideoBufferPoolPBO : public CVideoBufferPoolPBO
+{
+public:
+  int GetCount()
+  {
+    CSingleLock lock(m_critSection);
+    return std::count_if(m_all.begin(), m_all.end(),
+                         [](CVideoBufferPBO* buf) { return buf != nullptr; });
+  }
+
+  bool m_fail = false;
+
+protected:
+  CVideoBufferPBO* CreateBuffer(int id) override
+  {
+    return new CTestVideoBufferPBO(id, m_fail);
+  }
+};
+}
+
+class TestVideoBufferPBO : public ::testing::Test
+{
+protected:
+  TestVideoBufferPBO() : m_pool(std::make_shared<CTestVideoBufferPoolPBO>()) {}
+
+  // buffers still in use would be left to a gl context
+  ~TestVideoBufferPBO() override { m_pool->Dispose(); }
+
+  // the decoder misses buffers, the render thread adds them
+  void Add(int count)
+  {
+    for (int i = 0; i < count; i++)
+      EXPECT_EQ(nullptr, m_pool->Get());
+    m_pool->Update();
+  }
+
+  std::shared_ptr<CTestVideoBufferPoolPBO> m_pool;
+};
+
+TEST_F(TestVideoBufferPBO, GetAndReturn)
+{
+  EXPECT_FALSE(m_pool->IsConfigured());
+  EXPECT_EQ(nullptr, m_pool->Get());
+
+  m_pool->Configure(AV_PIX_FMT_YUV420P, SIZE);
+  EXPECT_TRUE(m_pool->IsConfigured());
+  EXPECT_TRUE(m_pool->IsCompatible(AV_PIX_FMT_YUV420P, SIZE));
+  EXPECT_FALSE(m_pool->IsCompatible(AV_PIX_FMT_YUV420P10, SIZE));
+
+  Add(1);
+  EXPECT_EQ(1, m_pool->GetCount());
+  CVideoBuffer* buffer = m_pool->Get();
+  ASSERT_NE(nullptr, buffer);
+  EXPECT_EQ(AV_PIX_FMT_YUV420P, buffer->GetFormat());
+  EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(buffer->GetMemPtr()) % 64);
+  EXPECT_EQ(nullptr, m_pool->Get());
+
+  const int id = buffer->GetId();
+  buffer->Release();
+  buffer = m_pool->Get();
+  ASSERT_NE(nullptr, buffer);
+  EXPECT_EQ(id, buffer->GetId());
+  buffer->Release();
+}
+
+TEST_F(TestVideoBufferPBO, Limits)
+{
+  m_pool->Configure(AV_PIX_FMT_YUV420P, SIZE);
+
+  // a few per update
+  Add(10);
+  EXPECT_EQ(4, m_pool->GetCount());
+
+  // and no more than MAX_BUFFERS
+  std::vector<CVideoBuffer*> buffers;
+  for (int i = 0; i < 20; i++)
+  {
+    CVideoBuffer* buffer;
+    while ((buffer = m_pool->Get()))
+      buffers.push_back(buffer);
+    Add(4);
+  }
+  EXPECT_EQ(CVideoBufferPoolPBO::MAX_BUFFERS, m_pool->GetCount());
+  for (auto buffer : buffers)
+    buffer->Release();
+
+  // large frames are limited by MAX_BYTES, a new configuration frees the free buffers
+  m_pool->Configure(AV_PIX_FMT_YUV420P10, CVideoBufferPoolPBO::MAX_BYTES / 3);
+  Add(10);
+  EXPECT_EQ(3, m_pool->GetCount());
+  buffers.clear();
+  for (int i = 0; i < 3; i++)
+    buffers.push_back(m_pool->Get());
+  Add(10);
+  EXPECT_EQ(3, m_pool->GetCount());
+  for (auto buffer : buffers)
+  {
+    ASSERT_NE(nullptr, buffer);
+    buffer->Release();
+  }
+}
+
+TEST_F(TestVideoBufferPBO, MapFailure)
+{
+  m_pool->Configure(AV_PIX_FMT_YUV420P, SIZE);
+
+  // a failed map stops adding buffers for a while
+  m_pool->m_fail = true;
+  Add(1);
+  EXPECT_EQ(0, m_pool->GetCount());
+  m_pool->m_fail = false;
+  for (int i = 0; i < CVideoBufferPoolPBO::RETRY_UPDATES; i++)
+    Add(1);
+  EXPECT_EQ(0, m_pool->GetCount());
+  Add(1);
+  EXPECT_EQ(1, m_pool->GetCount());
+
+  // failures in a row dispose the pool
+  CVideoBuffer* buffer = m_pool->Get();
+  ASSERT_NE(nullptr, buffer);
+  m_pool->m_fail = true;
+  for (int i = 0; i < CVideoBufferPoolPBO::MAX_FAILURES; i++)
+  {
+    for (int j = 0; j <= CVideoBufferPoolPBO::RETRY_UPDATES; j++)
+      Add(1);
+  }
+  buffer->Release();
+  EXPECT_EQ(nullptr, m_pool->Get());
+  m_pool->m_fail = false;
+  Add(1);
+  EXPECT_EQ(nullptr, m_pool->Get());
+}
+
+TEST_F(TestVideoBufferPBO, PlaneOffsets)
+{
+  m_pool->Configure(AV_PIX_FMT_YUV420P, SIZE);
+  Add(1);
+  CVideoBuffer* buffer = m_pool->Get();
+  ASSERT_NE(nullptr, buffer);
+
+  uint8_t* data = buffer->GetMemPtr();
+  uint8_t* planes[YuvImage::MAX_PLANES] = {data, data + WIDTH * HEIGHT,
+                                           data + WIDTH * HEIGHT * 5 / 4};
+  uintptr_t offsets[YuvImage::MAX_PLANES];
+  EXPECT_EQ(static_cast<GLuint>(buffer->GetId() + 1), m_pool->GetPlaneOffsets(planes, offsets));
+  EXPECT_EQ(static_cast<uintptr_t>(WIDTH * HEIGHT), offsets[1] - offsets[0]);
+  EXPECT_EQ(static_cast<uintptr_t>(WIDTH * HEIGHT / 4), offsets[2] - offsets[1]);
+
+  // planes which aren't all in a buffer are uploaded by copying
+  planes[2] = data + SIZE;
+  EXPECT_EQ(0U, m_pool->GetPlaneOffsets(planes, offsets));
+  uint8_t other[SIZE];
+  planes[0] = planes[1] = planes[2] = other;
+  EXPECT_EQ(0U, m_pool->GetPlaneOffsets(planes, offsets));
+
+  buffer->Release();
+}
+
+TEST_F(TestVideoBufferPBO, IsReadFast)
+{
+  std::vector<uint8_t> memory(SIZE, 0);
+  EXPECT_TRUE(CVideoBufferPoolPBO::IsReadFast(memory.data(), SIZE));
+  EXPECT_TRUE(CVideoBufferPoolPBO::IsReadFast(nullptr, 0));
+}
@@ -27,6 +27,8 @@
 #include "platform/posix/ConvUtils.h"
 #endif
 
+#include <algorithm>
+
 using namespace dbiplus;
 
 #define MAX_COMPRESS_COUNT 20
@@ -221,6 +223,8 @@ CDatabase::CDatabase() :
   m_sqlite = true;
   m_bMultiWrite = false;
   m_multipleExecute = false;
+  m_bulkInsert = false;
+  m_savepoints = 0;
 }
 
 CDatabase::~CDatabase(void)
@@ -301,6 +305,69 @@ bool CDatabase::DeleteValues(const std::string &strTable, const Filter &filter /
   return ExecuteQuery(strQuery);
 }
 
+bool CDatabase::AddDirtyPaths(const std::map<std::string, bool> &paths)
+{
+  if (nullptr == m_pDB || nullptr == m_pDS)
+    return false;
+
+  try
+  {
+    BeginTransaction();
+    for (const auto& path : paths)
+    {
+      // re-add the path so it gets a new id, it may already be part of a scan in progress
+      bool recursive = path.second;
+      m_pDS->query(PrepareSQL("SELECT scanRecursive FROM dirtypath WHERE strPath='%s'", path.first.c_str()));
+      if (!m_pDS->eof())
+        recursive |= m_pDS->fv(0).get_asBool();
+      m_pDS->close();
+
+      m_pDS->exec(PrepareSQL("DELETE FROM dirtypath WHERE strPath='%s'", path.first.c_str()));
+      m_pDS->exec(PrepareSQL("INSERT INTO dirtypath (idDirtyPath, strPath, scanRecursive) VALUES (NULL, '%s', %i)",
+                             path.first.c_str(), recursive ? 1 : 0));
+    }
+    return CommitTransaction();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+    RollbackTransaction();
+  }
+  return false;
+}
+
+bool CDatabase::GetDirtyPaths(std::map<std::string, bool> &paths, int &lastId)
+{
+  lastId = -1;
+  if (nullptr == m_pDB || nullptr == m_pDS)
+    return false;
+
+  try
+  {
+    if (!m_pDS->query("SELECT idDirtyPath, strPath, scanRecursive FROM dirtypath"))
+      return false;
+
+    while (!m_pDS->eof())
+    {
+      lastId = std::max(lastId, m_pDS->fv(0).get_asInt());
+      paths[m_pDS->fv(1).get_asString()] |= m_pDS->fv(2).get_asBool();
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
+bool CDatabase::ClearDirtyPaths(int lastId)
+{
+  return ExecuteQuery(PrepareSQL("DELETE FROM dirtypath WHERE idDirtyPath <= %i", lastId));
+}
+
 bool CDatabase::BeginMultipleExecute()
 {
   m_multipleExecute = true;
@@ -352,6 +419,28 @@ bool CDatabase::ExecuteQuery(const std::string &strQuery)
   return bReturn;
 }
 
+bool CDatabase::ExecuteStatement(const std::string &strStatement, const std::vector<field_value> &values)
+{
+  bool bReturn = false;
+
+  try
+  {
+    if (nullptr == m_pDB)
+      return bReturn;
+    if (nullptr == m_pDS)
+      return bReturn;
+    m_pDS->exec(strStatement, values);
+    bReturn = true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to execute statement '%s'",
+        __FUNCTION__, strStatement.c_str());
+  }
+
+  return bReturn;
+}
+
 bool CDatabase::ResultQuery(const std::string &strQuery)
 {
   bool bReturn = false;
@@ -599,6 +688,14 @@ void CDatabase::Close()
     return;
   }
 
+  if (m_bulkInsert)
+  {
+    // an item left halfway is undone, the finished ones are kept
+    while (m_savepoints > 0)
+      RollbackTransaction();
+    CommitBulkInsert();
+  }
+
   m_openCount = 0;
   m_multipleExecute = false;
 
@@ -659,7 +756,15 @@ void CDatabase::BeginTransaction()
 {
   try
   {
-    if (nullptr != m_pDB)
+    if (nullptr == m_pDB)
+      return;
+
+    if (m_bulkInsert)
+    {
+      // nested in the bulk insert transaction
+      m_pDS->exec(PrepareSQL("SAVEPOINT level%u", ++m_savepoints));
+    }
+    else
       m_pDB->start_transaction();
   }
   catch (...)
@@ -672,7 +777,16 @@ bool CDatabase::CommitTransaction()
 {
   try
   {
-    if (nullptr != m_pDB)
+    if (nullptr == m_pDB)
+      return true;
+
+    if (m_bulkInsert)
+    {
+      // the changes are committed with the bulk insert
+      if (m_savepoints > 0)
+        m_pDS->exec(PrepareSQL("RELEASE SAVEPOINT level%u", m_savepoints--));
+    }
+    else
       m_pDB->commit_transaction();
   }
   catch (...)
@@ -687,7 +801,25 @@ void CDatabase::RollbackTransaction()
 {
   try
   {
-    if (nullptr != m_pDB)
+    if (nullptr == m_pDB)
+      return;
+
+    if (m_bulkInsert)
+    {
+      // only undo the changes made since the matching BeginTransaction()
+      if (m_savepoints > 0)
+      {
+        m_pDS->exec(PrepareSQL("ROLLBACK TO SAVEPOINT level%u", m_savepoints));
+        m_pDS->exec(PrepareSQL("RELEASE SAVEPOINT level%u", m_savepoints--));
+      }
+      else
+      {
+        // not nested, the whole bulk insert is undone and ends here
+        m_bulkInsert = false;
+        m_pDB->rollback_transaction();
+      }
+    }
+    else
       m_pDB->rollback_transaction();
   }
   catch (...)
@@ -696,6 +828,28 @@ void CDatabase::RollbackTransaction()
   }
 }
 
+bool CDatabase::BeginBulkInsert()
+{
+  if (nullptr == m_pDB || m_bulkInsert)
+    return false;
+
+  BeginTransaction();
+  m_bulkInsert = true;
+  m_savepoints = 0;
+  return true;
+}
+
+bool CDatabase::CommitBulkInsert()
+{
+  if (!m_bulkInsert)
+    return false;
+
+  // savepoints that were never released are committed along with everything else
+  m_bulkInsert = false;
+  m_savepoints = 0;
+  return CommitTransaction();
+}
+
 bool CDatabase::CreateDatabase()
 {
   BeginTransaction();
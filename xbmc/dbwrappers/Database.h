@@ -11,8 +11,10 @@
 namespace dbiplus {
   class Database;
   class Dataset;
+  class field_value;
 }
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -146,6 +148,16 @@ public:
    */
   bool ExecuteQuery(const std::string &strQuery);
 
+  /*!
+   * @brief Execute a statement that does not return any result, binding values to its '?' placeholders.
+   *        The statement is compiled once and reused for subsequent calls with the same strStatement,
+   *        so it should be a constant string rather than one built with PrepareSQL().
+   * @param strStatement The statement to execute.
+   * @param values The values for the placeholders, in order.
+   * @return True if the statement was executed successfully, false otherwise.
+   */
+  bool ExecuteStatement(const std::string &strStatement, const std::vector<dbiplus::field_value> &values);
+
   /*!
    * @brief Execute a query that returns a result.
    * @remarks Call m_pDS->close(); to clean up the dataset when done.
@@ -187,6 +199,54 @@ public:
    */
   bool CommitInsertQueries();
 
+  /*!
+   * @brief Start a bulk insert. Everything up to CommitBulkInsert() is performed
+   *        within a single transaction. Transactions started in the meantime are
+   *        turned into savepoints, so they can still be rolled back on their own.
+   *        RollbackTransaction() outside of those undoes and ends the whole bulk insert,
+   *        Close() commits it after undoing the unfinished savepoints.
+   * @return true if the bulk insert was started, false if one is already running.
+   * @sa CommitBulkInsert, InBulkInsert
+   */
+  bool BeginBulkInsert();
+
+  /*!
+   * @brief Commit the transaction started by BeginBulkInsert().
+   * @return True if the transaction was committed successfully, false otherwise.
+   * @sa BeginBulkInsert
+   */
+  bool CommitBulkInsert();
+
+  /*!
+   * @brief Whether a bulk insert is running.
+   * @sa BeginBulkInsert
+   */
+  bool InBulkInsert() const { return m_bulkInsert; }
+
+  /*!
+   * @brief Record directories that changed on disk, so the next library update only has to rescan those.
+   *        The dirtypath table is created by the child classes that support it.
+   * @param paths The changed directories, mapped to whether changes anywhere below them may have been missed.
+   * @return True if the paths were recorded successfully, false otherwise.
+   * @sa GetDirtyPaths, ClearDirtyPaths, CLibraryMonitor
+   */
+  bool AddDirtyPaths(const std::map<std::string, bool> &paths);
+
+  /*!
+   * @brief Get the directories recorded by AddDirtyPaths().
+   * @param paths [out] The changed directories, mapped to whether they have to be rescanned recursively.
+   * @param lastId [out] The id of the last recorded directory, to pass to ClearDirtyPaths() once they were scanned.
+   * @return True if the paths were retrieved successfully, false otherwise.
+   */
+  bool GetDirtyPaths(std::map<std::string, bool> &paths, int &lastId);
+
+  /*!
+   * @brief Remove the directories retrieved by GetDirtyPaths(), keeping those recorded since.
+   * @param lastId The id returned by GetDirtyPaths().
+   * @return True if the paths were removed successfully, false otherwise.
+   */
+  bool ClearDirtyPaths(int lastId);
+
   virtual bool GetFilter(CDbUrl &dbUrl, Filter &filter, SortDescription &sorting) { return true; }
   virtual bool BuildSQL(const std::string &strBaseDir, const std::string &strQuery, Filter &filter, std::string &strSQL, CDbUrl &dbUrl);
   virtual bool BuildSQL(const std::string &strBaseDir, const std::string &strQuery, Filter &filter, std::string &strSQL, CDbUrl &dbUrl, SortDescription &sorting);
@@ -253,4 +313,7 @@ private:
 
   bool m_multipleExecute;
   std::vector<std::string> m_multipleQueries;
+
+  bool m_bulkInsert;
+  unsigned int m_savepoints; /*!< Number of transactions nested in the bulk insert */
 };
@@ -290,6 +290,10 @@ public:
 /* func. executes a query without results to return */
   virtual int  exec (const std::string &sql) = 0;
   virtual int  exec() = 0;
+/* func. executes a statement with '?' placeholders bound to params, without
+   results to return. The compiled statement is cached by the database and
+   reused by subsequent calls with the same sql */
+  virtual int  exec (const std::string &sql, const std::vector<field_value> &params) = 0;
   virtual const void* getExecRes()=0;
 /* as open, but with our query exec Sql */
   virtual bool query(const std::string &sql) = 0;
@@ -10,6 +10,8 @@
 #include <string>
 #include <set>
 #include <algorithm>
+#include <cstring>
+#include <vector>
 
 #include "utils/log.h"
 #include "network/WakeOnAccess.h"
@@ -30,6 +32,9 @@
 #define MYSQL_OK          0
 #define ER_BAD_DB_ERROR   1049
 
+// maximum number of prepared statements kept by MysqlDatabase
+#define MAX_CACHED_STATEMENTS 64
+
 namespace dbiplus {
 
 //************* MysqlDatabase implementation ***************
@@ -258,6 +263,9 @@ int MysqlDatabase::connect(bool create_new) {
 }
 
 void MysqlDatabase::disconnect(void) {
+  // statements belong to the connection, they have to be prepared again after reconnecting
+  clearStatements();
+
   if (conn != NULL)
   {
     mysql_close(conn);
@@ -461,6 +469,65 @@ int MysqlDatabase::query_with_reconnect(const char* query) {
   return result;
 }
 
+int MysqlDatabase::execute_with_reconnect(const std::string &sql, MYSQL_BIND *params, unsigned long count) {
+  int attempts = 5;
+  int result;
+
+  // try to reconnect if server is gone
+  while ( ((result = execute_statement(sql, params, count)) != MYSQL_OK) &&
+          (result == CR_SERVER_GONE_ERROR || result == CR_SERVER_LOST) &&
+          (attempts-- > 0) )
+  {
+    CLog::Log(LOGINFO,"MYSQL server has gone. Will try %d more attempt(s) to reconnect.", attempts);
+    active = false;
+    connect(true);
+  }
+
+  return result;
+}
+
+int MysqlDatabase::execute_statement(const std::string &sql, MYSQL_BIND *params, unsigned long count) {
+  MYSQL_STMT *stmt;
+
+  auto it = statements.find(sql);
+  if (it != statements.end())
+    stmt = it->second;
+  else
+  {
+    if ((stmt = mysql_stmt_init(conn)) == NULL)
+      return mysql_errno(conn);
+
+    if (mysql_stmt_prepare(stmt, sql.c_str(), sql.size()) != MYSQL_OK)
+    {
+      int result = mysql_stmt_errno(stmt);
+      mysql_stmt_close(stmt);
+      return result;
+    }
+
+    // the statements used are a handful of inserts and updates, so rather than
+    // tracking usage just start over should some caller use dynamic sql
+    if (statements.size() >= MAX_CACHED_STATEMENTS)
+      clearStatements();
+
+    statements.insert(std::make_pair(sql, stmt));
+  }
+
+  if (mysql_stmt_param_count(stmt) != count)
+    return CR_UNKNOWN_ERROR;
+
+  if (mysql_stmt_bind_param(stmt, params) != MYSQL_OK ||
+      mysql_stmt_execute(stmt) != MYSQL_OK)
+    return mysql_stmt_errno(stmt);
+
+  return MYSQL_OK;
+}
+
+void MysqlDatabase::clearStatements() {
+  for (auto &it : statements)
+    mysql_stmt_close(it.second);
+  statements.clear();
+}
+
 long MysqlDatabase::nextid(const char* sname) {
   CLog::Log(LOGDEBUG,"MysqlDatabase::nextid for %s",sname);
   if (!active) return DB_UNEXPECTED_RESULT;
@@ -1543,6 +1610,65 @@ int MysqlDataset::exec() {
    return exec(sql);
 }
 
+int MysqlDataset::exec(const std::string &sql, const std::vector<field_value> &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+  exec_res.clear();
+
+  // the bind structures only point to the values, so keep them alive until executed
+  std::vector<MYSQL_BIND> binds(params.size());
+  std::vector<long long> ints(params.size());
+  std::vector<double> doubles(params.size());
+  std::vector<std::string> strings(params.size());
+  if (!binds.empty())
+    memset(binds.data(), 0, binds.size() * sizeof(MYSQL_BIND));
+
+  for (unsigned int i = 0; i < params.size(); i++)
+  {
+    const field_value &param = params[i];
+    MYSQL_BIND &bind = binds[i];
+    if (param.get_isNull())
+    {
+      bind.buffer_type = MYSQL_TYPE_NULL;
+      continue;
+    }
+
+    switch (param.get_fType())
+    {
+      case ft_Boolean:
+      case ft_Char:
+      case ft_Short:
+      case ft_UShort:
+      case ft_Int:
+      case ft_UInt:
+      case ft_Int64:
+        ints[i] = param.get_asInt64();
+        bind.buffer_type = MYSQL_TYPE_LONGLONG;
+        bind.buffer = &ints[i];
+        break;
+      case ft_Float:
+      case ft_Double:
+        doubles[i] = param.get_asDouble();
+        bind.buffer_type = MYSQL_TYPE_DOUBLE;
+        bind.buffer = &doubles[i];
+        break;
+      default:
+        strings[i] = param.get_asString();
+        bind.buffer_type = MYSQL_TYPE_STRING;
+        bind.buffer = const_cast<char*>(strings[i].c_str());
+        bind.buffer_length = strings[i].size();
+        break;
+    }
+  }
+
+  CLog::Log(LOGDEBUG,"Mysql execute: %s", sql.c_str());
+
+  MysqlDatabase *mysqlDb = static_cast<MysqlDatabase*>(db);
+  if (db->setErr(mysqlDb->execute_with_reconnect(sql, binds.empty() ? NULL : binds.data(), binds.size()), sql.c_str()) != MYSQL_OK)
+    throw DbErrors(db->getErrorMsg());
+
+  return MYSQL_OK;
+}
+
 const void* MysqlDataset::getExecRes() {
   return &exec_res;
 }
@@ -1580,15 +1706,16 @@ bool MysqlDataset::query(const std::string &query) {
   result.record_header.resize(numColumns);
   for (unsigned int i = 0; i < numColumns; i++)
     result.record_header[i].name = fields[i].name;
+  result.records.reset(numColumns);
 
   // returned rows
   while ((row = mysql_fetch_row(stmt)))
   { // have a row of data
-    sql_record *res = new sql_record;
-    res->resize(numColumns);
+    const unsigned long *lengths = mysql_fetch_lengths(stmt);
+    const unsigned int rowIndex = result.records.add_row();
     for (unsigned int i = 0; i < numColumns; i++)
     {
-      field_value &v = res->at(i);
+      field_value &v = result.records.value(rowIndex, i);
       switch (fields[i].type)
       {
         case MYSQL_TYPE_LONGLONG:
@@ -1621,23 +1748,19 @@ bool MysqlDataset::query(const std::string &query) {
         case MYSQL_TYPE_STRING:
         case MYSQL_TYPE_VAR_STRING:
         case MYSQL_TYPE_VARCHAR:
-          if (row[i] != NULL) v.set_asString((const char *)row[i] );
-          break;
         case MYSQL_TYPE_TINY_BLOB:
         case MYSQL_TYPE_MEDIUM_BLOB:
         case MYSQL_TYPE_LONG_BLOB:
         case MYSQL_TYPE_BLOB:
-          if (row[i] != NULL) v.set_asString((const char *)row[i]);
+          if (row[i] != NULL) v.set_asStringView(result.records.add_string(row[i], lengths[i]));
           break;
         case MYSQL_TYPE_NULL:
         default:
           CLog::Log(LOGDEBUG,"MYSQL: Unknown field type: %u", fields[i].type);
-          v.set_asString("");
           v.set_isNull();
           break;
       }
     }
-    result.records.push_back(res);
   }
   mysql_free_result(stmt);
   active = true;
@@ -1716,15 +1839,7 @@ void MysqlDataset::next(void) {
 
 void MysqlDataset::free_row(void)
 {
-  if (frecno < 0 || (unsigned int)frecno >= result.records.size())
-    return;
-
-  sql_record *row = result.records[frecno];
-  if (row)
-  {
-    delete row;
-    result.records[frecno] = NULL;
-  }
+  // rows are stored in the result set's column arrays and released by close()
 }
 
 bool MysqlDataset::seek(int pos) {
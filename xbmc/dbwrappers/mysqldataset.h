@@ -8,7 +8,9 @@
 
 #pragma once
 
+#include <map>
 #include <stdio.h>
+#include <string>
 #include "dataset.h"
 #ifdef HAS_MYSQL
 #include <mysql/mysql.h>
@@ -28,6 +30,8 @@ protected:
   MYSQL* conn;
   bool _in_transaction;
   int last_err;
+/* prepared statements used by MysqlDataset::exec(sql, params), keyed by sql */
+  std::map<std::string, MYSQL_STMT*> statements;
 
 
 public:
@@ -76,6 +80,10 @@ public:
 
   bool in_transaction() override {return _in_transaction;};
   int query_with_reconnect(const char* query);
+/* executes a cached prepared statement, preparing it if needed */
+  int execute_with_reconnect(const std::string &sql, MYSQL_BIND *params, unsigned long count);
+/* closes all cached prepared statements */
+  void clearStatements();
   void configure_connection();
 
 private:
@@ -90,6 +98,7 @@ private:
   void mysqlStrAccumReset(StrAccum *p);
   void mysqlStrAccumInit(StrAccum *p, char *zBase, int n, int mx);
   std::string mysql_vmprintf(const char *zFormat, va_list ap);
+  int execute_statement(const std::string &sql, MYSQL_BIND *params, unsigned long count);
 };
 
 
@@ -138,6 +147,7 @@ or insert() operations default = false) */
 /* func. executes a query without results to return */
   int  exec () override;
   int  exec (const std::string &sql) override;
+  int  exec (const std::string &sql, const std::vector<field_value> &params) override;
   const void* getExecRes() override;
 /* as open, but with our query exec Sql */
   bool query(const std::string &query) override;
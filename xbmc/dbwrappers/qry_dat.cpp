@@ -17,8 +17,11 @@
 
 #include "qry_dat.h"
 
+#include <stdexcept>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <utility>
 
 #include "PlatformDefs.h" // for PRId64
 
@@ -33,6 +36,7 @@ namespace dbiplus {
 field_value::field_value()
 {
   field_type = ft_String;
+  str_view = nullptr;
   is_null = false;
 }
 
@@ -40,6 +44,15 @@ field_value::field_value(const char *s):
   str_value(s)
 {
   field_type = ft_String;
+  str_view = nullptr;
+  is_null = false;
+}
+
+field_value::field_value(const std::string &s):
+  str_value(s)
+{
+  field_type = ft_String;
+  str_view = nullptr;
   is_null = false;
 }
 
@@ -100,7 +113,11 @@ field_value::field_value(const int64_t i) {
 field_value::field_value (const field_value & fv) {
   switch (fv.get_fType()) {
     case ft_String: {
-      set_asString(fv.get_asString());
+      // copies own their string, they may outlive the result set a view points into
+      if (fv.str_view)
+        set_asString(fv.str_view);
+      else
+        set_asString(fv.str_value);
       break;
     }
     case ft_Boolean:{
@@ -145,6 +162,14 @@ field_value::field_value (const field_value & fv) {
   is_null = fv.get_isNull();
 }
 
+// moves keep a view, the vectors of a result set move their values when they grow
+field_value::field_value (field_value && fv) noexcept:
+  field_type(fv.field_type),
+  str_value(std::move(fv.str_value)),
+  is_null(fv.is_null)
+{
+  memcpy(&int64_value, &fv.int64_value, sizeof(int64_value));
+}
 
 //empty destructor
 field_value::~field_value() = default;
@@ -155,7 +180,7 @@ std::string field_value::get_asString() const {
     std::string tmp;
     switch (field_type) {
     case ft_String: {
-      tmp = str_value;
+      tmp = str_data();
       return tmp;
     }
     case ft_Boolean:{
@@ -212,7 +237,8 @@ std::string field_value::get_asString() const {
 bool field_value::get_asBool() const {
     switch (field_type) {
     case ft_String: {
-      if (str_value == "True" || str_value == "true" || str_value == "1")
+      const char *str = str_data();
+      if (strcmp(str, "True") == 0 || strcmp(str, "true") == 0 || strcmp(str, "1") == 0)
           return true;
       else
 	return false;
@@ -256,7 +282,7 @@ bool field_value::get_asBool() const {
 char field_value::get_asChar() const {
   switch (field_type) {
     case ft_String: {
-      return str_value[0];
+      return str_data()[0];
     }
     case ft_Boolean:{
       if (bool_value)
@@ -311,7 +337,7 @@ char field_value::get_asChar() const {
 short field_value::get_asShort() const {
     switch (field_type) {
     case ft_String: {
-      return (short)atoi(str_value.c_str());
+      return (short)atoi(str_data());
     }
     case ft_Boolean:{
       return (short)bool_value;
@@ -349,7 +375,7 @@ short field_value::get_asShort() const {
 unsigned short field_value::get_asUShort() const {
     switch (field_type) {
     case ft_String: {
-      return (unsigned short)atoi(str_value.c_str());
+      return (unsigned short)atoi(str_data());
     }
     case ft_Boolean:{
       return (unsigned short)bool_value;
@@ -386,7 +412,7 @@ unsigned short field_value::get_asUShort() const {
 int field_value::get_asInt() const {
     switch (field_type) {
     case ft_String: {
-      return atoi(str_value.c_str());
+      return atoi(str_data());
     }
     case ft_Boolean:{
       return (int)bool_value;
@@ -423,7 +449,7 @@ int field_value::get_asInt() const {
 unsigned int field_value::get_asUInt() const {
     switch (field_type) {
     case ft_String: {
-      return (unsigned int)atoi(str_value.c_str());
+      return (unsigned int)atoi(str_data());
     }
     case ft_Boolean:{
       return (unsigned int)bool_value;
@@ -460,7 +486,7 @@ unsigned int field_value::get_asUInt() const {
 float field_value::get_asFloat() const {
     switch (field_type) {
     case ft_String: {
-      return (float)atof(str_value.c_str());
+      return (float)atof(str_data());
     }
     case ft_Boolean:{
       return (float)bool_value;
@@ -497,7 +523,7 @@ float field_value::get_asFloat() const {
 double field_value::get_asDouble() const {
     switch (field_type) {
     case ft_String: {
-      return atof(str_value.c_str());
+      return atof(str_data());
     }
     case ft_Boolean:{
       return (double)bool_value;
@@ -534,7 +560,7 @@ double field_value::get_asDouble() const {
 int64_t field_value::get_asInt64() const {
     switch (field_type) {
     case ft_String: {
-      return _atoi64(str_value.c_str());
+      return _atoi64(str_data());
     }
     case ft_Boolean:{
       return (int64_t)bool_value;
@@ -576,7 +602,11 @@ field_value& field_value::operator= (const field_value & fv) {
 
   switch (fv.get_fType()) {
     case ft_String: {
-      set_asString(fv.get_asString());
+      // copies own their string, they may outlive the result set a view points into
+      if (fv.str_view)
+        set_asString(fv.str_view);
+      else
+        set_asString(fv.str_value);
       return *this;
       break;
     }
@@ -630,15 +660,32 @@ field_value& field_value::operator= (const field_value & fv) {
     }
 }
 
+field_value& field_value::operator= (field_value && fv) noexcept {
+  if ( this == &fv ) return *this;
+
+  field_type = fv.field_type;
+  str_value = std::move(fv.str_value);
+  memcpy(&int64_value, &fv.int64_value, sizeof(int64_value));
+  is_null = fv.is_null;
+  return *this;
+}
+
 
 
 //Set functions
 void field_value::set_asString(const char *s) {
   str_value = s;
+  str_view = nullptr;
   field_type = ft_String;}
 
 void field_value::set_asString(const std::string & s) {
   str_value = s;
+  str_view = nullptr;
+  field_type = ft_String;}
+
+void field_value::set_asStringView(const char *s) {
+  str_value.clear();
+  str_view = s;
   field_type = ft_String;}
 
 void field_value::set_asBool(const bool b) {
@@ -726,4 +773,81 @@ std::string field_value::gft() {
   return tmp;
   }
 
+
+//sql_record
+const field_value& sql_record::at(unsigned int column) const {
+  if (column >= m_data->columns())
+    throw std::out_of_range("sql_record::at");
+  return m_data->value(m_row, column);
+}
+
+const field_value& sql_record::operator[](unsigned int column) const {
+  return m_data->value(m_row, column);
+}
+
+unsigned int sql_record::size() const {
+  return m_data->columns();
+}
+
+
+//query_data
+namespace {
+// strings are copied into blocks of this size, larger strings get a block of their own
+const size_t STRING_BLOCK_SIZE = 64 * 1024;
+}
+
+void query_data::reset(unsigned int columns) {
+  clear();
+  m_columns.resize(columns);
+}
+
+unsigned int query_data::add_row() {
+  const unsigned int row = static_cast<unsigned int>(m_rows.size());
+  for (auto& column : m_columns)
+    column.emplace_back();
+  m_rows.emplace_back(this, row);
+  return row;
+}
+
+const char* query_data::add_string(const char *s, size_t len) {
+  if (len == 0)
+    return "";
+
+  if (len + 1 > m_stringFree)
+  {
+    if (len + 1 > STRING_BLOCK_SIZE / 4)
+    {
+      m_strings.emplace_back(new char[len + 1]);
+      char *str = m_strings.back().get();
+      memcpy(str, s, len);
+      str[len] = '\0';
+      return str;
+    }
+    m_strings.emplace_back(new char[STRING_BLOCK_SIZE]);
+    m_stringPos = m_strings.back().get();
+    m_stringFree = STRING_BLOCK_SIZE;
+  }
+
+  char *str = m_stringPos;
+  memcpy(str, s, len);
+  str[len] = '\0';
+  m_stringPos += len + 1;
+  m_stringFree -= len + 1;
+  return str;
+}
+
+const sql_record* query_data::at(size_t row) const {
+  if (row >= m_rows.size())
+    throw std::out_of_range("query_data::at");
+  return &m_rows[row];
+}
+
+void query_data::clear() {
+  m_columns.clear();
+  m_rows.clear();
+  m_strings.clear();
+  m_stringPos = nullptr;
+  m_stringFree = 0;
+}
+
 } //namespace
@@ -14,6 +14,7 @@
 
 #include <iostream>
 #include <map>
+#include <memory>
 #include <stdint.h>
 #include <string>
 #include <vector>
@@ -58,6 +59,7 @@ private:
     double double_value;
     int64_t int64_value;
     void   *object_value;
+    const char *str_view; // string not owned by this value, see set_asStringView()
   } ;
 
   bool is_null;
@@ -65,6 +67,7 @@ private:
 public:
   field_value();
   explicit field_value(const char *s);
+  explicit field_value(const std::string &s);
   explicit field_value(const bool b);
   explicit field_value(const char c);
   explicit field_value(const short s);
@@ -75,6 +78,7 @@ public:
   explicit field_value(const double d);
   explicit field_value(const int64_t i);
   field_value(const field_value & fv);
+  field_value(field_value && fv) noexcept;
   ~field_value();
 
   fType get_fType() const {return field_type;}
@@ -111,6 +115,7 @@ public:
   field_value& operator= (const int64_t i)
     {set_asInt64(i); return *this;}
   field_value& operator= (const field_value & fv);
+  field_value& operator= (field_value && fv) noexcept;
 
   //class ostream;
   friend std::ostream& operator<< (std::ostream& os, const field_value &fv)
@@ -165,6 +170,13 @@ public:
   void set_isNull(){is_null=true;}
   void set_asString(const char *s);
   void set_asString(const std::string & s);
+  /*!
+   \brief Reference a string without copying it.
+   The string must stay valid for as long as this value is used. Values stored in a result set
+   reference the result set's string storage, copies of them (e.g. from fv() or the fields of
+   the current row) copy the string.
+   */
+  void set_asStringView(const char *s);
   void set_asBool(const bool b);
   void set_asChar(const char c);
   void set_asShort(const short s);
@@ -177,6 +189,9 @@ public:
 
   fType get_field_type();
   std::string gft();
+
+private:
+  const char *str_data() const { return str_view ? str_view : str_value.c_str(); }
 };
 
 struct field_prop {
@@ -196,29 +211,90 @@ struct field {
 
 
 typedef std::vector<field> Fields;
-typedef std::vector<field_value> sql_record;
 typedef std::vector<field_prop> record_prop;
-typedef std::vector<sql_record*> query_data;
 typedef field_value variant;
 
 //typedef Fields::iterator fld_itor;
-typedef sql_record::iterator rec_itor;
 typedef record_prop::iterator recprop_itor;
-typedef query_data::iterator qry_itor;
+
+class query_data;
+
+/*!
+ \brief A single row of a query_data.
+ */
+class sql_record
+{
+public:
+  sql_record(const query_data *data, unsigned int row) : m_data(data), m_row(row) {}
+
+  const field_value& at(unsigned int column) const;
+  const field_value& operator[](unsigned int column) const;
+  unsigned int size() const;
+
+private:
+  const query_data *m_data;
+  unsigned int m_row;
+};
+
+/*!
+ \brief Rows returned by a query.
+
+ Every column is stored as one contiguous array of values and the text of all string values
+ is kept in a single string arena, so filling a result set doesn't need any allocation per
+ row or per value. String values are views into the arena and are valid until the result set
+ is cleared.
+ */
+class query_data
+{
+public:
+  query_data() = default;
+  query_data(const query_data&) = delete;
+  query_data& operator=(const query_data&) = delete;
+
+  /*!
+   \brief Remove all rows and set the number of columns of the rows added next.
+   */
+  void reset(unsigned int columns);
+
+  /*!
+   \brief Append a row of empty values.
+   \return the index of the new row.
+   */
+  unsigned int add_row();
+
+  field_value& value(unsigned int row, unsigned int column) { return m_columns[column][row]; }
+  const field_value& value(unsigned int row, unsigned int column) const { return m_columns[column][row]; }
+
+  /*!
+   \brief Copy a string into the string arena.
+   \return the zero terminated copy, valid until the result set is cleared.
+   */
+  const char* add_string(const char *s, size_t len);
+
+  unsigned int columns() const { return static_cast<unsigned int>(m_columns.size()); }
+  size_t size() const { return m_rows.size(); }
+  bool empty() const { return m_rows.empty(); }
+
+  const sql_record* at(size_t row) const;
+  const sql_record* operator[](size_t row) const { return &m_rows[row]; }
+
+  void clear();
+
+private:
+  std::vector<std::vector<field_value>> m_columns;
+  std::vector<sql_record> m_rows;
+  std::vector<std::unique_ptr<char[]>> m_strings;
+  char *m_stringPos = nullptr;
+  size_t m_stringFree = 0;
+};
 
 class result_set
 {
 public:
   result_set() = default;
-  ~result_set()
-  {
-    clear();
-  };
+  ~result_set() = default;
   void clear()
   {
-    for (unsigned int i = 0; i < records.size(); i++)
-      if (records[i])
-        delete records[i];
     records.clear();
     record_header.clear();
   };
@@ -10,6 +10,8 @@
  *  See LICENSES/README.md for more information.
  */
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <map>
 #include <string>
@@ -173,26 +175,21 @@ int callback(void* res_ptr,int ncol, char** result,char** cols)
       header.name = cols[i];
       r->record_header.push_back(header);
     }
+    r->records.reset(ncol);
   }
 
   if (result != NULL)
   {
-    sql_record *rec = new sql_record;
-    rec->resize(ncol);
-    for (int i=0; i<ncol; i++)
+    const unsigned int row = r->records.add_row();
+    const unsigned int ncols = std::min(static_cast<unsigned int>(ncol), r->records.columns());
+    for (unsigned int i = 0; i < ncols; i++)
     {
-      field_value &v = rec->at(i);
+      field_value &v = r->records.value(row, i);
       if (result[i] == NULL)
-      {
-        v.set_asString("");
         v.set_isNull();
-      }
       else
-      {
-        v.set_asString(result[i]);
-      }
+        v.set_asStringView(r->records.add_string(result[i], strlen(result[i])));
     }
-    r->records.push_back(rec);
   }
   return 0;
 }
@@ -203,6 +200,9 @@ static int busy_callback(void*, int busyCount)
   return 1;
 }
 
+// maximum number of compiled statements kept by SqliteDatabase::getStatement()
+static const size_t MAX_CACHED_STATEMENTS = 64;
+
 //************* SqliteDatabase implementation ***************
 
 SqliteDatabase::SqliteDatabase() {
@@ -352,6 +352,7 @@ bool SqliteDatabase::exists(void)
 
 void SqliteDatabase::disconnect(void) {
   if (active == false) return;
+  clearStatements();
   sqlite3_close(conn);
   active = false;
 }
@@ -507,6 +508,33 @@ void SqliteDatabase::rollback_transaction() {
 }
 
 
+// methods for compiled statements
+// ---------------------------------------------
+sqlite3_stmt *SqliteDatabase::getStatement(const std::string &sql) {
+  auto it = statements.find(sql);
+  if (it != statements.end())
+    return it->second;
+
+  sqlite3_stmt *stmt = NULL;
+  if (setErr(sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, NULL), sql.c_str()) != SQLITE_OK)
+    throw DbErrors("%s", getErrorMsg());
+
+  // the statements used are a handful of inserts and updates, so rather than
+  // tracking usage just start over should some caller use dynamic sql
+  if (statements.size() >= MAX_CACHED_STATEMENTS)
+    clearStatements();
+
+  statements.insert(std::make_pair(sql, stmt));
+  return stmt;
+}
+
+void SqliteDatabase::clearStatements() {
+  for (auto &it : statements)
+    sqlite3_finalize(it.second);
+  statements.clear();
+}
+
+
 // methods for formatting
 // ---------------------------------------------
 std::string SqliteDatabase::vprepare(const char *format, va_list args)
@@ -774,6 +802,63 @@ int SqliteDataset::exec() {
   return exec(sql);
 }
 
+int SqliteDataset::exec(const std::string &sql, const std::vector<field_value> &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+  exec_res.clear();
+
+  sqlite3_stmt *stmt = static_cast<SqliteDatabase*>(db)->getStatement(sql);
+
+  int res = SQLITE_OK;
+  for (unsigned int i = 0; i < params.size() && res == SQLITE_OK; i++)
+  {
+    const field_value &param = params[i];
+    if (param.get_isNull())
+    {
+      res = sqlite3_bind_null(stmt, i + 1);
+      continue;
+    }
+
+    switch (param.get_fType())
+    {
+      case ft_Boolean:
+      case ft_Char:
+      case ft_Short:
+      case ft_UShort:
+      case ft_Int:
+      case ft_UInt:
+      case ft_Int64:
+        res = sqlite3_bind_int64(stmt, i + 1, param.get_asInt64());
+        break;
+      case ft_Float:
+      case ft_Double:
+        res = sqlite3_bind_double(stmt, i + 1, param.get_asDouble());
+        break;
+      default:
+      {
+        const std::string value = param.get_asString();
+        res = sqlite3_bind_text(stmt, i + 1, value.c_str(), value.size(), SQLITE_TRANSIENT);
+        break;
+      }
+    }
+  }
+
+  if (res == SQLITE_OK)
+  {
+    res = sqlite3_step(stmt);
+    if (res == SQLITE_DONE || res == SQLITE_ROW)
+      res = SQLITE_OK;
+  }
+
+  // leave the statement ready for the next call, whatever the outcome
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+
+  if (db->setErr(res, sql.c_str()) != SQLITE_OK)
+    throw DbErrors("%s", db->getErrorMsg());
+
+  return res;
+}
+
 const void* SqliteDataset::getExecRes() {
   return &exec_res;
 }
@@ -798,15 +883,15 @@ bool SqliteDataset::query(const std::string &query) {
   result.record_header.resize(numColumns);
   for (unsigned int i = 0; i < numColumns; i++)
     result.record_header[i].name = sqlite3_column_name(stmt, i);
+  result.records.reset(numColumns);
 
   // returned rows
   while (sqlite3_step(stmt) == SQLITE_ROW)
   { // have a row of data
-    sql_record *res = new sql_record;
-    res->resize(numColumns);
+    const unsigned int row = result.records.add_row();
     for (unsigned int i = 0; i < numColumns; i++)
     {
-      field_value &v = res->at(i);
+      field_value &v = result.records.value(row, i);
       switch (sqlite3_column_type(stmt, i))
       {
       case SQLITE_INTEGER:
@@ -816,19 +901,18 @@ bool SqliteDataset::query(const std::string &query) {
         v.set_asDouble(sqlite3_column_double(stmt, i));
         break;
       case SQLITE_TEXT:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
-        break;
       case SQLITE_BLOB:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
+      {
+        const char *text = (const char *)sqlite3_column_text(stmt, i);
+        v.set_asStringView(result.records.add_string(text, sqlite3_column_bytes(stmt, i)));
         break;
+      }
       case SQLITE_NULL:
       default:
-        v.set_asString("");
         v.set_isNull();
         break;
       }
     }
-    result.records.push_back(res);
   }
   if (db->setErr(sqlite3_finalize(stmt),query.c_str()) == SQLITE_OK)
   {
@@ -916,15 +1000,7 @@ void SqliteDataset::next(void) {
 
 void SqliteDataset::free_row(void)
 {
-  if (frecno < 0 || (unsigned int)frecno >= result.records.size())
-    return;
-
-  sql_record *row = result.records[frecno];
-  if (row)
-  {
-    delete row;
-    result.records[frecno] = NULL;
-  }
+  // rows are stored in the result set's column arrays and released by close()
 }
 
 bool SqliteDataset::seek(int pos) {
@@ -14,7 +14,9 @@
 
 #include "dataset.h"
 
+#include <map>
 #include <stdio.h>
+#include <string>
 
 #include <sqlite3.h>
 
@@ -30,6 +32,8 @@ protected:
   sqlite3 *conn;
   bool _in_transaction;
   int last_err;
+/* compiled statements used by SqliteDataset::exec(sql, params), keyed by sql */
+  std::map<std::string, sqlite3_stmt*> statements;
 
 public:
 /* default constructor */
@@ -82,6 +86,11 @@ public:
 
   bool in_transaction() override {return _in_transaction;};
 
+/* func. returns a cached compiled statement for sql, preparing it if needed */
+  sqlite3_stmt *getStatement(const std::string &sql);
+/* func. finalizes all cached statements */
+  void clearStatements();
+
 };
 
 
@@ -131,6 +140,7 @@ or insert() operations default = false) */
 /* func. executes a query without results to return */
   int  exec () override;
   int  exec (const std::string &sql) override;
+  int  exec (const std::string &sql, const std::vector<field_value> &params) override;
   const void* getExecRes() override;
 /* as open, but with our query exec Sql */
   bool query(const std::string &query) override;
@@ -0,0 +1,235 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/SpecialProtocol.h"
+#include "test/AllocationCounter.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace dbiplus;
+
+class TestDataset : public ::testing::Test
+{
+protected:
+  SqliteDatabase database;
+  std::unique_ptr<Dataset> dataset;
+
+  void SetUp() override
+  {
+    database.setHostName(CSpecialProtocol::TranslatePath("special://temp/").c_str());
+    database.setDatabase("TestDataset");
+    ASSERT_EQ(DB_CONNECTION_OK, database.connect(true));
+    dataset.reset(database.CreateDataset());
+
+    dataset->exec("DROP TABLE IF EXISTS song");
+    dataset->exec("CREATE TABLE song (idSong INTEGER PRIMARY KEY, strTitle TEXT, strPath TEXT, "
+                  "iDuration INTEGER, dRating REAL, strComment TEXT)");
+  }
+
+  void TearDown() override
+  {
+    dataset->close();
+    dataset->exec("DROP TABLE song");
+    dataset.reset();
+    database.disconnect();
+  }
+
+  void AddSongs(int count)
+  {
+    dataset->exec("BEGIN");
+    for (int i = 0; i < count; i++)
+    {
+      // every other comment is NULL, every third one too long for small string optimisation
+      std::string comment = i % 2 ? "NULL" : i % 3 ? "'short'" : "'" + std::string(200, 'a' + i % 26) + "'";
+      dataset->exec("INSERT INTO song VALUES (NULL, 'Title " + std::to_string(i) +
+                    "', '/media/music/Artist " + std::to_string(i % 100) + "/Album/', " +
+                    std::to_string(180 + i) + ", " + std::to_string(i / 2.0) + ", " + comment + ")");
+    }
+    dataset->exec("COMMIT");
+  }
+};
+
+TEST_F(TestDataset, FieldValues)
+{
+  AddSongs(7);
+  ASSERT_TRUE(dataset->query("SELECT * FROM song ORDER BY idSong"));
+  ASSERT_EQ(7, dataset->num_rows());
+
+  for (int i = 0; !dataset->eof(); i++, dataset->next())
+  {
+    EXPECT_EQ(i + 1, dataset->fv("idSong").get_asInt());
+    EXPECT_EQ("Title " + std::to_string(i), dataset->fv("strTitle").get_asString());
+    EXPECT_EQ(180 + i, dataset->fv("iDuration").get_asInt());
+    EXPECT_DOUBLE_EQ(i / 2.0, dataset->fv("dRating").get_asDouble());
+    if (i % 2)
+    {
+      EXPECT_TRUE(dataset->fv("strComment").get_isNull());
+      EXPECT_EQ("", dataset->fv("strComment").get_asString());
+    }
+    else if (i % 3)
+      EXPECT_EQ("short", dataset->fv("strComment").get_asString());
+    else
+      EXPECT_EQ(std::string(200, 'a' + i % 26), dataset->fv("strComment").get_asString());
+  }
+}
+
+TEST_F(TestDataset, ResultSet)
+{
+  AddSongs(1000);
+  ASSERT_TRUE(dataset->query("SELECT idSong, strTitle, strComment FROM song ORDER BY idSong"));
+
+  const result_set& result = dataset->get_result_set();
+  ASSERT_EQ(3u, result.record_header.size());
+  ASSERT_EQ(1000u, result.records.size());
+  EXPECT_THROW(result.records.at(1000), std::out_of_range);
+
+  for (unsigned int i = 0; i < result.records.size(); i++)
+  {
+    const sql_record* const record = result.records.at(i);
+    ASSERT_EQ(3u, record->size());
+    EXPECT_EQ(static_cast<int>(i + 1), record->at(0).get_asInt());
+    EXPECT_EQ("Title " + std::to_string(i), record->at(1).get_asString());
+    EXPECT_EQ(i % 2 == 1, record->at(2).get_isNull());
+  }
+
+  // copies of a value own their string
+  dataset->seek(10);
+  field_value title = dataset->get_sql_record()->at(1);
+  EXPECT_EQ("Title 10", title.get_asString());
+  field_value copy(title);
+  copy.set_asString("changed");
+  EXPECT_EQ("Title 10", title.get_asString());
+  EXPECT_EQ("changed", copy.get_asString());
+
+  field_value assigned;
+  assigned = dataset->get_sql_record()->at(1);
+  field_value current = dataset->fv("strTitle");
+  dataset->next();
+  EXPECT_EQ("Title 11", dataset->fv("strTitle").get_asString());
+  dataset->close();
+  EXPECT_EQ("Title 10", title.get_asString());
+  EXPECT_EQ("Title 10", assigned.get_asString());
+  EXPECT_EQ("Title 10", current.get_asString());
+}
+
+TEST_F(TestDataset, Exec)
+{
+  AddSongs(3);
+  dataset->exec("SELECT strTitle, strComment FROM song ORDER BY idSong");
+
+  const result_set* result = static_cast<const result_set*>(dataset->getExecRes());
+  ASSERT_EQ(3u, result->records.size());
+  EXPECT_EQ("Title 2", result->records[2]->at(0).get_asString());
+  EXPECT_FALSE(result->records[0]->at(1).get_isNull());
+  EXPECT_TRUE(result->records[1]->at(1).get_isNull());
+}
+
+TEST_F(TestDataset, LargeQuery)
+{
+  const int count = 60000;
+  AddSongs(count);
+
+  auto start = std::chrono::steady_clock::now();
+  const uint64_t allocations = GetAllocationCount();
+  ASSERT_TRUE(dataset->query("SELECT * FROM song"));
+  const uint64_t allocated = GetAllocationCount() - allocations;
+  auto queried = std::chrono::steady_clock::now();
+
+  size_t length = 0;
+  for (; !dataset->eof(); dataset->next())
+    length += dataset->fv(2).get_asString().size();
+  auto elapsed = std::chrono::steady_clock::now();
+
+  EXPECT_EQ(count, dataset->num_rows());
+  EXPECT_LT(0u, length);
+  // the strings go to blocks of the string arena and the columns grow by doubling. Values
+  // copied instead of moved on growth would allocate a string for every view.
+  EXPECT_GT(static_cast<uint64_t>(count / 100), allocated);
+  std::cout << "rows: " << count << ", allocations: " << allocated << ", query: "
+            << std::chrono::duration_cast<std::chrono::microseconds>(queried - start).count()
+            << "us, iterate: "
+            << std::chrono::duration_cast<std::chrono::microseconds>(elapsed - queried).count()
+            << "us\n";
+}
+
+TEST_F(TestDataset, ExecParameters)
+{
+  const std::string sql = "INSERT INTO song (strTitle, strPath, iDuration, dRating, strComment) VALUES (?, ?, ?, ?, ?)";
+
+  // quotes need no escaping, the statement is reused
+  for (int i = 0; i < 3; i++)
+  {
+    dataset->exec(sql, { field_value("It's " + std::to_string(i)), field_value("/media/"),
+                         field_value(i == 2 ? int64_t(1) << 40 : int64_t(i)), field_value(1.5 * i),
+                         i == 1 ? field_value() : field_value(std::string(200, 'x')) });
+    EXPECT_EQ(i + 1, dataset->lastinsertid());
+  }
+  std::vector<field_value> params{ field_value("title"), field_value(""), field_value(1), field_value(1.0),
+                                   field_value() };
+  params.back().set_isNull();
+  dataset->exec(sql, params);
+
+  ASSERT_TRUE(dataset->query("SELECT * FROM song ORDER BY idSong"));
+  ASSERT_EQ(4, dataset->num_rows());
+  EXPECT_EQ("It's 0", dataset->fv("strTitle").get_asString());
+  EXPECT_EQ(std::string(200, 'x'), dataset->fv("strComment").get_asString());
+  dataset->next();
+  EXPECT_DOUBLE_EQ(1.5, dataset->fv("dRating").get_asDouble());
+  EXPECT_FALSE(dataset->fv("strComment").get_isNull());
+  dataset->next();
+  EXPECT_EQ(int64_t(1) << 40, dataset->fv("iDuration").get_asInt64());
+  dataset->next();
+  EXPECT_EQ("", dataset->fv("strPath").get_asString());
+  EXPECT_FALSE(dataset->fv("strPath").get_isNull());
+  EXPECT_TRUE(dataset->fv("strComment").get_isNull());
+  dataset->close();
+
+  // a failing statement can be executed again
+  dataset->exec("CREATE UNIQUE INDEX ixSongTitle ON song (strTitle)");
+  EXPECT_THROW(dataset->exec(sql, params), DbErrors);
+  params[0] = field_value("other title");
+  dataset->exec(sql, params);
+  EXPECT_EQ(5, dataset->lastinsertid());
+
+  EXPECT_THROW(dataset->exec("INSERT INTO nosuchtable VALUES (?)", { field_value(1) }), DbErrors);
+}
+
+TEST_F(TestDataset, ExecParametersPerformance)
+{
+  const int count = 10000;
+
+  auto start = std::chrono::steady_clock::now();
+  dataset->exec("BEGIN");
+  for (int i = 0; i < count; i++)
+    dataset->exec(database.prepare("INSERT INTO song (strTitle, strPath, iDuration) VALUES ('%s', '%s', %i)",
+                                   ("Title " + std::to_string(i)).c_str(), "/media/music/", i));
+  dataset->exec("COMMIT");
+  auto formatted = std::chrono::steady_clock::now();
+
+  dataset->exec("BEGIN");
+  for (int i = 0; i < count; i++)
+    dataset->exec("INSERT INTO song (strTitle, strPath, iDuration) VALUES (?, ?, ?)",
+                  { field_value("Title " + std::to_string(i)), field_value("/media/music/"), field_value(i) });
+  dataset->exec("COMMIT");
+  auto bound = std::chrono::steady_clock::now();
+
+  ASSERT_TRUE(dataset->query("SELECT COUNT(*) FROM song"));
+  EXPECT_EQ(2 * count, dataset->fv(0).get_asInt());
+  std::cout << "rows: " << count << ", formatted: "
+            << std::chrono::duration_cast<std::chrono::microseconds>(formatted - start).count()
+            << "us, bound: "
+            << std::chrono::duration_cast<std::chrono::microseconds>(bound - formatted).count()
+            << "us\n";
+}
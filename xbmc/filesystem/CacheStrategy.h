@@ -55,6 +55,16 @@ public:
 
   virtual CCacheStrategy *CreateNew() = 0;
 
+  /*!
+   \brief Fraction of seeks that could be served from data already in the cache
+   */
+  virtual float GetHitRatio() { return 0.0f; }
+
+  /*!
+   \brief Number of bytes served from the cache that would otherwise have been refetched
+   */
+  virtual uint64_t GetBytesSaved() { return 0; }
+
   CEvent m_space;
 protected:
   bool  m_bEndOfInput = false;
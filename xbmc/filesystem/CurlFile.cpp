@@ -434,11 +434,20 @@ void CCurlFile::SetBufferSize(unsigned int size)
   m_bufferSize = size;
 }
 
+void CCurlFile::SetRangeReads(unsigned int connections, unsigned int segmentSize)
+{
+  m_rangeConnections = std::max(connections, 1u);
+  m_rangeSegmentSize = segmentSize;
+}
+
 void CCurlFile::Close()
 {
   if (m_opened && m_forWrite && !m_inError)
       Write(NULL, 0);
 
+  StopRangeReads();
+  m_rangeConnections = 1;
+
   m_state->Disconnect();
   delete m_oldState;
   m_oldState = NULL;
@@ -521,8 +530,8 @@ void CCurlFile::SetCommonOptions(CReadState* state, bool failOnError /* = true *
   if (!m_verifyPeer)
     g_curlInterface.easy_setopt(h, CURLOPT_SSL_VERIFYPEER, 0);
 
-  g_curlInterface.easy_setopt(m_state->m_easyHandle, CURLOPT_URL, m_url.c_str());
-  g_curlInterface.easy_setopt(m_state->m_easyHandle, CURLOPT_TRANSFERTEXT, CURL_OFF);
+  g_curlInterface.easy_setopt(h, CURLOPT_URL, m_url.c_str());
+  g_curlInterface.easy_setopt(h, CURLOPT_TRANSFERTEXT, CURL_OFF);
 
   // setup POST data if it is set (and it may be empty)
   if (m_postdataset)
@@ -1320,6 +1329,12 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
   // We can't seek beyond EOF
   if (m_state->m_fileSize && nextPos > m_state->m_fileSize) return -1;
 
+  if (m_rangeMultiHandle)
+  {
+    SeekRanges(nextPos);
+    return nextPos;
+  }
+
   if(m_state->Seek(nextPos))
     return nextPos;
 
@@ -1402,6 +1417,297 @@ int64_t CCurlFile::GetPosition()
   return m_state->m_filePos;
 }
 
+ssize_t CCurlFile::Read(void* lpBuf, size_t uiBufSize)
+{
+  if (m_rangeConnections > 1 && !m_rangeMultiHandle && !StartRangeReads())
+    m_rangeConnections = 1;
+
+  if (m_rangeMultiHandle)
+    return ReadRanges(lpBuf, uiBufSize);
+
+  return m_state->Read(lpBuf, uiBufSize);
+}
+
+bool CCurlFile::StartRangeReads()
+{
+  if (!m_opened || m_forWrite || !m_seekable || !m_multisession || m_rangeSegmentSize == 0)
+    return false;
+
+  CURL url(m_url);
+  if (!url.IsProtocol("http") && !url.IsProtocol("https"))
+    return false;
+
+  // not worth it if a single range covers the rest of the file
+  const int64_t pos = m_state->m_filePos;
+  const int64_t fileSize = m_state->m_fileSize;
+  if (fileSize - pos <= m_rangeSegmentSize)
+    return false;
+
+  CLog::Log(LOGDEBUG, "CCurlFile::StartRangeReads - Reading with %u connections, segment size %u",
+            m_rangeConnections, m_rangeSegmentSize);
+
+  // the range requests replace the running transfer
+  m_state->Disconnect();
+  m_state->m_filePos = pos;
+  m_state->m_fileSize = fileSize;
+
+  m_rangeMultiHandle = g_curlInterface.multi_init();
+  for (unsigned int i = 0; i < m_rangeConnections; i++)
+  {
+    std::unique_ptr<CReadState> state(new CReadState()); // C++14 - Replace with std::make_unique
+    g_curlInterface.easy_acquire(url.GetProtocol().c_str(),
+                                 url.GetHostName().c_str(),
+                                 &state->m_easyHandle, NULL);
+    state->m_buffer.Create(m_rangeSegmentSize);
+    m_rangeIdle.push_back(std::move(state));
+  }
+
+  m_rangeFetchPos = pos;
+  ScheduleRangeRequests();
+  return true;
+}
+
+void CCurlFile::StopRangeReads()
+{
+  for (auto& request : m_rangeRequests)
+  {
+    AbortRangeRequest(request);
+    m_rangeIdle.push_back(std::move(request.state));
+  }
+  m_rangeRequests.clear();
+
+  for (auto& state : m_rangeIdle)
+    g_curlInterface.easy_release(&state->m_easyHandle, NULL);
+  m_rangeIdle.clear();
+
+  if (m_rangeMultiHandle)
+    g_curlInterface.multi_cleanup(m_rangeMultiHandle);
+  m_rangeMultiHandle = nullptr;
+}
+
+bool CCurlFile::FallbackFromRangeReads()
+{
+  CLog::Log(LOGWARNING, "CCurlFile::FallbackFromRangeReads - Range requests failed, continuing with a single connection");
+
+  const int64_t pos = m_state->m_filePos;
+  StopRangeReads();
+  m_rangeConnections = 1;
+
+  SetCommonOptions(m_state);
+  SetRequestHeaders(m_state);
+
+  m_state->m_filePos = pos;
+  m_state->m_sendRange = true;
+  m_state->m_bRetry = m_allowRetry;
+
+  long response = m_state->Connect(m_bufferSize);
+  if (response < 0 && (m_state->m_fileSize == 0 || m_state->m_fileSize != m_state->m_filePos))
+    return false;
+
+  SetCorrectHeaders(m_state);
+  return true;
+}
+
+void CCurlFile::ScheduleRangeRequests()
+{
+  while (!m_rangeIdle.empty() && m_rangeFetchPos < m_state->m_fileSize)
+  {
+    SRangeRequest request;
+    request.state = std::move(m_rangeIdle.back());
+    request.begin = m_rangeFetchPos;
+    request.end = std::min(m_rangeFetchPos + m_rangeSegmentSize, m_state->m_fileSize);
+    request.done = false;
+    m_rangeIdle.pop_back();
+    m_rangeFetchPos = request.end;
+
+    CReadState* state = request.state.get();
+    SetCommonOptions(state);
+    SetRequestHeaders(state);
+
+    std::string range = StringUtils::Format("%" PRId64 "-%" PRId64, request.begin, request.end - 1);
+    g_curlInterface.easy_setopt(state->m_easyHandle, CURLOPT_RANGE, range.c_str());
+
+    state->m_httpheader.Clear();
+    state->m_filePos = request.begin;
+    state->m_fileSize = request.end;
+    g_curlInterface.multi_add_handle(m_rangeMultiHandle, state->m_easyHandle);
+
+    m_rangeRequests.push_back(std::move(request));
+  }
+}
+
+void CCurlFile::AbortRangeRequest(SRangeRequest& request)
+{
+  if (!request.done)
+    g_curlInterface.multi_remove_handle(m_rangeMultiHandle, request.state->m_easyHandle);
+  request.done = true;
+
+  // keeps the easy handle and the buffer for the next request
+  request.state->Disconnect();
+}
+
+int8_t CCurlFile::PerformRangeRequests()
+{
+  int running = 0;
+  if (g_curlInterface.multi_perform(m_rangeMultiHandle, &running) != CURLM_OK)
+    return FILLBUFFER_FAIL;
+
+  int msgs;
+  CURLMsg* msg;
+  while ((msg = g_curlInterface.multi_info_read(m_rangeMultiHandle, &msgs)))
+  {
+    if (msg->msg != CURLMSG_DONE)
+      continue;
+
+    CURL_HANDLE* easy = msg->easy_handle;
+    CURLcode result = msg->data.result;
+    auto request = std::find_if(m_rangeRequests.begin(), m_rangeRequests.end(),
+                                [easy](const SRangeRequest& r) { return r.state->m_easyHandle == easy; });
+    if (request == m_rangeRequests.end())
+      continue;
+
+    g_curlInterface.multi_remove_handle(m_rangeMultiHandle, easy);
+    request->done = true;
+
+    if (result != CURLE_OK)
+    {
+      CLog::Log(LOGERROR, "CCurlFile::PerformRangeRequests - Failed: %s(%d)", g_curlInterface.easy_strerror(result), result);
+      return FILLBUFFER_FAIL;
+    }
+  }
+
+  for (const auto& request : m_rangeRequests)
+  {
+    CReadState* state = request.state.get();
+    const int64_t received = state->m_filePos + state->m_buffer.getMaxReadSize() + state->m_overflowSize;
+    if (received == state->m_filePos && !request.done)
+      continue;
+
+    // a server ignoring the range sends the whole file instead
+    long response = 0;
+    if (g_curlInterface.easy_getinfo(state->m_easyHandle, CURLINFO_RESPONSE_CODE, &response) == CURLE_OK && response != 206)
+    {
+      CLog::Log(LOGWARNING, "CCurlFile::PerformRangeRequests - Range request answered with %ld", response);
+      return FILLBUFFER_FAIL;
+    }
+
+    if (received > request.end || (request.done && received != request.end))
+    {
+      CLog::Log(LOGWARNING, "CCurlFile::PerformRangeRequests - Got %" PRId64 " bytes for range %" PRId64 "-%" PRId64,
+                received - request.begin, request.begin, request.end - 1);
+      return FILLBUFFER_FAIL;
+    }
+  }
+
+  const SRangeRequest& front = m_rangeRequests.front();
+  if (front.done || front.state->m_buffer.getMaxReadSize() > 0 || front.state->m_overflowSize > 0)
+    return FILLBUFFER_OK;
+
+  // wait for any of the transfers to make progress
+  fd_set fdread;
+  fd_set fdwrite;
+  fd_set fdexcep;
+  int maxfd = -1;
+  FD_ZERO(&fdread);
+  FD_ZERO(&fdwrite);
+  FD_ZERO(&fdexcep);
+  g_curlInterface.multi_fdset(m_rangeMultiHandle, &fdread, &fdwrite, &fdexcep, &maxfd);
+
+  long timeout = 0;
+  if (CURLM_OK != g_curlInterface.multi_timeout(m_rangeMultiHandle, &timeout) || timeout < 0 || timeout > 200)
+    timeout = 200;
+
+#ifdef TARGET_WINDOWS
+  if (maxfd == -1)
+  {
+    Sleep(timeout);
+    return FILLBUFFER_OK;
+  }
+#endif
+  struct timeval wait = { 0, static_cast<int>(timeout) * 1000 };
+  select(maxfd + 1, &fdread, &fdwrite, &fdexcep, &wait);
+
+  return FILLBUFFER_OK;
+}
+
+ssize_t CCurlFile::ReadRanges(void* lpBuf, size_t uiBufSize)
+{
+  while (m_state->m_filePos < m_state->m_fileSize)
+  {
+    if (m_state->m_cancelled)
+      return 0;
+
+    SRangeRequest& request = m_rangeRequests.front();
+    CReadState* state = request.state.get();
+
+    // curl puts what didn't fit into the buffer aside, a finished transfer doesn't move it back
+    if (state->m_buffer.getMaxReadSize() == 0)
+      state->FillFromOverflow();
+
+    // skip what was received before the read position after seeking into the range
+    if (state->m_filePos < m_state->m_filePos)
+    {
+      unsigned int skip = static_cast<unsigned int>(std::min<int64_t>(state->m_buffer.getMaxReadSize(),
+                                                                      m_state->m_filePos - state->m_filePos));
+      state->m_buffer.SkipBytes(skip);
+      state->m_filePos += skip;
+    }
+
+    if (state->m_filePos == m_state->m_filePos && state->m_buffer.getMaxReadSize() > 0)
+    {
+      unsigned int want = std::min<unsigned int>(state->m_buffer.getMaxReadSize(), uiBufSize);
+      state->m_buffer.ReadData(static_cast<char*>(lpBuf), want);
+      state->m_filePos += want;
+      m_state->m_filePos += want;
+
+      // range is used up, hand its connection to the next one
+      if (m_state->m_filePos == request.end)
+      {
+        AbortRangeRequest(request);
+        m_rangeIdle.push_back(std::move(request.state));
+        m_rangeRequests.pop_front();
+        ScheduleRangeRequests();
+      }
+      return want;
+    }
+
+    if (PerformRangeRequests() != FILLBUFFER_OK)
+    {
+      if (!FallbackFromRangeReads())
+        return -1;
+      return m_state->Read(lpBuf, uiBufSize);
+    }
+  }
+
+  return 0;
+}
+
+void CCurlFile::SeekRanges(int64_t pos)
+{
+  // drop the ranges before the new position
+  while (!m_rangeRequests.empty() && pos >= m_rangeRequests.front().end)
+  {
+    AbortRangeRequest(m_rangeRequests.front());
+    m_rangeIdle.push_back(std::move(m_rangeRequests.front().state));
+    m_rangeRequests.pop_front();
+  }
+
+  // start over if the position isn't covered by the running requests
+  if (m_rangeRequests.empty() || pos < m_rangeRequests.front().state->m_filePos)
+  {
+    for (auto& request : m_rangeRequests)
+    {
+      AbortRangeRequest(request);
+      m_rangeIdle.push_back(std::move(request.state));
+    }
+    m_rangeRequests.clear();
+    m_rangeFetchPos = pos;
+  }
+
+  m_state->m_filePos = pos;
+  ScheduleRangeRequests();
+}
+
 int CCurlFile::Stat(const CURL& url, struct __stat64* buffer)
 {
   // if file is already running, get info from it
@@ -1569,6 +1875,24 @@ ssize_t CCurlFile::CReadState::Read(void* lpBuf, size_t uiBufSize)
   return 0;
 }
 
+/* moves what curl wrote to the overflow buffer into the read buffer, as far as it fits */
+bool CCurlFile::CReadState::FillFromOverflow()
+{
+  if (!m_overflowSize)
+    return false;
+
+  unsigned amount = std::min(m_buffer.getMaxWriteSize(), m_overflowSize);
+  m_buffer.WriteData(m_overflowBuffer, amount);
+
+  if (amount < m_overflowSize)
+    memmove(m_overflowBuffer, m_overflowBuffer + amount, m_overflowSize - amount);
+
+  m_overflowSize -= amount;
+  // Shrink memory:
+  m_overflowBuffer = (char*)realloc_simple(m_overflowBuffer, m_overflowSize);
+  return true;
+}
+
 /* use to attempt to fill the read buffer up to requested number of bytes */
 int8_t CCurlFile::CReadState::FillBuffer(unsigned int want)
 {
@@ -1585,19 +1909,8 @@ int8_t CCurlFile::CReadState::FillBuffer(unsigned int want)
       return FILLBUFFER_NO_DATA;
 
     /* if there is data in overflow buffer, try to use that first */
-    if (m_overflowSize)
-    {
-      unsigned amount = std::min(m_buffer.getMaxWriteSize(), m_overflowSize);
-      m_buffer.WriteData(m_overflowBuffer, amount);
-
-      if (amount < m_overflowSize)
-        memmove(m_overflowBuffer, m_overflowBuffer + amount, m_overflowSize - amount);
-
-      m_overflowSize -= amount;
-      // Shrink memory:
-      m_overflowBuffer = (char*)realloc_simple(m_overflowBuffer, m_overflowSize);
+    if (FillFromOverflow())
       continue;
-    }
 
     CURLMcode result = g_curlInterface.multi_perform(m_multiHandle, &m_stillRunning);
     if (!m_stillRunning)
@@ -1973,6 +2286,14 @@ int CCurlFile::IoControl(EIoControl request, void* param)
     return 0;
   }
 
+  if (request == IOCTRL_SET_CACHE)
+  {
+    // the cache reads ahead, so it can keep several range requests busy
+    const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+    SetRangeReads(advancedSettings->m_curlRangeConnections, advancedSettings->m_curlRangeSegmentSize);
+    return 0;
+  }
+
   return -1;
 }
 
@@ -2018,6 +2339,18 @@ const std::vector<std::string> CCurlFile::GetPropertyValues(XFILE::FileProperty
 
 double CCurlFile::GetDownloadSpeed()
 {
+  if (m_rangeMultiHandle)
+  {
+    double total = 0.0;
+    for (const auto& request : m_rangeRequests)
+    {
+      double speed = 0.0;
+      if (!request.done && g_curlInterface.easy_getinfo(request.state->m_easyHandle, CURLINFO_SPEED_DOWNLOAD, &speed) == CURLE_OK)
+        total += speed;
+    }
+    return total;
+  }
+
 #if LIBCURL_VERSION_NUM >= 0x073a00 // 0.7.58.0
   double speed = 0.0;
   if (g_curlInterface.easy_getinfo(m_state->m_easyHandle, CURLINFO_SPEED_DOWNLOAD, &speed) == CURLE_OK)
@@ -12,8 +12,11 @@
 #include "utils/HttpHeader.h"
 #include "utils/RingBuffer.h"
 
+#include <deque>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 typedef void CURL_HANDLE;
 typedef void CURLM;
@@ -46,7 +49,7 @@ namespace XFILE
       int Stat(const CURL& url, struct __stat64* buffer) override;
       void Close() override;
       bool ReadString(char *szLine, int iLineLength) override { return m_state->ReadString(szLine, iLineLength); }
-      ssize_t Read(void* lpBuf, size_t uiBufSize) override { return m_state->Read(lpBuf, uiBufSize); }
+      ssize_t Read(void* lpBuf, size_t uiBufSize) override;
       ssize_t Write(const void* lpBuf, size_t uiBufSize) override;
       const std::string GetProperty(XFILE::FileProperty type, const std::string &name = "") const override;
       const std::vector<std::string> GetPropertyValues(XFILE::FileProperty type, const std::string &name = "") const override;
@@ -78,6 +81,14 @@ namespace XFILE
       void ClearRequestHeaders();
       void SetBufferSize(unsigned int size);
 
+      /*!
+       \brief Fetch the file through several range requests running in parallel.
+       Only used for seekable http(s) files, has to be called before the first Read().
+       \param connections number of concurrent requests, 1 disables parallel reads
+       \param segmentSize size of each requested range in bytes
+       */
+      void SetRangeReads(unsigned int connections, unsigned int segmentSize);
+
       const CHttpHeader& GetHttpHeader() const { return m_state->m_httpheader; }
       std::string GetURL(void);
       std::string GetRedirectURL();
@@ -130,6 +141,7 @@ namespace XFILE
           ssize_t Read(void* lpBuf, size_t uiBufSize);
           bool ReadString(char *szLine, int iLineLength);
           int8_t FillBuffer(unsigned int want);
+          bool FillFromOverflow();
           void SetReadBuffer(const void* lpBuf, int64_t uiBufSize);
 
           void SetResume(void);
@@ -145,12 +157,36 @@ namespace XFILE
       bool Service(const std::string& strURL, std::string& strHTML);
       std::string GetInfoString(int infoType);
 
+      struct SRangeRequest
+      {
+        std::unique_ptr<CReadState> state;
+        int64_t begin; /**< first byte of the range */
+        int64_t end;   /**< end of the range (exclusive) */
+        bool done;     /**< transfer of the range has finished */
+      };
+
+      bool StartRangeReads();
+      void StopRangeReads();
+      bool FallbackFromRangeReads();
+      void ScheduleRangeRequests();
+      void AbortRangeRequest(SRangeRequest& request);
+      int8_t PerformRangeRequests();
+      ssize_t ReadRanges(void* lpBuf, size_t uiBufSize);
+      void SeekRanges(int64_t pos);
+
     protected:
       CReadState* m_state;
       CReadState* m_oldState;
       unsigned int m_bufferSize;
       int64_t m_writeOffset = 0;
 
+      unsigned int m_rangeConnections = 1;
+      unsigned int m_rangeSegmentSize = 0;
+      CURLM* m_rangeMultiHandle = nullptr;
+      std::deque<SRangeRequest> m_rangeRequests; /**< running requests in file order, the first one holds the read position */
+      std::vector<std::unique_ptr<CReadState>> m_rangeIdle;
+      int64_t m_rangeFetchPos = 0; /**< where the next range request starts */
+
       std::string m_url;
       std::string m_userAgent;
       ProxyType m_proxytype = PROXY_HTTP;
@@ -10,23 +10,34 @@
 
 #include "Directory.h"
 #include "FileItem.h"
+#include "ServiceBroker.h"
 #include "URL.h"
+#include "games/tags/GameInfoTag.h"
+#include "music/tags/MusicInfoTag.h"
+#include "pictures/PictureInfoTag.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/log.h"
+#include "video/VideoInfoTag.h"
 
 #include <algorithm>
+#include <cinttypes>
 #include <climits>
+#include <functional>
 
-// Maximum number of directories to keep in our cache
-#define MAX_CACHED_DIRS 50
+// Limits used when advanced settings aren't available, see <directorycache> in advancedsettings.xml
+#define DIRECTORY_CACHE_MEMORY_SIZE (16 * 1024 * 1024)
+#define DIRECTORY_CACHE_MAX_DIRS 50
 
 using namespace XFILE;
 
 CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType)
 {
   m_cacheType = cacheType;
+  m_size = 0;
   m_lastAccess = 0;
   m_Items = new CFileItemList;
   m_Items->SetIgnoreURLOptions(true);
@@ -38,7 +49,7 @@ CDirectoryCache::CDir::~CDir()
   delete m_Items;
 }
 
-void CDirectoryCache::CDir::SetLastAccess(unsigned int &accessCounter)
+void CDirectoryCache::CDir::SetLastAccess(std::atomic<unsigned int> &accessCounter)
 {
   m_lastAccess = accessCounter++;
 }
@@ -46,24 +57,31 @@ void CDirectoryCache::CDir::SetLastAccess(unsigned int &accessCounter)
 CDirectoryCache::CDirectoryCache(void)
 {
   m_accessCounter = 0;
-#ifdef _DEBUG
+  m_size = 0;
+  m_numDirs = 0;
   m_cacheHits = 0;
   m_cacheMisses = 0;
-#endif
+  m_evictions = 0;
 }
 
 CDirectoryCache::~CDirectoryCache(void) = default;
 
-bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll)
+CDirectoryCache::Shard& CDirectoryCache::GetShard(const std::string& storedPath)
 {
-  CSingleLock lock (m_cs);
+  return m_shards[std::hash<std::string>()(storedPath) % NUM_SHARDS];
+}
 
+bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll)
+{
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+  Shard& shard = GetShard(storedPath);
+  CSingleLock lock (shard.m_cs);
+
+  ciCache i = shard.m_cache.find(storedPath);
+  if (i != shard.m_cache.end())
   {
     CDir* dir = i->second;
     if (dir->m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
@@ -71,12 +89,11 @@ bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &it
     {
       items.Copy(*dir->m_Items);
       dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
-      m_cacheHits+=items.Size();
-#endif
+      m_cacheHits++;
       return true;
     }
   }
+  m_cacheMisses++;
   return false;
 }
 
@@ -96,7 +113,6 @@ void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemLi
   // IDEALLY, any further processing on the item would actually create a new item
   // instead of altering it, but we can't really enforce that in an easy way, so
   // this is the best solution for now.
-  CSingleLock lock (m_cs);
 
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
@@ -104,12 +120,43 @@ void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemLi
 
   ClearDirectory(storedPath);
 
-  CheckIfFull();
+  size_t maxSize = DIRECTORY_CACHE_MEMORY_SIZE;
+  unsigned int maxDirs = DIRECTORY_CACHE_MAX_DIRS;
+  const auto settingsComponent = CServiceBroker::GetSettingsComponent();
+  if (settingsComponent && settingsComponent->GetAdvancedSettings())
+  {
+    maxSize = settingsComponent->GetAdvancedSettings()->m_directoryCacheMemSize;
+    maxDirs = settingsComponent->GetAdvancedSettings()->m_directoryCacheMaxDirs;
+  }
+
+  const size_t size = GetItemsSize(items);
+  if (cacheType != DIR_CACHE_ALWAYS && size > maxSize)
+  {
+    CLog::Log(LOGDEBUG, "%s - not caching %s, its %zu bytes exceed the directory cache size", __FUNCTION__,
+              CURL::GetRedacted(storedPath).c_str(), size);
+    return;
+  }
 
   CDir* dir = new CDir(cacheType);
   dir->m_Items->Copy(items);
+  dir->m_size = size;
   dir->SetLastAccess(m_accessCounter);
-  m_cache.insert(std::pair<std::string, CDir*>(storedPath, dir));
+  {
+    Shard& shard = GetShard(storedPath);
+    CSingleLock lock (shard.m_cs);
+    auto result = shard.m_cache.insert(std::pair<std::string, CDir*>(storedPath, dir));
+    if (!result.second)
+    {
+      // cached by another thread in the meantime, replace it with ours
+      Delete(shard, result.first);
+      shard.m_cache.insert(std::pair<std::string, CDir*>(storedPath, dir));
+    }
+    m_size += size;
+    if (cacheType != DIR_CACHE_ALWAYS)
+      m_numDirs++;
+  }
+
+  Trim(maxSize, maxDirs);
 }
 
 void CDirectoryCache::ClearFile(const std::string& strFile)
@@ -122,55 +169,62 @@ void CDirectoryCache::ClearFile(const std::string& strFile)
 
 void CDirectoryCache::ClearDirectory(const std::string& strPath)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  iCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
-    Delete(i);
+  Shard& shard = GetShard(storedPath);
+  CSingleLock lock (shard.m_cs);
+
+  iCache i = shard.m_cache.find(storedPath);
+  if (i != shard.m_cache.end())
+    Delete(shard, i);
 }
 
 void CDirectoryCache::ClearSubPaths(const std::string& strPath)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
 
-  iCache i = m_cache.begin();
-  while (i != m_cache.end())
+  for (Shard& shard : m_shards)
   {
-    if (URIUtils::PathHasParent(i->first, storedPath))
-      Delete(i++);
-    else
-      i++;
+    CSingleLock lock (shard.m_cs);
+
+    iCache i = shard.m_cache.begin();
+    while (i != shard.m_cache.end())
+    {
+      if (URIUtils::PathHasParent(i->first, storedPath))
+        Delete(shard, i++);
+      else
+        i++;
+    }
   }
 }
 
 void CDirectoryCache::AddFile(const std::string& strFile)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string strPath = URIUtils::GetDirectory(CURL(strFile).GetWithoutOptions());
   URIUtils::RemoveSlashAtEnd(strPath);
 
-  ciCache i = m_cache.find(strPath);
-  if (i != m_cache.end())
+  Shard& shard = GetShard(strPath);
+  CSingleLock lock (shard.m_cs);
+
+  ciCache i = shard.m_cache.find(strPath);
+  if (i != shard.m_cache.end())
   {
     CDir *dir = i->second;
     CFileItemPtr item(new CFileItem(strFile, false));
+    const size_t size = GetItemSize(*item);
     dir->m_Items->Add(item);
+    dir->m_size += size;
+    m_size += size;
     dir->SetLastAccess(m_accessCounter);
   }
 }
 
 bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
 {
-  CSingleLock lock (m_cs);
   bInCache = false;
 
   // Get rid of any URL options, else the compare may be wrong
@@ -179,31 +233,33 @@ bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
   std::string storedPath = URIUtils::GetDirectory(strPath);
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+  Shard& shard = GetShard(storedPath);
+  CSingleLock lock (shard.m_cs);
+
+  ciCache i = shard.m_cache.find(storedPath);
+  if (i != shard.m_cache.end())
   {
     bInCache = true;
     CDir *dir = i->second;
     dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
     m_cacheHits++;
-#endif
     return (URIUtils::PathEquals(strPath, storedPath) || dir->m_Items->Contains(strFile));
   }
-#ifdef _DEBUG
   m_cacheMisses++;
-#endif
   return false;
 }
 
 void CDirectoryCache::Clear()
 {
   // this routine clears everything
-  CSingleLock lock (m_cs);
+  for (Shard& shard : m_shards)
+  {
+    CSingleLock lock (shard.m_cs);
 
-  iCache i = m_cache.begin();
-  while (i != m_cache.end() )
-    Delete(i++);
+    iCache i = shard.m_cache.begin();
+    while (i != shard.m_cache.end() )
+      Delete(shard, i++);
+  }
 }
 
 void CDirectoryCache::InitCache(std::set<std::string>& dirs)
@@ -218,60 +274,135 @@ void CDirectoryCache::InitCache(std::set<std::string>& dirs)
 
 void CDirectoryCache::ClearCache(std::set<std::string>& dirs)
 {
-  iCache i = m_cache.begin();
-  while (i != m_cache.end())
+  for (Shard& shard : m_shards)
   {
-    if (dirs.find(i->first) != dirs.end())
-      Delete(i++);
-    else
-      i++;
+    CSingleLock lock (shard.m_cs);
+
+    iCache i = shard.m_cache.begin();
+    while (i != shard.m_cache.end())
+    {
+      if (dirs.find(i->first) != dirs.end())
+        Delete(shard, i++);
+      else
+        i++;
+    }
   }
 }
 
-void CDirectoryCache::CheckIfFull()
+void CDirectoryCache::Trim(size_t maxSize, unsigned int maxDirs)
 {
-  CSingleLock lock (m_cs);
-
-  // find the last accessed folder, and remove if the number of cached folders is too many
-  iCache lastAccessed = m_cache.end();
-  unsigned int numCached = 0;
-  for (iCache i = m_cache.begin(); i != m_cache.end(); i++)
+  while (m_size > maxSize || m_numDirs > maxDirs)
   {
-    // ensure dirs that are always cached aren't cleared
-    if (i->second->m_cacheType != DIR_CACHE_ALWAYS)
+    // find the least recently accessed folder. Shards are only locked one at a time, so the
+    // folder may have been accessed or removed by the time we get to delete it. In that case
+    // just look again.
+    Shard* oldestShard = nullptr;
+    std::string oldestPath;
+    unsigned int oldestAge = 0;
+    unsigned int oldestAccess = 0;
+    const unsigned int accessCounter = m_accessCounter;
+    for (Shard& shard : m_shards)
     {
-      if (lastAccessed == m_cache.end() || i->second->GetLastAccess() < lastAccessed->second->GetLastAccess())
-        lastAccessed = i;
-      numCached++;
+      CSingleLock lock (shard.m_cs);
+      for (ciCache i = shard.m_cache.begin(); i != shard.m_cache.end(); i++)
+      {
+        // ensure dirs that are always cached aren't cleared
+        if (i->second->m_cacheType == DIR_CACHE_ALWAYS)
+          continue;
+
+        // compare ages rather than access counters, they are safe when the counter wraps
+        const unsigned int age = accessCounter - i->second->GetLastAccess();
+        if (!oldestShard || age > oldestAge)
+        {
+          oldestShard = &shard;
+          oldestPath = i->first;
+          oldestAge = age;
+          oldestAccess = i->second->GetLastAccess();
+        }
+      }
+    }
+    if (!oldestShard)
+      break;
+
+    CSingleLock lock (oldestShard->m_cs);
+    iCache i = oldestShard->m_cache.find(oldestPath);
+    if (i != oldestShard->m_cache.end() && i->second->GetLastAccess() == oldestAccess)
+    {
+      Delete(*oldestShard, i);
+      m_evictions++;
     }
   }
-  if (lastAccessed != m_cache.end() && numCached >= MAX_CACHED_DIRS)
-    Delete(lastAccessed);
 }
 
-void CDirectoryCache::Delete(iCache it)
+void CDirectoryCache::Delete(Shard& shard, iCache it)
 {
   CDir* dir = it->second;
+  m_size -= dir->m_size;
+  if (dir->m_cacheType != DIR_CACHE_ALWAYS)
+    m_numDirs--;
   delete dir;
-  m_cache.erase(it);
+  shard.m_cache.erase(it);
 }
 
-#ifdef _DEBUG
-void CDirectoryCache::PrintStats() const
+size_t CDirectoryCache::GetItemSize(const CFileItem &item)
+{
+  // strings that are short enough to be stored in place are part of sizeof()
+  size_t size = sizeof(CFileItem) + sizeof(CFileItemPtr) + item.GetPath().capacity() +
+    item.GetDynPath().capacity() + item.GetLabel().capacity() + item.GetLabel2().capacity() +
+    item.GetMimeType().capacity() + item.GetSortLabel().capacity() * sizeof(wchar_t);
+
+  size += item.GetArtSize();
+
+  if (item.HasVideoInfoTag())
+    size += sizeof(CVideoInfoTag) + item.GetVideoInfoTag()->m_strPlot.capacity();
+  if (item.HasMusicInfoTag())
+    size += sizeof(MUSIC_INFO::CMusicInfoTag) + item.GetMusicInfoTag()->GetComment().capacity();
+  if (item.HasPictureInfoTag())
+    size += sizeof(CPictureInfoTag);
+  if (item.HasGameInfoTag())
+    size += sizeof(KODI::GAME::CGameInfoTag);
+
+  return size;
+}
+
+size_t CDirectoryCache::GetItemsSize(const CFileItemList &items)
+{
+  size_t size = sizeof(CFileItemList);
+  for (int i = 0; i < items.Size(); i++)
+    size += GetItemSize(*items[i]);
+  return size;
+}
+
+void CDirectoryCache::GetStats(Stats &stats) const
 {
-  CSingleLock lock (m_cs);
-  CLog::Log(LOGDEBUG, "%s - total of %u cache hits, and %u cache misses", __FUNCTION__, m_cacheHits, m_cacheMisses);
-  // run through and find the oldest and the number of items cached
-  unsigned int oldest = UINT_MAX;
-  unsigned int numItems = 0;
-  unsigned int numDirs = 0;
-  for (ciCache i = m_cache.begin(); i != m_cache.end(); i++)
+  stats.hits = m_cacheHits;
+  stats.misses = m_cacheMisses;
+  stats.evictions = m_evictions;
+  stats.size = m_size;
+  stats.directories = 0;
+  stats.items = 0;
+  for (const Shard& shard : m_shards)
   {
-    CDir *dir = i->second;
-    oldest = std::min(oldest, dir->GetLastAccess());
-    numItems += dir->m_Items->Size();
-    numDirs++;
+    CSingleLock lock (shard.m_cs);
+    stats.directories += shard.m_cache.size();
+    for (ciCache i = shard.m_cache.begin(); i != shard.m_cache.end(); i++)
+      stats.items += i->second->m_Items->Size();
   }
-  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total.  Oldest is %u, current is %u", __FUNCTION__, numDirs, numItems, oldest, m_accessCounter);
+
+  stats.maxSize = DIRECTORY_CACHE_MEMORY_SIZE;
+  const auto settingsComponent = CServiceBroker::GetSettingsComponent();
+  if (settingsComponent && settingsComponent->GetAdvancedSettings())
+    stats.maxSize = settingsComponent->GetAdvancedSettings()->m_directoryCacheMemSize;
+}
+
+#ifdef _DEBUG
+void CDirectoryCache::PrintStats() const
+{
+  Stats stats;
+  GetStats(stats);
+  CLog::Log(LOGDEBUG, "%s - total of %" PRIu64 " cache hits, %" PRIu64 " cache misses and %" PRIu64 " evictions",
+            __FUNCTION__, stats.hits, stats.misses, stats.evictions);
+  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total using %" PRIu64 " of %" PRIu64 " bytes",
+            __FUNCTION__, stats.directories, stats.items, stats.size, stats.maxSize);
 }
 #endif
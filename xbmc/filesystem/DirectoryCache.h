@@ -11,6 +11,8 @@
 #include "IDirectory.h"
 #include "threads/CriticalSection.h"
 
+#include <atomic>
+#include <cstdint>
 #include <map>
 #include <set>
 
@@ -18,6 +20,14 @@ class CFileItem;
 
 namespace XFILE
 {
+  /*!
+   \brief Cache of directory listings.
+
+   The cache is split into shards by path, each with its own lock, so listings of different
+   directories don't serialise each other. The total estimated size of the cached listings is
+   bounded (see \<directorycache\> in advancedsettings.xml); when it, or the number of cached
+   directories, is exceeded the least recently accessed directories are evicted.
+   */
   class CDirectoryCache
   {
     class CDir
@@ -26,17 +36,29 @@ namespace XFILE
       explicit CDir(DIR_CACHE_TYPE cacheType);
       virtual ~CDir();
 
-      void SetLastAccess(unsigned int &accessCounter);
+      void SetLastAccess(std::atomic<unsigned int> &accessCounter);
       unsigned int GetLastAccess() const { return m_lastAccess; };
 
       CFileItemList* m_Items;
       DIR_CACHE_TYPE m_cacheType;
+      size_t m_size; ///< estimated memory used by m_Items
     private:
       CDir(const CDir&) = delete;
       CDir& operator=(const CDir&) = delete;
       unsigned int m_lastAccess;
     };
   public:
+    struct Stats
+    {
+      uint64_t hits = 0;
+      uint64_t misses = 0;
+      uint64_t evictions = 0;
+      unsigned int directories = 0;
+      unsigned int items = 0;
+      uint64_t size = 0;     ///< estimated memory used by the cached listings in bytes
+      uint64_t maxSize = 0;  ///< memory budget in bytes
+    };
+
     CDirectoryCache(void);
     virtual ~CDirectoryCache(void);
     bool GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll = false);
@@ -47,27 +69,50 @@ namespace XFILE
     void Clear();
     void AddFile(const std::string& strFile);
     bool FileExists(const std::string& strPath, bool& bInCache);
+    void GetStats(Stats &stats) const;
 #ifdef _DEBUG
     void PrintStats() const;
 #endif
+
+    /*!
+     \brief Estimate the memory used by a file item, including its strings, art and tags.
+     */
+    static size_t GetItemSize(const CFileItem &item);
+    static size_t GetItemsSize(const CFileItemList &items);
+
   protected:
+    typedef std::map<std::string, CDir*> DirMap;
+    typedef DirMap::iterator iCache;
+    typedef DirMap::const_iterator ciCache;
+
+    struct Shard
+    {
+      mutable CCriticalSection m_cs;
+      DirMap m_cache;
+    };
+
+    static const unsigned int NUM_SHARDS = 16;
+
+    Shard& GetShard(const std::string& storedPath);
     void InitCache(std::set<std::string>& dirs);
     void ClearCache(std::set<std::string>& dirs);
-    void CheckIfFull();
 
-    std::map<std::string, CDir*> m_cache;
-    typedef std::map<std::string, CDir*>::iterator iCache;
-    typedef std::map<std::string, CDir*>::const_iterator ciCache;
-    void Delete(iCache i);
+    /*!
+     \brief Evict the least recently accessed directories until the cache fits the given limits.
+     Must be called without holding any shard lock.
+     */
+    void Trim(size_t maxSize, unsigned int maxDirs);
+    void Delete(Shard& shard, iCache i);
 
-    mutable CCriticalSection m_cs;
+    Shard m_shards[NUM_SHARDS];
 
-    unsigned int m_accessCounter;
+    std::atomic<unsigned int> m_accessCounter;
+    std::atomic<size_t> m_size;          ///< estimated memory used by all cached listings
+    std::atomic<unsigned int> m_numDirs; ///< number of cached directories that may be evicted
 
-#ifdef _DEBUG
-    unsigned int m_cacheHits;
-    unsigned int m_cacheMisses;
-#endif
+    std::atomic<uint64_t> m_cacheHits;
+    std::atomic<uint64_t> m_cacheMisses;
+    std::atomic<uint64_t> m_evictions;
   };
 }
 extern XFILE::CDirectoryCache g_directoryCache;
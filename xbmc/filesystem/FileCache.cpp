@@ -14,6 +14,7 @@
 #include "ServiceBroker.h"
 
 #include "CircularCache.h"
+#include "SegmentedFileCache.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "settings/AdvancedSettings.h"
@@ -144,7 +145,19 @@ bool CFileCache::Open(const CURL& url)
 
   if (!m_pCache)
   {
-    if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheMemSize == 0)
+    const unsigned int diskSize =
+        CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheDiskSize;
+    const bool segmented = diskSize > 0 && m_seekPossible > 0;
+    if (segmented)
+    {
+      // Keep previously fetched ranges in a spill file so seeking back doesn't refetch them.
+      // This handles multiple streams itself, so no double buffering is needed.
+      const size_t front = diskSize / 4;
+      CLog::Log(LOGDEBUG, "CFileCache::Open - Using segmented disk cache sized %u bytes", diskSize);
+      m_pCache = std::unique_ptr<CSegmentedFileCache>(new CSegmentedFileCache(diskSize, front)); // C++14 - Replace with std::make_unique
+      m_forwardCacheSize = front;
+    }
+    else if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheMemSize == 0)
     {
       // Use cache on disk
       m_pCache = std::unique_ptr<CSimpleFileCache>(new CSimpleFileCache()); // C++14 - Replace with std::make_unique
@@ -193,7 +206,7 @@ bool CFileCache::Open(const CURL& url)
       m_forwardCacheSize = front;
     }
 
-    if (m_flags & READ_MULTI_STREAM)
+    if ((m_flags & READ_MULTI_STREAM) && !segmented)
     {
       // If READ_MULTI_STREAM flag is set: Double buffering is required
       m_pCache = std::unique_ptr<CDoubleCache>(new CDoubleCache(m_pCache.release())); // C++14 - Replace with std::make_unique
@@ -606,6 +619,8 @@ int CFileCache::IoControl(EIoControl request, void* param)
     status->maxrate = m_writeRate;
     status->currate = m_writeRateActual;
     status->lowspeed = m_bLowSpeedDetected;
+    status->hitratio = m_pCache->GetHitRatio();
+    status->saved = m_pCache->GetBytesSaved();
     m_bLowSpeedDetected = false; // Reset flag
     return 0;
   }
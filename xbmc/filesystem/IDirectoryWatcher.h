@@ -0,0 +1,55 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <set>
+#include <string>
+
+namespace XFILE
+{
+class IDirectoryWatcherCallback
+{
+public:
+  virtual ~IDirectoryWatcherCallback() = default;
+
+  /*!
+   \brief Watching root and everything below it has started, changes from now on are reported.
+   */
+  virtual void OnWatchAdded(const std::string& root) = 0;
+
+  /*!
+   \brief Changes below root may have been missed, e.g. because the event queue overflowed or
+   the watch limit was reached. If the watch itself is gone OnWatchAdded() isn't called again.
+   */
+  virtual void OnWatchLost(const std::string& root, bool removed) = 0;
+
+  /*!
+   \brief Entries in the given directories were created, deleted, renamed or modified.
+   Directories end with a slash.
+   */
+  virtual void OnDirectoriesChanged(const std::set<std::string>& directories) = 0;
+};
+
+/*!
+ \brief Watches local directory trees for changes.
+ */
+class IDirectoryWatcher
+{
+public:
+  virtual ~IDirectoryWatcher() = default;
+
+  /*!
+   \brief Watch the given directory and all its subdirectories. Watching starts asynchronously,
+   the callback is told once it is in place.
+   */
+  virtual void AddWatch(const std::string& root) = 0;
+  virtual void RemoveWatch(const std::string& root) = 0;
+  virtual void RemoveAllWatches() = 0;
+};
+}
@@ -52,6 +52,8 @@ struct SCacheStatus
   unsigned maxrate;  /**< maximum number of bytes per second cache is allowed to fill */
   unsigned currate;  /**< average read rate from source file since last position change */
   bool     lowspeed; /**< cache low speed condition detected? */
+  float    hitratio = 0.0f; /**< fraction of seeks served from already cached data */
+  uint64_t saved = 0;       /**< number of bytes served from cache instead of refetching them */
 };
 
 typedef enum {
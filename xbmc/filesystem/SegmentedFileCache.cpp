@@ -0,0 +1,424 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "SegmentedFileCache.h"
+
+#include "SpecialProtocol.h"
+#include "Util.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <string.h>
+
+#if defined(TARGET_POSIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace XFILE;
+
+CSegmentedFileCache::CSegmentedFileCache(size_t size, size_t front, size_t segmentSize)
+ : CCacheStrategy()
+ , m_segmentSize(segmentSize)
+ , m_buf(NULL)
+ , m_useCounter(0)
+ , m_readPos(0)
+ , m_writePos(0)
+ , m_seeks(0)
+ , m_seekHits(0)
+ , m_bytesSaved(0)
+ , m_savedEnd(0)
+#ifdef TARGET_WINDOWS
+ , m_handle(NULL)
+#endif
+{
+  // the window between read and write position may touch one segment more than its size,
+  // so keep at least two segments outside of it for history
+  m_slots = std::max(size / m_segmentSize, static_cast<size_t>(4));
+  m_size = m_slots * m_segmentSize;
+  m_front = std::min(front, m_size - 2 * m_segmentSize);
+}
+
+CSegmentedFileCache::~CSegmentedFileCache()
+{
+  Close();
+}
+
+int CSegmentedFileCache::Open()
+{
+  Close();
+
+  CSingleLock lock(m_sync);
+
+#ifdef TARGET_WINDOWS
+  m_handle = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                               static_cast<DWORD>(static_cast<uint64_t>(m_size) >> 32),
+                               static_cast<DWORD>(m_size & 0xFFFFFFFF), NULL);
+  if (m_handle == NULL)
+    return CACHE_RC_ERROR;
+  m_buf = (uint8_t*)MapViewOfFile(m_handle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+  if (m_buf == NULL)
+    return CACHE_RC_ERROR;
+#else
+  const std::string filename = CSpecialProtocol::TranslatePath(
+      CUtil::GetNextFilename("special://temp/filecache%03d.cache", 999));
+  if (filename.empty())
+  {
+    CLog::LogF(LOGERROR, "unable to generate a new filename");
+    return CACHE_RC_ERROR;
+  }
+
+  int fd = open(filename.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IWUSR);
+  if (fd < 0)
+  {
+    CLog::LogF(LOGERROR, "failed to create spill file \"%s\"", filename.c_str());
+    return CACHE_RC_ERROR;
+  }
+
+  // the mapping keeps the data alive, so don't leave the file behind should we crash
+  unlink(filename.c_str());
+
+  void* buf = MAP_FAILED;
+  if (ftruncate(fd, m_size) == 0)
+    buf = mmap(NULL, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (buf == MAP_FAILED)
+  {
+    CLog::LogF(LOGERROR, "failed to map %zu bytes of spill file \"%s\"", m_size, filename.c_str());
+    return CACHE_RC_ERROR;
+  }
+  m_buf = static_cast<uint8_t*>(buf);
+#endif
+
+  m_segments.clear();
+  m_freeSlots.clear();
+  for (size_t slot = m_slots; slot > 0; --slot)
+    m_freeSlots.push_back(slot - 1);
+
+  m_useCounter = 0;
+  m_readPos = 0;
+  m_writePos = 0;
+  m_seeks = 0;
+  m_seekHits = 0;
+  m_bytesSaved = 0;
+  m_savedEnd = 0;
+
+  CLog::Log(LOGDEBUG, "CSegmentedFileCache::Open - %zu segments of %zu bytes, %zu bytes forward",
+            m_slots, m_segmentSize, m_front);
+
+  return CACHE_RC_OK;
+}
+
+void CSegmentedFileCache::Close()
+{
+  CSingleLock lock(m_sync);
+
+#ifdef TARGET_WINDOWS
+  if (m_buf != NULL)
+    UnmapViewOfFile(m_buf);
+  if (m_handle != NULL)
+    CloseHandle(m_handle);
+  m_handle = NULL;
+#else
+  if (m_buf != NULL)
+    munmap(m_buf, m_size);
+#endif
+  m_buf = NULL;
+
+  m_segments.clear();
+  m_freeSlots.clear();
+}
+
+size_t CSegmentedFileCache::GetMaxWriteSize(const size_t& iRequestSize)
+{
+  CSingleLock lock(m_sync);
+
+  const size_t front = static_cast<size_t>(m_writePos - m_readPos);
+  if (front >= m_front)
+    return 0;
+
+  return std::min(iRequestSize, m_front - front);
+}
+
+int64_t CSegmentedFileCache::GetContiguousEnd(int64_t iFilePosition) const
+{
+  int64_t end = iFilePosition;
+  while (true)
+  {
+    const auto it = m_segments.find(end / m_segmentSize);
+    if (it == m_segments.end() || it->second.begin > end || it->second.end <= end)
+      return end;
+    end = it->second.end;
+  }
+}
+
+size_t CSegmentedFileCache::AllocateSlot()
+{
+  if (!m_freeSlots.empty())
+  {
+    const size_t slot = m_freeSlots.back();
+    m_freeSlots.pop_back();
+    return slot;
+  }
+
+  // data between read and write position still has to be consumed
+  const int64_t first = m_readPos / m_segmentSize;
+  const int64_t last = m_writePos / m_segmentSize;
+
+  auto victim = m_segments.end();
+  for (auto it = m_segments.begin(); it != m_segments.end(); ++it)
+  {
+    if (it->first >= first && it->first <= last)
+      continue;
+    if (victim == m_segments.end() || it->second.lastUsed < victim->second.lastUsed)
+      victim = it;
+  }
+
+  if (victim == m_segments.end())
+    return m_slots;
+
+  const size_t slot = victim->second.slot;
+  m_segments.erase(victim);
+  return slot;
+}
+
+int CSegmentedFileCache::WriteToCache(const char *pBuffer, size_t iSize)
+{
+  CSingleLock lock(m_sync);
+
+  if (m_buf == NULL)
+    return 0;
+
+  // limit by max forward size
+  iSize = std::min(iSize, GetMaxWriteSize(iSize));
+
+  size_t written = 0;
+  while (written < iSize)
+  {
+    const int64_t index = m_writePos / m_segmentSize;
+    auto it = m_segments.find(index);
+    if (it == m_segments.end())
+    {
+      const size_t slot = AllocateSlot();
+      if (slot == m_slots)
+        break;
+      it = m_segments.emplace(index, Segment{slot, m_writePos, m_writePos, 0}).first;
+    }
+
+    Segment& segment = it->second;
+    if (m_writePos < segment.begin || m_writePos > segment.end)
+    {
+      // not adjacent to the data we have for this segment, drop it
+      segment.begin = m_writePos;
+      segment.end = m_writePos;
+    }
+
+    const size_t offset = static_cast<size_t>(m_writePos - index * m_segmentSize);
+    const size_t len = std::min(iSize - written, m_segmentSize - offset);
+    memcpy(m_buf + segment.slot * m_segmentSize + offset, pBuffer + written, len);
+
+    m_writePos += len;
+    segment.end = std::max(segment.end, m_writePos);
+    segment.lastUsed = ++m_useCounter;
+    written += len;
+  }
+
+  if (written > 0)
+    m_written.Set();
+
+  return written;
+}
+
+/**
+ * Reads data from cache. Will only read up till the end of
+ * the current segment. So multiple calls may be needed to
+ * empty the whole cache
+ */
+int CSegmentedFileCache::ReadFromCache(char *pBuffer, size_t iMaxSize)
+{
+  CSingleLock lock(m_sync);
+
+  const int64_t avail = m_writePos - m_readPos;
+  if (avail <= 0)
+  {
+    if (IsEndOfInput())
+      return 0;
+    else
+      return CACHE_RC_WOULD_BLOCK;
+  }
+
+  const int64_t index = m_readPos / m_segmentSize;
+  auto it = m_segments.find(index);
+  if (it == m_segments.end() || m_buf == NULL)
+    return CACHE_RC_ERROR;
+
+  const size_t offset = static_cast<size_t>(m_readPos - index * m_segmentSize);
+  const size_t len = std::min({iMaxSize, static_cast<size_t>(avail), m_segmentSize - offset});
+  if (len == 0)
+    return 0;
+
+  memcpy(pBuffer, m_buf + it->second.slot * m_segmentSize + offset, len);
+
+  if (m_readPos < m_savedEnd)
+    m_bytesSaved += std::min(static_cast<int64_t>(len), m_savedEnd - m_readPos);
+
+  m_readPos += len;
+  it->second.lastUsed = ++m_useCounter;
+
+  m_space.Set();
+
+  return len;
+}
+
+/* Wait "millis" milliseconds for "minimum" amount of data to come in.
+ * Note that caller needs to make sure there's sufficient space in the forward
+ * buffer for "minimum" bytes else we may block the full timeout time
+ */
+int64_t CSegmentedFileCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
+{
+  CSingleLock lock(m_sync);
+  int64_t avail = m_writePos - m_readPos;
+
+  if (iMillis == 0 || IsEndOfInput())
+    return avail;
+
+  if (iMinAvail > m_front)
+    iMinAvail = m_front;
+
+  XbmcThreads::EndTime endtime(iMillis);
+  while (!IsEndOfInput() && avail < iMinAvail && !endtime.IsTimePast())
+  {
+    lock.Leave();
+    m_written.WaitMSec(50); // may miss the deadline. shouldn't be a problem.
+    lock.Enter();
+    avail = m_writePos - m_readPos;
+  }
+
+  return avail;
+}
+
+int64_t CSegmentedFileCache::Seek(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+
+  m_seeks++;
+
+  // if seek is a bit over what we have, try to wait a few seconds for the data to be available.
+  // we try to avoid a (heavy) seek on the source
+  if (iFilePosition >= m_writePos && iFilePosition < m_writePos + 100000)
+  {
+    // make sure there's sufficient forward space, what we skip stays cached
+    m_readPos = m_writePos;
+    lock.Leave();
+    WaitForData(static_cast<unsigned int>(iFilePosition - m_readPos), 5000);
+    lock.Enter();
+  }
+
+  // we can only seek within the range the source is currently writing to,
+  // anything else requires the source to move
+  if (iFilePosition == m_writePos ||
+      (IsCachedPosition(iFilePosition) && GetContiguousEnd(iFilePosition) == m_writePos))
+  {
+    m_seekHits++;
+    m_readPos = iFilePosition;
+    m_space.Set();
+    return iFilePosition;
+  }
+
+  return CACHE_RC_ERROR;
+}
+
+bool CSegmentedFileCache::Reset(int64_t iSourcePosition, bool clearAnyway)
+{
+  CSingleLock lock(m_sync);
+
+  if (!clearAnyway && IsCachedPosition(iSourcePosition))
+  {
+    m_readPos = iSourcePosition;
+    m_writePos = GetContiguousEnd(iSourcePosition);
+    if (m_writePos > iSourcePosition)
+    {
+      // Seek() counted this as a miss, but we already have (some of) it
+      m_seekHits++;
+      m_savedEnd = m_writePos;
+    }
+    return false;
+  }
+
+  if (clearAnyway)
+  {
+    for (const auto& segment : m_segments)
+      m_freeSlots.push_back(segment.second.slot);
+    m_segments.clear();
+  }
+
+  m_readPos = iSourcePosition;
+  m_writePos = iSourcePosition;
+  m_savedEnd = iSourcePosition;
+
+  return true;
+}
+
+int64_t CSegmentedFileCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+
+  if (IsCachedPosition(iFilePosition))
+    return GetContiguousEnd(iFilePosition);
+  return iFilePosition;
+}
+
+int64_t CSegmentedFileCache::CachedDataEndPos()
+{
+  CSingleLock lock(m_sync);
+
+  return m_writePos;
+}
+
+bool CSegmentedFileCache::IsCachedPosition(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+
+  auto it = m_segments.find(iFilePosition / m_segmentSize);
+  if (it != m_segments.end() && it->second.begin <= iFilePosition && iFilePosition <= it->second.end)
+    return true;
+
+  // the end of a completely filled segment
+  if (iFilePosition % m_segmentSize == 0)
+  {
+    it = m_segments.find(iFilePosition / m_segmentSize - 1);
+    return it != m_segments.end() && it->second.end == iFilePosition;
+  }
+
+  return false;
+}
+
+CCacheStrategy *CSegmentedFileCache::CreateNew()
+{
+  return new CSegmentedFileCache(m_size, m_front, m_segmentSize);
+}
+
+float CSegmentedFileCache::GetHitRatio()
+{
+  CSingleLock lock(m_sync);
+
+  if (m_seeks == 0)
+    return 0.0f;
+  return static_cast<float>(m_seekHits) / m_seeks;
+}
+
+uint64_t CSegmentedFileCache::GetBytesSaved()
+{
+  CSingleLock lock(m_sync);
+
+  return m_bytesSaved;
+}
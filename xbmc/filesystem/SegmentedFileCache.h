@@ -0,0 +1,107 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "CacheStrategy.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+#include <map>
+#include <vector>
+
+namespace XFILE {
+
+/*!
+ \brief Cache strategy keeping a sparse set of fixed size segments of the source file in a
+ memory mapped spill file.
+
+ Unlike CCircularCache, data isn't dropped when seeking outside of the current window. Every
+ segment fetched from the source stays available until it is evicted (least recently used
+ first), so seeking back to a range that was already fetched is served without touching the
+ source. Segments between the read and the write position are never evicted.
+ */
+class CSegmentedFileCache : public CCacheStrategy
+{
+public:
+  /*!
+   \param size total size of the spill file in bytes.
+   \param front maximum number of bytes to cache ahead of the read position.
+   \param segmentSize granularity in which the spill file is managed.
+   */
+  CSegmentedFileCache(size_t size, size_t front, size_t segmentSize = 1024 * 1024);
+  ~CSegmentedFileCache() override;
+
+  int Open() override;
+  void Close() override;
+
+  size_t GetMaxWriteSize(const size_t& iRequestSize) override;
+  int WriteToCache(const char *pBuffer, size_t iSize) override;
+  int ReadFromCache(char *pBuffer, size_t iMaxSize) override;
+  int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis) override;
+
+  int64_t Seek(int64_t iFilePosition) override;
+  bool Reset(int64_t iSourcePosition, bool clearAnyway=true) override;
+
+  int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) override;
+  int64_t CachedDataEndPos() override;
+  bool IsCachedPosition(int64_t iFilePosition) override;
+
+  CCacheStrategy *CreateNew() override;
+
+  float GetHitRatio() override;
+  uint64_t GetBytesSaved() override;
+
+protected:
+  struct Segment
+  {
+    size_t   slot;     /**< index of the segment in the spill file */
+    int64_t  begin;    /**< index in file (not buffer) of beginning of valid data */
+    int64_t  end;      /**< index in file (not buffer) of end of valid data */
+    uint64_t lastUsed; /**< value of m_useCounter when the segment was last accessed */
+  };
+
+  /*!
+   \brief Get the end of the range of cached data that starts at a given position
+   \return iFilePosition if the position itself isn't cached.
+   */
+  int64_t GetContiguousEnd(int64_t iFilePosition) const;
+
+  /*!
+   \brief Get a free slot in the spill file, evicting the least recently used segment outside
+   of the read/write window if needed.
+   \return the slot index, or m_slots if every slot is in use by the window.
+   */
+  size_t AllocateSlot();
+
+  size_t   m_size;
+  size_t   m_front;
+  size_t   m_segmentSize;
+  size_t   m_slots;
+  uint8_t *m_buf;
+
+  std::map<int64_t, Segment> m_segments; /**< segments keyed by their index in the file */
+  std::vector<size_t> m_freeSlots;
+  uint64_t m_useCounter;
+
+  int64_t  m_readPos;
+  int64_t  m_writePos;
+
+  uint64_t m_seeks;
+  uint64_t m_seekHits;
+  uint64_t m_bytesSaved;
+  int64_t  m_savedEnd; /**< reads below this position are served from a previous fetch */
+
+  CCriticalSection m_sync;
+  CEvent           m_written;
+#ifdef TARGET_WINDOWS
+  HANDLE           m_handle;
+#endif
+};
+
+} // namespace XFILE
@@ -0,0 +1,199 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "filesystem/DirectoryCache.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+class TestDirectoryCache : public ::testing::Test
+{
+protected:
+  TestDirectoryCache()
+  {
+    const auto advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+    m_memSize = advancedSettings->m_directoryCacheMemSize;
+    m_maxDirs = advancedSettings->m_directoryCacheMaxDirs;
+  }
+
+  ~TestDirectoryCache() override
+  {
+    const auto advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+    advancedSettings->m_directoryCacheMemSize = m_memSize;
+    advancedSettings->m_directoryCacheMaxDirs = m_maxDirs;
+  }
+
+  static void SetLimits(unsigned int memSize, unsigned int maxDirs)
+  {
+    const auto advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+    advancedSettings->m_directoryCacheMemSize = memSize;
+    advancedSettings->m_directoryCacheMaxDirs = maxDirs;
+  }
+
+  static void CreateListing(const std::string& path, int count, CFileItemList& items)
+  {
+    items.Clear();
+    items.SetPath(path);
+    for (int i = 0; i < count; i++)
+      items.Add(CFileItemPtr(new CFileItem(path + "file" + std::to_string(i) + ".mkv", false)));
+  }
+
+  CDirectoryCache m_cache;
+
+private:
+  unsigned int m_memSize;
+  unsigned int m_maxDirs;
+};
+
+TEST_F(TestDirectoryCache, GetDirectory)
+{
+  CFileItemList items;
+  CreateListing("/media/movies/", 10, items);
+  m_cache.SetDirectory("/media/movies/", items, DIR_CACHE_ONCE);
+
+  CFileItemList cached;
+  EXPECT_FALSE(m_cache.GetDirectory("/media/movies/", cached));
+  EXPECT_TRUE(m_cache.GetDirectory("/media/movies", cached, true));
+  EXPECT_EQ(10, cached.Size());
+
+  bool inCache;
+  EXPECT_TRUE(m_cache.FileExists("/media/movies/file3.mkv", inCache));
+  EXPECT_TRUE(inCache);
+  EXPECT_FALSE(m_cache.FileExists("/media/movies/other.mkv", inCache));
+  EXPECT_TRUE(inCache);
+  EXPECT_FALSE(m_cache.FileExists("/media/tv/file3.mkv", inCache));
+  EXPECT_FALSE(inCache);
+
+  CDirectoryCache::Stats stats;
+  m_cache.GetStats(stats);
+  EXPECT_EQ(3u, stats.hits);
+  EXPECT_EQ(2u, stats.misses);
+  EXPECT_EQ(1u, stats.directories);
+  EXPECT_EQ(10u, stats.items);
+  EXPECT_EQ(CDirectoryCache::GetItemsSize(items), stats.size);
+
+  m_cache.AddFile("/media/movies/new.mkv");
+  EXPECT_TRUE(m_cache.FileExists("/media/movies/new.mkv", inCache));
+
+  m_cache.ClearSubPaths("/media/");
+  m_cache.GetStats(stats);
+  EXPECT_EQ(0u, stats.directories);
+  EXPECT_EQ(0u, stats.size);
+}
+
+TEST_F(TestDirectoryCache, EvictsLeastRecentlyUsed)
+{
+  SetLimits(64 * 1024 * 1024, 3);
+
+  CFileItemList items;
+  for (int i = 0; i < 4; i++)
+  {
+    const std::string path = "/media/dir" + std::to_string(i) + "/";
+    CreateListing(path, 5, items);
+    m_cache.SetDirectory(path, items, DIR_CACHE_ONCE);
+
+    // keep the first directory in use
+    CFileItemList cached;
+    EXPECT_TRUE(m_cache.GetDirectory("/media/dir0/", cached, true));
+  }
+
+  CFileItemList cached;
+  EXPECT_TRUE(m_cache.GetDirectory("/media/dir0/", cached, true));
+  EXPECT_FALSE(m_cache.GetDirectory("/media/dir1/", cached, true));
+  EXPECT_TRUE(m_cache.GetDirectory("/media/dir2/", cached, true));
+  EXPECT_TRUE(m_cache.GetDirectory("/media/dir3/", cached, true));
+
+  // directories that are always cached don't count and are never evicted
+  CreateListing("/media/always/", 5, items);
+  m_cache.SetDirectory("/media/always/", items, DIR_CACHE_ALWAYS);
+  CreateListing("/media/dir4/", 5, items);
+  m_cache.SetDirectory("/media/dir4/", items, DIR_CACHE_ONCE);
+  EXPECT_TRUE(m_cache.GetDirectory("/media/always/", cached));
+  EXPECT_FALSE(m_cache.GetDirectory("/media/dir0/", cached, true));
+
+  CDirectoryCache::Stats stats;
+  m_cache.GetStats(stats);
+  EXPECT_EQ(4u, stats.directories);
+  EXPECT_EQ(2u, stats.evictions);
+}
+
+TEST_F(TestDirectoryCache, MemoryBudget)
+{
+  CFileItemList items;
+  CreateListing("/media/small/", 100, items);
+  const size_t size = CDirectoryCache::GetItemsSize(items);
+  SetLimits(static_cast<unsigned int>(size * 5 / 2), 50);
+
+  // a listing larger than the whole budget isn't cached at all
+  CFileItemList large;
+  CreateListing("/media/large/", 300, large);
+  m_cache.SetDirectory("/media/large/", large, DIR_CACHE_ONCE);
+  CFileItemList cached;
+  EXPECT_FALSE(m_cache.GetDirectory("/media/large/", cached, true));
+
+  for (int i = 0; i < 3; i++)
+  {
+    CreateListing("/media/small" + std::to_string(i) + "/", 100, items);
+    m_cache.SetDirectory(items.GetPath(), items, DIR_CACHE_ONCE);
+  }
+
+  CDirectoryCache::Stats stats;
+  m_cache.GetStats(stats);
+  EXPECT_EQ(2u, stats.directories);
+  EXPECT_EQ(1u, stats.evictions);
+  EXPECT_LE(stats.size, stats.maxSize);
+  EXPECT_FALSE(m_cache.GetDirectory("/media/small0/", cached, true));
+  EXPECT_TRUE(m_cache.GetDirectory("/media/small2/", cached, true));
+}
+
+TEST_F(TestDirectoryCache, Concurrent)
+{
+  SetLimits(64 * 1024 * 1024, 20);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++)
+  {
+    threads.emplace_back([this, t]() {
+      CFileItemList items;
+      CFileItemList cached;
+      for (int i = 0; i < 200; i++)
+      {
+        const std::string path = "/media/thread" + std::to_string(t) + "/dir" + std::to_string(i % 10) + "/";
+        cached.Clear();
+        if (!m_cache.GetDirectory(path, cached, true))
+        {
+          CreateListing(path, 10, items);
+          m_cache.SetDirectory(path, items, DIR_CACHE_ONCE);
+        }
+        else
+          EXPECT_EQ(10, cached.Size());
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  CDirectoryCache::Stats stats;
+  m_cache.GetStats(stats);
+  EXPECT_EQ(20u, stats.directories);
+  EXPECT_EQ(800u, stats.hits + stats.misses);
+
+  m_cache.Clear();
+  m_cache.GetStats(stats);
+  EXPECT_EQ(0u, stats.directories);
+  EXPECT_EQ(0u, stats.size);
+}
@@ -0,0 +1,128 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/SegmentedFileCache.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+const size_t SEGMENT_SIZE = 64 * 1024;
+
+char PatternAt(int64_t pos)
+{
+  return static_cast<char>((pos * 7 + pos / 251) & 0xFF);
+}
+
+void WriteRange(CSegmentedFileCache& cache, int64_t from, int64_t to)
+{
+  std::vector<char> buffer(SEGMENT_SIZE / 2);
+  int64_t pos = from;
+  while (pos < to)
+  {
+    size_t len = std::min(buffer.size(), static_cast<size_t>(to - pos));
+    for (size_t i = 0; i < len; i++)
+      buffer[i] = PatternAt(pos + i);
+    int written = cache.WriteToCache(buffer.data(), len);
+    ASSERT_GT(written, 0);
+    pos += written;
+  }
+}
+
+void ReadAndVerify(CSegmentedFileCache& cache, int64_t from, int64_t to)
+{
+  std::vector<char> buffer(SEGMENT_SIZE / 3);
+  int64_t pos = from;
+  while (pos < to)
+  {
+    int read = cache.ReadFromCache(buffer.data(), std::min(buffer.size(), static_cast<size_t>(to - pos)));
+    ASSERT_GT(read, 0);
+    for (int i = 0; i < read; i++)
+      ASSERT_EQ(PatternAt(pos + i), buffer[i]) << "at position " << pos + i;
+    pos += read;
+  }
+}
+}
+
+TEST(TestSegmentedFileCache, SeekBackIsServedFromCache)
+{
+  CSegmentedFileCache cache(16 * SEGMENT_SIZE, 8 * SEGMENT_SIZE, SEGMENT_SIZE);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  // fetch and consume the start of the file
+  WriteRange(cache, 0, 3 * SEGMENT_SIZE + 100);
+  ReadAndVerify(cache, 0, 3 * SEGMENT_SIZE + 100);
+
+  // jump somewhere else, the source has to fetch that
+  const int64_t far = 100 * SEGMENT_SIZE + 17;
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(far));
+  EXPECT_FALSE(cache.IsCachedPosition(far));
+  EXPECT_EQ(far, cache.CachedDataEndPosIfSeekTo(far));
+  EXPECT_TRUE(cache.Reset(far, false));
+  WriteRange(cache, far, far + SEGMENT_SIZE);
+  ReadAndVerify(cache, far, far + SEGMENT_SIZE);
+
+  // jumping back only needs the source to continue where the cached range ends
+  const int64_t back = SEGMENT_SIZE + 5;
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(back));
+  EXPECT_TRUE(cache.IsCachedPosition(back));
+  EXPECT_EQ(3 * SEGMENT_SIZE + 100, cache.CachedDataEndPosIfSeekTo(back));
+  EXPECT_FALSE(cache.Reset(back, false));
+  EXPECT_EQ(3 * SEGMENT_SIZE + 100, cache.CachedDataEndPos());
+  EXPECT_EQ(2 * SEGMENT_SIZE + 95, cache.WaitForData(0, 0));
+  ReadAndVerify(cache, back, 3 * SEGMENT_SIZE + 100);
+
+  EXPECT_EQ(static_cast<uint64_t>(2 * SEGMENT_SIZE + 95), cache.GetBytesSaved());
+  EXPECT_FLOAT_EQ(0.5f, cache.GetHitRatio());
+
+  // and the source picks up right behind it
+  WriteRange(cache, 3 * SEGMENT_SIZE + 100, 5 * SEGMENT_SIZE);
+  ReadAndVerify(cache, 3 * SEGMENT_SIZE + 100, 5 * SEGMENT_SIZE);
+
+  // seeking within the range the source is writing to doesn't need the source
+  EXPECT_EQ(4 * SEGMENT_SIZE, cache.Seek(4 * SEGMENT_SIZE));
+  ReadAndVerify(cache, 4 * SEGMENT_SIZE, 5 * SEGMENT_SIZE);
+
+  cache.Close();
+}
+
+TEST(TestSegmentedFileCache, EvictsLeastRecentlyUsed)
+{
+  CSegmentedFileCache cache(4 * SEGMENT_SIZE, 2 * SEGMENT_SIZE, SEGMENT_SIZE);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  // forward data is capped
+  EXPECT_EQ(2 * SEGMENT_SIZE, cache.GetMaxWriteSize(10 * SEGMENT_SIZE));
+
+  for (size_t pos = 0; pos < 6 * SEGMENT_SIZE; pos += SEGMENT_SIZE)
+  {
+    WriteRange(cache, pos, pos + SEGMENT_SIZE);
+    ReadAndVerify(cache, pos, pos + SEGMENT_SIZE);
+  }
+
+  // only the last four segments fit
+  EXPECT_FALSE(cache.IsCachedPosition(SEGMENT_SIZE / 2));
+  EXPECT_FALSE(cache.IsCachedPosition(SEGMENT_SIZE + SEGMENT_SIZE / 2));
+  EXPECT_TRUE(cache.IsCachedPosition(2 * SEGMENT_SIZE + 1));
+  EXPECT_EQ(6 * SEGMENT_SIZE, cache.CachedDataEndPosIfSeekTo(2 * SEGMENT_SIZE + 1));
+
+  EXPECT_EQ(3 * SEGMENT_SIZE, cache.Seek(3 * SEGMENT_SIZE));
+  ReadAndVerify(cache, 3 * SEGMENT_SIZE, 6 * SEGMENT_SIZE);
+
+  // nothing left to read until the source delivers more
+  char c;
+  EXPECT_EQ(CACHE_RC_WOULD_BLOCK, cache.ReadFromCache(&c, 1));
+  cache.EndOfInput();
+  EXPECT_EQ(0, cache.ReadFromCache(&c, 1));
+
+  cache.Close();
+}
@@ -12,6 +12,8 @@
 #include "utils/TimeUtils.h"
 #include "utils/XBMCTinyXML.h"
 
+#include <cinttypes>
+
 bool CGUIControlProfiler::m_bIsRunning = false;
 
 CGUIControlProfilerItem::CGUIControlProfilerItem(CGUIControlProfiler *pProfiler, CGUIControlProfilerItem *pParent, CGUIControl *pControl)
@@ -241,6 +243,8 @@ void CGUIControlProfiler::Start(void)
   m_bIsRunning = true;
   m_pLastItem = NULL;
   m_ItemHead.Reset(this);
+  m_textureStats.clear();
+  m_windows.clear();
 }
 
 void CGUIControlProfiler::BeginVisibility(CGUIControl *pControl)
@@ -267,6 +271,26 @@ void CGUIControlProfiler::EndRender(CGUIControl *pControl)
   item->EndRender();
 }
 
+void CGUIControlProfiler::BeginWindow(int windowID)
+{
+  m_windows.push_back(windowID);
+}
+
+void CGUIControlProfiler::EndWindow(int windowID)
+{
+  if (!m_windows.empty() && m_windows.back() == windowID)
+    m_windows.pop_back();
+}
+
+void CGUIControlProfiler::AddTextureLoad(uint32_t memUsage, int64_t loadTime)
+{
+  // textures loaded outside of a window are accounted to window id 0
+  TextureStats& stats = m_textureStats[m_windows.empty() ? 0 : m_windows.back()];
+  stats.count++;
+  stats.memUsage += memUsage;
+  stats.loadTime += (unsigned int)(m_fPerfScale * loadTime);
+}
+
 CGUIControlProfilerItem *CGUIControlProfiler::FindOrAddControl(CGUIControl *pControl)
 {
   if (m_pLastItem)
@@ -330,5 +354,22 @@ bool CGUIControlProfiler::SaveResults(void)
   doc.LinkEndChild(root);
 
   m_ItemHead.SaveToXML(root);
+
+  if (!m_textureStats.empty())
+  {
+    TiXmlElement *xmlTextures = new TiXmlElement("textures");
+    root->LinkEndChild(xmlTextures);
+    for (const auto& it : m_textureStats)
+    {
+      // Note time is stored in 1/100 milliseconds but reported in ms
+      TiXmlElement *elem = new TiXmlElement("window");
+      xmlTextures->LinkEndChild(elem);
+      elem->SetAttribute("id", StringUtils::Format("%d", it.first).c_str());
+      elem->SetAttribute("count", StringUtils::Format("%u", it.second.count).c_str());
+      elem->SetAttribute("memory", StringUtils::Format("%" PRIu64, it.second.memUsage).c_str());
+      elem->SetAttribute("loadtime", StringUtils::Format("%u", it.second.loadTime / 100).c_str());
+    }
+  }
+
   return doc.SaveFile(m_strOutputFile);
 }
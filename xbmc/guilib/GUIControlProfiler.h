@@ -10,6 +10,7 @@
 
 #include "GUIControl.h"
 
+#include <map>
 #include <vector>
 
 class CGUIControlProfiler;
@@ -57,6 +58,9 @@ public:
   void EndVisibility(CGUIControl *pControl);
   void BeginRender(CGUIControl *pControl);
   void EndRender(CGUIControl *pControl);
+  void BeginWindow(int windowID);
+  void EndWindow(int windowID);
+  void AddTextureLoad(uint32_t memUsage, int64_t loadTime);
   int GetMaxFrameCount(void) const { return m_iMaxFrameCount; };
   void SetMaxFrameCount(int iMaxFrameCount) { m_iMaxFrameCount = iMaxFrameCount; };
   void SetOutputFile(const std::string &strOutputFile) { m_strOutputFile = strOutputFile; };
@@ -75,6 +79,15 @@ private:
   CGUIControlProfilerItem *m_pLastItem;
   CGUIControlProfilerItem *FindOrAddControl(CGUIControl *pControl);
 
+  struct TextureStats
+  {
+    unsigned int count = 0;
+    uint64_t memUsage = 0;
+    unsigned int loadTime = 0;
+  };
+  std::map<int, TextureStats> m_textureStats; ///< textures loaded while processing a window, by window id
+  std::vector<int> m_windows; ///< windows being processed
+
   static bool m_bIsRunning;
   std::string m_strOutputFile;
   int m_iMaxFrameCount = 200;
@@ -85,4 +98,7 @@ private:
 #define GUIPROFILER_VISIBILITY_END(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().EndVisibility(x); }
 #define GUIPROFILER_RENDER_BEGIN(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().BeginRender(x); }
 #define GUIPROFILER_RENDER_END(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().EndRender(x); }
+#define GUIPROFILER_WINDOW_BEGIN(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().BeginWindow(x); }
+#define GUIPROFILER_WINDOW_END(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().EndWindow(x); }
+#define GUIPROFILER_TEXTURE_LOAD(x, y) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().AddTextureLoad(x, y); }
 
@@ -51,7 +51,8 @@ float CScrollInfo::GetPixelsPerFrame()
 }
 
 CGUIFont::CGUIFont(const std::string& strFontName, uint32_t style, UTILS::Color textColor,
-                   UTILS::Color shadowColor, float lineSpacing, float origHeight, CGUIFontTTFBase *font):
+                   UTILS::Color shadowColor, float lineSpacing, float origHeight, CGUIFontTTFBase *font,
+                   float scale):
   m_strFontName(strFontName)
 {
   m_style = style & FONT_STYLE_MASK;
@@ -60,6 +61,7 @@ CGUIFont::CGUIFont(const std::string& strFontName, uint32_t style, UTILS::Color
   m_lineSpacing = lineSpacing;
   m_origHeight = origHeight;
   m_font = font;
+  m_scale = scale;
 
   if (m_font)
     m_font->AddReference();
@@ -85,7 +87,7 @@ void CGUIFont::DrawText( float x, float y, const std::vector<UTILS::Color> &colo
   if (clip && ClippedRegionIsEmpty(x, y, maxPixelWidth, alignment))
     return;
 
-  maxPixelWidth = ROUND(maxPixelWidth / CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleX());
+  maxPixelWidth = ROUND(maxPixelWidth / (CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleX() * m_scale));
   std::vector<UTILS::Color> renderColors;
   for (unsigned int i = 0; i < colors.size(); i++)
     renderColors.push_back(CServiceBroker::GetWinSystem()->GetGfxContext().MergeAlpha(colors[i] ? colors[i] : m_textColor));
@@ -96,9 +98,9 @@ void CGUIFont::DrawText( float x, float y, const std::vector<UTILS::Color> &colo
     std::vector<UTILS::Color> shadowColors;
     for (unsigned int i = 0; i < renderColors.size(); i++)
       shadowColors.push_back((renderColors[i] & 0xff000000) != 0 ? shadowColor : 0);
-    m_font->DrawTextInternal(x + 1, y + 1, shadowColors, text, alignment, maxPixelWidth, false);
+    m_font->DrawTextInternal(x + 1, y + 1, shadowColors, text, alignment, maxPixelWidth, false, m_scale);
   }
-  m_font->DrawTextInternal( x, y, renderColors, text, alignment, maxPixelWidth, false);
+  m_font->DrawTextInternal( x, y, renderColors, text, alignment, maxPixelWidth, false, m_scale);
 
   if (clip)
     CServiceBroker::GetWinSystem()->GetGfxContext().RestoreClipRegion();
@@ -169,8 +171,9 @@ void CGUIFont::DrawScrollingText(float x, float y, const std::vector<UTILS::Colo
 
   assert(scrollInfo.m_totalWidth != 0);
 
-  float textPixelWidth = ROUND(scrollInfo.m_textWidth / CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleX());
-  float suffixPixelWidth = ROUND((scrollInfo.m_totalWidth - scrollInfo.m_textWidth) / CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleX());
+  const float scaleX = CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleX() * m_scale;
+  float textPixelWidth = ROUND(scrollInfo.m_textWidth / scaleX);
+  float suffixPixelWidth = ROUND((scrollInfo.m_totalWidth - scrollInfo.m_textWidth) / scaleX);
 
   float offset;
   if(scrollInfo.pixelSpeed >= 0)
@@ -191,14 +194,14 @@ void CGUIFont::DrawScrollingText(float x, float y, const std::vector<UTILS::Colo
       shadowColors.push_back((renderColors[i] & 0xff000000) != 0 ? shadowColor : 0);
     for (float dx = -offset; dx < maxWidth; dx += scrollInfo.m_totalWidth)
     {
-      m_font->DrawTextInternal(x + dx + 1, y + 1, shadowColors, text, alignment, textPixelWidth, scroll);
-      m_font->DrawTextInternal(x + dx + scrollInfo.m_textWidth + 1, y + 1, shadowColors, scrollInfo.suffix, alignment, suffixPixelWidth, scroll);
+      m_font->DrawTextInternal(x + dx + 1, y + 1, shadowColors, text, alignment, textPixelWidth, scroll, m_scale);
+      m_font->DrawTextInternal(x + dx + scrollInfo.m_textWidth + 1, y + 1, shadowColors, scrollInfo.suffix, alignment, suffixPixelWidth, scroll, m_scale);
     }
   }
   for (float dx = -offset; dx < maxWidth; dx += scrollInfo.m_totalWidth)
   {
-    m_font->DrawTextInternal(x + dx, y, renderColors, text, alignment, textPixelWidth, scroll);
-    m_font->DrawTextInternal(x + dx + scrollInfo.m_textWidth, y, renderColors, scrollInfo.suffix, alignment, suffixPixelWidth, scroll);
+    m_font->DrawTextInternal(x + dx, y, renderColors, text, alignment, textPixelWidth, scroll, m_scale);
+    m_font->DrawTextInternal(x + dx + scrollInfo.m_textWidth, y, renderColors, scrollInfo.suffix, alignment, suffixPixelWidth, scroll, m_scale);
   }
 
   CServiceBroker::GetWinSystem()->GetGfxContext().RestoreClipRegion();
@@ -219,47 +222,47 @@ bool CGUIFont::ClippedRegionIsEmpty(float x, float y, float width, uint32_t alig
   else if (alignment & XBFONT_RIGHT)
     x -= width;
   if (alignment & XBFONT_CENTER_Y)
-    y -= m_font->GetLineHeight(m_lineSpacing);
+    y -= m_font->GetLineHeight(m_lineSpacing) * m_scale;
 
-  return !CServiceBroker::GetWinSystem()->GetGfxContext().SetClipRegion(x, y, width, m_font->GetTextHeight(1, 2) * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleY());
+  return !CServiceBroker::GetWinSystem()->GetGfxContext().SetClipRegion(x, y, width, m_font->GetTextHeight(1, 2) * m_scale * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleY());
 }
 
 float CGUIFont::GetTextWidth( const vecText &text )
 {
   if (!m_font) return 0;
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
-  return m_font->GetTextWidthInternal(text.begin(), text.end()) * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleX();
+  return m_font->GetTextWidthInternal(text.begin(), text.end()) * m_scale * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleX();
 }
 
 float CGUIFont::GetCharWidth( character_t ch )
 {
   if (!m_font) return 0;
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
-  return m_font->GetCharWidthInternal(ch) * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleX();
+  return m_font->GetCharWidthInternal(ch) * m_scale * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleX();
 }
 
 float CGUIFont::GetTextHeight(int numLines) const
 {
   if (!m_font) return 0;
-  return m_font->GetTextHeight(m_lineSpacing, numLines) * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleY();
+  return m_font->GetTextHeight(m_lineSpacing, numLines) * m_scale * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleY();
 }
 
 float CGUIFont::GetTextBaseLine() const
 {
   if (!m_font) return 0;
-  return m_font->GetTextBaseLine() * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleY();
+  return m_font->GetTextBaseLine() * m_scale * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleY();
 }
 
 float CGUIFont::GetLineHeight() const
 {
   if (!m_font) return 0;
-  return m_font->GetLineHeight(m_lineSpacing) * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleY();
+  return m_font->GetLineHeight(m_lineSpacing) * m_scale * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleY();
 }
 
 float CGUIFont::GetScaleFactor() const
 {
   if (!m_font) return 1.0f;
-  return m_font->GetFontHeight() / m_origHeight;
+  return m_font->GetFontHeight() * m_scale / m_origHeight;
 }
 
 void CGUIFont::Begin()
@@ -274,8 +277,9 @@ void CGUIFont::End()
   m_font->End();
 }
 
-void CGUIFont::SetFont(CGUIFontTTFBase *font)
+void CGUIFont::SetFont(CGUIFontTTFBase *font, float scale)
 {
+  m_scale = scale;
   if (m_font == font)
     return; // no need to update the font if we already have it
   if (m_font)
@@ -105,7 +105,8 @@ class CGUIFont
 {
 public:
   CGUIFont(const std::string& strFontName, uint32_t style, UTILS::Color textColor,
-	   UTILS::Color shadowColor, float lineSpacing, float origHeight, CGUIFontTTFBase *font);
+	   UTILS::Color shadowColor, float lineSpacing, float origHeight, CGUIFontTTFBase *font,
+	   float scale = 1.0f);
   virtual ~CGUIFont();
 
   std::string& GetFontName();
@@ -147,7 +148,13 @@ public:
     return m_font;
   }
 
-  void SetFont(CGUIFontTTFBase* font);
+  /*!
+   \brief Set the font file to render with
+   \param font the font file
+   \param scale the size to render at relative to the size the font file was loaded at,
+   only differs from 1 for distance field fonts which are shared between all sizes
+   */
+  void SetFont(CGUIFontTTFBase* font, float scale = 1.0f);
 
 protected:
   std::string m_strFontName;
@@ -157,6 +164,7 @@ protected:
   float m_lineSpacing;
   float m_origHeight;
   CGUIFontTTFBase *m_font; // the font object has the size information
+  float m_scale; // size relative to the font object
 
 private:
   bool ClippedRegionIsEmpty(float x, float y, float width, uint32_t alignment) const;
@@ -82,7 +82,7 @@ public:
                 const std::vector<UTILS::Color> &colors, const vecText &text,
                 uint32_t alignment, float maxPixelWidth,
                 bool scrolling,
-                unsigned int nowMillis, bool &dirtyCache);
+                unsigned int nowMillis, float scale, bool &dirtyCache);
   void Flush();
 };
 
@@ -128,12 +128,12 @@ Value &CGUIFontCache<Position, Value>::Lookup(Position &pos,
                                               const std::vector<UTILS::Color> &colors, const vecText &text,
                                               uint32_t alignment, float maxPixelWidth,
                                               bool scrolling,
-                                              unsigned int nowMillis, bool &dirtyCache)
+                                              unsigned int nowMillis, float scale, bool &dirtyCache)
 {
   if (m_impl == nullptr)
     m_impl = new CGUIFontCacheImpl<Position, Value>(this);
 
-  return m_impl->Lookup(pos, colors, text, alignment, maxPixelWidth, scrolling, nowMillis, dirtyCache);
+  return m_impl->Lookup(pos, colors, text, alignment, maxPixelWidth, scrolling, nowMillis, scale, dirtyCache);
 }
 
 template<class Position, class Value>
@@ -141,13 +141,14 @@ Value &CGUIFontCacheImpl<Position, Value>::Lookup(Position &pos,
                                                   const std::vector<UTILS::Color> &colors, const vecText &text,
                                                   uint32_t alignment, float maxPixelWidth,
                                                   bool scrolling,
-                                                  unsigned int nowMillis, bool &dirtyCache)
+                                                  unsigned int nowMillis, float scale, bool &dirtyCache)
 {
+  // distance field fonts are drawn at several sizes, which scale the text like the GUI does
   const CGUIFontCacheKey<Position> key(pos,
                                        const_cast<std::vector<UTILS::Color> &>(colors), const_cast<vecText &>(text),
                                        alignment, maxPixelWidth,
                                        scrolling, CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIMatrix(),
-                                       CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleX(), CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleY());
+                                       scale * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleX(), scale * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleY());
 
   auto i = m_list.FindKey(key);
   if (i == m_list.hashMap.end())
@@ -200,13 +201,13 @@ void CGUIFontCacheImpl<Position, Value>::Flush()
 template CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::CGUIFontCache(CGUIFontTTFBase &font);
 template CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::~CGUIFontCache();
 template CGUIFontCacheEntry<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::~CGUIFontCacheEntry();
-template CGUIFontCacheStaticValue &CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::Lookup(CGUIFontCacheStaticPosition &, const std::vector<UTILS::Color> &, const vecText &, uint32_t, float, bool, unsigned int, bool &);
+template CGUIFontCacheStaticValue &CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::Lookup(CGUIFontCacheStaticPosition &, const std::vector<UTILS::Color> &, const vecText &, uint32_t, float, bool, unsigned int, float, bool &);
 template void CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue>::Flush();
 
 template CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::CGUIFontCache(CGUIFontTTFBase &font);
 template CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::~CGUIFontCache();
 template CGUIFontCacheEntry<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::~CGUIFontCacheEntry();
-template CGUIFontCacheDynamicValue &CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::Lookup(CGUIFontCacheDynamicPosition &, const std::vector<UTILS::Color> &, const vecText &, uint32_t, float, bool, unsigned int, bool &);
+template CGUIFontCacheDynamicValue &CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::Lookup(CGUIFontCacheDynamicPosition &, const std::vector<UTILS::Color> &, const vecText &, uint32_t, float, bool, unsigned int, float, bool &);
 template void CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue>::Flush();
 
 void CVertexBuffer::clear()
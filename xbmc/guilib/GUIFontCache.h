@@ -139,7 +139,7 @@ public:
                 const std::vector<UTILS::Color> &colors, const vecText &text,
                 uint32_t alignment, float maxPixelWidth,
                 bool scrolling,
-                unsigned int nowMillis, bool &dirtyCache);
+                unsigned int nowMillis, float scale, bool &dirtyCache);
   void Flush();
 };
 
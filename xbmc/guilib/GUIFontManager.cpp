@@ -27,6 +27,8 @@
 #include "FileItem.h"
 #include "URL.h"
 #include "ServiceBroker.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
 
 #ifdef TARGET_POSIX
 #include "filesystem/SpecialProtocol.h"
@@ -34,6 +36,23 @@
 
 using namespace ADDON;
 
+namespace
+{
+bool UseDistanceField()
+{
+  return CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiFontDistanceField &&
+         CGUIFontTTF::SupportsDistanceField();
+}
+
+std::string GetFontFileName(const std::string& strFilename, float size, float aspect, bool border, bool distanceField)
+{
+  // distance field fonts are scaled to any size, so all sizes share one font file
+  if (distanceField)
+    return StringUtils::Format("%s_sdf_%f%s", strFilename.c_str(), aspect, border ? "_border" : "");
+  return StringUtils::Format("%s_%f_%f%s", strFilename.c_str(), size, aspect, border ? "_border" : "");
+}
+}
+
 GUIFontManager::GUIFontManager(void)
 {
   m_canReload = true;
@@ -129,13 +148,15 @@ CGUIFont* GUIFontManager::LoadTTF(const std::string& strFontName, const std::str
   }
 
   // check if we already have this font file loaded (font object could differ only by color or style)
-  std::string TTFfontName = StringUtils::Format("%s_%f_%f%s", strFilename.c_str(), newSize, aspect, border ? "_border" : "");
+  const bool distanceField = UseDistanceField();
+  const float fileSize = distanceField ? DISTANCE_FIELD_FONT_SIZE : newSize;
+  std::string TTFfontName = GetFontFileName(strFilename, newSize, aspect, border, distanceField);
 
   CGUIFontTTFBase* pFontFile = GetFontFile(TTFfontName);
   if (!pFontFile)
   {
     pFontFile = new CGUIFontTTF(TTFfontName);
-    bool bFontLoaded = pFontFile->Load(strPath, newSize, aspect, 1.0f, border);
+    bool bFontLoaded = pFontFile->Load(strPath, fileSize, aspect, 1.0f, border, distanceField);
 
     if (!bFontLoaded)
     {
@@ -156,7 +177,7 @@ CGUIFont* GUIFontManager::LoadTTF(const std::string& strFontName, const std::str
   }
 
   // font file is loaded, create our CGUIFont
-  CGUIFont *pNewFont = new CGUIFont(strFontName, iStyle, textColor, shadowColor, lineSpacing, (float)iSize, pFontFile);
+  CGUIFont *pNewFont = new CGUIFont(strFontName, iStyle, textColor, shadowColor, lineSpacing, (float)iSize, pFontFile, newSize / fileSize);
   m_vecFonts.push_back(pNewFont);
 
   // Store the original TTF font info in case we need to reload it in a different resolution
@@ -222,12 +243,14 @@ void GUIFontManager::ReloadTTFFonts(void)
 
     RescaleFontSizeAndAspect(&newSize, &aspect, fontInfo.sourceRes, fontInfo.preserveAspect);
 
-    std::string TTFfontName = StringUtils::Format("%s_%f_%f%s", strFilename.c_str(), newSize, aspect, fontInfo.border ? "_border" : "");
+    const bool distanceField = UseDistanceField();
+    const float fileSize = distanceField ? DISTANCE_FIELD_FONT_SIZE : newSize;
+    std::string TTFfontName = GetFontFileName(strFilename, newSize, aspect, fontInfo.border, distanceField);
     CGUIFontTTFBase* pFontFile = GetFontFile(TTFfontName);
     if (!pFontFile)
     {
       pFontFile = new CGUIFontTTF(TTFfontName);
-      if (!pFontFile || !pFontFile->Load(strPath, newSize, aspect, 1.0f, fontInfo.border))
+      if (!pFontFile || !pFontFile->Load(strPath, fileSize, aspect, 1.0f, fontInfo.border, distanceField))
       {
         delete pFontFile;
         // font could not be loaded
@@ -238,7 +261,7 @@ void GUIFontManager::ReloadTTFFonts(void)
       m_vecFontFiles.push_back(pFontFile);
     }
 
-    font->SetFont(pFontFile);
+    font->SetFont(pFontFile, newSize / fileSize);
   }
 }
 
@@ -21,6 +21,7 @@
 #include "filesystem/File.h"
 #include "threads/SystemClock.h"
 
+#include <algorithm>
 #include <math.h>
 #include <memory>
 #include <queue>
@@ -41,6 +42,66 @@
 #define CHAR_CHUNK    64      // 64 chars allocated at a time (1024 bytes)
 #define GLYPH_STRENGTH_BOLD 24
 #define GLYPH_STRENGTH_LIGHT -48
+#define DISTANCE_FIELD_SPREAD 8  // pixels a distance field reaches beyond the glyph outline
+
+namespace
+{
+struct DistanceOffset
+{
+  int dx, dy;
+  int Squared() const { return dx * dx + dy * dy; }
+};
+
+const DistanceOffset DISTANCE_FAR = { 10000, 10000 };
+
+/*!
+ \brief Propagate the offsets to the nearest set pixel through the grid, in two passes over
+ the neighbours of each pixel (8SSEDT).
+ */
+void PropagateDistances(std::vector<DistanceOffset>& grid, int width, int height)
+{
+  auto compare = [&grid, width, height](DistanceOffset& p, int x, int y, int offsetX, int offsetY)
+  {
+    x += offsetX;
+    y += offsetY;
+    if (x < 0 || y < 0 || x >= width || y >= height)
+      return;
+    DistanceOffset other = grid[y * width + x];
+    other.dx += offsetX;
+    other.dy += offsetY;
+    if (other.Squared() < p.Squared())
+      p = other;
+  };
+
+  for (int y = 0; y < height; y++)
+  {
+    for (int x = 0; x < width; x++)
+    {
+      DistanceOffset& p = grid[y * width + x];
+      compare(p, x, y, -1, 0);
+      compare(p, x, y, 0, -1);
+      compare(p, x, y, -1, -1);
+      compare(p, x, y, 1, -1);
+    }
+    for (int x = width - 1; x >= 0; x--)
+      compare(grid[y * width + x], x, y, 1, 0);
+  }
+
+  for (int y = height - 1; y >= 0; y--)
+  {
+    for (int x = width - 1; x >= 0; x--)
+    {
+      DistanceOffset& p = grid[y * width + x];
+      compare(p, x, y, 1, 0);
+      compare(p, x, y, 0, 1);
+      compare(p, x, y, -1, 1);
+      compare(p, x, y, 1, 1);
+    }
+    for (int x = 0; x < width; x++)
+      compare(grid[y * width + x], x, y, -1, 0);
+  }
+}
+}
 
 
 class CFreeTypeLibrary
@@ -164,6 +225,9 @@ CGUIFontTTFBase::CGUIFontTTFBase(const std::string& strFileName) : m_staticCache
   m_ellipsesWidth = m_height = 0.0f;
   m_color = 0;
   m_nTexture = 0;
+  m_distanceField = false;
+  m_glyphPadding = 0;
+  m_glyphsRendered = 0;
 
   m_renderSystem = CServiceBroker::GetRenderSystem();
 }
@@ -232,7 +296,7 @@ void CGUIFontTTFBase::Clear()
   m_fontFileInMemory.clear();
 }
 
-bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float aspect, float lineSpacing, bool border)
+bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float aspect, float lineSpacing, bool border, bool distanceField)
 {
   // we now know that this object is unique - only the GUIFont objects are non-unique, so no need
   // for reference tracking these fonts
@@ -290,6 +354,10 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
 
   m_height = height;
 
+  m_distanceField = distanceField;
+  m_glyphPadding = distanceField ? DISTANCE_FIELD_SPREAD : 0;
+  m_glyphsRendered = 0;
+
   delete(m_texture);
   m_texture = NULL;
   delete[] m_char;
@@ -301,7 +369,7 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
   m_strFilename = strFilename;
 
   m_textureHeight = 0;
-  m_textureWidth = ((m_cellHeight * CHARS_PER_TEXTURE_LINE) & ~63) + 64;
+  m_textureWidth = (((m_cellHeight + 2 * m_glyphPadding) * CHARS_PER_TEXTURE_LINE) & ~63) + 64;
 
   m_textureWidth = CBaseTexture::PadPow2(m_textureWidth);
 
@@ -342,7 +410,7 @@ void CGUIFontTTFBase::End()
   LastEnd();
 }
 
-void CGUIFontTTFBase::DrawTextInternal(float x, float y, const std::vector<UTILS::Color> &colors, const vecText &text, uint32_t alignment, float maxPixelWidth, bool scrolling)
+void CGUIFontTTFBase::DrawTextInternal(float x, float y, const std::vector<UTILS::Color> &colors, const vecText &text, uint32_t alignment, float maxPixelWidth, bool scrolling, float scale)
 {
   if (text.empty())
   {
@@ -369,6 +437,7 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const std::vector<UTILS
                             alignment, maxPixelWidth,
                             scrolling,
                             XbmcThreads::SystemClockMillis(),
+                            scale,
                             dirtyCache) :
       unusedVertexBuffer;
   std::shared_ptr<std::vector<SVertex> > tempVertices = std::make_shared<std::vector<SVertex> >();
@@ -379,6 +448,7 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const std::vector<UTILS
                            alignment, maxPixelWidth,
                            scrolling,
                            XbmcThreads::SystemClockMillis(),
+                           scale,
                            dirtyCache));
   if (dirtyCache)
   {
@@ -492,7 +562,7 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const std::vector<UTILS
 
           for (int i = 0; i < 3; i++)
           {
-            RenderCharacter(startX + cursorX, startY, period, color, !scrolling, *tempVertices);
+            RenderCharacter(startX + cursorX, startY, period, color, !scrolling, scale, *tempVertices);
             cursorX += period->advance;
           }
           break;
@@ -501,7 +571,7 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const std::vector<UTILS
       else if (maxPixelWidth > 0 && cursorX > maxPixelWidth)
         break;  // exceeded max allowed width - stop rendering
 
-      RenderCharacter(startX + cursorX, startY, ch, color, !scrolling, *tempVertices);
+      RenderCharacter(startX + cursorX, startY, ch, color, !scrolling, scale, *tempVertices);
       if ( alignment & XBFONT_JUSTIFIED )
       {
         if ((pos & 0xffff) == L' ')
@@ -520,6 +590,7 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const std::vector<UTILS
                                                           rawAlignment, maxPixelWidth,
                                                           scrolling,
                                                           XbmcThreads::SystemClockMillis(),
+                                                          scale,
                                                           dirtyCache);
       CVertexBuffer newVertexBuffer = CreateVertexBuffer(*tempVertices);
       vertexBuffer = newVertexBuffer;
@@ -533,6 +604,7 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const std::vector<UTILS
                            rawAlignment, maxPixelWidth,
                            scrolling,
                            XbmcThreads::SystemClockMillis(),
+                           scale,
                            dirtyCache) = *static_cast<CGUIFontCacheStaticValue *>(&tempVertices);
       /* Append the new vertices to the set collected since the first Begin() call */
       m_vertex.insert(m_vertex.end(), tempVertices->begin(), tempVertices->end());
@@ -564,7 +636,7 @@ float CGUIFontTTFBase::GetTextWidthInternal(vecText::const_iterator start, vecTe
       // and not advance distance - this makes sure that italic text isn't
       // choped on the end (as render width is larger than advance then).
       if (start == end)
-        width += std::max(c->right - c->left + c->offsetX, c->advance);
+        width += std::max(c->right - c->left + c->offsetX - m_glyphPadding, c->advance);
       else
         width += c->advance;
     }
@@ -595,7 +667,7 @@ const unsigned int CGUIFontTTFBase::spacing_between_characters_in_texture = 1;
 
 unsigned int CGUIFontTTFBase::GetTextureLineHeight() const
 {
-  return m_cellHeight + spacing_between_characters_in_texture;
+  return m_cellHeight + 2 * m_glyphPadding + spacing_between_characters_in_texture;
 }
 
 CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
@@ -651,24 +723,36 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
     memmove(m_char + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
   }
   // render the character to our texture
-  // must End() as we can't render text to our texture during a Begin(), End() block
+  // the glyphs are uploaded along with the text of a Begin(), End() block, unless the texture
+  // has to grow: that changes the texture coordinates of the text so far, so we must End() first
   unsigned int nestedBeginCount = m_nestedBeginCount;
-  m_nestedBeginCount = 1;
-  if (nestedBeginCount) End();
+  bool ended = false;
+  if (nestedBeginCount && (!m_texture || m_posY + 2 * GetTextureLineHeight() >= m_textureHeight))
+  {
+    m_nestedBeginCount = 1;
+    End();
+    ended = true;
+  }
   if (!CacheCharacter(letter, style, m_char + low))
   { // unable to cache character - try clearing them all out and starting over
     CLog::Log(LOGDEBUG, "%s: Unable to cache character.  Clearing character cache of %i characters", __FUNCTION__, m_numChars);
+    if (nestedBeginCount && !ended)
+    {
+      m_nestedBeginCount = 1;
+      End();
+      ended = true;
+    }
     ClearCharacterCache();
     low = 0;
     if (!CacheCharacter(letter, style, m_char + low))
     {
       CLog::Log(LOGERROR, "%s: Unable to cache character (out of memory?)", __FUNCTION__);
-      if (nestedBeginCount) Begin();
+      if (ended) Begin();
       m_nestedBeginCount = nestedBeginCount;
       return NULL;
     }
   }
-  if (nestedBeginCount) Begin();
+  if (ended) Begin();
   m_nestedBeginCount = nestedBeginCount;
 
   // fixup quick access
@@ -690,7 +774,8 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   int glyph_index = FT_Get_Char_Index( m_face, letter );
 
   FT_Glyph glyph = NULL;
-  if (FT_Load_Glyph( m_face, glyph_index, FT_LOAD_TARGET_LIGHT ))
+  // distance fields are drawn at any size, so don't hint the outlines for this one
+  if (FT_Load_Glyph( m_face, glyph_index, m_distanceField ? FT_LOAD_NO_HINTING : FT_LOAD_TARGET_LIGHT ))
   {
     CLog::Log(LOGDEBUG, "%s Failed to load glyph %x", __FUNCTION__, static_cast<uint32_t>(letter));
     return false;
@@ -722,19 +807,37 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   FT_Bitmap bitmap = bitGlyph->bitmap;
   bool isEmptyGlyph = (bitmap.width == 0 || bitmap.rows == 0);
 
+  const unsigned char* pixels = bitmap.buffer;
+  int pitch = bitmap.pitch;
+  unsigned int width = bitmap.width;
+  unsigned int rows = bitmap.rows;
+  int left = bitGlyph->left;
+  int top = bitGlyph->top;
+  std::vector<unsigned char> field;
+  if (m_distanceField && !isEmptyGlyph)
+  {
+    CreateDistanceField(bitmap.buffer, bitmap.width, bitmap.rows, bitmap.pitch, m_glyphPadding, field);
+    pixels = field.data();
+    width += 2 * m_glyphPadding;
+    rows += 2 * m_glyphPadding;
+    pitch = width;
+    left -= m_glyphPadding;
+    top += m_glyphPadding;
+  }
+
   if (!isEmptyGlyph)
   {
-    if (bitGlyph->left < 0)
-      m_posX += -bitGlyph->left;
+    if (left < 0)
+      m_posX += -left;
 
     // check we have enough room for the character.
     // cast-fest is here to avoid warnings due to freeetype version differences (signedness of width).
-    if (static_cast<int>(m_posX + bitGlyph->left + bitmap.width) > static_cast<int>(m_textureWidth))
+    if (static_cast<int>(m_posX + left + width) > static_cast<int>(m_textureWidth))
     { // no space - gotta drop to the next line (which means creating a new texture and copying it across)
       m_posX = 0;
       m_posY += GetTextureLineHeight();
-      if (bitGlyph->left < 0)
-        m_posX += -bitGlyph->left;
+      if (left < 0)
+        m_posX += -left;
 
       if(m_posY + GetTextureLineHeight() >= m_textureHeight)
       {
@@ -769,12 +872,12 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   }
   // set the character in our table
   ch->letterAndStyle = (style << 16) | letter;
-  ch->offsetX = (short)bitGlyph->left;
-  ch->offsetY = (short)m_cellBaseLine - bitGlyph->top;
+  ch->offsetX = (short)left;
+  ch->offsetY = (short)m_cellBaseLine - top;
   ch->left = isEmptyGlyph ? 0 : ((float)m_posX + ch->offsetX);
-  ch->top = isEmptyGlyph ? 0 : ((float)m_posY + ch->offsetY);
-  ch->right = ch->left + bitmap.width;
-  ch->bottom = ch->top + bitmap.rows;
+  ch->top = isEmptyGlyph ? 0 : ((float)m_posY + m_glyphPadding + ch->offsetY);
+  ch->right = ch->left + width;
+  ch->bottom = ch->top + rows;
   ch->advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
 
   // we need only render if we actually have some pixels
@@ -782,14 +885,15 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   {
     // ensure our rect will stay inside the texture (it *should* but we need to be certain)
     unsigned int x1 = std::max(m_posX + ch->offsetX, 0);
-    unsigned int y1 = std::max(m_posY + ch->offsetY, 0);
-    unsigned int x2 = std::min(x1 + bitmap.width, m_textureWidth);
-    unsigned int y2 = std::min(y1 + bitmap.rows, m_textureHeight);
-    CopyCharToTexture(bitGlyph, x1, y1, x2, y2);
+    unsigned int y1 = std::max(m_posY + static_cast<int>(m_glyphPadding) + ch->offsetY, 0);
+    unsigned int x2 = std::min(x1 + width, m_textureWidth);
+    unsigned int y2 = std::min(y1 + rows, m_textureHeight);
+    CopyCharToTexture(pixels, pitch, x1, y1, x2, y2);
 
     m_posX += spacing_between_characters_in_texture + (unsigned short)std::max(ch->right - ch->left + ch->offsetX, ch->advance);
   }
   m_numChars++;
+  m_glyphsRendered++;
 
   // free the glyph
   FT_Done_Glyph(glyph);
@@ -797,7 +901,7 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   return true;
 }
 
-void CGUIFontTTFBase::RenderCharacter(float posX, float posY, const Character *ch, UTILS::Color color, bool roundX, std::vector<SVertex> &vertices)
+void CGUIFontTTFBase::RenderCharacter(float posX, float posY, const Character *ch, UTILS::Color color, bool roundX, float scale, std::vector<SVertex> &vertices)
 {
   // actual image width isn't same as the character width as that is
   // just baseline width and height should include the descent
@@ -810,10 +914,13 @@ void CGUIFontTTFBase::RenderCharacter(float posX, float posY, const Character *c
 
   // posX and posY are relative to our origin, and the textcell is offset
   // from our (posX, posY).  Plus, these are unscaled quantities compared to the underlying GUI resolution
-  CRect vertex((posX + ch->offsetX) * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleX(),
-               (posY + ch->offsetY) * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleY(),
-               (posX + ch->offsetX + width) * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleX(),
-               (posY + ch->offsetY + height) * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleY());
+  // and, for distance fields, to the size the font is drawn at
+  const float scaleX = scale * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleX();
+  const float scaleY = scale * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleY();
+  CRect vertex((posX + ch->offsetX) * scaleX,
+               (posY + ch->offsetY) * scaleY,
+               (posX + ch->offsetX + width) * scaleX,
+               (posY + ch->offsetY + height) * scaleY);
   vertex += CPoint(m_originX, m_originY);
   CRect texture(ch->left, ch->top, ch->right, ch->bottom);
   if (!m_renderSystem->ScissorsCanEffectClipping())
@@ -938,6 +1045,40 @@ void CGUIFontTTFBase::RenderCharacter(float posX, float posY, const Character *c
 #endif
 }
 
+void CGUIFontTTFBase::CreateDistanceField(const unsigned char* pixels, unsigned int width, unsigned int height, int pitch,
+                                          unsigned int spread, std::vector<unsigned char>& field)
+{
+  const int fieldWidth = width + 2 * spread;
+  const int fieldHeight = height + 2 * spread;
+
+  // offsets to the nearest pixel inside and outside of the glyph
+  std::vector<DistanceOffset> inside(fieldWidth * fieldHeight, DISTANCE_FAR);
+  std::vector<DistanceOffset> outside(fieldWidth * fieldHeight, DistanceOffset{ 0, 0 });
+  for (unsigned int y = 0; y < height; y++)
+  {
+    const unsigned char* row = pixels + y * pitch;
+    for (unsigned int x = 0; x < width; x++)
+    {
+      if (row[x] >= 128)
+      {
+        const int i = (y + spread) * fieldWidth + x + spread;
+        inside[i] = { 0, 0 };
+        outside[i] = DISTANCE_FAR;
+      }
+    }
+  }
+
+  PropagateDistances(inside, fieldWidth, fieldHeight);
+  PropagateDistances(outside, fieldWidth, fieldHeight);
+
+  field.resize(fieldWidth * fieldHeight);
+  for (size_t i = 0; i < field.size(); i++)
+  {
+    const float distance = sqrtf(static_cast<float>(outside[i].Squared())) - sqrtf(static_cast<float>(inside[i].Squared()));
+    field[i] = static_cast<unsigned char>(std::max(0.0f, std::min(255.0f, 128.0f + distance * 128.0f / spread)));
+  }
+}
+
 // Oblique code - original taken from freetype2 (ftsynth.c)
 void CGUIFontTTFBase::ObliqueGlyph(FT_GlyphSlot slot)
 {
@@ -25,6 +25,7 @@ using namespace DirectX::PackedVector;
 #endif
 
 constexpr size_t LOOKUPTABLE_SIZE = 256 * 8;
+constexpr float DISTANCE_FIELD_FONT_SIZE = 64.0f; // size distance field fonts are rendered at, whatever size they're drawn at
 
 class CBaseTexture;
 class CRenderSystemBase;
@@ -75,7 +76,7 @@ public:
 
   void Clear();
 
-  bool Load(const std::string& strFilename, float height = 20.0f, float aspect = 1.0f, float lineSpacing = 1.0f, bool border = false);
+  bool Load(const std::string& strFilename, float height = 20.0f, float aspect = 1.0f, float lineSpacing = 1.0f, bool border = false, bool distanceField = false);
 
   void Begin();
   void End();
@@ -85,6 +86,19 @@ public:
 
   const std::string& GetFileName() const { return m_strFileName; };
 
+  /*! \brief Whether the glyphs are stored as distance fields, which are drawn at any size
+   \sa DISTANCE_FIELD_FONT_SIZE
+   */
+  bool IsDistanceField() const { return m_distanceField; }
+
+  /*! \brief The number of glyphs rendered to the texture since the font was loaded
+   */
+  unsigned int GetGlyphsRendered() const { return m_glyphsRendered; }
+
+  /*! \brief The size of the glyph texture in bytes
+   */
+  unsigned int GetTextureMemory() const { return m_textureWidth * m_textureHeight; }
+
 protected:
   struct Character
   {
@@ -104,7 +118,7 @@ protected:
   float GetFontHeight() const { return m_height; }
 
   void DrawTextInternal(float x, float y, const std::vector<UTILS::Color> &colors, const vecText &text,
-                            uint32_t alignment, float maxPixelWidth, bool scrolling);
+                            uint32_t alignment, float maxPixelWidth, bool scrolling, float scale = 1.0f);
 
   float m_height;
   std::string m_strFilename;
@@ -112,11 +126,18 @@ protected:
   // Stuff for pre-rendering for speed
   inline Character *GetCharacter(character_t letter);
   bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
-  void RenderCharacter(float posX, float posY, const Character *ch, UTILS::Color color, bool roundX, std::vector<SVertex> &vertices);
+  void RenderCharacter(float posX, float posY, const Character *ch, UTILS::Color color, bool roundX, float scale, std::vector<SVertex> &vertices);
   void ClearCharacterCache();
 
+  /*! \brief Convert a glyph bitmap to a distance field.
+   The field is padded by spread pixels on every side, 128 marks the edge of the glyph and every
+   step of 128 / spread the distance of a pixel to it, inside the glyph upwards.
+   */
+  static void CreateDistanceField(const unsigned char* pixels, unsigned int width, unsigned int height, int pitch,
+                                  unsigned int spread, std::vector<unsigned char>& field);
+
   virtual CBaseTexture* ReallocTexture(unsigned int& newHeight) = 0;
-  virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) = 0;
+  virtual bool CopyCharToTexture(const unsigned char* pixels, int pitch, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) = 0;
   virtual void DeleteHardwareTexture() = 0;
 
   // modifying glyphs
@@ -148,6 +169,10 @@ protected:
   unsigned int m_cellBaseLine;
   unsigned int m_cellHeight;
 
+  bool m_distanceField;              // glyphs are stored as distance fields
+  unsigned int m_glyphPadding;       // pixels around each glyph in the texture, the spread of distance fields
+  unsigned int m_glyphsRendered;
+
   unsigned int m_nestedBeginCount;             // speedups
 
   // freetype stuff
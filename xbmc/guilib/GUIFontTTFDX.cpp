@@ -116,6 +116,7 @@ void CGUIFontTTFDX::LastEnd()
 
       // 6 indices and 4 vertices per character
       pGUIShader->DrawIndexed(count * 6, 0, character * 4);
+      DX::Windowing()->AddDrawCalls(1);
     }
   }
 
@@ -163,6 +164,7 @@ void CGUIFontTTFDX::LastEnd()
 
         // 6 indices and 4 vertices per character
         pGUIShader->DrawIndexed(count * 6, 0, character * 4);
+        DX::Windowing()->AddDrawCalls(1);
       }
     }
 
@@ -263,15 +265,13 @@ CBaseTexture* CGUIFontTTFDX::ReallocTexture(unsigned int& newHeight)
   return pNewTexture;
 }
 
-bool CGUIFontTTFDX::CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
+bool CGUIFontTTFDX::CopyCharToTexture(const unsigned char* pixels, int pitch, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
 {
-  FT_Bitmap bitmap = bitGlyph->bitmap;
-
   ComPtr<ID3D11DeviceContext> pContext = DX::DeviceResources::Get()->GetImmediateContext();
-  if (m_speedupTexture && m_speedupTexture->Get() && pContext && bitmap.buffer)
+  if (m_speedupTexture && m_speedupTexture->Get() && pContext && pixels)
   {
     CD3D11_BOX dstBox(x1, y1, 0, x2, y2, 1);
-    pContext->UpdateSubresource(m_speedupTexture->Get(), 0, &dstBox, bitmap.buffer, bitmap.pitch, 0);
+    pContext->UpdateSubresource(m_speedupTexture->Get(), 0, &dstBox, pixels, pitch, 0);
     return true;
   }
 
@@ -43,10 +43,11 @@ public:
 
   static void CreateStaticIndexBuffer(void);
   static void DestroyStaticIndexBuffer(void);
+  static bool SupportsDistanceField() { return false; }
 
 protected:
   CBaseTexture* ReallocTexture(unsigned int& newHeight) override;
-  bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) override;
+  bool CopyCharToTexture(const unsigned char* pixels, int pitch, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) override;
   void DeleteHardwareTexture() override;
 
 private:
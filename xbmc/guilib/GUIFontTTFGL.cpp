@@ -52,6 +52,24 @@ CGUIFontTTFGL::~CGUIFontTTFGL(void)
 }
 
 bool CGUIFontTTFGL::FirstBegin()
+{
+  UpdateTexture();
+
+#ifdef HAS_GL
+  CRenderSystemGL* renderSystem = dynamic_cast<CRenderSystemGL*>(CServiceBroker::GetRenderSystem());
+  if (renderSystem->BatchDraws())
+    return true;
+#endif
+
+  // Turn Blending On
+  glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
+  glEnable(GL_BLEND);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, m_nTexture);
+  return true;
+}
+
+void CGUIFontTTFGL::UpdateTexture()
 {
 #if defined(HAS_GL)
   GLenum pixformat = GL_RED;
@@ -104,20 +122,41 @@ bool CGUIFontTTFGL::FirstBegin()
     m_updateY1 = m_updateY2 = 0;
     m_textureStatus = TEXTURE_READY;
   }
-
-  // Turn Blending On
-  glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
-  glEnable(GL_BLEND);
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, m_nTexture);
-  return true;
 }
 
 void CGUIFontTTFGL::LastEnd()
 {
+  // upload the glyphs cached since FirstBegin() in one go
+  if (m_textureStatus == TEXTURE_UPDATED)
+  {
+    UpdateTexture();
+    glBindTexture(GL_TEXTURE_2D, m_nTexture);
+  }
+
 #ifdef HAS_GL
   CRenderSystemGL* renderSystem = dynamic_cast<CRenderSystemGL*>(CServiceBroker::GetRenderSystem());
-  renderSystem->EnableShader(SM_FONTS);
+  if (renderSystem->BatchDraws())
+  {
+    // all text is clipped in software then, see CRenderSystemGL::ScissorsCanEffectClipping()
+    // the glyph vertices are in triangle strip order: top left, bottom left, top right, bottom right
+    static const int order[] = {0, 2, 3, 1};
+    m_batchVertices.resize(m_vertex.size());
+    for (size_t i = 0; i < m_vertex.size(); i++)
+    {
+      const SVertex& vertex = m_vertex[i - i % 4 + order[i % 4]];
+      m_batchVertices[i] = {vertex.x, vertex.y, vertex.z, vertex.u, vertex.v, 0.0f, 0.0f,
+                            vertex.r, vertex.g, vertex.b, vertex.a};
+    }
+
+    CGUIQuadBatcher::State state;
+    state.shader = m_distanceField ? SM_FONTS_SDF : SM_FONTS;
+    state.texture = m_nTexture;
+    state.blend = true;
+    renderSystem->AddQuads(state, m_batchVertices.data(), m_batchVertices.size() / 4);
+    return;
+  }
+
+  renderSystem->EnableShader(m_distanceField ? SM_FONTS_SDF : SM_FONTS);
 
   GLint posLoc = renderSystem->ShaderGetPos();
   GLint colLoc = renderSystem->ShaderGetCol();
@@ -160,6 +199,7 @@ void CGUIFontTTFGL::LastEnd()
     glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, GL_FALSE, sizeof(SVertex), BUFFER_OFFSET(offsetof(SVertex, u)));
 
     glDrawArrays(GL_TRIANGLES, 0, vecVertices.size());
+    renderSystem->AddDrawCalls(1);
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glDeleteBuffers(1, &VertexVBO);
@@ -207,6 +247,7 @@ void CGUIFontTTFGL::LastEnd()
     glVertexAttribPointer(tex0Loc, 2, GL_FLOAT,  GL_FALSE, sizeof(SVertex), (char*)vertices + offsetof(SVertex, u));
 
     glDrawArrays(GL_TRIANGLES, 0, vecVertices.size());
+    renderSystem->AddDrawCalls(1);
   }
 #endif
 
@@ -260,6 +301,7 @@ void CGUIFontTTFGL::LastEnd()
         glVertexAttribPointer(tex0Loc, 2, GL_FLOAT,         GL_FALSE, sizeof(SVertex), (GLvoid *) (character*sizeof(SVertex)*4 + offsetof(SVertex, u)));
 
         glDrawElements(GL_TRIANGLES, 6 * count, GL_UNSIGNED_SHORT, 0);
+        renderSystem->AddDrawCalls(1);
       }
 
       glMatrixModview.Pop();
@@ -361,17 +403,15 @@ CBaseTexture* CGUIFontTTFGL::ReallocTexture(unsigned int& newHeight)
   return newTexture;
 }
 
-bool CGUIFontTTFGL::CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
+bool CGUIFontTTFGL::CopyCharToTexture(const unsigned char* pixels, int pitch, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
 {
-  FT_Bitmap bitmap = bitGlyph->bitmap;
-
-  unsigned char* source = bitmap.buffer;
+  const unsigned char* source = pixels;
   unsigned char* target = m_texture->GetPixels() + y1 * m_texture->GetPitch() + x1;
 
   for (unsigned int y = y1; y < y2; y++)
   {
     memcpy(target, source, x2-x1);
-    source += bitmap.width;
+    source += pitch;
     target += m_texture->GetPitch();
   }
 
@@ -418,6 +458,15 @@ void CGUIFontTTFGL::DeleteHardwareTexture()
   }
 }
 
+bool CGUIFontTTFGL::SupportsDistanceField()
+{
+#if defined(HAS_GL)
+  return true;
+#else
+  return false;
+#endif
+}
+
 void CGUIFontTTFGL::CreateStaticVertexBuffers(void)
 {
   if (m_staticVertexBufferCreated)
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "GUIFontTTF.h"
+#include "GUIQuadBatcher.h"
 
 #include <string>
 #include <vector>
@@ -29,14 +30,20 @@ public:
   static void CreateStaticVertexBuffers(void);
   static void DestroyStaticVertexBuffers(void);
 
+  /*! \brief Whether distance field fonts can be drawn, they need a shader with derivatives
+   */
+  static bool SupportsDistanceField();
+
 protected:
   CBaseTexture* ReallocTexture(unsigned int& newHeight) override;
-  bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) override;
+  bool CopyCharToTexture(const unsigned char* pixels, int pitch, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) override;
   void DeleteHardwareTexture() override;
 
   static GLuint m_elementArrayHandle;
 
 private:
+  void UpdateTexture();
+
   unsigned int m_updateY1;
   unsigned int m_updateY2;
 
@@ -50,6 +57,8 @@ private:
 
   TextureStatus m_textureStatus;
 
+  std::vector<CGUIQuadBatcher::Vertex> m_batchVertices; ///< the text of LastEnd() queued for batched drawing
+
   static bool m_staticVertexBufferCreated;
 };
 
@@ -9,16 +9,246 @@
 #include "GUIListItem.h"
 
 #include "GUIListItemLayout.h"
+#include "threads/SharedSection.h"
 #include "utils/Archive.h"
 #include "utils/CharsetConverter.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <unordered_map>
 #include <utility>
 
-bool CGUIListItem::icompare::operator()(const std::string &s1, const std::string &s2) const
+namespace
 {
-  return StringUtils::CompareNoCase(s1, s2) < 0;
+/*!
+ \brief The names of properties and art types of all items.
+ Every name gets an index, together with the index of its lower case spelling for case insensitive
+ lookups. A name is removed once nothing refers to it anymore, its index is reused.
+ */
+class CListItemKeys
+{
+public:
+  static CListItemKeys &Get()
+  {
+    static CListItemKeys keys;
+    return keys;
+  }
+
+  /*! \brief Get the index of key, adding it if needed. The index has to be released. */
+  unsigned int Intern(const std::string &key)
+  {
+    {
+      CSharedLock lock(m_section);
+      auto it = m_indices.find(key);
+      if (it != m_indices.end())
+      {
+        ++m_keys[it->second].refs;
+        return it->second;
+      }
+    }
+
+    std::string lower(key);
+    StringUtils::ToLower(lower);
+
+    CExclusiveLock lock(m_section);
+    const unsigned int index = Add(lower, 0, true);
+    if (lower == key)
+      return index;
+    return Add(key, index, false);
+  }
+
+  bool Find(const std::string &key, unsigned int &index) const
+  {
+    CSharedLock lock(m_section);
+    auto it = m_indices.find(key);
+    if (it == m_indices.end())
+      return false;
+    index = it->second;
+    return true;
+  }
+
+  /*! \brief Find the index of the lower case spelling of key */
+  bool FindLower(const std::string &key, unsigned int &index) const
+  {
+    {
+      CSharedLock lock(m_section);
+      auto it = m_indices.find(key);
+      if (it != m_indices.end())
+      {
+        index = m_keys[it->second].lower;
+        return true;
+      }
+    }
+
+    std::string lower(key);
+    StringUtils::ToLower(lower);
+    return Find(lower, index);
+  }
+
+  unsigned int GetLower(unsigned int index) const
+  {
+    CSharedLock lock(m_section);
+    return m_keys[index].lower;
+  }
+
+  const std::string &GetName(unsigned int index) const
+  {
+    CSharedLock lock(m_section);
+    return m_keys[index].name;
+  }
+
+  void AddRef(unsigned int index)
+  {
+    CSharedLock lock(m_section);
+    ++m_keys[index].refs;
+  }
+
+  void Release(unsigned int index)
+  {
+    {
+      CSharedLock lock(m_section);
+      if (--m_keys[index].refs > 0)
+        return;
+    }
+
+    CExclusiveLock lock(m_section);
+    // it might have been interned again or removed by another thread in the meantime
+    if (m_keys[index].refs == 0 && !m_keys[index].removed)
+      Remove(index);
+  }
+
+  size_t Size() const
+  {
+    CSharedLock lock(m_section);
+    return m_indices.size();
+  }
+
+private:
+  struct Entry
+  {
+    std::string name;
+    unsigned int lower = 0;
+    std::atomic<unsigned int> refs{0};
+    bool removed = false;
+  };
+
+  /*!
+   \brief Add a reference to key, adding it if needed
+   A new name that isn't lower case takes over the reference to its lower case spelling.
+   */
+  unsigned int Add(const std::string &key, unsigned int lower, bool isLower)
+  {
+    // another thread might have added it in the meantime
+    auto it = m_indices.find(key);
+    if (it != m_indices.end())
+    {
+      ++m_keys[it->second].refs;
+      if (!isLower)
+        Unref(lower);
+      return it->second;
+    }
+
+    unsigned int index;
+    if (m_unused.empty())
+    {
+      index = static_cast<unsigned int>(m_keys.size());
+      m_keys.emplace_back();
+    }
+    else
+    {
+      index = m_unused.back();
+      m_unused.pop_back();
+    }
+    Entry &entry = m_keys[index];
+    entry.name = key;
+    entry.lower = isLower ? index : lower;
+    entry.refs = 1;
+    entry.removed = false;
+    m_indices.insert(std::make_pair(key, index));
+    return index;
+  }
+
+  void Unref(unsigned int index)
+  {
+    if (--m_keys[index].refs == 0)
+      Remove(index);
+  }
+
+  void Remove(unsigned int index)
+  {
+    Entry &entry = m_keys[index];
+    m_indices.erase(entry.name);
+    std::string().swap(entry.name);
+    entry.removed = true;
+    m_unused.push_back(index);
+    if (entry.lower != index)
+      Unref(entry.lower);
+  }
+
+  mutable CSharedSection m_section;
+  std::deque<Entry> m_keys; ///< a deque so that names stay where they are
+  std::vector<unsigned int> m_unused;
+  std::unordered_map<std::string, unsigned int> m_indices;
+};
+}
+
+CGUIListItem::Key::Key(const std::string &name)
+  : m_index(CListItemKeys::Get().Intern(name))
+{
+}
+
+CGUIListItem::Key::Key(const Key &key)
+  : m_index(key.m_index)
+{
+  CListItemKeys::Get().AddRef(m_index);
+}
+
+CGUIListItem::Key::Key(Key &&key) noexcept
+  : m_index(key.m_index)
+{
+  key.m_index = INVALID_KEY;
+}
+
+CGUIListItem::Key::~Key()
+{
+  if (m_index != INVALID_KEY)
+    CListItemKeys::Get().Release(m_index);
+}
+
+CGUIListItem::Key &CGUIListItem::Key::operator=(const Key &key)
+{
+  if (key.m_index != m_index)
+  {
+    CListItemKeys::Get().AddRef(key.m_index);
+    if (m_index != INVALID_KEY)
+      CListItemKeys::Get().Release(m_index);
+    m_index = key.m_index;
+  }
+  return *this;
+}
+
+CGUIListItem::Key &CGUIListItem::Key::operator=(Key &&key) noexcept
+{
+  std::swap(m_index, key.m_index);
+  return *this;
+}
+
+unsigned int CGUIListItem::Key::Lower() const
+{
+  return CListItemKeys::Get().GetLower(m_index);
+}
+
+const std::string &CGUIListItem::Key::Name() const
+{
+  return CListItemKeys::Get().GetName(m_index);
+}
+
+size_t CGUIListItem::GetKeyCount()
+{
+  return CListItemKeys::Get().Size();
 }
 
 CGUIListItem::CGUIListItem(const CGUIListItem& item)
@@ -97,29 +327,52 @@ const std::wstring& CGUIListItem::GetSortLabel() const
 
 void CGUIListItem::SetArt(const std::string &type, const std::string &url)
 {
-  ArtMap::iterator i = m_art.find(type);
-  if (i == m_art.end() || i->second != url)
+  auto i = std::lower_bound(m_art.begin(), m_art.end(), type, [](const Art &art, const std::string &type)
+  {
+    return art.type.Name() < type;
+  });
+  if (i == m_art.end() || i->type.Name() != type)
   {
-    m_art[type] = url;
+    m_art.insert(i, Art{Key(type), url});
+    m_artMap.reset();
+    SetInvalid();
+  }
+  else if (i->url != url)
+  {
+    i->url = url;
+    m_artMap.reset();
     SetInvalid();
   }
 }
 
 void CGUIListItem::SetArt(const ArtMap &art)
 {
-  m_art = art;
+  // the map is sorted already
+  m_art.clear();
+  m_art.reserve(art.size());
+  for (const auto& i : art)
+    m_art.push_back(Art{Key(i.first), i.second});
+  m_artMap.reset();
   SetInvalid();
 }
 
 void CGUIListItem::SetArtFallback(const std::string &from, const std::string &to)
 {
-  m_artFallbacks[from] = to;
+  auto i = std::lower_bound(m_artFallbacks.begin(), m_artFallbacks.end(), from, [](const ArtFallback &fallback, const std::string &from)
+  {
+    return fallback.from.Name() < from;
+  });
+  if (i == m_artFallbacks.end() || i->from.Name() != from)
+    m_artFallbacks.insert(i, ArtFallback{Key(from), Key(to)});
+  else
+    i->to = Key(to);
 }
 
 void CGUIListItem::ClearArt()
 {
   m_art.clear();
   m_artFallbacks.clear();
+  m_artMap.reset();
   SetProperty("libraryartfilled", false);
 }
 
@@ -131,22 +384,46 @@ void CGUIListItem::AppendArt(const ArtMap &art, const std::string &prefix)
 
 std::string CGUIListItem::GetArt(const std::string &type) const
 {
-  ArtMap::const_iterator i = m_art.find(type);
-  if (i != m_art.end())
-    return i->second;
-  i = m_artFallbacks.find(type);
-  if (i != m_artFallbacks.end())
+  // a type that was never set on any item isn't set on this one either
+  unsigned int index;
+  if (m_art.empty() || !CListItemKeys::Get().Find(type, index))
+    return "";
+
+  const Art *art = FindArt(index);
+  if (art)
+    return art->url;
+  for (const auto& fallback : m_artFallbacks)
   {
-    ArtMap::const_iterator j = m_art.find(i->second);
-    if (j != m_art.end())
-      return j->second;
+    if (fallback.from.Index() == index)
+    {
+      art = FindArt(fallback.to.Index());
+      if (art)
+        return art->url;
+      break;
+    }
   }
   return "";
 }
 
 const CGUIListItem::ArtMap &CGUIListItem::GetArt() const
 {
-  return m_art;
+  if (!m_artMap)
+  {
+    m_artMap.reset(new ArtMap);
+    for (const auto& i : m_art)
+      m_artMap->insert(m_artMap->end(), std::make_pair(i.type.Name(), i.url));
+  }
+  return *m_artMap;
+}
+
+const CGUIListItem::Art *CGUIListItem::FindArt(unsigned int type) const
+{
+  for (const auto& art : m_art)
+  {
+    if (art.type.Index() == type)
+      return &art;
+  }
+  return nullptr;
 }
 
 bool CGUIListItem::HasArt(const std::string &type) const
@@ -154,6 +431,19 @@ bool CGUIListItem::HasArt(const std::string &type) const
   return !GetArt(type).empty();
 }
 
+bool CGUIListItem::HasArt() const
+{
+  return !m_art.empty();
+}
+
+size_t CGUIListItem::GetArtSize() const
+{
+  size_t size = m_art.capacity() * sizeof(Art) + m_artFallbacks.capacity() * sizeof(ArtFallback);
+  for (const auto& art : m_art)
+    size += art.url.capacity();
+  return size;
+}
+
 void CGUIListItem::SetOverlayImage(GUIIconOverlay icon, bool bOnOff)
 {
   GUIIconOverlay newIcon = (bOnOff) ? GUIIconOverlay((int)(icon)+1) : icon;
@@ -212,6 +502,7 @@ CGUIListItem& CGUIListItem::operator =(const CGUIListItem& item)
   m_mapProperties = item.m_mapProperties;
   m_art = item.m_art;
   m_artFallbacks = item.m_artFallbacks;
+  m_artMap.reset();
   SetInvalid();
   return *this;
 }
@@ -229,20 +520,20 @@ void CGUIListItem::Archive(CArchive &ar)
     ar << (int)m_mapProperties.size();
     for (const auto& it : m_mapProperties)
     {
-      ar << it.first;
-      ar << it.second;
+      ar << it.key.Name();
+      ar << it.value;
     }
     ar << (int)m_art.size();
     for (const auto& i : m_art)
     {
-      ar << i.first;
-      ar << i.second;
+      ar << i.type.Name();
+      ar << i.url;
     }
     ar << (int)m_artFallbacks.size();
     for (const auto& i : m_artFallbacks)
     {
-      ar << i.first;
-      ar << i.second;
+      ar << i.from.Name();
+      ar << i.to.Name();
     }
   }
   else
@@ -273,7 +564,7 @@ void CGUIListItem::Archive(CArchive &ar)
       std::string key, value;
       ar >> key;
       ar >> value;
-      m_art.insert(make_pair(key, value));
+      SetArt(key, value);
     }
     ar >> mapSize;
     for (int i = 0; i < mapSize; i++)
@@ -281,7 +572,7 @@ void CGUIListItem::Archive(CArchive &ar)
       std::string key, value;
       ar >> key;
       ar >> value;
-      m_artFallbacks.insert(make_pair(key, value));
+      SetArtFallback(key, value);
     }
     SetInvalid();
   }
@@ -296,10 +587,10 @@ void CGUIListItem::Serialize(CVariant &value)
 
   for (const auto& it : m_mapProperties)
   {
-    value["properties"][it.first] = it.second;
+    value["properties"][it.key.Name()] = it.value;
   }
   for (const auto& it : m_art)
-    value["art"][it.first] = it.second;
+    value["art"][it.type.Name()] = it.url;
 }
 
 void CGUIListItem::FreeIcons()
@@ -349,47 +640,72 @@ void CGUIListItem::SetInvalid()
   if (m_focusedLayout) m_focusedLayout->SetInvalid();
 }
 
+CGUIListItem::Property *CGUIListItem::FindProperty(const std::string &strKey)
+{
+  return const_cast<Property*>(static_cast<const CGUIListItem*>(this)->FindProperty(strKey));
+}
+
+const CGUIListItem::Property *CGUIListItem::FindProperty(const std::string &strKey) const
+{
+  // a name that was never set on any item isn't set on this one either
+  unsigned int id;
+  if (m_mapProperties.empty() || !CListItemKeys::Get().FindLower(strKey, id))
+    return nullptr;
+
+  for (const auto& property : m_mapProperties)
+  {
+    if (property.id == id)
+      return &property;
+  }
+  return nullptr;
+}
+
 void CGUIListItem::SetProperty(const std::string &strKey, const CVariant &value)
 {
-  PropertyMap::iterator iter = m_mapProperties.find(strKey);
-  if (iter == m_mapProperties.end())
+  Property *property = FindProperty(strKey);
+  if (!property)
   {
-    m_mapProperties.insert(make_pair(strKey, value));
+    // keep the properties sorted case insensitively, as the lower case names compare that way
+    Key key(strKey);
+    const unsigned int id = key.Lower();
+    const CListItemKeys &keys = CListItemKeys::Get();
+    const std::string &lower = keys.GetName(id);
+    auto i = std::lower_bound(m_mapProperties.begin(), m_mapProperties.end(), lower, [&keys](const Property &property, const std::string &lower)
+    {
+      return keys.GetName(property.id) < lower;
+    });
+    m_mapProperties.insert(i, Property{std::move(key), id, value});
     SetInvalid();
   }
-  else if (iter->second != value)
+  else if (property->value != value)
   {
-    iter->second = value;
+    property->value = value;
     SetInvalid();
   }
 }
 
 const CVariant &CGUIListItem::GetProperty(const std::string &strKey) const
 {
-  PropertyMap::const_iterator iter = m_mapProperties.find(strKey);
+  const Property *property = FindProperty(strKey);
   static CVariant nullVariant = CVariant(CVariant::VariantTypeNull);
 
-  if (iter == m_mapProperties.end())
+  if (!property)
     return nullVariant;
 
-  return iter->second;
+  return property->value;
 }
 
 bool CGUIListItem::HasProperty(const std::string &strKey) const
 {
-  PropertyMap::const_iterator iter = m_mapProperties.find(strKey);
-  if (iter == m_mapProperties.end())
-    return false;
-
-  return true;
+  return FindProperty(strKey) != nullptr;
 }
 
 void CGUIListItem::ClearProperty(const std::string &strKey)
 {
-  PropertyMap::iterator iter = m_mapProperties.find(strKey);
-  if (iter != m_mapProperties.end())
+  const Property *property = FindProperty(strKey);
+  if (property)
   {
-    m_mapProperties.erase(iter);
+    m_mapProperties.erase(m_mapProperties.begin() + (property - m_mapProperties.data()));
     SetInvalid();
   }
 }
@@ -420,7 +736,7 @@ void CGUIListItem::IncrementProperty(const std::string &strKey, double dVal)
 void CGUIListItem::AppendProperties(const CGUIListItem &item)
 {
   for (const auto& i : item.m_mapProperties)
-    SetProperty(i.first, i.second);
+    SetProperty(i.key.Name(), i.value);
 }
 
 void CGUIListItem::SetCurrentItem(unsigned int position)
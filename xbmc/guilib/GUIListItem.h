@@ -13,15 +13,17 @@
 \brief
 */
 
+#include "utils/Variant.h"
+
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 //  Forward
 class CGUIListItemLayout;
 using CGUIListItemLayoutPtr = std::unique_ptr<CGUIListItemLayout>;
 class CArchive;
-class CVariant;
 
 /*!
  \ingroup controls
@@ -115,6 +117,18 @@ public:
    */
   bool HasArt(const std::string &type) const;
 
+  /*! \brief Check whether an item has any art
+   Equivalent to !GetArt().empty(), without building the map
+   \return true if the item has art set, false otherwise.
+   */
+  bool HasArt() const;
+
+  /*! \brief Get the memory used by the art of an item
+   The names of the art types are shared by all items and not included.
+   \return the size in bytes
+   */
+  size_t GetArtSize() const;
+
   void SetSortLabel(const std::string &label);
   void SetSortLabel(const std::wstring &label);
   const std::wstring &GetSortLabel() const;
@@ -174,6 +188,9 @@ public:
    */
   unsigned int GetCurrentItem() const;
 
+  /*! \brief Get the number of distinct names of properties and art types set on all items */
+  static size_t GetKeyCount();
+
 protected:
   std::string m_strLabel2;     // text of column2
   GUIIconOverlay m_overlayIcon; // type of overlay icon
@@ -183,18 +200,62 @@ protected:
   bool m_bSelected;     // item is selected or not
   unsigned int m_currentItem; // current item number within container (starting at 1)
 
-  struct icompare
+  /*! \brief The index of a name of a property or art type.
+   The names are interned, as the same few are set on every item. Items only keep the index of
+   their names in a table shared by all items, a name stays in there as long as a Key refers to it.
+   */
+  class Key
   {
-    bool operator()(const std::string &s1, const std::string &s2) const;
+  public:
+    explicit Key(const std::string &name);
+    Key(const Key &key);
+    Key(Key &&key) noexcept;
+    ~Key();
+    Key &operator=(const Key &key);
+    Key &operator=(Key &&key) noexcept;
+
+    unsigned int Index() const { return m_index; }
+    /*! \brief Index of the lower case spelling of the name */
+    unsigned int Lower() const;
+    const std::string &Name() const;
+
+  private:
+    static constexpr unsigned int INVALID_KEY = ~0U; ///< moved from
+    unsigned int m_index;
   };
 
-  typedef std::map<std::string, CVariant, icompare> PropertyMap;
+  /*! \brief A property of an item, kept sorted by name like a map */
+  struct Property
+  {
+    Key key;         ///< the name as it was set
+    unsigned int id; ///< the lower case name, properties are case insensitive
+    CVariant value;
+  };
+
+  typedef std::vector<Property> PropertyMap;
   PropertyMap m_mapProperties;
 private:
+  struct Art
+  {
+    Key type;
+    std::string url;
+  };
+
+  struct ArtFallback
+  {
+    Key from;
+    Key to;
+  };
+
+  Property *FindProperty(const std::string &strKey);
+  const Property *FindProperty(const std::string &strKey) const;
+  const Art *FindArt(unsigned int type) const;
+
   std::wstring m_sortLabel;    // text for sorting. Need to be UTF16 for proper sorting
   std::string m_strLabel;      // text of column1
 
-  ArtMap m_art;
-  ArtMap m_artFallbacks;
+  std::vector<Art> m_art;                  ///< sorted by type
+  std::vector<ArtFallback> m_artFallbacks; ///< sorted by the type to fall back from
+  mutable std::unique_ptr<ArtMap> m_artMap; ///< built on demand by GetArt()
 };
 
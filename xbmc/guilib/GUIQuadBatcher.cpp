@@ -0,0 +1,134 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "GUIQuadBatcher.h"
+
+#include <algorithm>
+
+namespace
+{
+bool Overlaps(const CRect& a, const CRect& b)
+{
+  // quads sharing an edge don't cover the same pixels
+  return a.x1 < b.x2 && b.x1 < a.x2 && a.y1 < b.y2 && b.y1 < a.y2;
+}
+}
+
+bool CGUIQuadBatcher::State::operator==(const State& right) const
+{
+  return shader == right.shader &&
+         texture == right.texture &&
+         diffuse == right.diffuse &&
+         color == right.color &&
+         blend == right.blend &&
+         scissors == right.scissors;
+}
+
+CGUIQuadBatcher::CGUIQuadBatcher(unsigned int lookBehind)
+  : m_lookBehind(lookBehind)
+{
+}
+
+bool CGUIQuadBatcher::AddQuads(const State& state, const Vertex* vertices, unsigned int quads)
+{
+  if (quads == 0)
+    return true;
+  if (m_quadBatches.size() + quads > MAX_QUADS)
+    return false;
+
+  CRect bounds(vertices[0].x, vertices[0].y, vertices[0].x, vertices[0].y);
+  bool flat = true;
+  for (unsigned int i = 0; i < quads * 4; i++)
+  {
+    const Vertex& vertex = vertices[i];
+    bounds.x1 = std::min(bounds.x1, vertex.x);
+    bounds.y1 = std::min(bounds.y1, vertex.y);
+    bounds.x2 = std::max(bounds.x2, vertex.x);
+    bounds.y2 = std::max(bounds.y2, vertex.y);
+    flat &= vertex.z == 0.0f;
+  }
+
+  const unsigned int index = FindBatch(state, bounds, flat);
+  if (index == m_batches.size())
+  {
+    m_batches.emplace_back();
+    m_batches.back().state = state;
+    m_batches.back().bounds = bounds;
+  }
+  else
+  {
+    CRect& batchBounds = m_batches[index].bounds;
+    batchBounds.x1 = std::min(batchBounds.x1, bounds.x1);
+    batchBounds.y1 = std::min(batchBounds.y1, bounds.y1);
+    batchBounds.x2 = std::max(batchBounds.x2, bounds.x2);
+    batchBounds.y2 = std::max(batchBounds.y2, bounds.y2);
+  }
+
+  Batch& batch = m_batches[index];
+  batch.flat &= flat;
+  batch.quads += quads;
+
+  m_vertices.insert(m_vertices.end(), vertices, vertices + quads * 4);
+  m_quadBatches.insert(m_quadBatches.end(), quads, index);
+  return true;
+}
+
+unsigned int CGUIQuadBatcher::FindBatch(const State& state, const CRect& bounds, bool flat) const
+{
+  const unsigned int count = static_cast<unsigned int>(m_batches.size());
+  const unsigned int last = count > m_lookBehind ? count - m_lookBehind : 0;
+  for (unsigned int i = count; i > last; i--)
+  {
+    const Batch& batch = m_batches[i - 1];
+    if (batch.state == state)
+      return i - 1;
+
+    // the quads would be drawn before this batch but have to end up on top of it
+    if (!flat || !batch.flat || Overlaps(batch.bounds, bounds))
+      break;
+  }
+  return count;
+}
+
+const std::vector<uint16_t>& CGUIQuadBatcher::BuildIndices()
+{
+  m_indices.resize(m_quadBatches.size() * 6);
+
+  std::vector<unsigned int> next;
+  next.reserve(m_batches.size());
+  unsigned int index = 0;
+  for (auto& batch : m_batches)
+  {
+    batch.firstIndex = index;
+    next.push_back(index);
+    index += batch.quads * 6;
+  }
+
+  for (unsigned int quad = 0; quad < m_quadBatches.size(); quad++)
+  {
+    uint16_t* indices = &m_indices[next[m_quadBatches[quad]]];
+    next[m_quadBatches[quad]] += 6;
+
+    const uint16_t vertex = static_cast<uint16_t>(quad * 4);
+    indices[0] = vertex + 0;
+    indices[1] = vertex + 1;
+    indices[2] = vertex + 2;
+    indices[3] = vertex + 2;
+    indices[4] = vertex + 3;
+    indices[5] = vertex + 0;
+  }
+
+  return m_indices;
+}
+
+void CGUIQuadBatcher::Clear()
+{
+  m_vertices.clear();
+  m_quadBatches.clear();
+  m_batches.clear();
+}
@@ -0,0 +1,97 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "utils/Color.h"
+#include "utils/Geometry.h"
+
+#include <stdint.h>
+#include <vector>
+
+/*!
+ \brief Collects the textured quads of a frame and groups them into batches that are drawn
+ with a single draw call each.
+
+ A quad joins the most recent batch with the same render state unless a batch queued after
+ that one overlaps it, so the batches can be drawn in order without changing the result of
+ drawing every quad on its own. The batcher only keeps the quads, drawing them is up to the
+ render system.
+ */
+class CGUIQuadBatcher
+{
+public:
+  struct Vertex
+  {
+    float x, y, z;
+    float u1, v1;
+    float u2, v2;
+    unsigned char r, g, b, a;
+  };
+
+  struct State
+  {
+    int shader = 0;
+    unsigned int texture = 0;
+    unsigned int diffuse = 0;
+    UTILS::Color color = 0; ///< uniform color of the shader, per vertex colors are in the vertices
+    bool blend = false;
+    CRect scissors;
+
+    bool operator==(const State& right) const;
+    bool operator!=(const State& right) const { return !(*this == right); }
+  };
+
+  struct Batch
+  {
+    State state;
+    CRect bounds;
+    bool flat = true; ///< false if a quad is not in the z = 0 plane and bounds can't be trusted
+    unsigned int quads = 0;
+    unsigned int firstIndex = 0; ///< set by BuildIndices()
+  };
+
+  /*! \brief the number of quads that fit into 16 bit indices */
+  static constexpr unsigned int MAX_QUADS = 16384;
+
+  /*!
+   \param lookBehind the number of batches searched for one the quad can join
+   */
+  explicit CGUIQuadBatcher(unsigned int lookBehind = 16);
+
+  /*!
+   \brief Queue quads
+   \param state the render state to draw the quads with
+   \param vertices 4 vertices per quad in the order top left, top right, bottom right, bottom left
+   \param quads the number of quads
+   \return false if the quads don't fit before Clear() is called
+   */
+  bool AddQuads(const State& state, const Vertex* vertices, unsigned int quads);
+
+  /*!
+   \brief Build the indices of two triangles per quad ordered by batch and set
+   Batch::firstIndex of every batch.
+   */
+  const std::vector<uint16_t>& BuildIndices();
+
+  const std::vector<Vertex>& GetVertices() const { return m_vertices; }
+  const std::vector<Batch>& GetBatches() const { return m_batches; }
+  unsigned int GetQuads() const { return static_cast<unsigned int>(m_quadBatches.size()); }
+  bool IsEmpty() const { return m_batches.empty(); }
+
+  void Clear();
+
+private:
+  unsigned int FindBatch(const State& state, const CRect& bounds, bool flat) const;
+
+  unsigned int m_lookBehind;
+  std::vector<Vertex> m_vertices;
+  std::vector<unsigned int> m_quadBatches; ///< batch of every quad
+  std::vector<Batch> m_batches;
+  std::vector<uint16_t> m_indices;
+};
@@ -9,7 +9,11 @@
 #include "GUITexture.h"
 
 #include "GUILargeTextureManager.h"
+#include "TextureDatabase.h"
 #include "TextureManager.h"
+#include "URL.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
 #include "utils/MathUtils.h"
 #include "utils/StringUtils.h"
 #include "windowing/GraphicContext.h"
@@ -289,8 +293,10 @@ bool CGUITextureBase::AllocResources()
     }
     if (m_isAllocated != NORMAL)
     { // use our large image background loader
+      if (!IsAllocated())
+        m_largeFileName = GetLargeFileName();
       CTextureArray texture;
-      if (CServiceBroker::GetGUI()->GetLargeTextureManager().GetImage(m_info.filename, texture, !IsAllocated(), m_use_cache))
+      if (CServiceBroker::GetGUI()->GetLargeTextureManager().GetImage(m_largeFileName, texture, !IsAllocated(), m_use_cache))
       {
         m_isAllocated = LARGE;
 
@@ -307,7 +313,10 @@ bool CGUITextureBase::AllocResources()
   }
   else if (!IsAllocated())
   {
-    CTextureArray texture = CServiceBroker::GetGUI()->GetTextureManager().Load(m_info.filename);
+    bool loading = false;
+    CTextureArray texture = CServiceBroker::GetGUI()->GetTextureManager().Load(m_info.filename, false, &loading);
+    if (loading)
+      return false; // decoded in the background, we show it once it's done
 
     // set allocated to true even if we couldn't load the image to save
     // us hitting the disk every frame
@@ -429,10 +438,24 @@ bool CGUITextureBase::CalculateSize()
   return true;
 }
 
+std::string CGUITextureBase::GetLargeFileName() const
+{
+  // cached images are loaded from a variant close to the size we draw them at. Images we crop or
+  // center are drawn larger than we are, so they are loaded in full.
+  if (!m_use_cache || !CURL::IsFullPath(m_info.filename) ||
+      (m_aspect.ratio != CAspectRatio::AR_STRETCH && m_aspect.ratio != CAspectRatio::AR_KEEP) ||
+      !CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageVariants)
+    return m_info.filename;
+
+  const CGraphicContext &context = CServiceBroker::GetWinSystem()->GetGfxContext();
+  const float size = std::max(m_width * context.GetGUIScaleX(), m_height * context.GetGUIScaleY());
+  return CTextureUtils::GetSizedImageURL(m_info.filename, MathUtils::round_int(size));
+}
+
 void CGUITextureBase::FreeResources(bool immediately /* = false */)
 {
   if (m_isAllocated == LARGE || m_isAllocated == LARGE_FAILED)
-    CServiceBroker::GetGUI()->GetLargeTextureManager().ReleaseImage(m_info.filename, immediately || (m_isAllocated == LARGE_FAILED));
+    CServiceBroker::GetGUI()->GetLargeTextureManager().ReleaseImage(m_largeFileName, immediately || (m_isAllocated == LARGE_FAILED));
   else if (m_isAllocated == NORMAL && m_texture.size())
     CServiceBroker::GetGUI()->GetTextureManager().ReleaseTexture(m_info.filename, immediately);
 
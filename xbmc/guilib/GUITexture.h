@@ -113,6 +113,7 @@ protected:
   void Render(float left, float top, float bottom, float right, float u1, float v1, float u2, float v2, float u3, float v3);
   static void OrientateTexture(CRect &rect, float width, float height, int orientation);
   void ResetAnimState();
+  std::string GetLargeFileName() const;
 
   // functions that our implementation classes handle
   virtual void Allocate() {}; ///< called after our textures have been allocated
@@ -151,6 +152,7 @@ protected:
   ALLOCATE_TYPE m_isAllocated;
 
   CTextureInfo m_info;
+  std::string m_largeFileName; ///< the image requested from the large texture manager
   CAspectRatio m_aspect;
 
   CTextureArray m_diffuse;
@@ -122,6 +122,7 @@ void CGUITextureD3D::Draw(float *x, float *y, float *z, const CRect &texture, co
     pGUIShader->SetShaderViews(1, &resource);
   }
   pGUIShader->DrawQuad(verts[0], verts[1], verts[2], verts[3]);
+  DX::Windowing()->AddDrawCalls(1);
 }
 
 void CGUITextureD3D::DrawQuad(const CRect &rect, UTILS::Color color, CBaseTexture *texture, const CRect *texCoords)
@@ -32,8 +32,6 @@ void CGUITextureGL::Begin(UTILS::Color color)
   if (m_diffuse.size())
     m_diffuse.m_textures[0]->LoadToGPU();
 
-  texture->BindToUnit(0);
-
   // Setup Colors
   m_col[0] = (GLubyte)GET_R(color);
   m_col[1] = (GLubyte)GET_G(color);
@@ -42,33 +40,51 @@ void CGUITextureGL::Begin(UTILS::Color color)
 
   bool hasAlpha = m_texture.m_textures[m_currentFrame]->HasAlpha() || m_col[3] < 255;
 
+  ESHADERMETHOD method;
   if (m_diffuse.size())
   {
     if (m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255 )
     {
-      m_renderSystem->EnableShader(SM_MULTI);
+      method = SM_MULTI;
     }
     else
     {
-      m_renderSystem->EnableShader(SM_MULTI_BLENDCOLOR);
+      method = SM_MULTI_BLENDCOLOR;
     }
 
     hasAlpha |= m_diffuse.m_textures[0]->HasAlpha();
-
-    m_diffuse.m_textures[0]->BindToUnit(1);
   }
   else
   {
     if (m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255)
     {
-      m_renderSystem->EnableShader(SM_TEXTURE_NOBLEND);
+      method = SM_TEXTURE_NOBLEND;
     }
     else
     {
-      m_renderSystem->EnableShader(SM_TEXTURE);
+      method = SM_TEXTURE;
     }
   }
 
+  m_packedVertices.clear();
+  m_idx.clear();
+
+  if (m_renderSystem->BatchDraws())
+  {
+    // the quads are queued in End() and drawn together with others of the same state
+    m_batchState.shader = method;
+    m_batchState.texture = static_cast<CTexture*>(texture)->GetTextureObject();
+    m_batchState.diffuse = m_diffuse.size() ? static_cast<CTexture*>(m_diffuse.m_textures[0])->GetTextureObject() : 0;
+    m_batchState.color = color;
+    m_batchState.blend = hasAlpha;
+    return;
+  }
+
+  texture->BindToUnit(0);
+  m_renderSystem->EnableShader(method);
+  if (m_diffuse.size())
+    m_diffuse.m_textures[0]->BindToUnit(1);
+
   if (hasAlpha)
   {
     glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
@@ -78,12 +94,16 @@ void CGUITextureGL::Begin(UTILS::Color color)
   {
     glDisable(GL_BLEND);
   }
-  m_packedVertices.clear();
-  m_idx.clear();
 }
 
 void CGUITextureGL::End()
 {
+  if (m_renderSystem->BatchDraws())
+  {
+    m_renderSystem->AddQuads(m_batchState, m_packedVertices.data(), m_packedVertices.size() / 4);
+    return;
+  }
+
   if (m_packedVertices.size())
   {
     GLint posLoc  = m_renderSystem->ShaderGetPos();
@@ -119,6 +139,7 @@ void CGUITextureGL::End()
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(ushort)*m_idx.size(), m_idx.data(), GL_STATIC_DRAW);
 
     glDrawElements(GL_TRIANGLES, m_packedVertices.size()*6 / 4, GL_UNSIGNED_SHORT, 0);
+    m_renderSystem->AddDrawCalls(1);
 
     if (m_diffuse.size())
       glDisableVertexAttribArray(tex1Loc);
@@ -216,10 +237,14 @@ void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, con
     vertices[i].x = x[i];
     vertices[i].y = y[i];
     vertices[i].z = z[i];
+    vertices[i].r = m_col[0];
+    vertices[i].g = m_col[1];
+    vertices[i].b = m_col[2];
+    vertices[i].a = m_col[3];
     m_packedVertices.push_back(vertices[i]);
   }
 
-  if ((m_packedVertices.size() / 4) > (m_idx.size() / 6))
+  if (!m_renderSystem->BatchDraws() && (m_packedVertices.size() / 4) > (m_idx.size() / 6))
   {
     size_t i = m_packedVertices.size() - 4;
     m_idx.push_back(i+0);
@@ -234,6 +259,7 @@ void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, con
 void CGUITextureGL::DrawQuad(const CRect &rect, UTILS::Color color, CBaseTexture *texture, const CRect *texCoords)
 {
   CRenderSystemGL *renderSystem = dynamic_cast<CRenderSystemGL*>(CServiceBroker::GetRenderSystem());
+  renderSystem->FlushBatches();
   if (texture)
   {
     texture->LoadToGPU();
@@ -320,6 +346,7 @@ void CGUITextureGL::DrawQuad(const CRect &rect, UTILS::Color color, CBaseTexture
   glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLubyte)*4, idx, GL_STATIC_DRAW);
 
   glDrawElements(GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_BYTE, 0);
+  renderSystem->AddDrawCalls(1);
 
   glDisableVertexAttribArray(posLoc);
   if (texture)
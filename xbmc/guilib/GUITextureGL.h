@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "GUIQuadBatcher.h"
 #include "GUITexture.h"
 #include "utils/Color.h"
 
@@ -29,14 +30,10 @@ protected:
 private:
   GLubyte m_col[4];
 
-  struct PackedVertex
-  {
-    float x, y, z;
-    float u1, v1;
-    float u2, v2;
-  };
+  typedef CGUIQuadBatcher::Vertex PackedVertex;
 
   std::vector<PackedVertex> m_packedVertices;
+  CGUIQuadBatcher::State m_batchState;
   std::vector<GLushort> m_idx;
   CRenderSystemGL *m_renderSystem;
 };
@@ -115,6 +115,7 @@ void CGUITextureGLES::End()
     glEnableVertexAttribArray(tex0Loc);
 
     glDrawElements(GL_TRIANGLES, m_packedVertices.size()*6 / 4, GL_UNSIGNED_SHORT, m_idx.data());
+    m_renderSystem->AddDrawCalls(1);
 
     if (m_diffuse.size())
       glDisableVertexAttribArray(tex1Loc);
@@ -275,6 +276,7 @@ void CGUITextureGLES::DrawQuad(const CRect &rect, UTILS::Color color, CBaseTextu
     tex[2][1] = tex[3][1] = coords.y2;
   }
   glDrawElements(GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_BYTE, idx);
+  renderSystem->AddDrawCalls(1);
 
   glDisableVertexAttribArray(posLoc);
   if (texture)
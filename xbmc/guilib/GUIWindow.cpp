@@ -64,6 +64,7 @@ CGUIWindow::CGUIWindow(int id, const std::string &xmlFile)
 CGUIWindow::~CGUIWindow()
 {
   delete m_windowXMLRootElement;
+  PropertiesChanged();
 }
 
 bool CGUIWindow::Load(const std::string& strFileName, bool bContainsPath)
@@ -330,7 +331,9 @@ void CGUIWindow::DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyregi
 
   CServiceBroker::GetWinSystem()->GetGfxContext().SetRenderingResolution(m_coordsRes, m_needsScaling);
   CServiceBroker::GetWinSystem()->GetGfxContext().AddGUITransform();
+  GUIPROFILER_WINDOW_BEGIN(GetID());
   CGUIControlGroup::DoProcess(currentTime, dirtyregions);
+  GUIPROFILER_WINDOW_END(GetID());
   CServiceBroker::GetWinSystem()->GetGfxContext().RemoveTransform();
 
   // check if currently focused control can have it
@@ -755,7 +758,9 @@ void CGUIWindow::AllocResources(bool forceLoad /*= false */)
 #endif
 
   // and now allocate resources
+  GUIPROFILER_WINDOW_BEGIN(GetID());
   CGUIControlGroup::AllocResources();
+  GUIPROFILER_WINDOW_END(GetID());
 
 #ifdef _DEBUG
   int64_t end, freq;
@@ -1023,6 +1028,7 @@ void CGUIWindow::SetProperty(const std::string &strKey, const CVariant &value)
 {
   CSingleLock lock(*this);
   m_mapProperties[strKey] = value;
+  PropertiesChanged();
 }
 
 CVariant CGUIWindow::GetProperty(const std::string &strKey) const
@@ -1039,6 +1045,15 @@ void CGUIWindow::ClearProperties()
 {
   CSingleLock lock(*this);
   m_mapProperties.clear();
+  PropertiesChanged();
+}
+
+void CGUIWindow::PropertiesChanged()
+{
+  // conditions depending on window properties are only evaluated again after a change
+  CGUIComponent* gui = CServiceBroker::GetGUI();
+  if (gui)
+    gui->GetInfoManager().InfoChanged(INFO::INFO_SOURCE_WINDOW_PROPERTIES);
 }
 
 void CGUIWindow::SetRunActionsManually()
@@ -284,6 +284,8 @@ protected:
   bool m_custom;
 
 private:
+  void PropertiesChanged();
+
   std::map<std::string, CVariant, icompare> m_mapProperties;
   std::map<INFO::InfoPtr, bool> m_xmlIncludeConditions; ///< \brief used to store conditions used to resolve includes for this window
 };
@@ -18,6 +18,7 @@
 #include "utils/URIUtils.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
+#include "rendering/RenderSystem.h"
 #include "addons/Skin.h"
 #include "GUITexture.h"
 #include "utils/Variant.h"
@@ -1205,6 +1206,8 @@ bool CGUIWindowManager::Render()
       CGUITexture::DrawQuad(i, 0x4c00ff00);
   }
 
+  CServiceBroker::GetRenderSystem()->FlushBatches();
+
   return hasRendered;
 }
 
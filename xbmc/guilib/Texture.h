@@ -80,6 +80,14 @@ public:
   virtual void LoadToGPU() = 0;
   virtual void BindToUnit(unsigned int unit) = 0;
 
+  /*! \brief Load the next rows of the texture to the GPU
+   Allows to spread the loading of large textures over several frames. Each call continues where the
+   last one stopped. Render systems that can't load parts of a texture load all of it.
+   \param rows the number of rows to load.
+   \return true once the whole texture is loaded, false otherwise.
+   */
+  virtual bool LoadRowsToGPU(unsigned int rows) { LoadToGPU(); return true; }
+
   unsigned char* GetPixels() const { return m_pixels; }
   unsigned int GetPitch() const { return GetPitch(m_textureWidth); }
   unsigned int GetRows() const { return GetRows(m_textureHeight); }
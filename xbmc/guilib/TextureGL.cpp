@@ -10,11 +10,18 @@
 #include "Texture.h"
 #include "guilib/TextureManager.h"
 #include "rendering/RenderSystem.h"
+#if defined(HAS_GL)
+#include "rendering/gl/RenderSystemGL.h"
+#endif
 #include "settings/AdvancedSettings.h"
 #include "utils/GLUtils.h"
 #include "utils/MemUtils.h"
 #include "utils/log.h"
 
+#include <algorithm>
+
+#define BUFFER_OFFSET(i) ((char *)NULL + (i))
+
 /************************************************************************/
 /*    CGLTexture                                                       */
 /************************************************************************/
@@ -43,13 +50,8 @@ void CGLTexture::DestroyTextureObject()
     CServiceBroker::GetGUI()->GetTextureManager().ReleaseHwTexture(m_texture);
 }
 
-void CGLTexture::LoadToGPU()
+void CGLTexture::SetupTextureObject()
 {
-  if (!m_pixels)
-  {
-    // nothing to load - probably same image (no change)
-    return;
-  }
   if (m_texture == 0)
   {
     // Have OpenGL generate a texture object handle for us
@@ -83,6 +85,17 @@ void CGLTexture::LoadToGPU()
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+void CGLTexture::LoadToGPU()
+{
+  if (!m_pixels)
+  {
+    // nothing to load - probably same image (no change)
+    return;
+  }
+
+  SetupTextureObject();
 
   unsigned int maxSize = CServiceBroker::GetRenderSystem()->GetMaxTextureSize();
   if (m_textureHeight > maxSize)
@@ -207,6 +220,83 @@ void CGLTexture::LoadToGPU()
   m_loadedToGPU = true;
 }
 
+bool CGLTexture::LoadRowsToGPU(unsigned int rows)
+{
+  if (!m_pixels)
+    return true;
+
+#ifndef HAS_GLES
+  // compressed textures, textures that need truncating and the mipmaps generated by old GL
+  // versions are loaded in one go
+  unsigned int maxSize = CServiceBroker::GetRenderSystem()->GetMaxTextureSize();
+  if ((m_format & XB_FMT_DXT_MASK) || !m_isOglVersion3orNewer ||
+      m_textureWidth > maxSize || m_textureHeight > maxSize)
+  {
+    LoadToGPU();
+    return true;
+  }
+
+  GLenum format = GL_BGRA;
+  GLint numcomponents = GL_RGBA;
+  if (m_format == XB_FMT_RGB8)
+  {
+    format = GL_RGB;
+    numcomponents = GL_RGB;
+  }
+
+  if (m_loadedRows == 0)
+  {
+    SetupTextureObject();
+    // only allocate the storage, the rows follow
+    glTexImage2D(GL_TEXTURE_2D, 0, numcomponents,
+                 m_textureWidth, m_textureHeight, 0,
+                 format, GL_UNSIGNED_BYTE, nullptr);
+  }
+  else
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+
+  rows = std::min(std::max(rows, 1u), m_textureHeight - m_loadedRows);
+  const unsigned char* pixels = m_pixels + m_loadedRows * GetPitch();
+  const size_t size = rows * GetPitch();
+
+  // the rows are copied into the stream upload buffer, so the driver copies them to the GPU
+  // asynchronously instead of from our memory during the call
+  CRenderSystemGL* renderSystem = dynamic_cast<CRenderSystemGL*>(CServiceBroker::GetRenderSystem());
+  const ptrdiff_t offset = renderSystem ? renderSystem->StagePixels(pixels, size) : -1;
+  if (offset >= 0)
+  {
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, m_loadedRows, m_textureWidth, rows,
+                    format, GL_UNSIGNED_BYTE, BUFFER_OFFSET(offset));
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  }
+  else
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, m_loadedRows, m_textureWidth, rows,
+                    format, GL_UNSIGNED_BYTE, pixels);
+
+  m_loadedRows += rows;
+  if (m_loadedRows < m_textureHeight)
+    return false;
+
+  if (IsMipmapped())
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+  VerifyGLState();
+
+  m_loadedRows = 0;
+  if (!m_bCacheMemory)
+  {
+    KODI::MEMORY::AlignedFree(m_pixels);
+    m_pixels = NULL;
+  }
+
+  m_loadedToGPU = true;
+  return true;
+#else
+  LoadToGPU();
+  return true;
+#endif
+}
+
 void CGLTexture::BindToUnit(unsigned int unit)
 {
   glActiveTexture(GL_TEXTURE0 + unit);
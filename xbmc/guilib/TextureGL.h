@@ -25,9 +25,15 @@ public:
   void DestroyTextureObject() override;
   void LoadToGPU() override;
   void BindToUnit(unsigned int unit) override;
+  bool LoadRowsToGPU(unsigned int rows) override;
+
+  GLuint GetTextureObject() const { return m_texture; }
 
 protected:
+  void SetupTextureObject();
+
   GLuint m_texture = 0;
   bool m_isOglVersion3orNewer = false;
+  unsigned int m_loadedRows = 0; ///< the rows loaded by LoadRowsToGPU() so far
 };
 
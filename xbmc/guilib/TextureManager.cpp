@@ -9,22 +9,23 @@
 #include "TextureManager.h"
 
 #include <cassert>
+#include <iterator>
 
 #include "addons/Skin.h"
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
 #include "windowing/GraphicContext.h"
+#include "GUIControlProfiler.h"
 #include "Texture.h"
 #include "threads/SingleLock.h"
 #include "threads/SystemClock.h"
 #include "URL.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 #include "utils/URIUtils.h"
 
-#ifdef _DEBUG_TEXTURES
-#include "utils/TimeUtils.h"
-#endif
 #if defined(TARGET_DARWIN_IOS)
 #define WIN_SYSTEM_CLASS CWinSystemIOS
 #include "ServiceBroker.h"
@@ -211,6 +212,46 @@ void CTextureMap::Add(CBaseTexture* texture, int delay)
     m_memUsage += sizeof(CTexture) + (texture->GetTextureWidth() * texture->GetTextureHeight() * 4);
 }
 
+namespace
+{
+/*!
+ \brief Decodes a texture from a file for CGUITextureManager::Load()
+ */
+class CTextureLoadJob : public CJob
+{
+public:
+  CTextureLoadJob(const std::string& name, const std::string& path)
+    : m_name(name), m_path(path)
+  {
+  }
+  ~CTextureLoadJob() override
+  {
+    delete m_texture;
+  }
+
+  bool DoWork() override
+  {
+    int64_t start = CurrentHostCounter();
+    m_texture = CBaseTexture::LoadFromFile(m_path);
+    m_loadTime = CurrentHostCounter() - start;
+    return m_texture != nullptr;
+  }
+  const char *GetType() const override { return "textureload"; }
+
+  std::string m_name;
+  std::string m_path;
+  CBaseTexture* m_texture = nullptr;
+  int64_t m_loadTime = 0;
+};
+
+CTextureMap* CreateTextureMap(const std::string& textureName, CBaseTexture* texture)
+{
+  CTextureMap* pMap = new CTextureMap(textureName, texture->GetWidth(), texture->GetHeight(), 0);
+  pMap->Add(texture, 100);
+  return pMap;
+}
+}
+
 /************************************************************************/
 /*                                                                      */
 /************************************************************************/
@@ -257,14 +298,10 @@ bool CGUITextureManager::HasTexture(const std::string &textureName, std::string
 
   // Check our loaded and bundled textures - we store in bundles using \\.
   std::string bundledName = CTextureBundle::Normalize(textureName);
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  if (m_textures.find(textureName) != m_textures.end())
   {
-    CTextureMap *pMap = m_vecTextures[i];
-    if (pMap->GetName() == textureName)
-    {
-      if (size) *size = 1;
-      return true;
-    }
+    if (size) *size = 1;
+    return true;
   }
 
   for (int i = 0; i < 2; i++)
@@ -283,55 +320,93 @@ bool CGUITextureManager::HasTexture(const std::string &textureName, std::string
   return !fullPath.empty();
 }
 
-const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName, bool checkBundleOnly /*= false */)
+const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName, bool checkBundleOnly /*= false */, bool* loading /*= nullptr */)
 {
   std::string strPath;
   static CTextureArray emptyTexture;
   int bundle = -1;
   int size = 0;
 
+  if (loading)
+    *loading = false;
+
   if (strTextureName.empty())
     return emptyTexture;
 
+  {
+    CSingleLock lock(m_section);
+    auto it = m_loadingTextures.find(strTextureName);
+    if (it != m_loadingTextures.end())
+    {
+      if (it->second.done)
+      {
+        // swap in the texture decoded in the background
+        CBaseTexture* pTexture = it->second.texture;
+        int64_t loadTime = it->second.loadTime;
+        m_loadingTextures.erase(it);
+        lock.Leave();
+
+        if (!pTexture)
+          return emptyTexture;
+        if (m_textures.find(strTextureName) == m_textures.end() &&
+            m_unusedIndex.find(strTextureName) == m_unusedIndex.end())
+          return AddTexture(CreateTextureMap(strTextureName, pTexture), loadTime);
+
+        // loaded meanwhile by someone who couldn't wait, or released and waiting for deletion,
+        // the map found below is used again
+        delete pTexture;
+      }
+      else if (loading)
+      {
+        *loading = true;
+        return emptyTexture;
+      }
+    }
+  }
+
   if (!HasTexture(strTextureName, &strPath, &bundle, &size))
     return emptyTexture;
 
   if (size) // we found the texture
   {
-    for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+    auto it = m_textures.find(strTextureName);
+    if (it != m_textures.end())
     {
-      CTextureMap *pMap = m_vecTextures[i];
-      if (pMap->GetName() == strTextureName)
-      {
-        //CLog::Log(LOGDEBUG, "Total memusage %u", GetMemoryUsage());
-        return pMap->GetTexture();
-      }
+      //CLog::Log(LOGDEBUG, "Total memusage %u", GetMemoryUsage());
+      return it->second->GetTexture();
     }
     // Whoops, not there.
     return emptyTexture;
   }
 
-  for (ilistUnused i = m_unusedTextures.begin(); i != m_unusedTextures.end(); ++i)
+  auto unused = m_unusedIndex.find(strTextureName);
+  if (unused != m_unusedIndex.end())
   {
-    CTextureMap* pMap = i->first;
-    if (pMap->GetName() == strTextureName && i->second > 0)
-    {
-      m_vecTextures.push_back(pMap);
-      m_unusedTextures.erase(i);
-      return pMap->GetTexture();
-    }
+    CTextureMap* pMap = unused->second->first;
+    m_unusedTextures.erase(unused->second);
+    m_unusedIndex.erase(unused);
+    m_textures[strTextureName] = pMap;
+    return pMap->GetTexture();
   }
 
   if (checkBundleOnly && bundle == -1)
     return emptyTexture;
 
+  if (loading && bundle == -1 &&
+      !StringUtils::EndsWithNoCase(strPath, ".gif") &&
+      !StringUtils::EndsWithNoCase(strPath, ".apng"))
+  {
+    CSingleLock lock(m_section);
+    CLoadingTexture& texture = m_loadingTextures[strTextureName];
+    texture.jobID = CJobManager::GetInstance().AddJob(new CTextureLoadJob(strTextureName, strPath), this, CJob::PRIORITY_HIGH);
+    *loading = true;
+    return emptyTexture;
+  }
+
   //Lock here, we will do stuff that could break rendering
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
 
-#ifdef _DEBUG_TEXTURES
-  int64_t start;
-  start = CurrentHostCounter();
-#endif
+  int64_t start = CurrentHostCounter();
 
   if (bundle >= 0 && StringUtils::EndsWithNoCase(strPath, ".gif"))
   {
@@ -364,8 +439,7 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
     delete[] pTextures;
     delete[] Delay;
 
-    m_vecTextures.push_back(pMap);
-    return pMap->GetTexture();
+    return AddTexture(pMap, CurrentHostCounter() - start);
   }
   else if (StringUtils::EndsWithNoCase(strPath, ".gif") ||
            StringUtils::EndsWithNoCase(strPath, ".apng"))
@@ -421,8 +495,7 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
 
     file.Close();
 
-    m_vecTextures.push_back(pMap);
-    return pMap->GetTexture();
+    return AddTexture(pMap, CurrentHostCounter() - start);
   }
 
   CBaseTexture *pTexture = NULL;
@@ -448,7 +521,6 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
 
   CTextureMap* pMap = new CTextureMap(strTextureName, width, height, 0);
   pMap->Add(pTexture, 100);
-  m_vecTextures.push_back(pMap);
 
 #ifdef _DEBUG_TEXTURES
   int64_t end, freq;
@@ -459,43 +531,116 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
   OutputDebugString(temp);
 #endif
 
+  return AddTexture(pMap, CurrentHostCounter() - start);
+}
+
+const CTextureArray& CGUITextureManager::AddTexture(CTextureMap* pMap, int64_t loadTime)
+{
+  m_textures[pMap->GetName()] = pMap;
+  GUIPROFILER_TEXTURE_LOAD(pMap->GetMemoryUsage(), loadTime);
   return pMap->GetTexture();
 }
 
+void CGUITextureManager::AddUnusedTexture(CTextureMap* pMap, unsigned int releaseTime)
+{
+  m_unusedTextures.emplace_back(pMap, releaseTime);
+
+  // textures released immediately are freed on the next cleanup and not used again
+  if (!releaseTime)
+    return;
+
+  auto it = m_unusedIndex.find(pMap->GetName());
+  if (it != m_unusedIndex.end())
+  {
+    it->second->second = 0;
+    it->second = std::prev(m_unusedTextures.end());
+  }
+  else
+    m_unusedIndex.emplace(pMap->GetName(), std::prev(m_unusedTextures.end()));
+}
+
+void CGUITextureManager::AddLoadedTextures(unsigned int releaseTime)
+{
+  // textures decoded in the background that nobody asked for again, e.g. because the control
+  // was hidden meanwhile, are kept like released ones
+  CSingleLock lock(m_section);
+  for (auto it = m_loadingTextures.begin(); it != m_loadingTextures.end();)
+  {
+    if (!it->second.done)
+    {
+      ++it;
+      continue;
+    }
+
+    CBaseTexture* pTexture = it->second.texture;
+    if (pTexture)
+    {
+      if (m_textures.find(it->first) != m_textures.end() ||
+          m_unusedIndex.find(it->first) != m_unusedIndex.end())
+        delete pTexture;
+      else
+        AddUnusedTexture(CreateTextureMap(it->first, pTexture), releaseTime);
+    }
+    it = m_loadingTextures.erase(it);
+  }
+}
+
+void CGUITextureManager::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CTextureLoadJob* loadJob = static_cast<CTextureLoadJob*>(job);
+
+  CSingleLock lock(m_section);
+  auto it = m_loadingTextures.find(loadJob->m_name);
+  if (it == m_loadingTextures.end() || it->second.jobID != jobID)
+    return;
+
+  it->second.done = true;
+  it->second.texture = loadJob->m_texture;
+  it->second.loadTime = loadJob->m_loadTime;
+  loadJob->m_texture = nullptr;
+}
 
 void CGUITextureManager::ReleaseTexture(const std::string& strTextureName, bool immediately /*= false */)
 {
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  auto i = m_textures.find(strTextureName);
+  if (i != m_textures.end())
   {
-    CTextureMap* pMap = *i;
-    if (pMap->GetName() == strTextureName)
+    CTextureMap* pMap = i->second;
+    if (pMap->Release())
     {
-      if (pMap->Release())
-      {
-        //CLog::Log(LOGINFO, "  cleanup:%s", strTextureName.c_str());
-        // add to our textures to free
-        m_unusedTextures.emplace_back(pMap, immediately ? 0 : XbmcThreads::SystemClockMillis());
-        i = m_vecTextures.erase(i);
-      }
-      return;
+      //CLog::Log(LOGINFO, "  cleanup:%s", strTextureName.c_str());
+      // add to our textures to free
+      AddUnusedTexture(pMap, immediately ? 0 : XbmcThreads::SystemClockMillis());
+      m_textures.erase(i);
     }
-    ++i;
+    return;
   }
   CLog::Log(LOGWARNING, "%s: Unable to release texture %s", __FUNCTION__, strTextureName.c_str());
 }
 
-void CGUITextureManager::FreeUnusedTextures(unsigned int timeDelay)
+void CGUITextureManager::FreeUnusedTextures(unsigned int timeDelay, uint64_t memoryBudget)
 {
   unsigned int currFrameTime = XbmcThreads::SystemClockMillis();
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
+
+  AddLoadedTextures(currFrameTime);
+
+  uint64_t memUsage = GetMemoryUsage();
+  for (const auto& it : m_unusedTextures)
+    memUsage += it.first->GetMemoryUsage();
+
+  // the least recently released textures come first
   for (ilistUnused i = m_unusedTextures.begin(); i != m_unusedTextures.end();)
   {
-    if (currFrameTime - i->second >= timeDelay)
+    if (currFrameTime - i->second >= timeDelay || memUsage > memoryBudget)
     {
+      auto it = m_unusedIndex.find(i->first->GetName());
+      if (it != m_unusedIndex.end() && it->second == i)
+        m_unusedIndex.erase(it);
+
+      memUsage -= i->first->GetMemoryUsage();
       delete i->first;
       i = m_unusedTextures.erase(i);
     }
@@ -504,6 +649,10 @@ void CGUITextureManager::FreeUnusedTextures(unsigned int timeDelay)
   }
 
 #if defined(HAS_GL) || defined(HAS_GLES)
+  // queued quads might still use the textures
+  if (!m_unusedHwTextures.empty() && CServiceBroker::GetRenderSystem())
+    CServiceBroker::GetRenderSystem()->FlushBatches();
+
   for (unsigned int i = 0; i < m_unusedHwTextures.size(); ++i)
   {
     // on ios/tvos the hw textures might be deleted from the os
@@ -529,14 +678,27 @@ void CGUITextureManager::Cleanup()
 {
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  std::vector<unsigned int> jobs;
+  {
+    CSingleLock loadingLock(m_section);
+    for (auto& it : m_loadingTextures)
+    {
+      if (it.second.done)
+        delete it.second.texture;
+      else
+        jobs.push_back(it.second.jobID);
+    }
+    m_loadingTextures.clear();
+  }
+  for (unsigned int jobID : jobs)
+    CJobManager::GetInstance().CancelJob(jobID);
+
+  for (auto i = m_textures.begin(); i != m_textures.end();)
   {
-    CTextureMap* pMap = *i;
+    CTextureMap* pMap = i->second;
     CLog::Log(LOGWARNING, "%s: Having to cleanup texture %s", __FUNCTION__, pMap->GetName().c_str());
     delete pMap;
-    i = m_vecTextures.erase(i);
+    i = m_textures.erase(i);
   }
   m_TexBundle[0].Close();
   m_TexBundle[1].Close();
@@ -547,11 +709,11 @@ void CGUITextureManager::Cleanup()
 
 void CGUITextureManager::Dump() const
 {
-  CLog::Log(LOGDEBUG, "{0}: total texturemaps size: {1}", __FUNCTION__, m_vecTextures.size());
+  CLog::Log(LOGDEBUG, "{0}: total texturemaps size: {1}", __FUNCTION__, m_textures.size());
 
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  for (const auto& it : m_textures)
   {
-    const CTextureMap* pMap = m_vecTextures[i];
+    const CTextureMap* pMap = it.second;
     if (!pMap->IsEmpty())
       pMap->Dump();
   }
@@ -561,16 +723,14 @@ void CGUITextureManager::Flush()
 {
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  for (auto i = m_textures.begin(); i != m_textures.end();)
   {
-    CTextureMap* pMap = *i;
+    CTextureMap* pMap = i->second;
     pMap->Flush();
     if (pMap->IsEmpty() )
     {
       delete pMap;
-      i = m_vecTextures.erase(i);
+      i = m_textures.erase(i);
     }
     else
     {
@@ -582,9 +742,9 @@ void CGUITextureManager::Flush()
 unsigned int CGUITextureManager::GetMemoryUsage() const
 {
   unsigned int memUsage = 0;
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  for (const auto& it : m_textures)
   {
-    memUsage += m_vecTextures[i]->GetMemoryUsage();
+    memUsage += it.second->GetMemoryUsage();
   }
   return memUsage;
 }
@@ -11,8 +11,12 @@
 #include "GUIComponent.h"
 #include "TextureBundle.h"
 #include "threads/CriticalSection.h"
+#include "utils/Job.h"
 
+#include <limits>
 #include <list>
+#include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -86,15 +90,24 @@ protected:
 /************************************************************************/
 /*                                                                      */
 /************************************************************************/
-class CGUITextureManager
+class CGUITextureManager : public IJobCallback
 {
 public:
   CGUITextureManager(void);
-  virtual ~CGUITextureManager(void);
+  ~CGUITextureManager(void) override;
 
   bool HasTexture(const std::string &textureName, std::string *path = NULL, int *bundle = NULL, int *size = NULL);
   static bool CanLoad(const std::string &texturePath); ///< Returns true if the texture manager can load this texture
-  const CTextureArray& Load(const std::string& strTextureName, bool checkBundleOnly = false);
+  /*!
+   \brief Load a texture, or take another reference to it if it's loaded already.
+   \param strTextureName name or path of the texture
+   \param checkBundleOnly only load the texture if it's in one of the texture bundles
+   \param loading if given, images that are neither bundled nor animated are decoded in the
+   background. An empty texture is returned and loading set to true until the decoded texture is
+   ready, call Load() again to get it.
+   \return the texture, empty if it can't be loaded (yet)
+   */
+  const CTextureArray& Load(const std::string& strTextureName, bool checkBundleOnly = false, bool* loading = nullptr);
   void ReleaseTexture(const std::string& strTextureName, bool immediately = false);
   void Cleanup();
   void Dump() const;
@@ -107,14 +120,36 @@ public:
   void SetTexturePath(const std::string &texturePath);    ///< Set a single path as the path to check when loading media (clear then add)
   void RemoveTexturePath(const std::string &texturePath); ///< Remove a path from the paths to check when loading media
 
-  void FreeUnusedTextures(unsigned int timeDelay = 0); ///< Free textures (called from app thread only)
+  /*!
+   \brief Free textures that have been released (called from app thread only)
+   \param timeDelay free textures released at least this many milliseconds ago
+   \param memoryBudget while all textures use more memory than this, the least recently released
+   textures are freed regardless of their delay
+   */
+  void FreeUnusedTextures(unsigned int timeDelay = 0, uint64_t memoryBudget = std::numeric_limits<uint64_t>::max());
   void ReleaseHwTexture(unsigned int texture);
+
+  void OnJobComplete(unsigned int jobID, bool success, CJob *job) override;
 protected:
-  std::vector<CTextureMap*> m_vecTextures;
-  std::list<std::pair<CTextureMap*, unsigned int> > m_unusedTextures;
-  std::vector<unsigned int> m_unusedHwTextures;
-  typedef std::vector<CTextureMap*>::iterator ivecTextures;
+  struct CLoadingTexture
+  {
+    unsigned int jobID = 0;
+    bool done = false;
+    CBaseTexture* texture = nullptr; ///< decoded texture, nullptr if decoding failed
+    int64_t loadTime = 0;
+  };
+
   typedef std::list<std::pair<CTextureMap*, unsigned int> >::iterator ilistUnused;
+
+  const CTextureArray& AddTexture(CTextureMap* pMap, int64_t loadTime);
+  void AddUnusedTexture(CTextureMap* pMap, unsigned int releaseTime);
+  void AddLoadedTextures(unsigned int releaseTime);
+
+  std::unordered_map<std::string, CTextureMap*> m_textures; ///< textures in use by name
+  std::list<std::pair<CTextureMap*, unsigned int> > m_unusedTextures; ///< released textures, least recently released first
+  std::unordered_map<std::string, ilistUnused> m_unusedIndex; ///< released textures that may be used again by name
+  std::unordered_map<std::string, CLoadingTexture> m_loadingTextures; ///< textures decoded in the background (protected by m_section)
+  std::vector<unsigned int> m_unusedHwTextures;
   // we have 2 texture bundles (one for the base textures, one for the theme)
   CTextureBundle m_TexBundle[2];
 
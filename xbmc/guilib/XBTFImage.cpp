@@ -0,0 +1,244 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "XBTFImage.h"
+
+#include "utils/EndianSwap.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <lzo/lzo1x.h>
+
+namespace
+{
+bool ReadUInt32(const unsigned char* &data, const unsigned char* end, uint32_t& value)
+{
+  if (end - data < static_cast<ptrdiff_t>(sizeof(value)))
+    return false;
+  memcpy(&value, data, sizeof(value));
+  value = Endian_SwapLE32(value);
+  data += sizeof(value);
+  return true;
+}
+
+bool ReadUInt64(const unsigned char* &data, const unsigned char* end, uint64_t& value)
+{
+  if (end - data < static_cast<ptrdiff_t>(sizeof(value)))
+    return false;
+  memcpy(&value, data, sizeof(value));
+  value = Endian_SwapLE64(value);
+  data += sizeof(value);
+  return true;
+}
+
+void WriteUInt32(std::vector<unsigned char>& data, uint32_t value)
+{
+  value = Endian_SwapLE32(value);
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+  data.insert(data.end(), bytes, bytes + sizeof(value));
+}
+
+void WriteUInt64(std::vector<unsigned char>& data, uint64_t value)
+{
+  value = Endian_SwapLE64(value);
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+  data.insert(data.end(), bytes, bytes + sizeof(value));
+}
+}
+
+bool CXBTFImage::LoadImageFromMemory(unsigned char* buffer, unsigned int bufSize, unsigned int width, unsigned int height)
+{
+  const unsigned char* data = buffer;
+  const unsigned char* end = buffer + bufSize;
+
+  if (bufSize < XBTF_MAGIC.size() + XBTF_VERSION.size() ||
+      memcmp(data, XBTF_MAGIC.c_str(), XBTF_MAGIC.size()) != 0 ||
+      memcmp(data + XBTF_MAGIC.size(), XBTF_VERSION.c_str(), XBTF_VERSION.size()) != 0)
+    return false;
+  data += XBTF_MAGIC.size() + XBTF_VERSION.size();
+
+  // only the first frame of the first file is used
+  uint32_t files, loop, frames;
+  if (!ReadUInt32(data, end, files) || files == 0 ||
+      end - data < static_cast<ptrdiff_t>(CXBTFFile::MaximumPathLength))
+    return false;
+  data += CXBTFFile::MaximumPathLength;
+  if (!ReadUInt32(data, end, loop) || !ReadUInt32(data, end, frames) || frames == 0)
+    return false;
+
+  uint32_t u32;
+  uint64_t u64;
+  if (!ReadUInt32(data, end, u32))
+    return false;
+  m_frame.SetWidth(u32);
+  if (!ReadUInt32(data, end, u32))
+    return false;
+  m_frame.SetHeight(u32);
+  if (!ReadUInt32(data, end, u32))
+    return false;
+  m_frame.SetFormat(u32);
+  if (!ReadUInt64(data, end, u64))
+    return false;
+  m_frame.SetPackedSize(u64);
+  if (!ReadUInt64(data, end, u64))
+    return false;
+  m_frame.SetUnpackedSize(u64);
+  if (!ReadUInt32(data, end, u32))
+    return false;
+  m_frame.SetDuration(u32);
+  if (!ReadUInt64(data, end, u64))
+    return false;
+  m_frame.SetOffset(u64);
+
+  if (m_frame.GetFormat() != XB_FMT_A8R8G8B8 || m_frame.GetWidth() == 0 || m_frame.GetHeight() == 0 ||
+      m_frame.GetUnpackedSize() != static_cast<uint64_t>(m_frame.GetWidth()) * m_frame.GetHeight() * 4 ||
+      m_frame.GetOffset() > bufSize || m_frame.GetPackedSize() > bufSize - m_frame.GetOffset())
+  {
+    CLog::Log(LOGERROR, "CXBTFImage::%s - unsupported or damaged texture", __FUNCTION__);
+    return false;
+  }
+
+  m_data = buffer;
+  m_width = m_originalWidth = m_frame.GetWidth();
+  m_height = m_originalHeight = m_frame.GetHeight();
+  m_hasAlpha = m_frame.HasAlpha();
+  return true;
+}
+
+bool CXBTFImage::Decode(unsigned char* const pixels, unsigned int width, unsigned int height, unsigned int pitch, unsigned int format)
+{
+  if (m_data == nullptr || format != XB_FMT_A8R8G8B8)
+    return false;
+
+  // unpack straight into the texture if it's large enough, then move the rows to their place
+  // starting with the last one, which doesn't overwrite rows that are still to be moved
+  const unsigned int framePitch = m_frame.GetWidth() * 4;
+  if (pitch >= framePitch && height >= m_frame.GetHeight())
+  {
+    if (!Unpack(pixels, m_frame.GetUnpackedSize()))
+      return false;
+    if (pitch != framePitch)
+    {
+      for (unsigned int y = m_frame.GetHeight() - 1; y > 0; y--)
+        memmove(pixels + y * pitch, pixels + y * framePitch, framePitch);
+    }
+    return true;
+  }
+
+  std::vector<unsigned char> unpacked(static_cast<size_t>(m_frame.GetUnpackedSize()));
+  if (!Unpack(unpacked.data(), unpacked.size()))
+    return false;
+
+  const unsigned int rowSize = std::min(framePitch, pitch);
+  const unsigned int rows = std::min(m_frame.GetHeight(), height);
+  for (unsigned int y = 0; y < rows; y++)
+    memcpy(pixels + y * pitch, unpacked.data() + y * framePitch, rowSize);
+  return true;
+}
+
+bool CXBTFImage::Unpack(unsigned char* pixels, uint64_t size) const
+{
+  const unsigned char* packed = m_data + m_frame.GetOffset();
+  if (!m_frame.IsPacked())
+  {
+    memcpy(pixels, packed, static_cast<size_t>(size));
+    return true;
+  }
+
+  lzo_uint unpackedSize = static_cast<lzo_uint>(size);
+  if (lzo1x_decompress_safe(packed, static_cast<lzo_uint>(m_frame.GetPackedSize()), pixels, &unpackedSize, nullptr) != LZO_E_OK ||
+      unpackedSize != m_frame.GetUnpackedSize())
+  {
+    CLog::Log(LOGERROR, "CXBTFImage::%s - failed to decompress %ux%u texture", __FUNCTION__, m_frame.GetWidth(), m_frame.GetHeight());
+    return false;
+  }
+  return true;
+}
+
+bool CXBTFImage::CreateThumbnailFromSurface(unsigned char* bufferin, unsigned int width, unsigned int height, unsigned int format, unsigned int pitch, const std::string& destFile,
+                                            unsigned char* &bufferout, unsigned int &bufferoutSize)
+{
+  if (format != XB_FMT_A8R8G8B8 || width == 0 || height == 0 || lzo_init() != LZO_E_OK)
+    return false;
+
+  // gather the rows, noting whether any of them is transparent
+  const unsigned int rowSize = width * 4;
+  std::vector<unsigned char> pixels(static_cast<size_t>(rowSize) * height);
+  bool hasAlpha = false;
+  for (unsigned int y = 0; y < height; y++)
+  {
+    const unsigned char* src = bufferin + y * pitch;
+    memcpy(pixels.data() + y * rowSize, src, rowSize);
+    for (unsigned int x = 3; x < rowSize && !hasAlpha; x += 4)
+      hasAlpha = src[x] != 0xff;
+  }
+
+  CXBTFFrame frame;
+  frame.SetWidth(width);
+  frame.SetHeight(height);
+  frame.SetFormat(hasAlpha ? XB_FMT_A8R8G8B8 : XB_FMT_A8R8G8B8 | XB_FMT_OPAQUE);
+  frame.SetUnpackedSize(pixels.size());
+  frame.SetDuration(0);
+
+  CXBTFFile file;
+  file.GetFrames().push_back(frame);
+  const uint64_t headerSize = XBTF_MAGIC.size() + XBTF_VERSION.size() + sizeof(uint32_t) + file.GetHeaderSize();
+  frame.SetOffset(headerSize);
+
+  // lzo1x_1 rather than lzo1x_999 as used for skins: it's a lot quicker to pack, and unpacking
+  // is just as fast
+  m_thumbnail.resize(static_cast<size_t>(headerSize) + pixels.size() + pixels.size() / 16 + 64 + 3);
+  std::vector<unsigned char> working(LZO1X_1_MEM_COMPRESS);
+  lzo_uint packedSize = 0;
+  if (lzo1x_1_compress(pixels.data(), pixels.size(), m_thumbnail.data() + headerSize, &packedSize, working.data()) != LZO_E_OK ||
+      packedSize >= pixels.size())
+  { // store it unpacked
+    packedSize = pixels.size();
+    memcpy(m_thumbnail.data() + headerSize, pixels.data(), pixels.size());
+  }
+  frame.SetPackedSize(packedSize);
+
+  std::vector<unsigned char> header;
+  header.reserve(static_cast<size_t>(headerSize));
+  header.insert(header.end(), XBTF_MAGIC.begin(), XBTF_MAGIC.end());
+  header.insert(header.end(), XBTF_VERSION.begin(), XBTF_VERSION.end());
+  WriteUInt32(header, 1);
+
+  std::string path = URIUtils::GetFileName(destFile);
+  StringUtils::ToLower(path);
+  path.resize(CXBTFFile::MaximumPathLength, '\0');
+  header.insert(header.end(), path.begin(), path.end());
+  WriteUInt32(header, 0);
+  WriteUInt32(header, 1);
+
+  WriteUInt32(header, frame.GetWidth());
+  WriteUInt32(header, frame.GetHeight());
+  WriteUInt32(header, frame.GetFormat(true));
+  WriteUInt64(header, frame.GetPackedSize());
+  WriteUInt64(header, frame.GetUnpackedSize());
+  WriteUInt32(header, frame.GetDuration());
+  WriteUInt64(header, frame.GetOffset());
+  if (header.size() != headerSize)
+    return false;
+
+  std::copy(header.begin(), header.end(), m_thumbnail.begin());
+  m_thumbnail.resize(static_cast<size_t>(headerSize + packedSize));
+  bufferout = m_thumbnail.data();
+  bufferoutSize = static_cast<unsigned int>(m_thumbnail.size());
+  return true;
+}
+
+void CXBTFImage::ReleaseThumbnailBuffer()
+{
+  m_thumbnail.clear();
+  m_thumbnail.shrink_to_fit();
+}
@@ -0,0 +1,45 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "XBTF.h"
+#include "iimage.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*!
+ \ingroup textures
+ \brief Reads and writes single textures in the XBT format.
+
+ The pixels are stored as lzo packed A8R8G8B8, so decoding them is a decompression straight
+ into the texture rather than decoding a JPEG or PNG. Used for the texture cache when
+ <imagecachepacked> is enabled. The buffer given to LoadImageFromMemory() has to be kept
+ until Decode() is called.
+ */
+class CXBTFImage : public IImage
+{
+public:
+  CXBTFImage() = default;
+  ~CXBTFImage() override = default;
+
+  bool LoadImageFromMemory(unsigned char* buffer, unsigned int bufSize, unsigned int width, unsigned int height) override;
+  bool Decode(unsigned char* const pixels, unsigned int width, unsigned int height, unsigned int pitch, unsigned int format) override;
+  bool CreateThumbnailFromSurface(unsigned char* bufferin, unsigned int width, unsigned int height, unsigned int format, unsigned int pitch, const std::string& destFile,
+                                  unsigned char* &bufferout, unsigned int &bufferoutSize) override;
+  void ReleaseThumbnailBuffer() override;
+
+private:
+  bool Unpack(unsigned char* pixels, uint64_t size) const;
+
+  const unsigned char* m_data = nullptr;
+  CXBTFFrame m_frame;
+  std::vector<unsigned char> m_thumbnail;
+};
@@ -23,6 +23,7 @@
 #include "guilib/guiinfo/GUIInfo.h"
 #include "guilib/guiinfo/GUIInfoHelper.h"
 #include "guilib/guiinfo/GUIInfoLabels.h"
+#include "interfaces/info/InfoBool.h"
 #include "music/dialogs/GUIDialogMusicInfo.h"
 #include "music/dialogs/GUIDialogSongInfo.h"
 #include "music/tags/MusicInfoTag.h"
@@ -811,3 +812,15 @@ bool CGUIControlsGUIInfo::GetBool(bool& value, const CGUIListItem *gitem, int co
 
   return false;
 }
+
+bool CGUIControlsGUIInfo::GetDependencies(unsigned int& dependencies, const CGUIInfo &info) const
+{
+  // properties of the active window change along with the active window
+  if (info.m_info == WINDOW_PROPERTY && info.GetData1())
+  {
+    dependencies = 1 << INFO::INFO_SOURCE_WINDOW_PROPERTIES;
+    return true;
+  }
+
+  return false;
+}
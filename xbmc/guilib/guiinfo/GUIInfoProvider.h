@@ -29,6 +29,8 @@ public:
   void UpdateAVInfo(const AudioStreamInfo& audioInfo, const VideoStreamInfo& videoInfo, const SubtitleStreamInfo& subtitleInfo) override
   { m_audioInfo = audioInfo, m_videoInfo = videoInfo, m_subtitleInfo = subtitleInfo; }
 
+  bool GetDependencies(unsigned int& dependencies, const CGUIInfo &info) const override { return false; }
+
 protected:
   VideoStreamInfo m_videoInfo;
   AudioStreamInfo m_audioInfo;
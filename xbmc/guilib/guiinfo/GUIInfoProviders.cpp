@@ -108,6 +108,16 @@ bool CGUIInfoProviders::GetBool(bool& value, const CGUIListItem *item, int conte
   return false;
 }
 
+bool CGUIInfoProviders::GetDependencies(unsigned int& dependencies, const CGUIInfo &info) const
+{
+  for (const auto& provider : m_providers)
+  {
+    if (provider->GetDependencies(dependencies, info))
+      return true;
+  }
+  return false;
+}
+
 void CGUIInfoProviders::UpdateAVInfo(const AudioStreamInfo& audioInfo, const VideoStreamInfo& videoInfo, const SubtitleStreamInfo& subtitleInfo)
 {
   for (const auto& provider : m_providers)
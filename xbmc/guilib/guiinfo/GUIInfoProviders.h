@@ -97,6 +97,14 @@ public:
    */
   bool GetBool(bool& value, const CGUIListItem *item, int contextWindow, const CGUIInfo &info) const;
 
+  /*!
+   * @brief Get the sources a GUIInfoManager value depends on from one of the registered providers.
+   * @param dependencies Will be filled with the sources as flags, 1 << INFO::InfoSource.
+   * @param info The GUI info (label id + additional data).
+   * @return True if the dependencies were filled by one of the providers, false otherwise.
+   */
+  bool GetDependencies(unsigned int& dependencies, const CGUIInfo &info) const;
+
   /*!
    * @brief Set new audio/video/subtitle stream info data at all registered providers.
    * @param audioInfo New audio stream info.
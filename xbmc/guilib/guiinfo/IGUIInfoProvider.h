@@ -68,6 +68,14 @@ public:
    */
   virtual bool GetBool(bool& value, const CGUIListItem *item, int contextWindow, const CGUIInfo &info) const = 0;
 
+  /*!
+   * @brief Get the sources a GUIInfoManager value depends on, if they announce their changes.
+   * @param dependencies Will be filled with the sources as flags, 1 << INFO::InfoSource.
+   * @param info The GUI info (label id + additional data).
+   * @return True if the dependencies were filled by the provider, false if the value has to be updated every frame.
+   */
+  virtual bool GetDependencies(unsigned int& dependencies, const CGUIInfo &info) const = 0;
+
   /*!
    * @brief Set new audio/video stream info data.
    * @param audioInfo New audio stream info.
@@ -320,6 +320,16 @@ bool CPlayerGUIInfo::GetLabel(std::string& value, const CFileItem *item, int con
     case PLAYER_PROCESS_VIDEOHEIGHT:
       value = StringUtils::FormatNumber(CServiceBroker::GetDataCacheCore().GetVideoHeight());
       return true;
+    case PLAYER_PROCESS_VIDEOTHREADING:
+      value = CServiceBroker::GetDataCacheCore().GetVideoDecoderThreading();
+      return true;
+    case PLAYER_PROCESS_VIDEODECODETIME:
+    {
+      float decodeTime = CServiceBroker::GetDataCacheCore().GetVideoDecodeTime();
+      if (decodeTime > 0.0f)
+        value = StringUtils::Format("%.1f", decodeTime);
+      return true;
+    }
     case PLAYER_PROCESS_AUDIODECODER:
       value = CServiceBroker::GetDataCacheCore().GetAudioDecoderName();
       return true;
@@ -13,6 +13,7 @@
 #include "guilib/LocalizeStrings.h"
 #include "guilib/guiinfo/GUIInfo.h"
 #include "guilib/guiinfo/GUIInfoLabels.h"
+#include "interfaces/info/InfoBool.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "settings/SkinSettings.h"
@@ -115,3 +116,17 @@ bool CSkinGUIInfo::GetBool(bool& value, const CGUIListItem *gitem, int contextWi
 
   return false;
 }
+
+bool CSkinGUIInfo::GetDependencies(unsigned int& dependencies, const CGUIInfo &info) const
+{
+  switch (info.m_info)
+  {
+    case SKIN_BOOL:
+    case SKIN_STRING:
+    case SKIN_STRING_IS_EQUAL:
+      dependencies = 1 << INFO::INFO_SOURCE_SKIN_SETTINGS;
+      return true;
+  }
+
+  return false;
+}
@@ -30,6 +30,7 @@ public:
   bool GetLabel(std::string& value, const CFileItem *item, int contextWindow, const CGUIInfo &info, std::string *fallback) const override;
   bool GetInt(int& value, const CGUIListItem *item, int contextWindow, const CGUIInfo &info) const override;
   bool GetBool(bool& value, const CGUIListItem *item, int contextWindow, const CGUIInfo &info) const override;
+  bool GetDependencies(unsigned int& dependencies, const CGUIInfo &info) const override;
 };
 
 } // namespace GUIINFO
@@ -12,6 +12,7 @@
 #include "addons/ImageDecoder.h"
 #include "addons/binary-addons/BinaryAddonBase.h"
 #include "guilib/FFmpegImage.h"
+#include "guilib/XBTFImage.h"
 #include "utils/Mime.h"
 #include "utils/StringUtils.h"
 
@@ -37,6 +38,10 @@ IImage* ImageFactory::CreateLoader(const CURL& url)
 
 IImage* ImageFactory::CreateLoaderFromMimeType(const std::string& strMimeType)
 {
+  // textures packed for the texture cache
+  if (strMimeType == "image/xbt")
+    return new CXBTFImage();
+
   BinaryAddonBaseList addonInfos;
 
   CServiceBroker::GetBinaryAddonManager().GetAddonInfos(addonInfos, true, ADDON_IMAGEDECODER);
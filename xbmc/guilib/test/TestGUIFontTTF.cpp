@@ -0,0 +1,183 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "guilib/GUIFontTTF.h"
+#include "guilib/Texture.h"
+#include "rendering/RenderSystem.h"
+#include "test/TestUtils.h"
+#include "windowing/WinSystem.h"
+
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+class CTestRenderSystem : public CRenderSystemBase
+{
+public:
+  CTestRenderSystem() { m_maxTextureSize = 4096; }
+
+  bool InitRenderSystem() override { return true; }
+  bool DestroyRenderSystem() override { return true; }
+  bool ResetRenderSystem(int width, int height) override { return true; }
+  bool BeginRender() override { return true; }
+  bool EndRender() override { return true; }
+  void PresentRender(bool rendered, bool videoLayer) override {}
+  bool ClearBuffers(UTILS::Color color) override { return true; }
+  bool IsExtSupported(const char* extension) const override { return false; }
+  void SetViewPort(const CRect& viewPort) override {}
+  void GetViewPort(CRect& viewPort) override {}
+  void SetScissors(const CRect& rect) override {}
+  void ResetScissors() override {}
+  void CaptureStateBlock() override {}
+  void ApplyStateBlock() override {}
+  void SetCameraPosition(const CPoint& camera, int screenWidth, int screenHeight, float stereoFactor = 0.f) override {}
+};
+
+class CTestWinSystem : public CWinSystemBase
+{
+public:
+  CRenderSystemBase* GetRenderSystem() override { return &m_renderSystem; }
+
+  bool CreateNewWindow(const std::string& name, bool fullScreen, RESOLUTION_INFO& res) override { return false; }
+  bool ResizeWindow(int newWidth, int newHeight, int newLeft, int newTop) override { return false; }
+  bool SetFullScreen(bool fullScreen, RESOLUTION_INFO& res, bool blankOtherDisplays) override { return false; }
+  void Register(IDispResource* resource) override {}
+  void Unregister(IDispResource* resource) override {}
+
+private:
+  CTestRenderSystem m_renderSystem;
+};
+
+class CTestTexture : public CBaseTexture
+{
+public:
+  CTestTexture(unsigned int width, unsigned int height) : CBaseTexture(width, height, XB_FMT_A8) {}
+
+  void CreateTextureObject() override {}
+  void DestroyTextureObject() override {}
+  void LoadToGPU() override {}
+  void BindToUnit(unsigned int unit) override {}
+};
+
+// caches the glyphs in memory only
+class CTestFont : public CGUIFontTTFBase
+{
+public:
+  CTestFont() : CGUIFontTTFBase("test") {}
+
+  ~CTestFont() override { m_dynamicCache.Flush(); }
+
+  void CacheText(const std::string& text)
+  {
+    // measuring the text caches its glyphs
+    vecText chars(text.begin(), text.end());
+    GetTextWidthInternal(chars.begin(), chars.end());
+  }
+
+  using CGUIFontTTFBase::CreateDistanceField;
+
+protected:
+  CBaseTexture* ReallocTexture(unsigned int& newHeight) override
+  {
+    newHeight = CBaseTexture::PadPow2(newHeight);
+    CBaseTexture* newTexture = new CTestTexture(m_textureWidth, newHeight);
+    memset(newTexture->GetPixels(), 0, newTexture->GetPitch() * newTexture->GetRows());
+    if (m_texture)
+    {
+      memcpy(newTexture->GetPixels(), m_texture->GetPixels(), m_texture->GetPitch() * m_texture->GetRows());
+      delete m_texture;
+    }
+    m_textureWidth = newTexture->GetWidth();
+    m_textureHeight = newTexture->GetHeight();
+    return newTexture;
+  }
+
+  bool CopyCharToTexture(const unsigned char* pixels, int pitch, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) override
+  {
+    for (unsigned int y = y1; y < y2; y++)
+      memcpy(m_texture->GetPixels() + y * m_texture->GetPitch() + x1, pixels + (y - y1) * pitch, x2 - x1);
+    return true;
+  }
+
+  void DeleteHardwareTexture() override {}
+
+private:
+  bool FirstBegin() override { return true; }
+  void LastEnd() override {}
+};
+
+const std::string ASCII = " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~";
+}
+
+class TestGUIFontTTF : public ::testing::Test
+{
+protected:
+  TestGUIFontTTF() { CServiceBroker::RegisterWinSystem(&m_winSystem); }
+  ~TestGUIFontTTF() override { CServiceBroker::UnregisterWinSystem(); }
+
+  CTestWinSystem m_winSystem;
+};
+
+TEST_F(TestGUIFontTTF, DistanceField)
+{
+  // a 16x16 square
+  const unsigned int size = 16;
+  const unsigned int spread = 8;
+  std::vector<unsigned char> bitmap(size * size, 255);
+  std::vector<unsigned char> field;
+  CTestFont::CreateDistanceField(bitmap.data(), size, size, size, spread, field);
+
+  const unsigned int width = size + 2 * spread;
+  ASSERT_EQ(width * width, field.size());
+
+  // inside the glyph the field rises, outside it falls to 0 at the spread
+  EXPECT_EQ(255, field[(width / 2) * width + width / 2]);
+  EXPECT_EQ(0, field[0]);
+  EXPECT_GT(field[(width / 2) * width + spread + 1], 128);
+  EXPECT_LT(field[(width / 2) * width + spread - 2], 128);
+  EXPECT_NEAR(128, field[(width / 2) * width + spread], 16);
+}
+
+TEST_F(TestGUIFontTTF, GlyphCacheBenchmark)
+{
+  const std::string font = XBMC_REF_FILE_PATH("media/Fonts/teletext.ttf");
+  const float sizes[] = { 20.0f, 26.0f, 30.0f, 36.0f, 48.0f };
+
+  // the skins use each font face at several sizes, each one caching its own glyphs
+  unsigned int glyphs = 0;
+  unsigned int memory = 0;
+  for (float size : sizes)
+  {
+    CTestFont bitmapFont;
+    ASSERT_TRUE(bitmapFont.Load(font, size));
+    bitmapFont.CacheText(ASCII);
+    glyphs += bitmapFont.GetGlyphsRendered();
+    memory += bitmapFont.GetTextureMemory();
+  }
+
+  // a distance field is drawn at all of them
+  CTestFont distanceFieldFont;
+  ASSERT_TRUE(distanceFieldFont.Load(font, DISTANCE_FIELD_FONT_SIZE, 1.0f, 1.0f, false, true));
+  EXPECT_TRUE(distanceFieldFont.IsDistanceField());
+  for (unsigned int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    distanceFieldFont.CacheText(ASCII);
+
+  std::cout << "bitmap: " << glyphs << " glyphs, " << memory / 1024 << " KiB; "
+            << "distance field: " << distanceFieldFont.GetGlyphsRendered() << " glyphs, "
+            << distanceFieldFont.GetTextureMemory() / 1024 << " KiB\n";
+
+  EXPECT_EQ(ASCII.size(), distanceFieldFont.GetGlyphsRendered());
+  EXPECT_LT(distanceFieldFont.GetGlyphsRendered(), glyphs);
+  EXPECT_LT(distanceFieldFont.GetTextureMemory(), memory);
+}
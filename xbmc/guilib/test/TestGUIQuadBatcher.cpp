@@ -0,0 +1,186 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "guilib/GUIQuadBatcher.h"
+
+#include <iostream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+CGUIQuadBatcher::State MakeState(unsigned int texture, int shader = 1)
+{
+  CGUIQuadBatcher::State state;
+  state.shader = shader;
+  state.texture = texture;
+  state.color = 0xffffffff;
+  state.blend = true;
+  state.scissors = CRect(0, 0, 1920, 1080);
+  return state;
+}
+
+std::vector<CGUIQuadBatcher::Vertex> MakeQuad(const CRect& rect, float z = 0.0f)
+{
+  std::vector<CGUIQuadBatcher::Vertex> quad(4);
+  quad[0].x = quad[3].x = rect.x1;
+  quad[1].x = quad[2].x = rect.x2;
+  quad[0].y = quad[1].y = rect.y1;
+  quad[2].y = quad[3].y = rect.y2;
+  for (auto& vertex : quad)
+    vertex.z = z;
+  return quad;
+}
+
+void AddQuad(CGUIQuadBatcher& batcher, const CGUIQuadBatcher::State& state, const CRect& rect, float z = 0.0f)
+{
+  EXPECT_TRUE(batcher.AddQuads(state, MakeQuad(rect, z).data(), 1));
+}
+}
+
+TEST(TestGUIQuadBatcher, SameStateIsOneBatch)
+{
+  CGUIQuadBatcher batcher;
+  for (int i = 0; i < 10; i++)
+    AddQuad(batcher, MakeState(1), CRect(0, i * 10.0f, 100, i * 10.0f + 20));
+
+  ASSERT_EQ(1u, batcher.GetBatches().size());
+  EXPECT_EQ(10u, batcher.GetBatches()[0].quads);
+  EXPECT_EQ(CRect(0, 0, 100, 110), batcher.GetBatches()[0].bounds);
+}
+
+TEST(TestGUIQuadBatcher, DisjointQuadsJoinEarlierBatches)
+{
+  // a list: background, icon and label per item, none of the items overlap
+  CGUIQuadBatcher batcher;
+  for (int i = 0; i < 10; i++)
+  {
+    const float y = i * 50.0f;
+    AddQuad(batcher, MakeState(1), CRect(0, y, 500, y + 50));
+    AddQuad(batcher, MakeState(2), CRect(0, y, 50, y + 50));
+    AddQuad(batcher, MakeState(3, 2), CRect(60, y + 10, 400, y + 40));
+  }
+
+  ASSERT_EQ(3u, batcher.GetBatches().size());
+  for (const auto& batch : batcher.GetBatches())
+    EXPECT_EQ(10u, batch.quads);
+}
+
+TEST(TestGUIQuadBatcher, OverlapKeepsOrder)
+{
+  CGUIQuadBatcher batcher;
+  AddQuad(batcher, MakeState(1), CRect(0, 0, 100, 100));
+  AddQuad(batcher, MakeState(2), CRect(50, 50, 150, 150));
+  // on top of the second quad, can't be drawn with the first one
+  AddQuad(batcher, MakeState(1), CRect(100, 100, 200, 200));
+  // touches the second quad only at the edge
+  AddQuad(batcher, MakeState(2), CRect(150, 0, 250, 50));
+
+  const auto& batches = batcher.GetBatches();
+  ASSERT_EQ(3u, batches.size());
+  EXPECT_EQ(1u, batches[0].state.texture);
+  EXPECT_EQ(1u, batches[0].quads);
+  EXPECT_EQ(2u, batches[1].state.texture);
+  EXPECT_EQ(2u, batches[1].quads);
+  EXPECT_EQ(1u, batches[2].state.texture);
+  EXPECT_EQ(1u, batches[2].quads);
+}
+
+TEST(TestGUIQuadBatcher, StateDifferences)
+{
+  CGUIQuadBatcher batcher;
+  CGUIQuadBatcher::State state = MakeState(1);
+  AddQuad(batcher, state, CRect(0, 0, 10, 10));
+
+  state.scissors = CRect(0, 0, 960, 540);
+  AddQuad(batcher, state, CRect(20, 0, 30, 10));
+  state = MakeState(1);
+  state.color = 0x80ffffff;
+  AddQuad(batcher, state, CRect(40, 0, 50, 10));
+  state = MakeState(1);
+  state.diffuse = 5;
+  AddQuad(batcher, state, CRect(60, 0, 70, 10));
+  state = MakeState(1);
+  state.blend = false;
+  AddQuad(batcher, state, CRect(80, 0, 90, 10));
+
+  EXPECT_EQ(5u, batcher.GetBatches().size());
+}
+
+TEST(TestGUIQuadBatcher, AngledQuadsAreNotReordered)
+{
+  CGUIQuadBatcher batcher;
+  AddQuad(batcher, MakeState(1), CRect(0, 0, 10, 10));
+  AddQuad(batcher, MakeState(2), CRect(500, 500, 510, 510), 5.0f);
+  AddQuad(batcher, MakeState(1), CRect(20, 0, 30, 10));
+
+  EXPECT_EQ(3u, batcher.GetBatches().size());
+}
+
+TEST(TestGUIQuadBatcher, IndicesByBatch)
+{
+  CGUIQuadBatcher batcher;
+  AddQuad(batcher, MakeState(1), CRect(0, 0, 10, 10));
+  AddQuad(batcher, MakeState(2), CRect(20, 0, 30, 10));
+  AddQuad(batcher, MakeState(1), CRect(40, 0, 50, 10));
+
+  const std::vector<uint16_t>& indices = batcher.BuildIndices();
+  const auto& batches = batcher.GetBatches();
+  ASSERT_EQ(2u, batches.size());
+  EXPECT_EQ(0u, batches[0].firstIndex);
+  EXPECT_EQ(12u, batches[1].firstIndex);
+
+  const std::vector<uint16_t> expected = {0, 1, 2, 2, 3, 0,
+                                          8, 9, 10, 10, 11, 8,
+                                          4, 5, 6, 6, 7, 4};
+  EXPECT_EQ(expected, indices);
+}
+
+TEST(TestGUIQuadBatcher, Full)
+{
+  CGUIQuadBatcher batcher;
+  std::vector<CGUIQuadBatcher::Vertex> vertices;
+  for (unsigned int i = 0; i < CGUIQuadBatcher::MAX_QUADS; i++)
+  {
+    auto quad = MakeQuad(CRect(0, 0, 10, 10));
+    vertices.insert(vertices.end(), quad.begin(), quad.end());
+  }
+  EXPECT_TRUE(batcher.AddQuads(MakeState(1), vertices.data(), CGUIQuadBatcher::MAX_QUADS));
+  EXPECT_FALSE(batcher.AddQuads(MakeState(1), vertices.data(), 1));
+
+  batcher.Clear();
+  EXPECT_TRUE(batcher.IsEmpty());
+  EXPECT_TRUE(batcher.AddQuads(MakeState(1), vertices.data(), 1));
+}
+
+TEST(TestGUIQuadBatcher, DrawCalls)
+{
+  // a home screen like frame: a background, a fixed list of 12 items with a shared background,
+  // an icon from one of 4 textures and a label each, and a few labels in the same font on top
+  CGUIQuadBatcher batcher;
+  unsigned int quads = 0;
+  auto add = [&batcher, &quads](const CGUIQuadBatcher::State& state, const CRect& rect) {
+    AddQuad(batcher, state, rect);
+    quads++;
+  };
+
+  add(MakeState(1), CRect(0, 0, 1920, 1080));
+  for (int i = 0; i < 12; i++)
+  {
+    const float y = 100 + i * 70.0f;
+    add(MakeState(2), CRect(100, y, 700, y + 70));
+    add(MakeState(10 + i % 4), CRect(110, y + 5, 170, y + 65));
+    add(MakeState(3, 2), CRect(180, y + 20, 600, y + 50));
+  }
+  for (int i = 0; i < 4; i++)
+    add(MakeState(3, 2), CRect(800, 100 + i * 40.0f, 1800, 130 + i * 40.0f));
+
+  std::cout << "quads: " << quads << ", draw calls: " << batcher.GetBatches().size() << "\n";
+  EXPECT_EQ(7u, batcher.GetBatches().size());
+}
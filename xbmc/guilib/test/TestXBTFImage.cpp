@@ -0,0 +1,157 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "guilib/FFmpegImage.h"
+#include "guilib/TextureFormats.h"
+#include "guilib/XBTFImage.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// a poster sized image with gradients and some noise, roughly as compressible as artwork
+std::vector<unsigned char> CreatePixels(unsigned int width, unsigned int height, unsigned int pitch, bool alpha)
+{
+  std::vector<unsigned char> pixels(pitch * height);
+  unsigned int seed = 1;
+  for (unsigned int y = 0; y < height; y++)
+  {
+    for (unsigned int x = 0; x < width; x++)
+    {
+      seed = seed * 1103515245 + 12345;
+      const unsigned int noise = (seed >> 16) & 7;
+      unsigned char* pixel = &pixels[y * pitch + x * 4];
+      pixel[0] = static_cast<unsigned char>(x * 255 / width + noise);
+      pixel[1] = static_cast<unsigned char>(y * 255 / height + noise);
+      pixel[2] = static_cast<unsigned char>((x + y) * 127 / (width + height) + (x / 64 % 2) * 64);
+      pixel[3] = alpha ? static_cast<unsigned char>(y * 255 / height) : 0xff;
+    }
+  }
+  return pixels;
+}
+
+std::vector<unsigned char> Encode(IImage& image, const std::vector<unsigned char>& pixels, unsigned int width, unsigned int height, unsigned int pitch, const std::string& file)
+{
+  unsigned char* buffer = nullptr;
+  unsigned int size = 0;
+  if (!image.CreateThumbnailFromSurface(const_cast<unsigned char*>(pixels.data()), width, height, XB_FMT_A8R8G8B8, pitch, file, buffer, size))
+    return std::vector<unsigned char>();
+  std::vector<unsigned char> result(buffer, buffer + size);
+  image.ReleaseThumbnailBuffer();
+  return result;
+}
+
+// decodes the image into a texture the way CBaseTexture::LoadIImage does, returns the time per decode
+template<class Image, class... Args>
+double DecodeTime(std::vector<unsigned char>& file, unsigned int width, unsigned int height, int runs, Args... args)
+{
+  const unsigned int pitch = ((width + 15) / 16) * 16 * 4;
+  std::vector<unsigned char> pixels(pitch * height);
+  const auto start = std::chrono::steady_clock::now();
+  for (int run = 0; run < runs; run++)
+  {
+    Image image(args...);
+    if (!image.LoadImageFromMemory(file.data(), file.size(), width, height) ||
+        !image.Decode(pixels.data(), width, height, pitch, XB_FMT_A8R8G8B8))
+      return -1.0;
+  }
+  const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+  return duration.count() / runs;
+}
+}
+
+TEST(TestXBTFImage, RoundTrip)
+{
+  for (bool alpha : {false, true})
+  {
+    // a width that doesn't fill the pitch, as for cached images scaled down
+    const unsigned int width = 333, height = 500, pitch = 336 * 4;
+    const std::vector<unsigned char> pixels = CreatePixels(width, height, pitch, alpha);
+
+    CXBTFImage encoder;
+    std::vector<unsigned char> file = Encode(encoder, pixels, width, height, pitch, "special://thumbnails/0/01234567.xbt");
+    ASSERT_FALSE(file.empty());
+    EXPECT_LT(file.size(), pixels.size());
+
+    for (unsigned int texturePitch : {width * 4, pitch, 512u * 4})
+    {
+      CXBTFImage image;
+      ASSERT_TRUE(image.LoadImageFromMemory(file.data(), file.size(), 0, 0));
+      EXPECT_EQ(width, image.Width());
+      EXPECT_EQ(height, image.Height());
+      EXPECT_EQ(alpha, image.hasAlpha());
+
+      std::vector<unsigned char> texture(texturePitch * height);
+      ASSERT_TRUE(image.Decode(texture.data(), width, height, texturePitch, XB_FMT_A8R8G8B8));
+      for (unsigned int y = 0; y < height; y++)
+        ASSERT_EQ(0, memcmp(&pixels[y * pitch], &texture[y * texturePitch], width * 4)) << "row " << y;
+    }
+  }
+}
+
+TEST(TestXBTFImage, DamagedFiles)
+{
+  // a plain image, so that it's packed
+  const unsigned int width = 64, height = 64;
+  const std::vector<unsigned char> pixels(width * height * 4, 0x80);
+  CXBTFImage encoder;
+  std::vector<unsigned char> file = Encode(encoder, pixels, width, height, width * 4, "test.xbt");
+  ASSERT_FALSE(file.empty());
+  ASSERT_LT(file.size(), pixels.size());
+
+  for (size_t size : {size_t(0), size_t(5), size_t(100), file.size() - 1})
+  {
+    CXBTFImage image;
+    EXPECT_FALSE(image.LoadImageFromMemory(file.data(), size, 0, 0)) << "size " << size;
+  }
+
+  // packed data that doesn't unpack
+  std::vector<unsigned char> damaged(file);
+  for (size_t i = damaged.size() - 64; i < damaged.size(); i++)
+    damaged[i] = 0xff;
+  CXBTFImage image;
+  std::vector<unsigned char> texture(pixels.size());
+  EXPECT_FALSE(image.LoadImageFromMemory(damaged.data(), damaged.size(), 0, 0) &&
+               image.Decode(texture.data(), width, height, width * 4, XB_FMT_A8R8G8B8));
+}
+
+TEST(TestXBTFImage, DecodeTime)
+{
+  // a poster at the default image resolution of the texture cache
+  const unsigned int width = 480, height = 720, pitch = width * 4;
+  const int runs = 20;
+  const std::vector<unsigned char> pixels = CreatePixels(width, height, pitch, false);
+
+  CFFmpegImage jpegEncoder("image/jpeg");
+  std::vector<unsigned char> jpeg = Encode(jpegEncoder, pixels, width, height, pitch, "poster.jpg");
+  CFFmpegImage pngEncoder("image/png");
+  std::vector<unsigned char> png = Encode(pngEncoder, pixels, width, height, pitch, "poster.png");
+  CXBTFImage xbtEncoder;
+  std::vector<unsigned char> xbt = Encode(xbtEncoder, pixels, width, height, pitch, "poster.xbt");
+  ASSERT_FALSE(jpeg.empty());
+  ASSERT_FALSE(png.empty());
+  ASSERT_FALSE(xbt.empty());
+
+  const double jpegTime = DecodeTime<CFFmpegImage>(jpeg, width, height, runs, "image/jpeg");
+  const double pngTime = DecodeTime<CFFmpegImage>(png, width, height, runs, "image/png");
+  const double xbtTime = DecodeTime<CXBTFImage>(xbt, width, height, runs);
+  EXPECT_GE(jpegTime, 0.0);
+  EXPECT_GE(pngTime, 0.0);
+  EXPECT_GE(xbtTime, 0.0);
+
+  std::cout << width << "x" << height << " image decode: jpg " << jpegTime << " ms (" << jpeg.size() / 1024
+            << " kB), png " << pngTime << " ms (" << png.size() / 1024 << " kB), xbt " << xbtTime << " ms ("
+            << xbt.size() / 1024 << " kB)\n";
+}
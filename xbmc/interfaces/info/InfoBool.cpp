@@ -12,13 +12,22 @@
 
 namespace INFO
 {
-  InfoBool::InfoBool(const std::string &expression, int context, unsigned int &refreshCounter)
+  InfoRefresh::InfoRefresh()
+    : m_evaluations(0)
+  {
+    for (auto& counter : m_counters)
+      counter = 0;
+  }
+
+  InfoBool::InfoBool(const std::string &expression, int context, InfoRefresh &refresh)
     : m_value(false),
       m_context(context),
       m_listItemDependent(false),
       m_expression(expression),
+      m_dependencies(1 << INFO_SOURCE_FRAME),
+      m_evaluated(false),
       m_refreshCounter(0),
-      m_parentRefreshCounter(refreshCounter)
+      m_refresh(refresh)
   {
     StringUtils::ToLower(m_expression);
   }
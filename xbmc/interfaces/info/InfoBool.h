@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <string>
 
@@ -15,6 +16,59 @@ class CGUIListItem;
 
 namespace INFO
 {
+/*!
+ \ingroup info
+ \brief Sources of information conditions depend on
+
+ Conditions that only depend on sources announcing their changes are evaluated again after one of
+ them changed, all other conditions once per frame.
+ */
+enum InfoSource
+{
+  INFO_SOURCE_FRAME = 0,         ///< anything that changes without notice
+  INFO_SOURCE_SKIN_SETTINGS,     ///< Skin.HasSetting(), Skin.String()
+  INFO_SOURCE_WINDOW_PROPERTIES, ///< Window(id).Property()
+  INFO_SOURCE_COUNT
+};
+
+/*!
+ \ingroup info
+ \brief Change counters of the info sources, shared by the info bools of the info manager
+ */
+class InfoRefresh
+{
+public:
+  InfoRefresh();
+
+  /*! \brief Mark the conditions depending on a source as dirty
+   */
+  void Changed(InfoSource source) { ++m_counters[source]; }
+
+  /*! \brief Get a counter that changes whenever one of the given sources changes
+   \param dependencies the sources as flags, 1 << InfoSource
+   */
+  unsigned int GetCounter(unsigned int dependencies) const
+  {
+    unsigned int counter = 0;
+    for (int source = 0; dependencies; source++, dependencies >>= 1)
+    {
+      if (dependencies & 1)
+        counter += m_counters[source];
+    }
+    return counter;
+  }
+
+  void CountEvaluation() { m_evaluations.fetch_add(1, std::memory_order_relaxed); }
+
+  /*! \brief Get the number of conditions evaluated since the last call
+   */
+  unsigned int ResetEvaluations() { return m_evaluations.exchange(0); }
+
+private:
+  std::atomic<unsigned int> m_counters[INFO_SOURCE_COUNT];
+  std::atomic<unsigned int> m_evaluations;
+};
+
 /*!
  \ingroup info
  \brief Base class, wrapping boolean conditions and expressions
@@ -22,7 +76,7 @@ namespace INFO
 class InfoBool
 {
 public:
-  InfoBool(const std::string &expression, int context, unsigned int &refreshCounter);
+  InfoBool(const std::string &expression, int context, InfoRefresh &refresh);
   virtual ~InfoBool() = default;
 
   virtual void Initialize() {};
@@ -34,11 +88,16 @@ public:
   inline bool Get(const CGUIListItem *item = NULL)
   {
     if (item && m_listItemDependent)
-      Update(item);
-    else if (m_refreshCounter != m_parentRefreshCounter || m_refreshCounter == 0)
+      Evaluate(item);
+    else
     {
-      Update(NULL);
-      m_refreshCounter = m_parentRefreshCounter;
+      const unsigned int refreshCounter = m_refresh.GetCounter(m_dependencies);
+      if (!m_evaluated || m_refreshCounter != refreshCounter)
+      {
+        Evaluate(NULL);
+        m_refreshCounter = refreshCounter;
+        m_evaluated = true;
+      }
     }
     return m_value;
   }
@@ -66,16 +125,25 @@ public:
 
   const std::string &GetExpression() const { return m_expression; }
   bool ListItemDependent() const { return m_listItemDependent; }
+  unsigned int GetDependencies() const { return m_dependencies; }
 protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
   bool m_listItemDependent;    ///< do not cache if a listitem pointer is given
   std::string  m_expression;   ///< original expression
+  unsigned int m_dependencies; ///< sources the value depends on as flags, 1 << InfoSource
 
 private:
+  void Evaluate(const CGUIListItem *item)
+  {
+    m_refresh.CountEvaluation();
+    Update(item);
+  }
+
+  bool m_evaluated;
   unsigned int m_refreshCounter;
-  unsigned int &m_parentRefreshCounter;
+  InfoRefresh &m_refresh;
 };
 
 typedef std::shared_ptr<InfoBool> InfoPtr;
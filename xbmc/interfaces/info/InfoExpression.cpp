@@ -21,7 +21,9 @@ using namespace INFO;
 
 void InfoSingle::Initialize()
 {
-  m_condition = CServiceBroker::GetGUI()->GetInfoManager().TranslateSingleString(m_expression, m_listItemDependent);
+  CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
+  m_condition = infoMgr.TranslateSingleString(m_expression, m_listItemDependent);
+  m_dependencies = m_listItemDependent ? 1 << INFO_SOURCE_FRAME : infoMgr.GetBoolDependencies(m_condition);
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
@@ -35,6 +37,7 @@ void InfoExpression::Initialize()
   {
     CLog::Log(LOGERROR, "Error parsing boolean expression %s", m_expression.c_str());
     m_expression_tree = std::make_shared<InfoLeaf>(CServiceBroker::GetGUI()->GetInfoManager().Register("false", 0), false);
+    m_dependencies = 0;
   }
 }
 
@@ -210,6 +213,9 @@ bool InfoExpression::Parse(const std::string &expression)
 
   CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
 
+  // the expression depends on what its operands depend on
+  m_dependencies = 0;
+
   char c;
   // Skip leading whitespace - don't want it to count as an operand if that's all there is
   while (isspace((unsigned char)(c=*s)))
@@ -244,6 +250,7 @@ bool InfoExpression::Parse(const std::string &expression)
         }
         /* Propagate any listItem dependency from the operand to the expression */
         m_listItemDependent |= info->ListItemDependent();
+        m_dependencies |= info->GetDependencies();
         nodes.push(std::make_shared<InfoLeaf>(info, invert));
         /* Reuse operand string for next operand */
         operand.clear();
@@ -295,6 +302,7 @@ bool InfoExpression::Parse(const std::string &expression)
     }
     /* Propagate any listItem dependency from the operand to the expression */
     m_listItemDependent |= info->ListItemDependent();
+    m_dependencies |= info->GetDependencies();
     nodes.push(std::make_shared<InfoLeaf>(info, invert));
   }
   while (!operator_stack.empty())
@@ -23,8 +23,8 @@ namespace INFO
 class InfoSingle : public InfoBool
 {
 public:
-  InfoSingle(const std::string &expression, int context, unsigned int &refreshCounter)
-    : InfoBool(expression, context, refreshCounter) {};
+  InfoSingle(const std::string &expression, int context, InfoRefresh &refresh)
+    : InfoBool(expression, context, refresh) {};
   void Initialize() override;
 
   void Update(const CGUIListItem *item) override;
@@ -37,8 +37,8 @@ private:
 class InfoExpression : public InfoBool
 {
 public:
-  InfoExpression(const std::string &expression, int context, unsigned int &refreshCounter)
-    : InfoBool(expression, context, refreshCounter) {};
+  InfoExpression(const std::string &expression, int context, InfoRefresh &refresh)
+    : InfoBool(expression, context, refresh) {};
   ~InfoExpression() override = default;
 
   void Initialize() override;
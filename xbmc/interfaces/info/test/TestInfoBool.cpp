@@ -0,0 +1,143 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "interfaces/info/InfoBool.h"
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace INFO;
+
+namespace
+{
+class CTestInfoBool : public InfoBool
+{
+public:
+  CTestInfoBool(InfoRefresh& refresh, unsigned int dependencies)
+    : InfoBool("test", 0, refresh)
+  {
+    m_dependencies = dependencies;
+  }
+
+  void Update(const CGUIListItem* item) override
+  {
+    m_updates++;
+    m_value = !m_value;
+  }
+
+  unsigned int m_updates = 0;
+};
+}
+
+TEST(TestInfoBool, FrameConditions)
+{
+  InfoRefresh refresh;
+  CTestInfoBool condition(refresh, 1 << INFO_SOURCE_FRAME);
+
+  // the value is cached within a frame
+  EXPECT_TRUE(condition.Get());
+  EXPECT_TRUE(condition.Get());
+  EXPECT_EQ(1u, condition.m_updates);
+
+  refresh.Changed(INFO_SOURCE_FRAME);
+  EXPECT_FALSE(condition.Get());
+  EXPECT_EQ(2u, condition.m_updates);
+
+  // other sources changing don't matter, the condition is evaluated every frame anyway
+  refresh.Changed(INFO_SOURCE_SKIN_SETTINGS);
+  EXPECT_FALSE(condition.Get());
+  EXPECT_EQ(2u, condition.m_updates);
+}
+
+TEST(TestInfoBool, SkinSettingConditions)
+{
+  InfoRefresh refresh;
+  CTestInfoBool condition(refresh, 1 << INFO_SOURCE_SKIN_SETTINGS);
+
+  EXPECT_TRUE(condition.Get());
+  for (int frame = 0; frame < 10; frame++)
+  {
+    refresh.Changed(INFO_SOURCE_FRAME);
+    refresh.Changed(INFO_SOURCE_WINDOW_PROPERTIES);
+    EXPECT_TRUE(condition.Get());
+  }
+  EXPECT_EQ(1u, condition.m_updates);
+
+  refresh.Changed(INFO_SOURCE_SKIN_SETTINGS);
+  EXPECT_FALSE(condition.Get());
+  EXPECT_EQ(2u, condition.m_updates);
+}
+
+TEST(TestInfoBool, ConstantConditions)
+{
+  InfoRefresh refresh;
+  CTestInfoBool condition(refresh, 0);
+
+  for (int frame = 0; frame < 10; frame++)
+  {
+    refresh.Changed(INFO_SOURCE_FRAME);
+    refresh.Changed(INFO_SOURCE_SKIN_SETTINGS);
+    EXPECT_TRUE(condition.Get());
+  }
+  EXPECT_EQ(1u, condition.m_updates);
+}
+
+TEST(TestInfoBool, CombinedConditions)
+{
+  InfoRefresh refresh;
+  CTestInfoBool condition(refresh, 1 << INFO_SOURCE_SKIN_SETTINGS | 1 << INFO_SOURCE_WINDOW_PROPERTIES);
+
+  condition.Get();
+  refresh.Changed(INFO_SOURCE_FRAME);
+  condition.Get();
+  EXPECT_EQ(1u, condition.m_updates);
+
+  refresh.Changed(INFO_SOURCE_WINDOW_PROPERTIES);
+  condition.Get();
+  EXPECT_EQ(2u, condition.m_updates);
+
+  refresh.Changed(INFO_SOURCE_SKIN_SETTINGS);
+  condition.Get();
+  EXPECT_EQ(3u, condition.m_updates);
+}
+
+TEST(TestInfoBool, EvaluationsPerFrame)
+{
+  // a skin's conditions are mostly visibility conditions on skin settings and window properties
+  const int frames = 1000;
+  const int frameConditions = 200;
+  const int skinConditions = 800;
+
+  InfoRefresh refresh;
+  std::vector<std::unique_ptr<CTestInfoBool>> conditions;
+  for (int i = 0; i < frameConditions; i++)
+    conditions.emplace_back(new CTestInfoBool(refresh, 1 << INFO_SOURCE_FRAME));
+  for (int i = 0; i < skinConditions; i++)
+    conditions.emplace_back(new CTestInfoBool(refresh, 1 << INFO_SOURCE_SKIN_SETTINGS));
+
+  unsigned int evaluations = 0;
+  for (int frame = 0; frame < frames; frame++)
+  {
+    // a skin setting is toggled every 100 frames
+    if (frame % 100 == 99)
+      refresh.Changed(INFO_SOURCE_SKIN_SETTINGS);
+
+    for (const auto& condition : conditions)
+      condition->Get();
+
+    refresh.Changed(INFO_SOURCE_FRAME);
+    evaluations += refresh.ResetEvaluations();
+  }
+
+  EXPECT_EQ(static_cast<unsigned int>(frames * frameConditions + 11 * skinConditions), evaluations);
+  std::cout << "conditions: " << frameConditions + skinConditions << ", evaluations per frame: "
+            << evaluations / frames << " (" << frameConditions + skinConditions << " without dependencies)\n";
+}
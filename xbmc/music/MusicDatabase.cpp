@@ -174,6 +174,9 @@ void CMusicDatabase::CreateTables()
   CLog::Log(LOGINFO, "create path table");
   m_pDS->exec("CREATE TABLE path (idPath integer primary key, strPath varchar(512), strHash text)");
 
+  CLog::Log(LOGINFO, "create dirtypath table");
+  m_pDS->exec("CREATE TABLE dirtypath (idDirtyPath INTEGER PRIMARY KEY, strPath varchar(512), scanRecursive INTEGER)");
+
   CLog::Log(LOGINFO, "create source table");
   m_pDS->exec("CREATE TABLE source (idSource INTEGER PRIMARY KEY, strName TEXT, strMultipath TEXT)");
 
@@ -1668,10 +1671,9 @@ bool CMusicDatabase::AddSongArtist(int idArtist, int idSong, const std::string&
 
 bool CMusicDatabase::AddSongArtist(int idArtist, int idSong, int idRole, const std::string& strArtist, int iOrder)
 {
-  std::string strSQL;
-  strSQL = PrepareSQL("replace into song_artist (idArtist, idSong, idRole, strArtist, iOrder) values(%i,%i,%i,'%s',%i)",
-    idArtist, idSong, idRole, strArtist.c_str(), iOrder);
-  return ExecuteQuery(strSQL);
+  return ExecuteStatement("replace into song_artist (idArtist, idSong, idRole, strArtist, iOrder) values(?,?,?,?,?)",
+    { dbiplus::field_value(idArtist), dbiplus::field_value(idSong), dbiplus::field_value(idRole),
+      dbiplus::field_value(strArtist), dbiplus::field_value(iOrder) });
 }
 
 int CMusicDatabase::AddSongContributor(int idSong, const std::string& strRole, const std::string& strArtist, const std::string &strSort)
@@ -1809,10 +1811,9 @@ bool CMusicDatabase::DeleteSongArtistsBySong(int idSong)
 
 bool CMusicDatabase::AddAlbumArtist(int idArtist, int idAlbum, std::string strArtist, int iOrder)
 {
-  std::string strSQL;
-  strSQL = PrepareSQL("replace into album_artist (idArtist, idAlbum, strArtist, iOrder) values(%i,%i,'%s',%i)",
-    idArtist, idAlbum, strArtist.c_str(), iOrder);
-  return ExecuteQuery(strSQL);
+  return ExecuteStatement("replace into album_artist (idArtist, idAlbum, strArtist, iOrder) values(?,?,?,?)",
+    { dbiplus::field_value(idArtist), dbiplus::field_value(idAlbum), dbiplus::field_value(strArtist),
+      dbiplus::field_value(iOrder) });
 }
 
 bool CMusicDatabase::DeleteAlbumArtistsByAlbum(int idAlbum)
@@ -1837,9 +1838,8 @@ bool CMusicDatabase::AddSongGenres(int idSong, const std::vector<std::string>& g
     for (auto &strGenre : modgenres)
     {
       int idGenre = AddGenre(strGenre); // Genre string trimed and matched case insensitively
-      strSQL = PrepareSQL("INSERT INTO song_genre (idGenre, idSong, iOrder) VALUES(%i,%i,%i)",
-        idGenre, idSong, index++);
-      if (!ExecuteQuery(strSQL))
+      if (!ExecuteStatement("INSERT INTO song_genre (idGenre, idSong, iOrder) VALUES(?,?,?)",
+        { dbiplus::field_value(idGenre), dbiplus::field_value(idSong), dbiplus::field_value(index++) }))
         return false;
     }
     // Update concatenated genre string from the standardised genre values
@@ -7772,6 +7772,11 @@ void CMusicDatabase::UpdateTables(int version)
     // add strDiscSubtitles to song table
     m_pDS->exec("ALTER TABLE song ADD strDiscSubtitle TEXT \n");
   }
+  if (version < 74)
+  {
+    // Create dirtypath table, directories changed on disk since the last scan
+    m_pDS->exec("CREATE TABLE dirtypath (idDirtyPath INTEGER PRIMARY KEY, strPath varchar(512), scanRecursive INTEGER)");
+  }
 
   // Set the verion of tag scanning required.
   // Not every schema change requires the tags to be rescanned, set to the highest schema version
@@ -7793,7 +7798,7 @@ void CMusicDatabase::UpdateTables(int version)
 
 int CMusicDatabase::GetSchemaVersion() const
 {
-  return 73;
+  return 74;
 }
 
 int CMusicDatabase::GetMusicNeedsTagScan()
@@ -9663,7 +9668,11 @@ int CMusicDatabase::GetSongIDFromPath(const std::string &filePath)
 bool CMusicDatabase::CommitTransaction()
 {
   if (CDatabase::CommitTransaction())
-  { // number of items in the db has likely changed, so reset the infomanager cache
+  {
+    if (InBulkInsert())
+      return true; // reset once the bulk insert is committed
+
+    // number of items in the db has likely changed, so reset the infomanager cache
     CGUIComponent* gui = CServiceBroker::GetGUI();
     if (gui)
     {
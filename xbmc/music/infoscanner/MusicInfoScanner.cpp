@@ -11,6 +11,7 @@
 #include "FileItem.h"
 #include "GUIInfoManager.h"
 #include "GUIUserMessages.h"
+#include "LibraryMonitor.h"
 #include "MusicAlbumInfo.h"
 #include "MusicInfoScraper.h"
 #include "NfoFile.h"
@@ -40,7 +41,6 @@
 #include "music/MusicThumbLoader.h"
 #include "music/MusicUtils.h"
 #include "music/tags/MusicInfoTag.h"
-#include "music/tags/MusicInfoTagLoaderFactory.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
@@ -62,6 +62,9 @@ using namespace MUSIC_GRABBER;
 using namespace ADDON;
 using KODI::UTILITY::CDigest;
 
+// folders whose tags may be read ahead of the folder that is added to the library
+static const size_t MAX_TAG_SCAN_FOLDERS = 8;
+
 CMusicInfoScanner::CMusicInfoScanner()
 : m_fileCountReader(this, "MusicFileCounter")
 {
@@ -116,6 +119,9 @@ void CMusicInfoScanner::Process()
       if (m_handle)
         m_fileCountReader.Create();
 
+      const unsigned int tagReaders = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_iMusicLibraryTagReaders;
+      m_tagReader.reset(new CMusicTagReader(tagReaders));
+
       // Database operations should not be canceled
       // using Interrupt() while scanning as it could
       // result in unexpected behaviour.
@@ -142,6 +148,8 @@ void CMusicInfoScanner::Process()
         // Clear list of albums added by this scan
         m_albumsAdded.clear();
         bool scancomplete = DoScan(it);
+        // add the folders still waiting for their tags, or discard them if the scan was cancelled
+        scancomplete = AddScannedFolders(0) && scancomplete;
         if (scancomplete)
         {
           if (m_albumsAdded.size() > 0)
@@ -165,6 +173,9 @@ void CMusicInfoScanner::Process()
 
       if (commit)
       {
+        if (m_dirtyPathId >= 0)
+          m_musicDatabase.ClearDirtyPaths(m_dirtyPathId);
+
         CServiceBroker::GetGUI()->GetInfoManager().GetInfoProviders().GetLibraryInfoProvider().ResetLibraryBools();
 
         if (m_needsCleanup)
@@ -186,6 +197,11 @@ void CMusicInfoScanner::Process()
 
       m_fileCountReader.StopThread();
 
+      if (m_tagReader->GetFilesRead() > 0)
+        CLog::Log(LOGNOTICE, "My Music: Read tags from %u files using %u threads, %.1f files/s",
+                  m_tagReader->GetFilesRead(), tagReaders, m_tagReader->GetFilesPerSecond());
+      m_tagReader.reset();
+
       m_musicDatabase.EmptyCache();
 
       tick = XbmcThreads::SystemClockMillis() - tick;
@@ -287,6 +303,7 @@ void CMusicInfoScanner::Start(const std::string& strDirectory, int flags)
   m_seenPaths.clear();
   m_albumsAdded.clear();
   m_flags = flags;
+  m_dirtyPathId = -1;
 
   m_musicDatabase.Open();
   // Check db sources match xml file and update if they don't
@@ -296,6 +313,8 @@ void CMusicInfoScanner::Start(const std::string& strDirectory, int flags)
   { // Scan all paths in the database.  We do this by scanning all paths in the
     // db, and crossing them off the list as we go.
     m_musicDatabase.GetPaths(m_pathsToScan);
+    // paths in sources watched for changes only need to be scanned if something changed
+    m_dirtyPathId = CLibraryMonitor::GetInstance().GetPathsToScan("music", m_musicDatabase, m_pathsToScan);
     m_idSourcePath = -1;
   }
   else
@@ -499,22 +518,13 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
     else
       CLog::Log(LOGDEBUG, "%s Rescanning dir '%s' due to change", __FUNCTION__, CURL::GetRedacted(strDirectory).c_str());
 
-    if (m_handle)
-      m_handle->SetTitle(g_localizeStrings.Get(505)); //"Loading media information from files..."
-
     // filter items in the sub dir (for .cue sheet support)
     items.FilterCueItems();
     items.Sort(SortByLabel, SortOrderAscending);
 
-    // and then scan in the new information from tags
-    if (RetrieveMusicInfo(strDirectory, items) > 0)
-    {
-      if (m_handle)
-        OnDirectoryScanned(strDirectory);
-    }
-
-    // save information about this folder
-    m_musicDatabase.SetPathHash(strDirectory, hash);
+    // and then scan in the new information from tags, the folder is added to the library
+    // once they have been read
+    QueueTagScan(strDirectory, items, hash);
   }
   else
   { // path is the same - no need to rescan
@@ -550,16 +560,17 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
   return !m_bStop;
 }
 
-CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
-                                                   CFileItemList& scannedItems)
+void CMusicInfoScanner::QueueTagScan(const std::string& strDirectory,
+                                     const CFileItemList& items,
+                                     const std::string& hash)
 {
   std::vector<std::string> regexps = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_audioExcludeFromScanRegExps;
 
+  TagScanFolder folder;
+  folder.path = strDirectory;
+  folder.hash = hash;
   for (int i = 0; i < items.Size(); ++i)
   {
-    if (m_bStop)
-      return INFO_CANCELLED;
-
     CFileItemPtr pItem = items[i];
 
     if (CUtil::ExcludeFileOrFolder(pItem->GetPath(), regexps))
@@ -568,19 +579,86 @@ CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
     if (pItem->m_bIsFolder || pItem->IsPlayList() || pItem->IsPicture() || pItem->IsLyrics())
       continue;
 
-    m_currentItem++;
+    folder.files.push_back(pItem);
+  }
+  folder.batch = m_tagReader->Queue(folder.files);
+  m_tagScanFolders.push_back(std::move(folder));
 
-    CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
-    if (!tag.Loaded())
+  // add what has been read so far, and don't let reading get too far ahead of the library
+  AddScannedFolders(MAX_TAG_SCAN_FOLDERS);
+}
+
+bool CMusicInfoScanner::AddScannedFolders(size_t maxQueued)
+{
+  bool bulkInsert = false;
+  while (!m_tagScanFolders.empty() && !m_bStop)
+  {
+    const TagScanFolder& folder = m_tagScanFolders.front();
+    if (!m_tagReader->Wait(folder.batch, 0))
     {
-      std::unique_ptr<IMusicInfoTagLoader> pLoader (CMusicInfoTagLoaderFactory::CreateLoader(*pItem));
-      if (nullptr != pLoader)
-        pLoader->Load(pItem->GetPath(), tag);
+      if (m_tagScanFolders.size() <= maxQueued)
+        break;
+
+      // don't keep the database locked while waiting for the tags
+      if (bulkInsert)
+      {
+        m_musicDatabase.CommitBulkInsert();
+        bulkInsert = false;
+      }
+
+      while (!m_bStop && !m_tagReader->Wait(folder.batch, 500))
+      {
+        if (m_handle)
+          m_handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(508), m_tagReader->GetFilesPerSecond()));
+      }
+      if (m_bStop)
+        break;
+    }
+
+    // folders that are ready are added in a single transaction
+    if (!bulkInsert)
+      bulkInsert = m_musicDatabase.BeginBulkInsert();
+
+    if (RetrieveMusicInfo(folder) > 0)
+    {
+      if (m_handle)
+        OnDirectoryScanned(folder.path);
     }
 
+    // save information about this folder
+    m_musicDatabase.SetPathHash(folder.path, folder.hash);
+    m_tagScanFolders.pop_front();
+
+    if (m_handle)
+      m_handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(508), m_tagReader->GetFilesPerSecond()));
+  }
+
+  if (bulkInsert)
+    m_musicDatabase.CommitBulkInsert();
+
+  if (m_bStop)
+  {
+    m_tagReader->Cancel();
+    m_tagScanFolders.clear();
+    return false;
+  }
+  return true;
+}
+
+CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const std::vector<CFileItemPtr>& items,
+                                                   CFileItemList& scannedItems)
+{
+  for (const auto& pItem : items)
+  {
+    if (m_bStop)
+      return INFO_CANCELLED;
+
+    m_currentItem++;
+
     if (m_handle && m_itemCount>0)
       m_handle->SetPercentage(static_cast<float>(m_currentItem * 100) / static_cast<float>(m_itemCount));
 
+    const CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
     if (!tag.Loaded() && !pItem->HasCueDocument())
     {
       CLog::Log(LOGDEBUG, "%s - No tag found for: %s", __FUNCTION__, pItem->GetPath().c_str());
@@ -874,8 +952,9 @@ CMusicInfoScanner::UpdateArtistInfo(CArtist& artist,
   return result;
 }
 
-int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileItemList& items)
+int CMusicInfoScanner::RetrieveMusicInfo(const TagScanFolder& folder)
 {
+  const std::string& strDirectory = folder.path;
   MAPSONGS songsMap;
 
   // get all information for all files in current directory from database, and remove them
@@ -883,7 +962,7 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
     m_needsCleanup = true;
 
   CFileItemList scannedItems;
-  if (ScanTags(items, scannedItems) == INFO_CANCELLED || scannedItems.Size() == 0)
+  if (ScanTags(folder.files, scannedItems) == INFO_CANCELLED || scannedItems.Size() == 0)
     return 0;
 
   VECALBUMS albums;
@@ -906,7 +985,7 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
   that album is processed, and needs to be corrected later once all the parts
   of the album have been scanned.
   */
-  FindArtForAlbums(albums, items.GetPath());
+  FindArtForAlbums(albums, strDirectory);
 
   /* Strategy: Having scanned tags and made a list of albums, add them to the library. Only then try
   to scrape additional album and artist information. Music is often tagged to a mixed standard
@@ -922,7 +1001,8 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
 
   int numAdded = 0;
 
-  // Add all albums to the library, and hence any new song or album artists or other contributors
+  // Add all albums to the library, and hence any new song or album artists or other contributors.
+  // This is part of the bulk insert started by AddScannedFolders() rather than one transaction per album.
   for (auto& album : albums)
   {
     if (m_bStop)
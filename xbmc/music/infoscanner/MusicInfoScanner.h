@@ -11,10 +11,14 @@
 #include "InfoScanner.h"
 #include "MusicAlbumInfo.h"
 #include "MusicInfoScraper.h"
+#include "MusicTagReader.h"
 #include "music/MusicDatabase.h"
 #include "threads/IRunnable.h"
 #include "threads/Thread.h"
 
+#include <deque>
+#include <memory>
+
 class CAlbum;
 class CArtist;
 class CGUIDialogProgressBarHandle;
@@ -187,27 +191,53 @@ protected:
   */
   void SetDiscSetArtwork(CAlbum& album, const std::vector<std::pair<std::string, int>>& paths);
 
-  /*! \brief Scan in the ID3/Ogg/FLAC tags for a bunch of FileItems
-   Given a list of FileItems, scan in the tags for those FileItems
-   and populate a new FileItemList with the files that were successfully scanned.
-   Add album to library, populate a list of album ids added for possible scraping later.
-   Any files which couldn't be scanned (no/bad tags) are discarded in the process.
-   \param items [in] list of FileItems to scan
-   \param scannedItems [in] list to populate with the scannedItems
+  /*! \brief A folder whose tags are read by m_tagReader before it's added to the library
+   */
+  struct TagScanFolder
+  {
+    std::string path;
+    std::string hash;
+    std::vector<CFileItemPtr> files;
+    int batch;
+  };
+
+  /*! \brief Start reading the tags of the files in a folder
+   The folder is added to the library by AddScannedFolders() once all its tags have been read,
+   in the meantime the scan continues with the following folders.
+   \param strDirectory [in] path of the folder
+   \param items [in] list of FileItems in the folder
+   \param hash [in] hash of the folder to store once it has been added
+   */
+  void QueueTagScan(const std::string& strDirectory, const CFileItemList& items, const std::string& hash);
+
+  /*! \brief Add the folders whose tags have been read to the library
+   Ready folders are added in a single transaction. Waits for tags to be read only while more than
+   maxQueued folders are queued, committing before it does.
+   \param maxQueued [in] number of folders that may be left in the queue, 0 to add all
+   \return false if the scan was cancelled
+   */
+  bool AddScannedFolders(size_t maxQueued);
+
+  /*! \brief Add the songs of a folder to the library
+   Given a folder whose tags have been read, populate a FileItemList with the files that were
+   successfully scanned. Add album to library, populate a list of album ids added for possible
+   scraping later. Any files which couldn't be scanned (no/bad tags) are discarded in the process.
+   \param folder [in] the folder to add
+   \return number of songs added
    */
-  int RetrieveMusicInfo(const std::string& strDirectory, CFileItemList& items);
+  int RetrieveMusicInfo(const TagScanFolder& folder);
 
   void RetrieveLocalArt();
   void ScrapeInfoAddedAlbums();
 
-  /*! \brief Scan in the ID3/Ogg/FLAC tags for a bunch of FileItems
-    Given a list of FileItems, scan in the tags for those FileItems
-   and populate a new FileItemList with the files that were successfully scanned.
+  /*! \brief Collect the ID3/Ogg/FLAC tags read for a bunch of FileItems
+   Given a list of FileItems whose tags have been read, populate a new FileItemList with the
+   files that were successfully scanned.
    Any files which couldn't be scanned (no/bad tags) are discarded in the process.
-   \param items [in] list of FileItems to scan
+   \param items [in] list of FileItems that were scanned
    \param scannedItems [in] list to populate with the scannedItems
    */
-  INFO_RET ScanTags(const CFileItemList& items, CFileItemList& scannedItems);
+  INFO_RET ScanTags(const std::vector<CFileItemPtr>& items, CFileItemList& scannedItems);
   int GetPathHash(const CFileItemList &items, std::string &hash);
   void GetAlbumArtwork(long id, const CAlbum &artist);
 
@@ -239,5 +269,7 @@ protected:
   std::set<std::string> m_seenPaths;
   int m_flags;
   CThread m_fileCountReader;
+  std::unique_ptr<CMusicTagReader> m_tagReader;
+  std::deque<TagScanFolder> m_tagScanFolders;
 };
 }
@@ -0,0 +1,139 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "MusicTagReader.h"
+
+#include "FileItem.h"
+#include "music/tags/MusicInfoTag.h"
+#include "music/tags/MusicInfoTagLoaderFactory.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+
+#include <algorithm>
+
+using namespace MUSIC_INFO;
+
+CMusicTagReader::CMusicTagReader(unsigned int threads)
+  : m_maxThreads(std::max(threads, 1u))
+{
+}
+
+CMusicTagReader::~CMusicTagReader()
+{
+  {
+    CSingleLock lock(m_critSection);
+    m_bStop = true;
+    m_queue.clear();
+    m_queued.notifyAll();
+  }
+
+  for (auto& thread : m_threads)
+    thread->StopThread(true);
+}
+
+int CMusicTagReader::Queue(const std::vector<CFileItemPtr>& items)
+{
+  CSingleLock lock(m_critSection);
+  const int batch = m_nextBatch++;
+  if (items.empty())
+    return batch;
+
+  if (m_threads.empty())
+  {
+    m_startTime = XbmcThreads::SystemClockMillis();
+    for (unsigned int i = 0; i < m_maxThreads; i++)
+    {
+      m_threads.emplace_back(new CThread(this, "MusicTagReader"));
+      m_threads.back()->Create();
+    }
+  }
+
+  for (const auto& item : items)
+    m_queue.emplace_back(batch, item);
+  m_pending[batch] = items.size();
+  m_queued.notifyAll();
+
+  return batch;
+}
+
+bool CMusicTagReader::Wait(int batch, unsigned int milliseconds)
+{
+  const XbmcThreads::EndTime timeout(milliseconds);
+
+  CSingleLock lock(m_critSection);
+  while (batch > m_cancelledBatch && m_pending.find(batch) != m_pending.end())
+  {
+    if (timeout.IsTimePast())
+      return false;
+    m_read.wait(lock, timeout.MillisLeft());
+  }
+  return batch > m_cancelledBatch;
+}
+
+void CMusicTagReader::Cancel()
+{
+  CSingleLock lock(m_critSection);
+  m_cancelledBatch = m_nextBatch - 1;
+  m_queue.clear();
+  m_pending.clear();
+  m_read.notifyAll();
+}
+
+unsigned int CMusicTagReader::GetFilesRead() const
+{
+  CSingleLock lock(m_critSection);
+  return m_filesRead;
+}
+
+float CMusicTagReader::GetFilesPerSecond() const
+{
+  CSingleLock lock(m_critSection);
+  if (m_threads.empty())
+    return 0.0f;
+
+  const unsigned int elapsed = XbmcThreads::SystemClockMillis() - m_startTime;
+  return m_filesRead * 1000.0f / std::max(elapsed, 1u);
+}
+
+void CMusicTagReader::Run()
+{
+  CSingleLock lock(m_critSection);
+  while (!m_bStop)
+  {
+    if (m_queue.empty())
+    {
+      m_queued.wait(lock);
+      continue;
+    }
+
+    const int batch = m_queue.front().first;
+    CFileItemPtr item = m_queue.front().second;
+    m_queue.pop_front();
+
+    {
+      CSingleExit exit(m_critSection);
+
+      CMusicInfoTag& tag = *item->GetMusicInfoTag();
+      if (!tag.Loaded())
+      {
+        std::unique_ptr<IMusicInfoTagLoader> pLoader(CMusicInfoTagLoaderFactory::CreateLoader(*item));
+        if (nullptr != pLoader)
+          pLoader->Load(item->GetPath(), tag);
+      }
+    }
+
+    m_filesRead++;
+
+    auto pending = m_pending.find(batch);
+    if (pending != m_pending.end() && --pending->second == 0)
+    {
+      m_pending.erase(pending);
+      m_read.notifyAll();
+    }
+  }
+}
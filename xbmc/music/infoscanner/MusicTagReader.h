@@ -0,0 +1,92 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/IRunnable.h"
+#include "threads/Thread.h"
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class CFileItem;
+typedef std::shared_ptr<CFileItem> CFileItemPtr;
+
+namespace MUSIC_INFO
+{
+/*!
+ \brief Reads the tags of music files on a pool of threads.
+
+ Tag reading is bound by the latency of the file system on network shares, so reading several
+ files at once and ahead of the files being added to the library keeps the scanner busy. Files
+ are read in the order they were queued and grouped into batches, the scanner waits for a whole
+ batch (e.g. a folder) to be read.
+ */
+class CMusicTagReader : public IRunnable
+{
+public:
+  explicit CMusicTagReader(unsigned int threads);
+  ~CMusicTagReader() override;
+
+  /*!
+   \brief Queue a batch of files to read the tags of.
+   \param items the files, their music info tags are loaded unless loaded already.
+   \return the id of the batch to pass to Wait()
+   */
+  int Queue(const std::vector<CFileItemPtr>& items);
+
+  /*!
+   \brief Wait for all files of a batch to be read.
+   \param batch the id returned by Queue()
+   \param milliseconds how long to wait at most, 0 to only check
+   \return true if the batch has been read, false if the time ran out or reading was cancelled
+   */
+  bool Wait(int batch, unsigned int milliseconds);
+
+  /*!
+   \brief Discard all queued files. Files being read when this is called are finished in the
+   background, Wait() returns false for every batch queued so far.
+   */
+  void Cancel();
+
+  /*!
+   \brief The number of files read since the reader was created.
+   */
+  unsigned int GetFilesRead() const;
+
+  /*!
+   \brief The number of files read per second since the first batch was queued.
+   */
+  float GetFilesPerSecond() const;
+
+protected:
+  void Run() override;
+
+private:
+  CMusicTagReader(const CMusicTagReader&) = delete;
+  CMusicTagReader& operator=(const CMusicTagReader&) = delete;
+
+  mutable CCriticalSection m_critSection;
+  XbmcThreads::ConditionVariable m_queued;
+  XbmcThreads::ConditionVariable m_read;
+  std::deque<std::pair<int, CFileItemPtr>> m_queue;
+  std::map<int, unsigned int> m_pending; ///< files not read yet by batch
+  std::vector<std::unique_ptr<CThread>> m_threads;
+  unsigned int m_maxThreads;
+  int m_nextBatch = 0;
+  int m_cancelledBatch = -1; ///< batches up to this one were cancelled
+  bool m_bStop = false;
+  unsigned int m_filesRead = 0;
+  unsigned int m_startTime = 0;
+};
+}
@@ -40,6 +40,7 @@ using namespace XFILE;
 #define TEST_FILES_DATA_RANGES  "range1;range2;range3"
 #define TEST_FILES_HTML         TEST_FILES_DATA ".html"
 #define TEST_FILES_RANGES       TEST_FILES_DATA "-ranges.txt"
+#define TEST_FILES_BINARY       TEST_FILES_DATA ".png"
 
 class TestWebServer : public testing::Test
 {
@@ -145,6 +146,31 @@ protected:
     return lastModified.IsValid();
   }
 
+  std::string GetContentOfTestFile(const std::string& testFile)
+  {
+    CFile file;
+    XUTILS::auto_buffer content;
+    if (file.LoadFile(URIUtils::AddFileToFolder(sourcePath, testFile), content) <= 0)
+      return "";
+
+    return std::string(content.get(), content.size());
+  }
+
+  std::string ReadFromCurlFile(CCurlFile& curl, size_t size)
+  {
+    std::string result(size, '\0');
+    size_t total = 0;
+    while (total < size)
+    {
+      ssize_t read = curl.Read(&result[total], size - total);
+      if (read <= 0)
+        break;
+      total += read;
+    }
+    result.resize(total);
+    return result;
+  }
+
   void CheckHtmlTestFileResponse(const CCurlFile& curl)
   {
     // get the HTTP header details
@@ -897,3 +923,43 @@ TEST_F(TestWebServer, CanGetCachedRangedFileWithNewerIfRange)
   ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
   CheckRangesTestFileResponse(curl, result, ranges);
 }
+
+TEST_F(TestWebServer, CanReadFileWithParallelRanges)
+{
+  const std::string content = GetContentOfTestFile(TEST_FILES_BINARY);
+  ASSERT_FALSE(content.empty());
+
+  // use segments much smaller than the file to keep several requests busy
+  CCurlFile curl;
+  curl.SetRangeReads(3, 64);
+  ASSERT_TRUE(curl.Open(CURL(GetUrlOfTestFile(TEST_FILES_BINARY))));
+  ASSERT_EQ(static_cast<int64_t>(content.size()), curl.GetLength());
+
+  EXPECT_EQ(content, ReadFromCurlFile(curl, content.size() + 1));
+  EXPECT_EQ(static_cast<int64_t>(content.size()), curl.GetPosition());
+  curl.Close();
+}
+
+TEST_F(TestWebServer, CanSeekFileWithParallelRanges)
+{
+  const std::string content = GetContentOfTestFile(TEST_FILES_BINARY);
+  ASSERT_GT(content.size(), 400u);
+
+  CCurlFile curl;
+  curl.SetRangeReads(3, 64);
+  ASSERT_TRUE(curl.Open(CURL(GetUrlOfTestFile(TEST_FILES_BINARY))));
+  EXPECT_EQ(content.substr(0, 10), ReadFromCurlFile(curl, 10));
+
+  // within the ranges already requested
+  ASSERT_EQ(100, curl.Seek(100, SEEK_SET));
+  EXPECT_EQ(content.substr(100, 50), ReadFromCurlFile(curl, 50));
+
+  // beyond them
+  ASSERT_EQ(400, curl.Seek(400, SEEK_SET));
+  EXPECT_EQ(content.substr(400, 100), ReadFromCurlFile(curl, 100));
+
+  // back to data that was already consumed
+  ASSERT_EQ(20, curl.Seek(20, SEEK_SET));
+  EXPECT_EQ(content.substr(20), ReadFromCurlFile(curl, content.size()));
+  curl.Close();
+}
@@ -834,6 +834,7 @@ void CSlideShowPic::Render(float *x, float *y, CBaseTexture* pTexture, UTILS::Co
 
 #elif defined(HAS_GL)
   CRenderSystemGL *renderSystem = dynamic_cast<CRenderSystemGL*>(CServiceBroker::GetRenderSystem());
+  renderSystem->FlushBatches();
   if (pTexture)
   {
     pTexture->LoadToGPU();
@@ -133,6 +133,21 @@ CCPUInfoFreebsd::CCPUInfoFreebsd()
 
     if (ecx & CPUID_00000001_ECX_SSE42)
       m_cpuFeatures |= CPU_FEATURE_SSE42;
+
+    // AVX2 is only usable if the OS saves the YMM registers as well
+    if ((ecx & CPUID_00000001_ECX_OSXSAVE) && (ecx & CPUID_00000001_ECX_AVX) &&
+        __get_cpuid_max(0, nullptr) >= CPUID_INFOTYPE_EXTENDED_FEATURES)
+    {
+      uint32_t xcr0;
+      uint32_t xcr0High;
+      __asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0High) : "c"(0));
+      if ((xcr0 & 6) == 6)
+      {
+        __cpuid_count(CPUID_INFOTYPE_EXTENDED_FEATURES, 0, eax, ebx, ecx, edx);
+        if (ebx & CPUID_00000007_EBX_AVX2)
+          m_cpuFeatures |= CPU_FEATURE_AVX2;
+      }
+    }
   }
 
   if (__get_cpuid(CPUID_INFOTYPE_EXTENDED_IMPLEMENTED, &eax, &eax, &ecx, &edx))
@@ -159,6 +159,21 @@ CCPUInfoLinux::CCPUInfoLinux()
 
     if (ecx & CPUID_00000001_ECX_SSE42)
       m_cpuFeatures |= CPU_FEATURE_SSE42;
+
+    // AVX2 is only usable if the OS saves the YMM registers as well
+    if ((ecx & CPUID_00000001_ECX_OSXSAVE) && (ecx & CPUID_00000001_ECX_AVX) &&
+        __get_cpuid_max(0, nullptr) >= CPUID_INFOTYPE_EXTENDED_FEATURES)
+    {
+      unsigned int xcr0;
+      unsigned int xcr0High;
+      __asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0High) : "c"(0));
+      if ((xcr0 & 6) == 6)
+      {
+        __cpuid_count(CPUID_INFOTYPE_EXTENDED_FEATURES, 0, eax, ebx, ecx, edx);
+        if (ebx & CPUID_00000007_EBX_AVX2)
+          m_cpuFeatures |= CPU_FEATURE_AVX2;
+      }
+    }
   }
 
   if (__get_cpuid(CPUID_INFOTYPE_EXTENDED_IMPLEMENTED, &eax, &eax, &ecx, &edx))
@@ -214,6 +229,9 @@ CCPUInfoLinux::CCPUInfoLinux()
 #if defined(HAS_NEON) && defined(__arm__)
   if (getauxval(AT_HWCAP) & HWCAP_NEON)
     m_cpuFeatures |= CPU_FEATURE_NEON;
+#elif defined(__aarch64__)
+  if (getauxval(AT_HWCAP) & HWCAP_ASIMD)
+    m_cpuFeatures |= CPU_FEATURE_NEON;
 #endif
 
   // Set MMX2 when SSE is present as SSE is a superset of MMX2 and Intel doesn't set the MMX2 cap
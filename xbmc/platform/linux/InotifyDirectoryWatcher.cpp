@@ -0,0 +1,360 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "InotifyDirectoryWatcher.h"
+
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#include <cstring>
+#include <errno.h>
+#include <stack>
+
+#include <dirent.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+const uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVED_FROM |
+                            IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR |
+                            IN_DONT_FOLLOW;
+
+// changes are reported once a tree has been quiet for this long
+const unsigned int NOTIFY_DELAY_MS = 1000;
+// but not later than this after the first change
+const unsigned int NOTIFY_MAX_DELAY_MS = 10000;
+
+const size_t EVENT_BUFFER_SIZE = 64 * 1024;
+}
+
+CInotifyDirectoryWatcher::CInotifyDirectoryWatcher(XFILE::IDirectoryWatcherCallback& callback) :
+  CThread("InotifyDirectoryWatcher"),
+  m_callback(callback)
+{
+}
+
+CInotifyDirectoryWatcher::~CInotifyDirectoryWatcher()
+{
+  if (m_wakeupfd >= 0)
+  {
+    /* sets m_bStop */
+    StopThread(false);
+
+    /* wake up the poll() call */
+    eventfd_write(m_wakeupfd, 1);
+
+    StopThread(true);
+    close(m_wakeupfd);
+  }
+
+  if (m_fd >= 0)
+    close(m_fd);
+}
+
+void CInotifyDirectoryWatcher::AddWatch(const std::string& root)
+{
+  std::string path(root);
+  URIUtils::AddSlashAtEnd(path);
+
+  CSingleLock lock(m_critSection);
+  m_requests.emplace_back(path, true);
+  Start();
+}
+
+void CInotifyDirectoryWatcher::RemoveWatch(const std::string& root)
+{
+  std::string path(root);
+  URIUtils::AddSlashAtEnd(path);
+
+  CSingleLock lock(m_critSection);
+  m_requests.emplace_back(path, false);
+  Start();
+}
+
+void CInotifyDirectoryWatcher::RemoveAllWatches()
+{
+  CSingleLock lock(m_critSection);
+  m_requests.emplace_back("", false);
+  Start();
+}
+
+void CInotifyDirectoryWatcher::Start()
+{
+  if (m_wakeupfd >= 0)
+  {
+    eventfd_write(m_wakeupfd, 1);
+    return;
+  }
+
+  m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_fd < 0)
+  {
+    CLog::Log(LOGERROR, "CInotifyDirectoryWatcher::Start - inotify_init1() failed, error %d", errno);
+    return;
+  }
+
+  m_wakeupfd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (m_wakeupfd < 0)
+  {
+    CLog::Log(LOGERROR, "CInotifyDirectoryWatcher::Start - Failed to create eventfd, error %d", errno);
+    close(m_fd);
+    m_fd = -1;
+    return;
+  }
+
+  Create(false);
+}
+
+void CInotifyDirectoryWatcher::Process()
+{
+  std::vector<char> buffer(EVENT_BUFFER_SIZE);
+
+  while (!m_bStop)
+  {
+    ProcessRequests();
+
+    struct pollfd pollDescs[2] = { { m_fd, POLLIN, 0 }, { m_wakeupfd, POLLIN, 0 } };
+    int err = poll(pollDescs, 2, m_changed.empty() ? -1 : static_cast<int>(NOTIFY_DELAY_MS));
+    if (err < 0 && errno != EINTR)
+    {
+      CLog::Log(LOGERROR, "CInotifyDirectoryWatcher::Process - poll() failed, error %d, stopping", errno);
+      break;
+    }
+
+    if (pollDescs[1].revents & POLLIN)
+    {
+      eventfd_t dummy;
+      eventfd_read(m_wakeupfd, &dummy);
+    }
+
+    if (pollDescs[0].revents & POLLIN)
+    {
+      ssize_t length;
+      while ((length = read(m_fd, buffer.data(), buffer.size())) > 0)
+      {
+        for (ssize_t i = 0; i < length;)
+        {
+          const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(&buffer[i]);
+          HandleEvent(event);
+          i += sizeof(struct inotify_event) + event->len;
+        }
+      }
+    }
+
+    const unsigned int now = XbmcThreads::SystemClockMillis();
+    if (!m_changed.empty() &&
+        (now - m_lastChange >= NOTIFY_DELAY_MS || now - m_firstChange >= NOTIFY_MAX_DELAY_MS))
+      NotifyChanges();
+  }
+
+  if (!m_changed.empty())
+    NotifyChanges();
+}
+
+void CInotifyDirectoryWatcher::ProcessRequests()
+{
+  std::vector<std::pair<std::string, bool>> requests;
+  {
+    CSingleLock lock(m_critSection);
+    requests.swap(m_requests);
+  }
+
+  for (const auto& request : requests)
+  {
+    if (!request.second && request.first.empty())
+    {
+      while (!m_roots.empty())
+        RemoveRoot(*m_roots.begin());
+    }
+    else if (!request.second)
+      RemoveRoot(request.first);
+    else if (m_roots.find(request.first) == m_roots.end() && AddRoot(request.first))
+      m_callback.OnWatchAdded(request.first);
+  }
+}
+
+void CInotifyDirectoryWatcher::HandleEvent(const struct inotify_event* event)
+{
+  if (event->mask & IN_Q_OVERFLOW)
+  {
+    CLog::Log(LOGWARNING, "CInotifyDirectoryWatcher: event queue overflowed, changes were lost");
+    for (const auto& root : m_roots)
+      m_callback.OnWatchLost(root, false);
+    return;
+  }
+
+  auto watch = m_watches.find(event->wd);
+  if (watch == m_watches.end())
+    return;
+
+  if (event->mask & IN_IGNORED)
+  {
+    // the directory was deleted or its file system unmounted
+    m_directories.erase(watch->second);
+    m_watches.erase(watch);
+    return;
+  }
+
+  const std::string directory = watch->second;
+  if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF))
+  {
+    // subdirectories are handled through the events of their parent
+    if (m_roots.find(directory) != m_roots.end())
+    {
+      CLog::Log(LOGDEBUG, "CInotifyDirectoryWatcher: %s was removed", directory.c_str());
+      RemoveRoot(directory);
+      m_callback.OnWatchLost(directory, true);
+    }
+    return;
+  }
+
+  const unsigned int now = XbmcThreads::SystemClockMillis();
+  if (m_changed.empty())
+    m_firstChange = now;
+  m_lastChange = now;
+
+  if (event->len > 0 && (event->mask & IN_ISDIR))
+  {
+    const std::string path = directory + event->name + "/";
+    if (event->mask & (IN_CREATE | IN_MOVED_TO))
+    {
+      if (!AddTree(path))
+      {
+        const std::string root = GetRoot(directory);
+        RemoveRoot(root);
+        m_callback.OnWatchLost(root, true);
+        return;
+      }
+      // files may have been created before the watch was in place
+      m_changed.insert(path);
+    }
+    else if (event->mask & IN_MOVED_FROM)
+      RemoveTree(path);
+  }
+
+  m_changed.insert(directory);
+}
+
+bool CInotifyDirectoryWatcher::AddRoot(const std::string& root)
+{
+  m_roots.insert(root);
+  if (!AddTree(root))
+  {
+    RemoveRoot(root);
+    m_callback.OnWatchLost(root, true);
+    return false;
+  }
+
+  CLog::Log(LOGDEBUG, "CInotifyDirectoryWatcher: watching %s, %zu directories watched in total",
+            root.c_str(), m_directories.size());
+  return true;
+}
+
+void CInotifyDirectoryWatcher::RemoveRoot(const std::string& root)
+{
+  if (m_roots.erase(root) == 0)
+    return;
+
+  // keep the directories of roots nested in this one
+  auto it = m_directories.lower_bound(root);
+  while (it != m_directories.end() && StringUtils::StartsWith(it->first, root))
+  {
+    if (GetRoot(it->first).empty())
+    {
+      inotify_rm_watch(m_fd, it->second);
+      m_watches.erase(it->second);
+      it = m_directories.erase(it);
+    }
+    else
+      ++it;
+  }
+}
+
+bool CInotifyDirectoryWatcher::AddTree(const std::string& directory)
+{
+  std::stack<std::string> directories;
+  directories.push(directory);
+  while (!directories.empty())
+  {
+    const std::string path = directories.top();
+    directories.pop();
+
+    int wd = inotify_add_watch(m_fd, path.c_str(), WATCH_MASK);
+    if (wd < 0)
+    {
+      if (errno == ENOSPC || errno == ENOMEM)
+      {
+        CLog::Log(LOGWARNING, "CInotifyDirectoryWatcher: unable to watch %s, the watch limit "
+                  "(fs.inotify.max_user_watches) has been reached", path.c_str());
+        return false;
+      }
+      // gone already or not accessible
+      continue;
+    }
+    m_watches[wd] = path;
+    m_directories[path] = wd;
+
+    DIR* dir = opendir(path.c_str());
+    if (!dir)
+      continue;
+
+    while (struct dirent* entry = readdir(dir))
+    {
+      if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+        continue;
+
+      const std::string subdirectory = path + entry->d_name + "/";
+      bool isDirectory = entry->d_type == DT_DIR;
+      if (entry->d_type == DT_UNKNOWN)
+      {
+        struct stat st;
+        isDirectory = lstat(subdirectory.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+      }
+      if (isDirectory)
+        directories.push(subdirectory);
+    }
+    closedir(dir);
+  }
+  return true;
+}
+
+void CInotifyDirectoryWatcher::RemoveTree(const std::string& directory)
+{
+  auto it = m_directories.lower_bound(directory);
+  while (it != m_directories.end() && StringUtils::StartsWith(it->first, directory))
+  {
+    inotify_rm_watch(m_fd, it->second);
+    m_watches.erase(it->second);
+    it = m_directories.erase(it);
+  }
+}
+
+std::string CInotifyDirectoryWatcher::GetRoot(const std::string& directory) const
+{
+  std::string root;
+  for (const auto& it : m_roots)
+  {
+    if (it.size() > root.size() && StringUtils::StartsWith(directory, it))
+      root = it;
+  }
+  return root;
+}
+
+void CInotifyDirectoryWatcher::NotifyChanges()
+{
+  std::set<std::string> changed;
+  changed.swap(m_changed);
+  m_callback.OnDirectoriesChanged(changed);
+}
@@ -0,0 +1,69 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "filesystem/IDirectoryWatcher.h"
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct inotify_event;
+
+/**
+ * Watch directory trees with inotify(7).
+ *
+ * inotify isn't recursive, so every directory below a root gets its own watch. Watches are added
+ * and events are read on a single thread, changes are reported in batches once a tree has been
+ * quiet for a short while.
+ */
+class CInotifyDirectoryWatcher : public XFILE::IDirectoryWatcher, private CThread
+{
+public:
+  explicit CInotifyDirectoryWatcher(XFILE::IDirectoryWatcherCallback& callback);
+  ~CInotifyDirectoryWatcher() override;
+
+  void AddWatch(const std::string& root) override;
+  void RemoveWatch(const std::string& root) override;
+  void RemoveAllWatches() override;
+
+protected:
+  void Process() override;
+
+private:
+  void Start();
+  void ProcessRequests();
+  void HandleEvent(const struct inotify_event* event);
+
+  bool AddRoot(const std::string& root);
+  void RemoveRoot(const std::string& root);
+  bool AddTree(const std::string& directory);
+  void RemoveTree(const std::string& directory);
+  std::string GetRoot(const std::string& directory) const;
+  void NotifyChanges();
+
+  XFILE::IDirectoryWatcherCallback& m_callback;
+  int m_fd = -1;
+  int m_wakeupfd = -1;
+
+  CCriticalSection m_critSection;
+  std::vector<std::pair<std::string, bool>> m_requests; ///< roots to add (true) or remove (false)
+
+  // only accessed by the watcher thread
+  std::set<std::string> m_roots;
+  std::map<int, std::string> m_watches;
+  std::map<std::string, int> m_directories;
+  std::set<std::string> m_changed;
+  unsigned int m_firstChange = 0;
+  unsigned int m_lastChange = 0;
+};
@@ -0,0 +1,187 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "platform/linux/InotifyDirectoryWatcher.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+
+#include <cstdlib>
+#include <fstream>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const unsigned int TIMEOUT_MS = 15000;
+
+class CTestCallback : public XFILE::IDirectoryWatcherCallback
+{
+public:
+  void OnWatchAdded(const std::string& root) override
+  {
+    CSingleLock lock(m_critSection);
+    m_added.insert(root);
+    m_event.Set();
+  }
+
+  void OnWatchLost(const std::string& root, bool removed) override
+  {
+    CSingleLock lock(m_critSection);
+    m_lost.insert(root);
+    m_event.Set();
+  }
+
+  void OnDirectoriesChanged(const std::set<std::string>& directories) override
+  {
+    CSingleLock lock(m_critSection);
+    m_changed.insert(directories.begin(), directories.end());
+    m_event.Set();
+  }
+
+  bool WaitForAdded(const std::string& root) { return WaitFor(m_added, root); }
+  bool WaitForLost(const std::string& root) { return WaitFor(m_lost, root); }
+  bool WaitForChanged(const std::string& directory) { return WaitFor(m_changed, directory); }
+
+  bool HasChanged(const std::string& directory)
+  {
+    CSingleLock lock(m_critSection);
+    return m_changed.find(directory) != m_changed.end();
+  }
+
+  void Reset()
+  {
+    CSingleLock lock(m_critSection);
+    m_changed.clear();
+  }
+
+private:
+  bool WaitFor(const std::set<std::string>& set, const std::string& entry)
+  {
+    for (;;)
+    {
+      {
+        CSingleLock lock(m_critSection);
+        if (set.find(entry) != set.end())
+          return true;
+      }
+      if (!m_event.WaitMSec(TIMEOUT_MS))
+        return false;
+    }
+  }
+
+  CCriticalSection m_critSection;
+  CEvent m_event;
+  std::set<std::string> m_added;
+  std::set<std::string> m_lost;
+  std::set<std::string> m_changed;
+};
+}
+
+class TestInotifyDirectoryWatcher : public ::testing::Test
+{
+protected:
+  TestInotifyDirectoryWatcher()
+  {
+    char path[] = "/tmp/kodi-test-XXXXXX";
+    if (mkdtemp(path))
+      m_root = std::string(path) + "/";
+  }
+
+  ~TestInotifyDirectoryWatcher() override
+  {
+    if (!m_root.empty())
+      system(("rm -rf '" + m_root + "'").c_str());
+  }
+
+  void WriteFile(const std::string& path)
+  {
+    std::ofstream file(path);
+    file << "kodi";
+  }
+
+  std::string m_root;
+};
+
+TEST_F(TestInotifyDirectoryWatcher, ReportsChanges)
+{
+  ASSERT_FALSE(m_root.empty());
+  ASSERT_EQ(0, mkdir((m_root + "existing").c_str(), 0700));
+
+  CTestCallback callback;
+  CInotifyDirectoryWatcher watcher(callback);
+  watcher.AddWatch(m_root);
+  ASSERT_TRUE(callback.WaitForAdded(m_root));
+
+  WriteFile(m_root + "existing/file");
+  EXPECT_TRUE(callback.WaitForChanged(m_root + "existing/"));
+
+  callback.Reset();
+  ASSERT_EQ(0, unlink((m_root + "existing/file").c_str()));
+  EXPECT_TRUE(callback.WaitForChanged(m_root + "existing/"));
+
+  // new directories are watched as well
+  callback.Reset();
+  ASSERT_EQ(0, mkdir((m_root + "new").c_str(), 0700));
+  EXPECT_TRUE(callback.WaitForChanged(m_root));
+  callback.Reset();
+  WriteFile(m_root + "new/file");
+  EXPECT_TRUE(callback.WaitForChanged(m_root + "new/"));
+
+  // as are directories moved into the tree
+  char other[] = "/tmp/kodi-test-XXXXXX";
+  ASSERT_NE(nullptr, mkdtemp(other));
+  callback.Reset();
+  ASSERT_EQ(0, rename(other, (m_root + "moved").c_str()));
+  EXPECT_TRUE(callback.WaitForChanged(m_root));
+  callback.Reset();
+  WriteFile(m_root + "moved/file");
+  EXPECT_TRUE(callback.WaitForChanged(m_root + "moved/"));
+}
+
+TEST_F(TestInotifyDirectoryWatcher, RemovedRootIsLost)
+{
+  ASSERT_FALSE(m_root.empty());
+  const std::string root = m_root + "root/";
+  ASSERT_EQ(0, mkdir(root.c_str(), 0700));
+
+  CTestCallback callback;
+  CInotifyDirectoryWatcher watcher(callback);
+  watcher.AddWatch(root);
+  ASSERT_TRUE(callback.WaitForAdded(root));
+
+  ASSERT_EQ(0, rmdir(root.c_str()));
+  EXPECT_TRUE(callback.WaitForLost(root));
+}
+
+TEST_F(TestInotifyDirectoryWatcher, RemoveWatch)
+{
+  ASSERT_FALSE(m_root.empty());
+  const std::string root = m_root + "root/";
+  const std::string other = m_root + "other/";
+  ASSERT_EQ(0, mkdir(root.c_str(), 0700));
+  ASSERT_EQ(0, mkdir(other.c_str(), 0700));
+
+  CTestCallback callback;
+  CInotifyDirectoryWatcher watcher(callback);
+  watcher.AddWatch(root);
+  ASSERT_TRUE(callback.WaitForAdded(root));
+
+  // requests are handled in order, so once the other watch is in place the root isn't watched anymore
+  watcher.RemoveWatch(root);
+  watcher.AddWatch(other);
+  ASSERT_TRUE(callback.WaitForAdded(other));
+
+  WriteFile(root + "file");
+  WriteFile(other + "file");
+  EXPECT_TRUE(callback.WaitForChanged(other));
+  EXPECT_FALSE(callback.HasChanged(root));
+}
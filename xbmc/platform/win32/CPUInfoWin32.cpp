@@ -146,6 +146,16 @@ CCPUInfoWin32::CCPUInfoWin32()
       m_cpuFeatures |= CPU_FEATURE_SSE4;
     if (CPUInfo[CPUINFO_ECX] & CPUID_00000001_ECX_SSE42)
       m_cpuFeatures |= CPU_FEATURE_SSE42;
+
+    // AVX2 is only usable if the OS saves the YMM registers as well
+    if ((CPUInfo[CPUINFO_ECX] & CPUID_00000001_ECX_OSXSAVE) &&
+        (CPUInfo[CPUINFO_ECX] & CPUID_00000001_ECX_AVX) &&
+        MaxStdInfoType >= CPUID_INFOTYPE_EXTENDED_FEATURES && (_xgetbv(0) & 6) == 6)
+    {
+      __cpuidex(CPUInfo, CPUID_INFOTYPE_EXTENDED_FEATURES, 0);
+      if (CPUInfo[CPUINFO_EBX] & CPUID_00000007_EBX_AVX2)
+        m_cpuFeatures |= CPU_FEATURE_AVX2;
+    }
   }
 
   __cpuid(CPUInfo, CPUID_INFOTYPE_EXTENDED_IMPLEMENTED);
@@ -33,6 +33,12 @@ void CRenderSystemBase::GetRenderVersion(unsigned int& major, unsigned int& mino
   minor = m_RenderVersionMinor;
 }
 
+void CRenderSystemBase::ResetDrawCalls()
+{
+  m_lastDrawCalls = m_drawCalls;
+  m_drawCalls = 0;
+}
+
 bool CRenderSystemBase::SupportsNPOT(bool dxt) const
 {
   if (dxt)
@@ -66,6 +66,24 @@ public:
 
   virtual std::string GetShaderPath(const std::string &filename) { return ""; }
 
+  /**
+   * Draw everything queued for batched drawing. Has to be called before drawing
+   * without going through the render system.
+   */
+  virtual void FlushBatches() {}
+
+  void AddDrawCalls(unsigned int count) { m_drawCalls += count; }
+
+  /**
+   * Start counting the draw calls of the next frame
+   */
+  void ResetDrawCalls();
+
+  /**
+   * The number of GUI draw calls issued during the last frame
+   */
+  unsigned int GetDrawCalls() const { return m_lastDrawCalls; }
+
   void GetRenderVersion(unsigned int& major, unsigned int& minor) const;
   const std::string& GetRenderVendor() const { return m_RenderVendor; }
   const std::string& GetRenderRenderer() const { return m_RenderRenderer; }
@@ -91,6 +109,8 @@ protected:
   RENDER_STEREO_VIEW m_stereoView = RENDER_STEREO_VIEW_OFF;
   RENDER_STEREO_MODE m_stereoMode = RENDER_STEREO_MODE_OFF;
   bool m_limitedColorRange = false;
+  unsigned int m_drawCalls = 0;
+  unsigned int m_lastDrawCalls = 0;
 
   std::unique_ptr<CGUIImage> m_splashImage;
   std::unique_ptr<CGUITextLayout> m_splashMessageLayout;
@@ -7,11 +7,13 @@
  */
 
 #include "RenderSystemGL.h"
+#include "ServiceBroker.h"
 #include "filesystem/File.h"
 #include "rendering/MatrixGL.h"
 #include "windowing/GraphicContext.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/DisplaySettings.h"
+#include "settings/SettingsComponent.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
 #include "utils/TimeUtils.h"
@@ -22,6 +24,11 @@
 #include "platform/posix/XTimeUtils.h"
 #endif
 
+#include <algorithm>
+#include <cstring>
+
+#define BUFFER_OFFSET(i) ((char *)NULL + (i))
+
 CRenderSystemGL::CRenderSystemGL() : CRenderSystemBase()
 {
 }
@@ -107,6 +114,8 @@ bool CRenderSystemGL::InitRenderSystem()
 
   InitialiseShaders();
 
+  m_batchDraws = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiBatchDraws;
+
   return true;
 }
 
@@ -117,6 +126,8 @@ bool CRenderSystemGL::ResetRenderSystem(int width, int height)
 
   m_width = width;
   m_height = height;
+  m_batcher.Clear();
+  m_cameraValid = false;
 
   if (m_RenderVersionMajor > 3 ||
       (m_RenderVersionMajor == 3 && m_RenderVersionMinor >= 2))
@@ -191,6 +202,19 @@ bool CRenderSystemGL::ResetRenderSystem(int width, int height)
 
 bool CRenderSystemGL::DestroyRenderSystem()
 {
+  m_batcher.Clear();
+  if (m_batchVertexBuffer)
+  {
+    glDeleteBuffers(1, &m_batchVertexBuffer);
+    glDeleteBuffers(1, &m_batchIndexBuffer);
+    m_batchVertexBuffer = m_batchIndexBuffer = 0;
+  }
+  if (m_uploadBuffer)
+  {
+    glDeleteBuffers(1, &m_uploadBuffer);
+    m_uploadBuffer = 0;
+  }
+
   if (m_vertexArray != GL_NONE)
   {
     glDeleteVertexArrays(1, &m_vertexArray);
@@ -224,6 +248,8 @@ bool CRenderSystemGL::EndRender()
   if (!m_bRenderCreated)
     return false;
 
+  FlushBatches();
+
   return true;
 }
 
@@ -236,6 +262,8 @@ bool CRenderSystemGL::ClearBuffers(UTILS::Color color)
   if(m_stereoMode == RENDER_STEREO_MODE_INTERLACED && m_stereoView == RENDER_STEREO_VIEW_RIGHT)
     return true;
 
+  FlushBatches();
+
   float r = GET_R(color) / 255.0f;
   float g = GET_G(color) / 255.0f;
   float b = GET_B(color) / 255.0f;
@@ -284,6 +312,7 @@ void CRenderSystemGL::PresentRender(bool rendered, bool videoLayer)
   if (!m_bRenderCreated)
     return;
 
+  FlushBatches();
   PresentRenderImpl(rendered);
 
   if (!rendered)
@@ -314,6 +343,8 @@ void CRenderSystemGL::CaptureStateBlock()
   if (!m_bRenderCreated)
     return;
 
+  FlushBatches();
+
   glMatrixProject.Push();
   glMatrixModview.Push();
   glMatrixTexture.Push();
@@ -327,6 +358,9 @@ void CRenderSystemGL::ApplyStateBlock()
   if (!m_bRenderCreated)
     return;
 
+  FlushBatches();
+  m_cameraValid = false;
+
   glBindVertexArray(m_vertexArray);
 
   glViewport(m_viewPort[0], m_viewPort[1], m_viewPort[2], m_viewPort[3]);
@@ -345,6 +379,17 @@ void CRenderSystemGL::SetCameraPosition(const CPoint &camera, int screenWidth, i
   if (!m_bRenderCreated)
     return;
 
+  if (m_cameraValid && camera == m_camera && screenWidth == m_cameraScreenWidth &&
+      screenHeight == m_cameraScreenHeight && stereoFactor == m_cameraStereoFactor)
+    return;
+
+  FlushBatches();
+  m_cameraValid = true;
+  m_camera = camera;
+  m_cameraScreenWidth = screenWidth;
+  m_cameraScreenHeight = screenHeight;
+  m_cameraStereoFactor = stereoFactor;
+
   CPoint offset = camera - CPoint(screenWidth*0.5f, screenHeight*0.5f);
 
 
@@ -434,6 +479,10 @@ void CRenderSystemGL::SetViewPort(const CRect& viewPort)
   if (!m_bRenderCreated)
     return;
 
+  FlushBatches();
+  m_cameraValid = false;
+  m_scissors = viewPort;
+
   glScissor((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   glViewport((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   m_viewPort[0] = viewPort.x1;
@@ -444,6 +493,10 @@ void CRenderSystemGL::SetViewPort(const CRect& viewPort)
 
 bool CRenderSystemGL::ScissorsCanEffectClipping()
 {
+  // the fonts would have to change the scissors and the model view matrix for every text
+  if (m_batchDraws)
+    return false;
+
   if (m_pShader[m_method])
     return m_pShader[m_method]->HardwareClipIsPossible();
 
@@ -468,6 +521,14 @@ void CRenderSystemGL::SetScissors(const CRect &rect)
 {
   if (!m_bRenderCreated)
     return;
+
+  // queued quads keep the scissors they were queued with
+  m_scissors = rect;
+  ApplyScissors(rect);
+}
+
+void CRenderSystemGL::ApplyScissors(const CRect &rect)
+{
   GLint x1 = MathUtils::round_int(rect.x1);
   GLint y1 = MathUtils::round_int(rect.y1);
   GLint x2 = MathUtils::round_int(rect.x2);
@@ -537,6 +598,7 @@ static const GLubyte stipple_3d[] = {
 
 void CRenderSystemGL::SetStereoMode(RENDER_STEREO_MODE mode, RENDER_STEREO_VIEW view)
 {
+  FlushBatches();
   CRenderSystemBase::SetStereoMode(mode, view);
 
   glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
@@ -673,6 +735,14 @@ void CRenderSystemGL::InitialiseShaders()
     m_pShader[SM_MULTI_BLENDCOLOR].reset();
     CLog::Log(LOGERROR, "GUI Shader gl_shader_frag_multi_blendcolor.glsl - compile and link failed");
   }
+
+  m_pShader[SM_FONTS_SDF].reset(new CGLShader("gl_shader_frag_fonts_sdf.glsl", defines));
+  if (!m_pShader[SM_FONTS_SDF]->CompileAndLink())
+  {
+    m_pShader[SM_FONTS_SDF]->Free();
+    m_pShader[SM_FONTS_SDF].reset();
+    CLog::Log(LOGERROR, "GUI Shader gl_shader_frag_fonts_sdf.glsl - compile and link failed");
+  }
 }
 
 void CRenderSystemGL::ReleaseShaders()
@@ -704,10 +774,44 @@ void CRenderSystemGL::ReleaseShaders()
   if (m_pShader[SM_MULTI_BLENDCOLOR])
     m_pShader[SM_MULTI_BLENDCOLOR]->Free();
   m_pShader[SM_MULTI_BLENDCOLOR].reset();
+
+  if (m_pShader[SM_FONTS_SDF])
+    m_pShader[SM_FONTS_SDF]->Free();
+  m_pShader[SM_FONTS_SDF].reset();
 }
 
 void CRenderSystemGL::EnableShader(ESHADERMETHOD method)
 {
+  if (!m_batcher.IsEmpty())
+  {
+    // somebody draws on their own and may have set up textures and blending already, draw the
+    // queued quads first without disturbing that
+    GLint activeTexture, texture0, texture1, srcRGB, dstRGB, srcAlpha, dstAlpha;
+    glGetIntegerv(GL_ACTIVE_TEXTURE, &activeTexture);
+    glActiveTexture(GL_TEXTURE1);
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture1);
+    glActiveTexture(GL_TEXTURE0);
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture0);
+    glGetIntegerv(GL_BLEND_SRC_RGB, &srcRGB);
+    glGetIntegerv(GL_BLEND_DST_RGB, &dstRGB);
+    glGetIntegerv(GL_BLEND_SRC_ALPHA, &srcAlpha);
+    glGetIntegerv(GL_BLEND_DST_ALPHA, &dstAlpha);
+    GLboolean blend = glIsEnabled(GL_BLEND);
+
+    FlushBatches();
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, texture1);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture0);
+    glActiveTexture(activeTexture);
+    glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+    if (blend)
+      glEnable(GL_BLEND);
+    else
+      glDisable(GL_BLEND);
+  }
+
   m_method = method;
   if (m_pShader[m_method])
   {
@@ -776,6 +880,180 @@ GLint CRenderSystemGL::ShaderGetModel()
   return -1;
 }
 
+void CRenderSystemGL::AddQuads(CGUIQuadBatcher::State state, const CGUIQuadBatcher::Vertex* vertices, unsigned int quads)
+{
+  state.scissors = m_scissors;
+  while (quads > 0)
+  {
+    const unsigned int count = std::min(quads, CGUIQuadBatcher::MAX_QUADS);
+    if (!m_batcher.AddQuads(state, vertices, count))
+    {
+      FlushBatches();
+      m_batcher.AddQuads(state, vertices, count);
+    }
+    vertices += count * 4;
+    quads -= count;
+  }
+}
+
+void CRenderSystemGL::FlushBatches()
+{
+  if (m_batcher.IsEmpty())
+    return;
+
+  const std::vector<uint16_t>& indices = m_batcher.BuildIndices();
+  const std::vector<CGUIQuadBatcher::Vertex>& vertices = m_batcher.GetVertices();
+  const std::vector<CGUIQuadBatcher::Batch>& batches = m_batcher.GetBatches();
+
+  if (!m_batchVertexBuffer)
+  {
+    glGenBuffers(1, &m_batchVertexBuffer);
+    glGenBuffers(1, &m_batchIndexBuffer);
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, m_batchVertexBuffer);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(CGUIQuadBatcher::Vertex) * vertices.size(), vertices.data(), GL_STREAM_DRAW);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_batchIndexBuffer);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint16_t) * indices.size(), indices.data(), GL_STREAM_DRAW);
+
+  glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
+
+  const CGUIQuadBatcher::State* last = nullptr;
+  GLint posLoc = -1, colLoc = -1, tex0Loc = -1, tex1Loc = -1, uniColLoc = -1;
+  unsigned int drawCalls = 0;
+  for (const auto& batch : batches)
+  {
+    const CGUIQuadBatcher::State& state = batch.state;
+    const ESHADERMETHOD method = static_cast<ESHADERMETHOD>(state.shader);
+    if (!m_pShader[method])
+      continue;
+
+    if (!last || last->shader != state.shader)
+    {
+      if (last)
+        m_pShader[m_method]->Disable();
+
+      for (GLint loc : {posLoc, colLoc, tex0Loc, tex1Loc})
+      {
+        if (loc >= 0)
+          glDisableVertexAttribArray(loc);
+      }
+
+      m_method = method;
+      m_pShader[m_method]->Enable();
+      posLoc = m_pShader[m_method]->GetPosLoc();
+      colLoc = m_pShader[m_method]->GetColLoc();
+      tex0Loc = m_pShader[m_method]->GetCord0Loc();
+      tex1Loc = m_pShader[m_method]->GetCord1Loc();
+      uniColLoc = m_pShader[m_method]->GetUniColLoc();
+
+      glVertexAttribPointer(posLoc, 3, GL_FLOAT, GL_FALSE, sizeof(CGUIQuadBatcher::Vertex), BUFFER_OFFSET(offsetof(CGUIQuadBatcher::Vertex, x)));
+      glEnableVertexAttribArray(posLoc);
+      if (colLoc >= 0)
+      {
+        glVertexAttribPointer(colLoc, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(CGUIQuadBatcher::Vertex), BUFFER_OFFSET(offsetof(CGUIQuadBatcher::Vertex, r)));
+        glEnableVertexAttribArray(colLoc);
+      }
+      if (tex0Loc >= 0)
+      {
+        glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, GL_FALSE, sizeof(CGUIQuadBatcher::Vertex), BUFFER_OFFSET(offsetof(CGUIQuadBatcher::Vertex, u1)));
+        glEnableVertexAttribArray(tex0Loc);
+      }
+      if (tex1Loc >= 0)
+      {
+        glVertexAttribPointer(tex1Loc, 2, GL_FLOAT, GL_FALSE, sizeof(CGUIQuadBatcher::Vertex), BUFFER_OFFSET(offsetof(CGUIQuadBatcher::Vertex, u2)));
+        glEnableVertexAttribArray(tex1Loc);
+      }
+    }
+
+    if (!last || last->diffuse != state.diffuse)
+    {
+      glActiveTexture(GL_TEXTURE1);
+      glBindTexture(GL_TEXTURE_2D, state.diffuse);
+      glActiveTexture(GL_TEXTURE0);
+    }
+    if (!last || last->texture != state.texture)
+      glBindTexture(GL_TEXTURE_2D, state.texture);
+
+    if (!last || last->blend != state.blend)
+    {
+      if (state.blend)
+        glEnable(GL_BLEND);
+      else
+        glDisable(GL_BLEND);
+    }
+
+    if (uniColLoc >= 0)
+      glUniform4f(uniColLoc, GET_R(state.color) / 255.0f, GET_G(state.color) / 255.0f, GET_B(state.color) / 255.0f, GET_A(state.color) / 255.0f);
+
+    if (!last || last->scissors != state.scissors)
+      ApplyScissors(state.scissors);
+
+    glDrawElements(GL_TRIANGLES, batch.quads * 6, GL_UNSIGNED_SHORT, BUFFER_OFFSET(batch.firstIndex * sizeof(uint16_t)));
+    drawCalls++;
+    last = &state;
+  }
+
+  if (last)
+  {
+    for (GLint loc : {posLoc, colLoc, tex0Loc, tex1Loc})
+    {
+      if (loc >= 0)
+        glDisableVertexAttribArray(loc);
+    }
+    m_pShader[m_method]->Disable();
+    m_method = SM_DEFAULT;
+
+    glEnable(GL_BLEND);
+    ApplyScissors(m_scissors);
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+  AddDrawCalls(drawCalls);
+  m_batcher.Clear();
+}
+
+ptrdiff_t CRenderSystemGL::StagePixels(const void* pixels, size_t size)
+{
+  if (!m_bRenderCreated || m_RenderVersionMajor < 3 || size > UPLOAD_BUFFER_SIZE)
+    return -1;
+
+  if (!m_uploadBuffer)
+  {
+    glGenBuffers(1, &m_uploadBuffer);
+    m_uploadOffset = UPLOAD_BUFFER_SIZE;
+  }
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_uploadBuffer);
+
+  if (m_uploadOffset + size > UPLOAD_BUFFER_SIZE)
+  {
+    // new storage once the buffer is full, the old one is released by the driver once the uploads
+    // from it are done. Parts of the buffer are never written twice, so it can be mapped without
+    // waiting for the GPU.
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, UPLOAD_BUFFER_SIZE, nullptr, GL_STREAM_DRAW);
+    m_uploadOffset = 0;
+  }
+
+  void* buffer = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, m_uploadOffset, size,
+                                  GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+  if (buffer)
+  {
+    memcpy(buffer, pixels, size);
+    if (glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE)
+    {
+      const ptrdiff_t offset = m_uploadOffset;
+      // keep the rows of the next upload aligned
+      m_uploadOffset = (m_uploadOffset + size + 63) & ~static_cast<size_t>(63);
+      return offset;
+    }
+  }
+
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  return -1;
+}
+
 std::string CRenderSystemGL::GetShaderPath(const std::string &filename)
 {
   std::string path = "GL/1.2/";
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "GLShader.h"
+#include "guilib/GUIQuadBatcher.h"
 #include "rendering/RenderSystem.h"
 #include "utils/Color.h"
 
@@ -26,6 +27,7 @@ enum ESHADERMETHOD
   SM_FONTS,
   SM_TEXTURE_NOBLEND,
   SM_MULTI_BLENDCOLOR,
+  SM_FONTS_SDF,
   SM_MAX
 };
 
@@ -68,6 +70,32 @@ public:
 
   std::string GetShaderPath(const std::string &filename) override;
 
+  void FlushBatches() override;
+
+  /*!
+   \brief Whether GUI textures and fonts queue their quads with AddQuads() instead of drawing
+   them right away
+   */
+  bool BatchDraws() const { return m_batchDraws; }
+
+  /*!
+   \brief Queue quads to be drawn with the next FlushBatches()
+   \param state the shader, textures and blending to draw with, the scissors are the current ones
+   \param vertices 4 vertices per quad
+   \param quads the number of quads
+   */
+  void AddQuads(CGUIQuadBatcher::State state, const CGUIQuadBatcher::Vertex* vertices, unsigned int quads);
+
+  /*!
+   \brief Copy pixels into the stream upload buffer
+   The buffer is left bound to GL_PIXEL_UNPACK_BUFFER. Pass the returned offset instead of the pixels
+   to glTexSubImage2D() and unbind the buffer afterwards.
+   \param pixels the pixels to upload
+   \param size the size of the pixels in bytes
+   \return the offset of the pixels in the buffer, -1 if they couldn't be copied
+   */
+  ptrdiff_t StagePixels(const void* pixels, size_t size);
+
   void GetGLVersion(int& major, int& minor);
   void GetGLSLVersion(int& major, int& minor);
 
@@ -89,6 +117,7 @@ protected:
   void CalculateMaxTexturesize();
   void InitialiseShaders();
   void ReleaseShaders();
+  void ApplyScissors(const CRect& rect);
 
   bool m_bVsyncInit = false;
   int m_width;
@@ -100,8 +129,25 @@ protected:
   int m_glslMinor = 0;
 
   GLint m_viewPort[4];
+  CRect m_scissors;
+
+  // the camera last set, SetCameraPosition() is called far more often than it changes
+  bool m_cameraValid = false;
+  CPoint m_camera;
+  int m_cameraScreenWidth = 0;
+  int m_cameraScreenHeight = 0;
+  float m_cameraStereoFactor = 0.0f;
 
   std::array<std::unique_ptr<CGLShader>, SM_MAX> m_pShader;
   ESHADERMETHOD m_method = SM_DEFAULT;
   GLuint m_vertexArray = GL_NONE;
+
+  bool m_batchDraws = false;
+  CGUIQuadBatcher m_batcher;
+  GLuint m_batchVertexBuffer = 0;
+  GLuint m_batchIndexBuffer = 0;
+
+  static const size_t UPLOAD_BUFFER_SIZE = 8 * 1024 * 1024;
+  GLuint m_uploadBuffer = 0;
+  size_t m_uploadOffset = 0;
 };
@@ -266,6 +266,9 @@ void CAdvancedSettings::Initialize()
 
   m_fanartRes = 1080;
   m_imageRes = 720;
+  m_imageVariants = true;
+  m_imageVariantMaxAge = 30;
+  m_imageCachePacked = false;
   m_imageScalingAlgorithm = CPictureScalingAlgorithm::Default;
 
   m_sambaclienttimeout = 30;
@@ -284,6 +287,8 @@ void CAdvancedSettings::Initialize()
   m_bMusicLibraryAllItemsOnBottom = false;
   m_bMusicLibraryCleanOnUpdate = false;
   m_bMusicLibraryArtistSortOnUpdate = false;
+  m_bMusicLibraryWatchForChanges = false;
+  m_iMusicLibraryTagReaders = 4;
   m_iMusicLibraryRecentlyAddedItems = 25;
   m_strMusicLibraryAlbumFormat = "";
   m_prioritiseAPEv2tags = false;
@@ -296,6 +301,7 @@ void CAdvancedSettings::Initialize()
   m_iVideoLibraryRecentlyAddedItems = 25;
   m_bVideoLibraryCleanOnUpdate = false;
   m_bVideoLibraryUseFastHash = true;
+  m_bVideoLibraryWatchForChanges = false;
   m_bVideoLibraryImportWatchedState = false;
   m_bVideoLibraryImportResumePoint = false;
   m_bVideoScannerIgnoreErrors = false;
@@ -347,6 +353,8 @@ void CAdvancedSettings::Initialize()
   m_curlDisableIPV6 = false;      //Certain hardware/OS combinations have trouble
                                   //with ipv6.
   m_curlDisableHTTP2 = false;
+  m_curlRangeConnections = 1;
+  m_curlRangeSegmentSize = 1024 * 1024;
 
 #if defined(TARGET_DARWIN_EMBEDDED)
   m_startFullScreen = true;
@@ -382,12 +390,16 @@ void CAdvancedSettings::Initialize()
   m_bPVRTimeshiftSimpleOSD = true;
 
   m_cacheMemSize = 1024 * 1024 * 20; // 20 MiB
+  m_cacheDiskSize = 0; // segmented disk cache disabled
   m_cacheBufferMode = CACHE_BUFFER_MODE_INTERNET; // Default (buffer all internet streams/filesystems)
   m_cacheChunkSize = 128 * 1024; // 128 KiB
   // the following setting determines the readRate of a player data
   // as multiply of the default data read rate
   m_cacheReadFactor = 4.0f;
 
+  m_directoryCacheMemSize = 1024 * 1024 * 16; // 16 MiB
+  m_directoryCacheMaxDirs = 50;
+
   m_addonPackageFolderSize = 200;
 
   m_jsonOutputCompact = true;
@@ -399,6 +411,10 @@ void CAdvancedSettings::Initialize()
   m_guiVisualizeDirtyRegions = false;
   m_guiAlgorithmDirtyRegions = 3;
   m_guiSmartRedraw = false;
+  m_guiTextureMemSize = 1024 * 1024 * 256; // 256 MiB
+  m_guiFontDistanceField = false;
+  m_guiBatchDraws = true;
+  m_guiTextureUploadTime = 4;
   m_airTunesPort = 36666;
   m_airPlayPort = 36667;
 
@@ -747,6 +763,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetBoolean(pElement, "allitemsonbottom", m_bMusicLibraryAllItemsOnBottom);
     XMLUtils::GetBoolean(pElement, "cleanonupdate", m_bMusicLibraryCleanOnUpdate);
     XMLUtils::GetBoolean(pElement, "artistsortonupdate", m_bMusicLibraryArtistSortOnUpdate);
+    XMLUtils::GetBoolean(pElement, "watchforchanges", m_bMusicLibraryWatchForChanges);
+    XMLUtils::GetInt(pElement, "tagreaders", m_iMusicLibraryTagReaders, 1, 16);
     XMLUtils::GetString(pElement, "albumformat", m_strMusicLibraryAlbumFormat);
     XMLUtils::GetString(pElement, "itemseparator", m_musicItemSeparator);
     XMLUtils::GetInt(pElement, "dateadded", m_iMusicLibraryDateAdded);
@@ -775,6 +793,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "recentlyaddeditems", m_iVideoLibraryRecentlyAddedItems, 1, INT_MAX);
     XMLUtils::GetBoolean(pElement, "cleanonupdate", m_bVideoLibraryCleanOnUpdate);
     XMLUtils::GetBoolean(pElement, "usefasthash", m_bVideoLibraryUseFastHash);
+    XMLUtils::GetBoolean(pElement, "watchforchanges", m_bVideoLibraryWatchForChanges);
     XMLUtils::GetString(pElement, "itemseparator", m_videoItemSeparator);
     XMLUtils::GetBoolean(pElement, "importwatchedstate", m_bVideoLibraryImportWatchedState);
     XMLUtils::GetBoolean(pElement, "importresumepoint", m_bVideoLibraryImportResumePoint);
@@ -816,17 +835,27 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
     XMLUtils::GetBoolean(pElement, "disableipv6", m_curlDisableIPV6);
     XMLUtils::GetBoolean(pElement, "disablehttp2", m_curlDisableHTTP2);
+    XMLUtils::GetInt(pElement, "curlrangeconnections", m_curlRangeConnections, 1, 8);
+    XMLUtils::GetUInt(pElement, "curlrangesegmentsize", m_curlRangeSegmentSize, 64 * 1024, 64 * 1024 * 1024);
   }
 
   pElement = pRootElement->FirstChildElement("cache");
   if (pElement)
   {
     XMLUtils::GetUInt(pElement, "memorysize", m_cacheMemSize);
+    XMLUtils::GetUInt(pElement, "disksize", m_cacheDiskSize);
     XMLUtils::GetUInt(pElement, "buffermode", m_cacheBufferMode, 0, 4);
     XMLUtils::GetUInt(pElement, "chunksize", m_cacheChunkSize, 256, 1024 * 1024);
     XMLUtils::GetFloat(pElement, "readfactor", m_cacheReadFactor);
   }
 
+  pElement = pRootElement->FirstChildElement("directorycache");
+  if (pElement)
+  {
+    XMLUtils::GetUInt(pElement, "memorysize", m_directoryCacheMemSize, 256 * 1024, UINT_MAX);
+    XMLUtils::GetUInt(pElement, "maxdirs", m_directoryCacheMaxDirs, 1, 10000);
+  }
+
   pElement = pRootElement->FirstChildElement("jsonrpc");
   if (pElement)
   {
@@ -1029,6 +1058,9 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
 
   XMLUtils::GetUInt(pRootElement, "fanartres", m_fanartRes, 0, 9999);
   XMLUtils::GetUInt(pRootElement, "imageres", m_imageRes, 0, 9999);
+  XMLUtils::GetBoolean(pRootElement, "imagevariants", m_imageVariants);
+  XMLUtils::GetUInt(pRootElement, "imagevariantmaxage", m_imageVariantMaxAge, 0, 3650);
+  XMLUtils::GetBoolean(pRootElement, "imagecachepacked", m_imageCachePacked);
   if (XMLUtils::GetString(pRootElement, "imagescalingalgorithm", tmp))
     m_imageScalingAlgorithm = CPictureScalingAlgorithm::FromString(tmp);
   XMLUtils::GetBoolean(pRootElement, "playlistasfolders", m_playlistAsFolders);
@@ -1172,6 +1204,10 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetBoolean(pElement, "visualizedirtyregions", m_guiVisualizeDirtyRegions);
     XMLUtils::GetInt(pElement, "algorithmdirtyregions",     m_guiAlgorithmDirtyRegions);
     XMLUtils::GetBoolean(pElement, "smartredraw", m_guiSmartRedraw);
+    XMLUtils::GetUInt(pElement, "texturememorysize", m_guiTextureMemSize, 16 * 1024 * 1024, UINT_MAX);
+    XMLUtils::GetBoolean(pElement, "fontdistancefield", m_guiFontDistanceField);
+    XMLUtils::GetBoolean(pElement, "batchdraws", m_guiBatchDraws);
+    XMLUtils::GetUInt(pElement, "textureuploadtime", m_guiTextureUploadTime, 0, 1000);
   }
 
   std::string seekSteps;
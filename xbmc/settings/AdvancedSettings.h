@@ -223,6 +223,9 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
 
     unsigned int m_fanartRes; ///< \brief the maximal resolution to cache fanart at (assumes 16x9)
     unsigned int m_imageRes;  ///< \brief the maximal resolution to cache images at (assumes 16x9)
+    bool m_imageVariants; ///< \brief whether to cache smaller variants of images for the sizes the GUI draws them at
+    unsigned int m_imageVariantMaxAge; ///< \brief the days after which unused image variants are removed, 0 to keep them
+    bool m_imageCachePacked; ///< \brief whether to cache images as lzo packed textures (.xbt) rather than JPEG/PNG
     CPictureScalingAlgorithm::Algorithm m_imageScalingAlgorithm;
 
     int m_sambaclienttimeout;
@@ -243,6 +246,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_bMusicLibraryAllItemsOnBottom;
     bool m_bMusicLibraryCleanOnUpdate;
     bool m_bMusicLibraryArtistSortOnUpdate;
+    bool m_bMusicLibraryWatchForChanges;
+    int m_iMusicLibraryTagReaders;
     std::string m_strMusicLibraryAlbumFormat;
     bool m_prioritiseAPEv2tags;
     std::string m_musicItemSeparator;
@@ -254,6 +259,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_iVideoLibraryRecentlyAddedItems;
     bool m_bVideoLibraryCleanOnUpdate;
     bool m_bVideoLibraryUseFastHash;
+    bool m_bVideoLibraryWatchForChanges;
     bool m_bVideoLibraryImportWatchedState;
     bool m_bVideoLibraryImportResumePoint;
     std::vector<std::string> m_videoEpisodeExtraArt;
@@ -290,6 +296,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_curlretries;
     bool m_curlDisableIPV6;
     bool m_curlDisableHTTP2;
+    int m_curlRangeConnections;           // parallel range requests used when filling the file cache, 1 = disabled
+    unsigned int m_curlRangeSegmentSize;  // size of each range request in bytes
 
     bool m_fullScreen;
     bool m_startFullScreen;
@@ -324,13 +332,21 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
     bool m_guiSmartRedraw;
+    unsigned int m_guiTextureMemSize; /*!< memory the GUI textures may use before released textures are freed early, in bytes */
+    bool m_guiFontDistanceField; /*!< render fonts from distance fields shared by all sizes of a font */
+    bool m_guiBatchDraws; /*!< merge the draws of textures and fonts with the same render state */
+    unsigned int m_guiTextureUploadTime; /*!< time per frame spent loading background loaded images to the GPU in ms, 0 to load them at once */
     unsigned int m_addonPackageFolderSize;
 
     unsigned int m_cacheMemSize;
+    unsigned int m_cacheDiskSize;
     unsigned int m_cacheBufferMode;
     unsigned int m_cacheChunkSize;
     float m_cacheReadFactor;
 
+    unsigned int m_directoryCacheMemSize; /*!< estimated memory the cached directory listings may use in bytes */
+    unsigned int m_directoryCacheMaxDirs; /*!< number of directory listings to cache */
+
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
 
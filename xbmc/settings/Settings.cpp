@@ -10,6 +10,7 @@
 #include "Application.h"
 #include "Autorun.h"
 #include "LangInfo.h"
+#include "LibraryMonitor.h"
 #include "Util.h"
 #include "addons/AddonSystemSettings.h"
 #include "addons/Skin.h"
@@ -844,6 +845,7 @@ void CSettings::InitializeISettingsHandlers()
   // register ISettingsHandler implementations
   // The order of these matters! Handlers are processed in the order they were registered.
   GetSettingsManager()->RegisterSettingsHandler(&CMediaSourceSettings::GetInstance());
+  GetSettingsManager()->RegisterSettingsHandler(&CLibraryMonitor::GetInstance());
 #ifdef HAS_UPNP
   GetSettingsManager()->RegisterSettingsHandler(&CUPnPSettings::GetInstance());
 #endif
@@ -871,6 +873,7 @@ void CSettings::UninitializeISettingsHandlers()
 #ifdef HAS_UPNP
   GetSettingsManager()->UnregisterSettingsHandler(&CUPnPSettings::GetInstance());
 #endif
+  GetSettingsManager()->UnregisterSettingsHandler(&CLibraryMonitor::GetInstance());
   GetSettingsManager()->UnregisterSettingsHandler(&CMediaSourceSettings::GetInstance());
 }
 
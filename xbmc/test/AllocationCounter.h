@@ -0,0 +1,19 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/*!
+ * \brief The number of calls to operator new of the test process so far.
+ *
+ * Tests compare it before and after the code they measure. Allocations of other threads are
+ * included, malloc() is not counted.
+ */
+uint64_t GetAllocationCount();
@@ -14,6 +14,12 @@
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "settings/lib/SettingsManager.h"
+#include "utils/Variant.h"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -131,3 +137,91 @@ const TestFileData BaseMovies[] = {{ "c:\\dir\\filename.avi", false, "c:\\dir\\f
                                    { "/home/user/movies/movie_name/BDMV/index.bdmv", true, "/home/user/movies/movie_name/" }};
 
 INSTANTIATE_TEST_CASE_P(BaseNameMovies, TestFileItemBasePath, ValuesIn(BaseMovies));
+
+namespace
+{
+class TestPropertyItem : public CFileItem
+{
+public:
+  std::vector<std::string> GetPropertyNames() const
+  {
+    std::vector<std::string> names;
+    for (const auto& property : m_mapProperties)
+      names.push_back(property.key.Name());
+    return names;
+  }
+};
+
+// resident memory of the process in bytes, 0 if it can't be read
+long long ResidentMemory()
+{
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line))
+  {
+    if (line.compare(0, 6, "VmRSS:") == 0)
+      return std::stoll(line.substr(6)) * 1024;
+  }
+  return 0;
+}
+}
+
+TEST(TestFileItem, PropertiesAndArtMemory)
+{
+  // a large library listing, every item has the same types of art and properties
+  const int count = 200000;
+  const size_t keys = CGUIListItem::GetKeyCount();
+  const long long before = ResidentMemory();
+  {
+    CFileItemList items;
+    for (int i = 0; i < count; i++)
+    {
+      CFileItemPtr item(new CFileItem("Song " + std::to_string(i)));
+      const std::string album = std::to_string(i / 12);
+      item->SetArt("thumb", "image://music@/library/album/" + album + "/cover.jpg/");
+      item->SetArt("album.thumb", "image://music@/library/album/" + album + "/cover.jpg/");
+      item->SetArt("artist.fanart", "image://music@/library/artist/" + std::to_string(i / 120) + "/fanart.jpg/");
+      item->SetArtFallback("icon", "thumb");
+      item->SetProperty("IsPlayable", "true");
+      item->SetProperty("libraryartfilled", true);
+      item->SetProperty("Album_Duration", i % 3600);
+      item->SetProperty("Artist_Genre", "Rock");
+      item->SetProperty("Unique_" + std::to_string(i % 1000), i);
+      items.Add(item);
+    }
+    const long long after = ResidentMemory();
+
+    ASSERT_EQ(count, items.Size());
+    EXPECT_EQ("image://music@/library/album/1/cover.jpg/", items[12]->GetArt("icon"));
+    EXPECT_EQ("true", items[12]->GetProperty("isplayable").asString());
+    EXPECT_EQ(12, items[12]->GetProperty("Album_Duration").asInteger());
+
+    // art and properties keep the order of a map sorted by name
+    const CGUIListItem::ArtMap &art = items[12]->GetArt();
+    ASSERT_EQ(3u, art.size());
+    EXPECT_EQ("album.thumb", art.begin()->first);
+    EXPECT_EQ(&art, &items[12]->GetArt());
+
+    if (before > 0)
+      std::cout << "items: " << count << ", resident bytes before: " << before << ", after: " << after
+                << ", per item: " << (after - before) / count << "\n";
+  }
+
+  // names nothing refers to anymore are dropped
+  EXPECT_EQ(keys, CGUIListItem::GetKeyCount());
+}
+
+TEST(TestFileItem, PropertiesSortedByName)
+{
+  TestPropertyItem item;
+  item.SetProperty("libraryartfilled", true);
+  item.SetProperty("IsPlayable", "true");
+  item.SetProperty("Artist_Genre", "Rock");
+  item.SetProperty("album_duration", 12);
+  item.SetProperty("Album_Duration", 13);
+
+  // case insensitive like the map they were kept in before
+  const std::vector<std::string> sorted{"album_duration", "Artist_Genre", "IsPlayable", "libraryartfilled"};
+  EXPECT_EQ(sorted, item.GetPropertyNames());
+  EXPECT_EQ(13, item.GetProperty("ALBUM_DURATION").asInteger());
+}
@@ -0,0 +1,86 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "LibraryMonitor.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const std::set<std::string> LIBRARY_PATHS = {
+  "/media/movies/",
+  "/media/movies/Alien (1979)/",
+  "/media/movies/Heat (1995)/",
+  "/media/tv/",
+  "/media/tv/Firefly/",
+  "/media/tv/Firefly/Season 1/",
+  "smb://server/share/",
+};
+
+const std::vector<std::string> WATCHED_ROOTS = { "/media/movies/", "/media/tv/" };
+}
+
+TEST(TestLibraryMonitor, UnwatchedPathsAreScanned)
+{
+  std::set<std::string> pathsToScan;
+  CLibraryMonitor::GetPathsToScan(LIBRARY_PATHS, WATCHED_ROOTS, {}, pathsToScan);
+
+  EXPECT_EQ(std::set<std::string>({ "smb://server/share/" }), pathsToScan);
+}
+
+TEST(TestLibraryMonitor, ChangedPathIsScanned)
+{
+  std::set<std::string> pathsToScan;
+  CLibraryMonitor::GetPathsToScan(LIBRARY_PATHS, WATCHED_ROOTS,
+                                  { { "/media/movies/Heat (1995)/", false } }, pathsToScan);
+
+  EXPECT_EQ(std::set<std::string>({ "/media/movies/Heat (1995)/", "smb://server/share/" }), pathsToScan);
+}
+
+TEST(TestLibraryMonitor, ChangedSubdirectoryScansNearestPath)
+{
+  std::set<std::string> pathsToScan;
+  CLibraryMonitor::GetPathsToScan(LIBRARY_PATHS, WATCHED_ROOTS,
+                                  { { "/media/tv/Firefly/Season 1/extras/", false },
+                                    { "/media/movies/Up (2009)/", false } }, pathsToScan);
+
+  EXPECT_EQ(std::set<std::string>({ "/media/movies/", "/media/tv/Firefly/Season 1/", "smb://server/share/" }),
+            pathsToScan);
+}
+
+TEST(TestLibraryMonitor, RecursiveChangeScansEverythingBelow)
+{
+  std::set<std::string> pathsToScan;
+  CLibraryMonitor::GetPathsToScan(LIBRARY_PATHS, WATCHED_ROOTS,
+                                  { { "/media/tv/", true } }, pathsToScan);
+
+  EXPECT_EQ(std::set<std::string>({ "/media/tv/", "/media/tv/Firefly/", "/media/tv/Firefly/Season 1/",
+                                    "smb://server/share/" }),
+            pathsToScan);
+}
+
+TEST(TestLibraryMonitor, NewDirectoryWithoutPathIsScanned)
+{
+  // a source that has never been scanned has no paths in the library yet
+  std::set<std::string> pathsToScan;
+  CLibraryMonitor::GetPathsToScan({}, WATCHED_ROOTS,
+                                  { { "/media/movies/Up (2009)/", false } }, pathsToScan);
+
+  EXPECT_EQ(std::set<std::string>({ "/media/movies/Up (2009)/" }), pathsToScan);
+}
+
+TEST(TestLibraryMonitor, ChangesOutsideWatchedRootsAreIgnored)
+{
+  std::set<std::string> pathsToScan;
+  CLibraryMonitor::GetPathsToScan(LIBRARY_PATHS, { "/media/movies/" },
+                                  { { "/media/tv/Firefly/", false } }, pathsToScan);
+
+  EXPECT_EQ(std::set<std::string>({ "/media/tv/", "/media/tv/Firefly/", "/media/tv/Firefly/Season 1/",
+                                    "smb://server/share/" }),
+            pathsToScan);
+}
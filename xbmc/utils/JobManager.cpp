@@ -10,7 +10,10 @@
 #include <algorithm>
 #include <functional>
 #include <stdexcept>
+#include <thread>
+#include "ServiceBroker.h"
 #include "threads/SingleLock.h"
+#include "utils/CPUInfo.h"
 #include "utils/log.h"
 #ifdef TARGET_POSIX
 #include "platform/posix/XTimeUtils.h"
@@ -23,9 +26,10 @@ bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
   return false;
 }
 
-CJobWorker::CJobWorker(CJobManager *manager) : CThread("JobWorker")
+CJobWorker::CJobWorker(CJobManager *manager, unsigned int lane) : CThread("JobWorker")
 {
   m_jobManager = manager;
+  m_lane = lane;
   Create(true); // start work immediately, and kill ourselves when we're done
 }
 
@@ -168,8 +172,23 @@ CJobManager &CJobManager::GetInstance()
 CJobManager::CJobManager()
 {
   m_jobCounter = 0;
+  m_nextLane = 0;
+  m_processingCount = 0;
   m_running = true;
   m_pauseJobs = false;
+  for (auto& queued : m_queued)
+    queued = 0;
+
+  unsigned int cpuCount = 0;
+  if (CServiceBroker::GetCPUInfo())
+    cpuCount = std::max(CServiceBroker::GetCPUInfo()->GetCPUCount(), 0);
+  if (cpuCount == 0)
+    cpuCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+  // keep at least the historic 5 workers so low priority jobs still get a slot on small boxes
+  m_maxWorkers = std::max(cpuCount, 5u);
+  for (unsigned int lane = 0; lane < cpuCount; ++lane)
+    m_lanes.emplace_back(new CJobLane);
 }
 
 void CJobManager::Restart()
@@ -186,15 +205,22 @@ void CJobManager::CancelJobs()
   CSingleLock lock(m_section);
   m_running = false;
 
-  // clear any pending jobs
-  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+  for (auto& jobLane : m_lanes)
   {
-    for_each(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), [](CWorkItem& wi) { wi.FreeJob(); });
-    m_jobQueue[priority].clear();
-  }
+    CSingleLock laneLock(jobLane->m_section);
 
-  // cancel any callbacks on jobs still processing
-  for_each(m_processing.begin(), m_processing.end(), [](CWorkItem& wi) { wi.Cancel(); });
+    // clear any pending jobs
+    for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+    {
+      JobQueue &queue = jobLane->m_jobQueue[priority];
+      for_each(queue.begin(), queue.end(), [](CWorkItem& wi) { wi.FreeJob(); });
+      m_queued[priority] -= queue.size();
+      queue.clear();
+    }
+
+    // cancel any callbacks on jobs still processing
+    for_each(jobLane->m_processing.begin(), jobLane->m_processing.end(), [](CWorkItem& wi) { wi.Cancel(); });
+  }
 
   // tell our workers to finish
   while (m_workers.size())
@@ -208,19 +234,27 @@ void CJobManager::CancelJobs()
 
 unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORITY priority)
 {
-  CSingleLock lock(m_section);
-
   if (!m_running)
     return 0;
 
   // increment the job counter, ensuring 0 (invalid job) is never hit
-  m_jobCounter++;
-  if (m_jobCounter == 0)
-    m_jobCounter++;
+  unsigned int id = ++m_jobCounter;
+  if (id == 0)
+    id = ++m_jobCounter;
 
   // create a work item for this job
-  CWorkItem work(job, m_jobCounter, priority, callback);
-  m_jobQueue[priority].push_back(work);
+  CWorkItem work(job, id, priority, callback);
+  {
+    CJobLane &jobLane = *m_lanes[GetLaneForNewJob()];
+    CSingleLock lock(jobLane.m_section);
+
+    // CancelJobs() may have run since we checked above
+    if (!m_running)
+      return 0;
+
+    jobLane.m_jobQueue[priority].push_back(work);
+    ++m_queued[priority];
+  }
 
   StartWorkers(priority);
   return work.m_id;
@@ -228,23 +262,41 @@ unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORI
 
 void CJobManager::CancelJob(unsigned int jobID)
 {
-  CSingleLock lock(m_section);
-
-  // check whether we have this job in the queue
-  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+  for (auto& jobLane : m_lanes)
   {
-    JobQueue::iterator i = find(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), jobID);
-    if (i != m_jobQueue[priority].end())
+    CSingleLock lock(jobLane->m_section);
+
+    // check whether we have this job in the queue
+    for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+    {
+      JobQueue &queue = jobLane->m_jobQueue[priority];
+      JobQueue::iterator i = find(queue.begin(), queue.end(), jobID);
+      if (i != queue.end())
+      {
+        delete i->m_job;
+        queue.erase(i);
+        --m_queued[priority];
+        return;
+      }
+    }
+    // or if we're processing it
+    Processing::iterator it = find(jobLane->m_processing.begin(), jobLane->m_processing.end(), jobID);
+    if (it != jobLane->m_processing.end())
     {
-      delete i->m_job;
-      m_jobQueue[priority].erase(i);
+      it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
       return;
     }
   }
-  // or if we're processing it
-  Processing::iterator it = find(m_processing.begin(), m_processing.end(), jobID);
-  if (it != m_processing.end())
-    it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
+}
+
+unsigned int CJobManager::GetLaneForNewJob() const
+{
+  // jobs queued from within a job stay with the worker that queued them
+  const CJobWorker *worker = dynamic_cast<const CJobWorker*>(CThread::GetCurrentThread());
+  if (worker && worker->GetLane() < m_lanes.size())
+    return worker->GetLane();
+
+  return m_nextLane++ % m_lanes.size();
 }
 
 void CJobManager::StartWorkers(CJob::PRIORITY priority)
@@ -252,37 +304,72 @@ void CJobManager::StartWorkers(CJob::PRIORITY priority)
   CSingleLock lock(m_section);
 
   // check how many free threads we have
-  if (m_processing.size() >= GetMaxWorkers(priority))
+  if (m_processingCount >= GetMaxWorkers(priority))
     return;
 
   // do we have any sleeping threads?
-  if (m_processing.size() < m_workers.size())
+  if (m_processingCount < m_workers.size())
   {
     m_jobEvent.Set();
     return;
   }
 
-  // everyone is busy - we need more workers
-  m_workers.push_back(new CJobWorker(this));
+  // everyone is busy - we need more workers. Home the new one on the least served lane.
+  std::vector<unsigned int> workersPerLane(m_lanes.size(), 0);
+  for (const CJobWorker *worker : m_workers)
+    ++workersPerLane[worker->GetLane()];
+  unsigned int lane = std::min_element(workersPerLane.begin(), workersPerLane.end()) - workersPerLane.begin();
+
+  m_workers.push_back(new CJobWorker(this, lane));
 }
 
-CJob *CJobManager::PopJob()
+bool CJobManager::ReserveWorkerSlot(CJob::PRIORITY priority)
+{
+  unsigned int maxWorkers = GetMaxWorkers(priority);
+  unsigned int processing = m_processingCount;
+  do
+  {
+    if (processing >= maxWorkers)
+      return false;
+  } while (!m_processingCount.compare_exchange_weak(processing, processing + 1));
+  return true;
+}
+
+CJob *CJobManager::PopJob(unsigned int lane)
 {
-  CSingleLock lock(m_section);
   for (int priority = CJob::PRIORITY_DEDICATED; priority >= CJob::PRIORITY_LOW_PAUSABLE; --priority)
   {
     // Check whether we're pausing pausable jobs
     if (priority == CJob::PRIORITY_LOW_PAUSABLE && m_pauseJobs)
       continue;
 
-    if (m_jobQueue[priority].size() && m_processing.size() < GetMaxWorkers(CJob::PRIORITY(priority)))
+    if (m_queued[priority] == 0)
+      continue;
+
+    // start with our own lane, then steal from the others
+    for (unsigned int i = 0; i < m_lanes.size(); ++i)
     {
+      CJobLane &jobLane = *m_lanes[(lane + i) % m_lanes.size()];
+      CSingleLock lock(jobLane.m_section);
+
+      JobQueue &queue = jobLane.m_jobQueue[priority];
+      if (queue.empty())
+        continue;
+
+      if (!m_running)
+        return NULL;
+
+      // lower priorities have fewer slots, so there's no point in looking further
+      if (!ReserveWorkerSlot(CJob::PRIORITY(priority)))
+        return NULL;
+
       // pop the job off the queue
-      CWorkItem job = m_jobQueue[priority].front();
-      m_jobQueue[priority].pop_front();
+      CWorkItem job = queue.front();
+      queue.pop_front();
+      --m_queued[priority];
 
       // add to the processing vector
-      m_processing.push_back(job);
+      jobLane.m_processing.push_back(job);
       job.m_job->m_callback = this;
       return job.m_job;
     }
@@ -290,29 +377,42 @@ CJob *CJobManager::PopJob()
   return NULL;
 }
 
+unsigned int CJobManager::FindProcessingLane(const CJob *job) const
+{
+  for (unsigned int lane = 0; lane < m_lanes.size(); ++lane)
+  {
+    const CJobLane &jobLane = *m_lanes[lane];
+    CSingleLock lock(jobLane.m_section);
+    if (find(jobLane.m_processing.begin(), jobLane.m_processing.end(), job) != jobLane.m_processing.end())
+      return lane;
+  }
+  return m_lanes.size();
+}
+
 void CJobManager::PauseJobs()
 {
-  CSingleLock lock(m_section);
   m_pauseJobs = true;
 }
 
 void CJobManager::UnPauseJobs()
 {
-  CSingleLock lock(m_section);
   m_pauseJobs = false;
+  m_jobEvent.Set();
 }
 
 bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
 {
-  CSingleLock lock(m_section);
-
   if (m_pauseJobs)
     return false;
 
-  for(Processing::const_iterator it = m_processing.begin(); it < m_processing.end(); ++it)
+  for (const auto& jobLane : m_lanes)
   {
-    if (priority == it->m_priority)
-      return true;
+    CSingleLock lock(jobLane->m_section);
+    for(Processing::const_iterator it = jobLane->m_processing.begin(); it < jobLane->m_processing.end(); ++it)
+    {
+      if (priority == it->m_priority)
+        return true;
+    }
   }
   return false;
 }
@@ -320,38 +420,49 @@ bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
 int CJobManager::IsProcessing(const std::string &type) const
 {
   int jobsMatched = 0;
-  CSingleLock lock(m_section);
 
   if (m_pauseJobs)
     return 0;
 
-  for(Processing::const_iterator it = m_processing.begin(); it < m_processing.end(); ++it)
+  for (const auto& jobLane : m_lanes)
   {
-    if (type == std::string(it->m_job->GetType()))
-      jobsMatched++;
+    CSingleLock lock(jobLane->m_section);
+    for(Processing::const_iterator it = jobLane->m_processing.begin(); it < jobLane->m_processing.end(); ++it)
+    {
+      if (type == std::string(it->m_job->GetType()))
+        jobsMatched++;
+    }
   }
   return jobsMatched;
 }
 
 CJob *CJobManager::GetNextJob(const CJobWorker *worker)
 {
-  CSingleLock lock(m_section);
   while (m_running)
   {
-    // grab a job off the queue if we have one
-    CJob *job = PopJob();
+    // grab a job off the queues if we have one
+    CJob *job = PopJob(worker->GetLane());
     if (job)
+    {
+      // more work is waiting - wake up another sleeping worker to take it
+      for (const auto& queued : m_queued)
+      {
+        if (queued)
+        {
+          m_jobEvent.Set();
+          break;
+        }
+      }
       return job;
+    }
     // no jobs are left - sleep for 30 seconds to allow new jobs to come in
-    lock.Leave();
-    bool newJob = m_jobEvent.WaitMSec(30000);
-    lock.Enter();
-    if (!newJob)
+    if (!m_jobEvent.WaitMSec(30000))
       break;
   }
   // ensure no jobs have come in during the period after
   // timeout and before we held the lock
-  CJob *job = PopJob();
+  CSingleLock lock(m_section);
+  CJob *job = PopJob(worker->GetLane());
   if (job)
     return job;
   // have no jobs
@@ -361,17 +472,22 @@ CJob *CJobManager::GetNextJob(const CJobWorker *worker)
 
 bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const CJob *job) const
 {
-  CSingleLock lock(m_section);
-  // find the job in the processing queue, and check whether it's cancelled (no callback)
-  Processing::const_iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  unsigned int lane = FindProcessingLane(job);
+  if (lane < m_lanes.size())
   {
-    CWorkItem item(*i);
-    lock.Leave(); // leave section prior to call
-    if (item.m_callback)
+    const CJobLane &jobLane = *m_lanes[lane];
+    CSingleLock lock(jobLane.m_section);
+    // find the job in the processing queue, and check whether it's cancelled (no callback)
+    Processing::const_iterator i = find(jobLane.m_processing.begin(), jobLane.m_processing.end(), job);
+    if (i != jobLane.m_processing.end())
     {
-      item.m_callback->OnJobProgress(item.m_id, progress, total, job);
-      return false;
+      CWorkItem item(*i);
+      lock.Leave(); // leave section prior to call
+      if (item.m_callback)
+      {
+        item.m_callback->OnJobProgress(item.m_id, progress, total, job);
+        return false;
+      }
     }
   }
   return true; // couldn't find the job, or it's been cancelled
@@ -379,10 +495,15 @@ bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const
 
 void CJobManager::OnJobComplete(bool success, CJob *job)
 {
-  CSingleLock lock(m_section);
+  unsigned int lane = FindProcessingLane(job);
+  if (lane >= m_lanes.size())
+    return;
+
+  CJobLane &jobLane = *m_lanes[lane];
+  CSingleLock lock(jobLane.m_section);
   // remove the job from the processing queue
-  Processing::iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  Processing::iterator i = find(jobLane.m_processing.begin(), jobLane.m_processing.end(), job);
+  if (i != jobLane.m_processing.end())
   {
     // tell any listeners we're done with the job, then delete it
     CWorkItem item(*i);
@@ -397,9 +518,12 @@ void CJobManager::OnJobComplete(bool success, CJob *job)
       CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, item.m_job->GetType());
     }
     lock.Enter();
-    Processing::iterator j = find(m_processing.begin(), m_processing.end(), job);
-    if (j != m_processing.end())
-      m_processing.erase(j);
+    Processing::iterator j = find(jobLane.m_processing.begin(), jobLane.m_processing.end(), job);
+    if (j != jobLane.m_processing.end())
+    {
+      jobLane.m_processing.erase(j);
+      --m_processingCount;
+    }
     lock.Leave();
     item.FreeJob();
   }
@@ -414,10 +538,9 @@ void CJobManager::RemoveWorker(const CJobWorker *worker)
     m_workers.erase(i); // workers auto-delete
 }
 
-unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority)
+unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority) const
 {
-  static const unsigned int max_workers = 5;
   if (priority == CJob::PRIORITY_DEDICATED)
     return 10000; // A large number..
-  return max_workers - (CJob::PRIORITY_HIGH - priority);
+  return m_maxWorkers - (CJob::PRIORITY_HIGH - priority);
 }
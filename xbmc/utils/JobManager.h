@@ -12,6 +12,8 @@
 #include "threads/CriticalSection.h"
 #include "threads/Thread.h"
 
+#include <atomic>
+#include <memory>
 #include <queue>
 #include <string>
 #include <vector>
@@ -21,12 +23,18 @@ class CJobManager;
 class CJobWorker : public CThread
 {
 public:
-  explicit CJobWorker(CJobManager *manager);
+  CJobWorker(CJobManager *manager, unsigned int lane);
   ~CJobWorker() override;
 
   void Process() override;
+
+  /*!
+   \brief The lane this worker services first before stealing from other lanes.
+   */
+  unsigned int GetLane() const { return m_lane; }
 private:
   CJobManager  *m_jobManager;
+  unsigned int  m_lane;
 };
 
 template<typename F>
@@ -187,6 +195,11 @@ private:
  priority levels.  Lower priority jobs are executed only if there are sufficient
  spare worker threads free to allow for higher priority jobs that may arise.
 
+ Queued jobs are spread over a number of lanes (one per CPU core), each guarded
+ by its own lock. A worker serves its own lane first and steals from the other
+ lanes when it runs dry, so workers don't serialize on a single queue. Jobs added
+ from within a running job stay on the lane of the worker that added them.
+
  \sa CJob and IJobCallback
  */
 class CJobManager final
@@ -347,27 +360,57 @@ private:
   CJobManager(const CJobManager&) = delete;
   CJobManager const& operator=(CJobManager const&) = delete;
 
-  /*! \brief Pop a job off the job queue and add to the processing queue ready to process
+  typedef std::deque<CWorkItem>    JobQueue;
+  typedef std::vector<CWorkItem>   Processing;
+  typedef std::vector<CJobWorker*> Workers;
+
+  /*!
+   \brief A queue of jobs per priority, together with the jobs popped from it that are
+   currently processing. Popping a job and registering it as processing happens under
+   the lane's lock, so a job is always findable for cancellation.
+   */
+  class CJobLane
+  {
+  public:
+    JobQueue   m_jobQueue[CJob::PRIORITY_DEDICATED + 1];
+    Processing m_processing;
+    mutable CCriticalSection m_section;
+  };
+
+  /*! \brief Pop a job off the job queues and add to the processing queue ready to process
+   Tries the given lane first, then steals from the other lanes.
+   \param lane the lane to start looking at.
    \return the job to process, NULL if no jobs are available
    */
-  CJob *PopJob();
+  CJob *PopJob(unsigned int lane);
 
+  /*! \brief Reserve a processing slot for a job of the given priority
+   \return true if a slot was available, false if GetMaxWorkers(priority) is reached.
+   */
+  bool ReserveWorkerSlot(CJob::PRIORITY priority);
+
+  /*! \brief Find the lane a processing job was popped from
+   \return the lane index, or m_lanes.size() if the job isn't processing.
+   */
+  unsigned int FindProcessingLane(const CJob *job) const;
+
+  unsigned int GetLaneForNewJob() const;
   void StartWorkers(CJob::PRIORITY priority);
   void RemoveWorker(const CJobWorker *worker);
-  static unsigned int GetMaxWorkers(CJob::PRIORITY priority);
+  unsigned int GetMaxWorkers(CJob::PRIORITY priority) const;
 
-  unsigned int m_jobCounter;
+  std::atomic<unsigned int> m_jobCounter;
+  mutable std::atomic<unsigned int> m_nextLane;
 
-  typedef std::deque<CWorkItem>    JobQueue;
-  typedef std::vector<CWorkItem>   Processing;
-  typedef std::vector<CJobWorker*> Workers;
+  std::vector<std::unique_ptr<CJobLane>> m_lanes;
+  std::atomic<unsigned int> m_queued[CJob::PRIORITY_DEDICATED + 1];
+  std::atomic<unsigned int> m_processingCount;
+  unsigned int              m_maxWorkers;
 
-  JobQueue   m_jobQueue[CJob::PRIORITY_DEDICATED + 1];
-  bool       m_pauseJobs;
-  Processing m_processing;
+  std::atomic<bool> m_pauseJobs;
   Workers    m_workers;
 
   mutable CCriticalSection m_section;
   CEvent           m_jobEvent;
-  bool             m_running;
+  std::atomic<bool> m_running;
 };
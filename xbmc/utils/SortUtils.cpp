@@ -16,6 +16,9 @@
 #include "utils/Variant.h"
 
 #include <algorithm>
+#include <locale>
+#include <thread>
+#include <unordered_map>
 
 std::string ArrayToString(SortAttribute attributes, const CVariant &variant, const std::string &separator = " / ")
 {
@@ -433,130 +436,299 @@ std::string ByLastUsed(SortAttribute attributes, const SortItem &values)
   return values.at(FieldLastUsed).asString();
 }
 
-bool preliminarySort(const SortItem &left, const SortItem &right, bool handleFolder, bool &result, std::wstring &labelLeft, std::wstring &labelRight)
+namespace
 {
-  // make sure both items have the necessary data to do the sorting
-  SortItem::const_iterator itLeftSort, itRightSort;
-  if ((itLeftSort = left.find(FieldSort)) == left.end())
+// lists with at least this many items are sorted by multiple threads
+const size_t PARALLEL_SORT_THRESHOLD = 16384;
+
+/*!
+ \brief Sort keys of a list of items in flat arrays.
+
+ Everything a comparison needs is extracted from the items once: the special sort position,
+ the folder flag and the sort label. The label is split into tokens, every run of digits
+ becomes a single number and every other character is replaced by its rank in the collation
+ order of the system locale, so comparing two labels doesn't need any conversion, allocation
+ or locale lookup while still ordering them like StringUtils::AlphaNumericCompare().
+ */
+class CSortKeys
+{
+public:
+  explicit CSortKeys(size_t count)
   {
-    result = false;
-    return true;
+    m_hasSort.reserve(count);
+    m_special.reserve(count);
+    m_folder.reserve(count);
+    m_labels.reserve(count);
+    m_offsets.reserve(count + 1);
+    m_offsets.push_back(0);
   }
-  if ((itRightSort = right.find(FieldSort)) == right.end())
+
+  void Add(const SortItem &item)
   {
-    result = true;
-    return true;
+    SortItem::const_iterator it = item.find(FieldSort);
+    m_hasSort.push_back(it != item.end());
+    m_labels.push_back(it != item.end() ? it->second.asWideString() : std::wstring());
+    AddTokens(m_labels.back());
+
+    SortSpecial special = SortSpecialNone;
+    if ((it = item.find(FieldSortSpecial)) != item.end() && it->second.asInteger() <= (int64_t)SortSpecialOnBottom)
+      special = (SortSpecial)it->second.asInteger();
+    m_special.push_back(special);
+
+    if ((it = item.find(FieldFolder)) != item.end())
+      m_folder.push_back(it->second.asBoolean() ? 1 : 0);
+    else
+      m_folder.push_back(-1);
   }
 
-  // look at special sorting behaviour
-  SortItem::const_iterator itLeft, itRight;
-  SortSpecial leftSortSpecial = SortSpecialNone;
-  SortSpecial rightSortSpecial = SortSpecialNone;
-  if ((itLeft = left.find(FieldSortSpecial)) != left.end() && itLeft->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    leftSortSpecial = (SortSpecial)itLeft->second.asInteger();
-  if ((itRight = right.find(FieldSortSpecial)) != right.end() && itRight->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    rightSortSpecial = (SortSpecial)itRight->second.asInteger();
-
-  // one has a special sort
-  if (leftSortSpecial != rightSortSpecial)
+  /*!
+   \brief Stable sort of the items added so far.
+   \param order receives the indices of the items in sorted order.
+   */
+  void Sort(SortOrder sortOrder, SortAttribute attributes, std::vector<size_t> &order)
   {
-    // left should be sorted on top
-    // or right should be sorted on bottom
-    // => left is sorted above right
-    if (leftSortSpecial == SortSpecialOnTop ||
-        rightSortSpecial == SortSpecialOnBottom)
+    RankCharacters();
+
+    order.resize(m_labels.size());
+    for (size_t i = 0; i < order.size(); i++)
+      order[i] = i;
+
+    const bool descending = sortOrder == SortOrderDescending;
+    const bool handleFolder = !(attributes & SortAttributeIgnoreFolders);
+    auto less = [this, descending, handleFolder](size_t left, size_t right)
     {
-      result = true;
-      return true;
+      return Less(left, right, descending, handleFolder);
+    };
+
+    const size_t threads = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u),
+                                            order.size() / (PARALLEL_SORT_THRESHOLD / 2));
+    if (order.size() < PARALLEL_SORT_THRESHOLD || threads < 2)
+    {
+      std::stable_sort(order.begin(), order.end(), less);
+      return;
     }
 
-    // otherwise right is sorted above left
-    result = false;
-    return true;
+    // sort chunks in parallel and merge neighbouring chunks until only one is left
+    std::vector<size_t> bounds;
+    for (size_t i = 0; i <= threads; i++)
+      bounds.push_back(order.size() * i / threads);
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i + 1 < bounds.size(); i++)
+      workers.emplace_back([&order, &bounds, &less, i]()
+      {
+        std::stable_sort(order.begin() + bounds[i], order.begin() + bounds[i + 1], less);
+      });
+    std::stable_sort(order.begin(), order.begin() + bounds[1], less);
+    for (auto &worker : workers)
+      worker.join();
+
+    while (bounds.size() > 2)
+    {
+      std::vector<size_t> merged;
+      workers.clear();
+      for (size_t i = 0; i + 1 < bounds.size(); i += 2)
+      {
+        merged.push_back(bounds[i]);
+        if (i + 2 < bounds.size())
+          workers.emplace_back([&order, &bounds, &less, i]()
+          {
+            std::inplace_merge(order.begin() + bounds[i], order.begin() + bounds[i + 1],
+                               order.begin() + bounds[i + 2], less);
+          });
+      }
+      merged.push_back(bounds.back());
+      for (auto &worker : workers)
+        worker.join();
+      bounds.swap(merged);
+    }
   }
-  // both have either sort on top or sort on bottom -> leave as-is
-  else if (leftSortSpecial != SortSpecialNone && leftSortSpecial == rightSortSpecial)
+
+private:
+  struct Token
+  {
+    int64_t value;   /**< value of a run of digits, or the collation rank of a character */
+    uint32_t first;  /**< collation rank of the first character of the token */
+    bool number;
+  };
+
+  void AddTokens(const std::wstring &label)
   {
-    result = false;
-    return true;
+    const wchar_t *c = label.c_str();
+    while (*c != 0)
+    {
+      Token token;
+      if (*c >= L'0' && *c <= L'9')
+      {
+        // like AlphaNumericCompare() only up to 15 digits are taken as one number
+        const wchar_t *start = c;
+        token.value = 0;
+        while (*c >= L'0' && *c <= L'9' && c < start + 15)
+          token.value = token.value * 10 + (*c++ - L'0');
+        token.first = CharacterIndex(*start);
+        token.number = true;
+      }
+      else
+      {
+        wchar_t lc = *c++;
+        if (lc >= L'A' && lc <= L'Z')
+          lc += L'a' - L'A';
+        token.first = CharacterIndex(lc);
+        token.value = token.first;
+        token.number = false;
+      }
+      m_tokens.push_back(token);
+    }
+    m_offsets.push_back(m_tokens.size());
+  }
+
+  uint32_t CharacterIndex(wchar_t c)
+  {
+    auto it = m_characterIndex.find(c);
+    if (it != m_characterIndex.end())
+      return it->second;
+
+    const uint32_t index = static_cast<uint32_t>(m_characters.size());
+    m_characters.push_back(c);
+    m_characterIndex.insert(std::make_pair(c, index));
+    return index;
   }
 
-  if (handleFolder)
+  /*!
+   \brief Replace the character indices in all tokens by their collation rank.
+   Characters that collate equally get the same rank.
+   */
+  void RankCharacters()
   {
-    itLeft = left.find(FieldFolder);
-    itRight = right.find(FieldFolder);
-    if (itLeft != left.end() && itRight != right.end() &&
-        itLeft->second.asBoolean() != itRight->second.asBoolean())
+    const std::collate<wchar_t> &coll = std::use_facet<std::collate<wchar_t> >(g_langInfo.GetSystemLocale());
+
+    std::vector<std::pair<std::wstring, uint32_t>> keys;
+    keys.reserve(m_characters.size());
+    for (uint32_t i = 0; i < m_characters.size(); i++)
+      keys.emplace_back(coll.transform(&m_characters[i], &m_characters[i] + 1), i);
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<uint32_t> ranks(keys.size());
+    uint32_t rank = 0;
+    for (size_t i = 0; i < keys.size(); i++)
     {
-      result = itLeft->second.asBoolean();
-      return true;
+      if (i > 0 && keys[i].first != keys[i - 1].first)
+        rank++;
+      ranks[keys[i].second] = rank;
+    }
+
+    for (auto &token : m_tokens)
+    {
+      token.first = ranks[token.first];
+      if (!token.number)
+        token.value = token.first;
     }
   }
 
-  labelLeft = itLeftSort->second.asWideString();
-  labelRight = itRightSort->second.asWideString();
+  int64_t CompareLabels(size_t left, size_t right) const
+  {
+    const Token *l = m_tokens.data() + m_offsets[left];
+    const Token *lEnd = m_tokens.data() + m_offsets[left + 1];
+    const Token *r = m_tokens.data() + m_offsets[right];
+    const Token *rEnd = m_tokens.data() + m_offsets[right + 1];
+    for (; l != lEnd && r != rEnd; l++, r++)
+    {
+      if (l->number == r->number)
+      {
+        if (l->value != r->value)
+          return l->value - r->value;
+      }
+      else if (l->first != r->first)
+        return (int64_t)l->first - (int64_t)r->first;
+      else
+      {
+        // a digit collating equal to another character, the tokens don't line up anymore
+        return StringUtils::AlphaNumericCompare(m_labels[left].c_str(), m_labels[right].c_str());
+      }
+    }
 
-  return false;
-}
+    if (r != rEnd)
+      return -1;
+    if (l != lEnd)
+      return 1;
+    return 0;
+  }
 
-bool SorterAscending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
-    return result;
+  bool Less(size_t left, size_t right, bool descending, bool handleFolder) const
+  {
+    // make sure both items have the necessary data to do the sorting
+    if (!m_hasSort[left])
+      return false;
+    if (!m_hasSort[right])
+      return true;
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
-}
+    // one has a special sort
+    if (m_special[left] != m_special[right])
+    {
+      // left should be sorted on top
+      // or right should be sorted on bottom
+      // => left is sorted above right
+      return m_special[left] == SortSpecialOnTop || m_special[right] == SortSpecialOnBottom;
+    }
+    // both have either sort on top or sort on bottom -> leave as-is
+    else if (m_special[left] != SortSpecialNone)
+      return false;
 
-bool SorterDescending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
-    return result;
+    if (handleFolder && m_folder[left] >= 0 && m_folder[right] >= 0 && m_folder[left] != m_folder[right])
+      return m_folder[left] == 1;
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
-}
+    const int64_t result = CompareLabels(left, right);
+    return descending ? result > 0 : result < 0;
+  }
 
-bool SorterIgnoreFoldersAscending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
-    return result;
+  std::vector<bool> m_hasSort;
+  std::vector<SortSpecial> m_special;
+  std::vector<int8_t> m_folder;
+  std::vector<std::wstring> m_labels;
+  std::vector<Token> m_tokens;
+  std::vector<size_t> m_offsets; /**< tokens of item i are [m_offsets[i], m_offsets[i + 1]) */
+  std::vector<wchar_t> m_characters;
+  std::unordered_map<wchar_t, uint32_t> m_characterIndex;
+};
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
-}
+SortItem& GetSortItem(SortItem &item) { return item; }
+SortItem& GetSortItem(const SortItemPtr &item) { return *item; }
 
-bool SorterIgnoreFoldersDescending(const SortItem &left, const SortItem &right)
+template<typename T>
+void SortList(SortUtils::SortPreparator preparator, const Fields &sortingFields,
+              SortOrder sortOrder, SortAttribute attributes, std::vector<T> &items)
 {
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
-    return result;
+  CSortKeys keys(items.size());
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
-}
+  // Prepare the string used for sorting and store it under FieldSort
+  for (T &entry : items)
+  {
+    SortItem &item = GetSortItem(entry);
 
-bool SorterIndirectAscending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterAscending(*left, *right);
-}
+    // add all fields to the item that are required for sorting if they are currently missing
+    for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); ++field)
+    {
+      if (item.find(*field) == item.end())
+        item.insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
+    }
 
-bool SorterIndirectDescending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterDescending(*left, *right);
-}
+    std::wstring sortLabel;
+    g_charsetConverter.utf8ToW(preparator(attributes, item), sortLabel, false);
+    item.insert(std::pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
 
-bool SorterIndirectIgnoreFoldersAscending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterIgnoreFoldersAscending(*left, *right);
-}
+    keys.Add(item);
+  }
 
-bool SorterIndirectIgnoreFoldersDescending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterIgnoreFoldersDescending(*left, *right);
+  // Do the sorting
+  std::vector<size_t> order;
+  keys.Sort(sortOrder, attributes, order);
+
+  std::vector<T> sorted;
+  sorted.reserve(items.size());
+  for (size_t index : order)
+    sorted.push_back(std::move(items[index]));
+  items.swap(sorted);
+}
 }
 
 std::map<SortBy, SortUtils::SortPreparator> fillPreparators()
@@ -720,27 +892,7 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
     // get the matching SortPreparator
     SortPreparator preparator = getPreparator(sortBy);
     if (preparator != NULL)
-    {
-      Fields sortingFields = GetFieldsForSorting(sortBy);
-
-      // Prepare the string used for sorting and store it under FieldSort
-      for (DatabaseResults::iterator item = items.begin(); item != items.end(); ++item)
-      {
-        // add all fields to the item that are required for sorting if they are currently missing
-        for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); ++field)
-        {
-          if (item->find(*field) == item->end())
-            item->insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
-        }
-
-        std::wstring sortLabel;
-        g_charsetConverter.utf8ToW(preparator(attributes, *item), sortLabel, false);
-        item->insert(std::pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
-      }
-
-      // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorter(sortOrder, attributes));
-    }
+      SortList(preparator, GetFieldsForSorting(sortBy), sortOrder, attributes, items);
   }
 
   if (limitStart > 0 && (size_t)limitStart < items.size())
@@ -759,27 +911,7 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
     // get the matching SortPreparator
     SortPreparator preparator = getPreparator(sortBy);
     if (preparator != NULL)
-    {
-      Fields sortingFields = GetFieldsForSorting(sortBy);
-
-      // Prepare the string used for sorting and store it under FieldSort
-      for (SortItems::iterator item = items.begin(); item != items.end(); ++item)
-      {
-        // add all fields to the item that are required for sorting if they are currently missing
-        for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); ++field)
-        {
-          if ((*item)->find(*field) == (*item)->end())
-            (*item)->insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
-        }
-
-        std::wstring sortLabel;
-        g_charsetConverter.utf8ToW(preparator(attributes, **item), sortLabel, false);
-        (*item)->insert(std::pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
-      }
-
-      // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorterIndirect(sortOrder, attributes));
-    }
+      SortList(preparator, GetFieldsForSorting(sortBy), sortOrder, attributes, items);
   }
 
   if (limitStart > 0 && (size_t)limitStart < items.size())
@@ -831,22 +963,6 @@ const SortUtils::SortPreparator& SortUtils::getPreparator(SortBy sortBy)
   return m_preparators[SortByNone];
 }
 
-SortUtils::Sorter SortUtils::getSorter(SortOrder sortOrder, SortAttribute attributes)
-{
-  if (attributes & SortAttributeIgnoreFolders)
-    return sortOrder == SortOrderDescending ? SorterIgnoreFoldersDescending : SorterIgnoreFoldersAscending;
-
-  return sortOrder == SortOrderDescending ? SorterDescending : SorterAscending;
-}
-
-SortUtils::SorterIndirect SortUtils::getSorterIndirect(SortOrder sortOrder, SortAttribute attributes)
-{
-  if (attributes & SortAttributeIgnoreFolders)
-    return sortOrder == SortOrderDescending ? SorterIndirectIgnoreFoldersDescending : SorterIndirectIgnoreFoldersAscending;
-
-  return sortOrder == SortOrderDescending ? SorterIndirectDescending : SorterIndirectAscending;
-}
-
 const Fields& SortUtils::GetFieldsForSorting(SortBy sortBy)
 {
   std::map<SortBy, Fields>::const_iterator it = m_sortingFields.find(sortBy);
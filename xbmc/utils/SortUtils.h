@@ -206,13 +206,9 @@ public:
   static std::string RemoveArticles(const std::string &label);
 
   typedef std::string (*SortPreparator) (SortAttribute, const SortItem&);
-  typedef bool (*Sorter) (const DatabaseResult &, const DatabaseResult &);
-  typedef bool (*SorterIndirect) (const SortItemPtr &, const SortItemPtr &);
 
 private:
   static const SortPreparator& getPreparator(SortBy sortBy);
-  static Sorter getSorter(SortOrder sortOrder, SortAttribute attributes);
-  static SorterIndirect getSorterIndirect(SortOrder sortOrder, SortAttribute attributes);
 
   static std::map<SortBy, SortPreparator> m_preparators;
   static std::map<SortBy, Fields> m_sortingFields;
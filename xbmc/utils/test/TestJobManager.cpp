@@ -7,11 +7,17 @@
  */
 
 #include "test/MtTestUtils.h"
+#include "threads/Event.h"
 #include "utils/JobManager.h"
 #include "utils/Job.h"
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
 
 #ifdef TARGET_POSIX
 #include "platform/posix/XTimeUtils.h"
@@ -25,6 +31,7 @@ struct Flags
   std::atomic<bool> started{false};
   std::atomic<bool> finished{false};
   std::atomic<bool> wasCanceled{false};
+  std::atomic<bool> deleted{false};
 };
 
 class DummyJob : public CJob
@@ -62,6 +69,24 @@ public:
   }
 };
 
+// blocks its worker until the test sets the event
+class EventJob : public CJob
+{
+  CEvent& m_release;
+  Flags* m_flags;
+public:
+  EventJob(CEvent& release, Flags* flags) : m_release(release), m_flags(flags) {}
+  ~EventJob() override { m_flags->deleted = true; }
+
+  bool DoWork() override
+  {
+    m_flags->started = true;
+    m_release.Wait();
+    m_flags->finished = true;
+    return true;
+  }
+};
+
 class TestJobManager : public testing::Test
 {
 protected:
@@ -215,3 +240,143 @@ TEST_F(TestJobManager, IsProcessing)
 
   job->FinishAndStopBlocking();
 }
+
+namespace
+{
+class SpawningJob : public CJob
+{
+public:
+  SpawningJob(Flags* flags, Flags* childFlags) : m_flags(flags), m_childFlags(childFlags) {}
+
+  bool DoWork() override
+  {
+    // jobs added from within a job go onto the worker's own lane
+    CJobManager::GetInstance().AddJob(new ReallyDumbJob(m_childFlags), NULL);
+    m_flags->finished = true;
+    return true;
+  }
+
+private:
+  Flags* m_flags;
+  Flags* m_childFlags;
+};
+
+class TimedJob : public CJob
+{
+public:
+  TimedJob(std::chrono::steady_clock::time_point queued,
+           std::chrono::microseconds* latency,
+           std::atomic<unsigned int>* done)
+    : m_queued(queued), m_latency(latency), m_done(done)
+  {
+  }
+
+  bool DoWork() override
+  {
+    *m_latency = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - m_queued);
+    ++(*m_done);
+    return true;
+  }
+
+private:
+  std::chrono::steady_clock::time_point m_queued;
+  std::chrono::microseconds* m_latency;
+  std::atomic<unsigned int>* m_done;
+};
+}
+
+TEST_F(TestJobManager, AddJobFromJob)
+{
+  Flags* flags = new Flags();
+  Flags* childFlags = new Flags();
+  CJobManager::GetInstance().AddJob(new SpawningJob(flags, childFlags), NULL);
+  ASSERT_TRUE(poll([flags]() -> bool { return flags->finished; }));
+  ASSERT_TRUE(poll([childFlags]() -> bool { return childFlags->finished; }));
+  delete flags;
+  delete childFlags;
+}
+
+TEST_F(TestJobManager, PausedJobsRunAfterUnPause)
+{
+  CJobManager::GetInstance().PauseJobs();
+
+  Flags* flags = new Flags();
+  CJobManager::GetInstance().AddJob(new ReallyDumbJob(flags), NULL, CJob::PRIORITY_LOW_PAUSABLE);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_FALSE(flags->finished);
+
+  CJobManager::GetInstance().UnPauseJobs();
+  ASSERT_TRUE(poll([flags]() -> bool { return flags->finished; }));
+  delete flags;
+}
+
+TEST_F(TestJobManager, CancelQueuedJob)
+{
+  // pausable jobs stay queued while paused
+  CJobManager::GetInstance().PauseJobs();
+
+  CEvent release(true);
+  Flags* flags = new Flags();
+  unsigned int id = CJobManager::GetInstance().AddJob(new EventJob(release, flags), NULL,
+                                                      CJob::PRIORITY_LOW_PAUSABLE);
+
+  // a queued job is deleted right away and never started
+  CJobManager::GetInstance().CancelJob(id);
+  EXPECT_TRUE(flags->deleted);
+  EXPECT_FALSE(flags->started);
+
+  // the next one still runs
+  Flags* next = new Flags();
+  CJobManager::GetInstance().AddJob(new EventJob(release, next), NULL, CJob::PRIORITY_LOW_PAUSABLE);
+  CJobManager::GetInstance().UnPauseJobs();
+  EXPECT_TRUE(poll([next]() -> bool { return next->started; }));
+  EXPECT_FALSE(next->finished);
+  release.Set();
+  ASSERT_TRUE(poll([next]() -> bool { return next->deleted; }));
+  EXPECT_TRUE(next->finished);
+  EXPECT_FALSE(flags->started);
+
+  delete flags;
+  delete next;
+}
+
+TEST_F(TestJobManager, ThroughputUnderContention)
+{
+  const unsigned int producers = std::max(std::thread::hardware_concurrency(), 2u);
+  const unsigned int jobsPerProducer = 2000;
+  const unsigned int totalJobs = producers * jobsPerProducer;
+
+  std::vector<std::chrono::microseconds> latencies(totalJobs);
+  std::atomic<unsigned int> done{0};
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (unsigned int p = 0; p < producers; p++)
+  {
+    threads.emplace_back([p, jobsPerProducer, &latencies, &done]() {
+      for (unsigned int i = 0; i < jobsPerProducer; i++)
+      {
+        std::chrono::microseconds* latency = &latencies[p * jobsPerProducer + i];
+        CJobManager::GetInstance().AddJob(
+            new TimedJob(std::chrono::steady_clock::now(), latency, &done), NULL);
+      }
+    });
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+
+  // spin rather than poll so the measurement isn't dominated by the poll interval
+  XbmcThreads::EndTime endTime(defaultTimeout);
+  while (done != totalJobs && !endTime.IsTimePast())
+    std::this_thread::yield();
+  ASSERT_EQ(totalJobs, done);
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+
+  std::sort(latencies.begin(), latencies.end());
+  std::cout << "jobs/sec: " << totalJobs * 1000000.0 / std::max<long long>(elapsed.count(), 1)
+            << ", p50 latency: " << latencies[totalJobs / 2].count() << "us"
+            << ", p99 latency: " << latencies[totalJobs * 99 / 100].count() << "us"
+            << ", max latency: " << latencies.back().count() << "us\n";
+}
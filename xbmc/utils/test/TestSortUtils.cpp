@@ -7,8 +7,13 @@
  */
 
 #include "utils/SortUtils.h"
+#include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
+#include <chrono>
+#include <iostream>
+#include <random>
+
 #include <gtest/gtest.h>
 
 TEST(TestSortUtils, Sort_SortBy)
@@ -121,3 +126,101 @@ TEST(TestSortUtils, GetFieldsForSorting)
   EXPECT_EQ(FieldTrackNumber, *it);
   EXPECT_EQ((unsigned int)5, fields.size());
 }
+
+namespace
+{
+SortItemPtr CreateItem(const std::string &label, int id)
+{
+  SortItemPtr item(new SortItem());
+  (*item)[FieldLabel] = label;
+  (*item)[FieldId] = id;
+  return item;
+}
+}
+
+TEST(TestSortUtils, Sort_Numbers)
+{
+  SortItems items;
+  items.push_back(CreateItem("Track 10", 0));
+  items.push_back(CreateItem("Track 02b", 1));
+  items.push_back(CreateItem("track 1", 2));
+  items.push_back(CreateItem("Track 2", 3));
+  items.push_back(CreateItem("Track", 4));
+  items.push_back(CreateItem("Track 1000000000000000000", 5));
+
+  SortUtils::Sort(SortByLabel, SortOrderAscending, SortAttributeNone, items);
+
+  EXPECT_EQ("Track", (*items.at(0))[FieldLabel].asString());
+  EXPECT_EQ("track 1", (*items.at(1))[FieldLabel].asString());
+  EXPECT_EQ("Track 2", (*items.at(2))[FieldLabel].asString());
+  EXPECT_EQ("Track 02b", (*items.at(3))[FieldLabel].asString());
+  EXPECT_EQ("Track 10", (*items.at(4))[FieldLabel].asString());
+  EXPECT_EQ("Track 1000000000000000000", (*items.at(5))[FieldLabel].asString());
+
+  SortUtils::Sort(SortByLabel, SortOrderDescending, SortAttributeNone, items);
+
+  EXPECT_EQ("Track 1000000000000000000", (*items.at(0))[FieldLabel].asString());
+  EXPECT_EQ("Track", (*items.at(5))[FieldLabel].asString());
+}
+
+TEST(TestSortUtils, Sort_SpecialAndFolders)
+{
+  SortItems items;
+  items.push_back(CreateItem("b", 0));
+  items.push_back(CreateItem("a", 1));
+  items.push_back(CreateItem("z folder", 2));
+  (*items.back())[FieldFolder] = true;
+  items.push_back(CreateItem("y bottom", 3));
+  (*items.back())[FieldSortSpecial] = SortSpecialOnBottom;
+  items.push_back(CreateItem("c top", 4));
+  (*items.back())[FieldSortSpecial] = SortSpecialOnTop;
+  (*items.at(0))[FieldFolder] = false;
+  (*items.at(1))[FieldFolder] = false;
+
+  SortUtils::Sort(SortByLabel, SortOrderDescending, SortAttributeNone, items);
+
+  std::vector<int> ids;
+  for (const auto &item : items)
+    ids.push_back((int)item->at(FieldId).asInteger());
+  EXPECT_EQ(std::vector<int>({4, 2, 0, 1, 3}), ids);
+
+  SortUtils::Sort(SortByLabel, SortOrderAscending, SortAttributeIgnoreFolders, items);
+
+  ids.clear();
+  for (const auto &item : items)
+    ids.push_back((int)item->at(FieldId).asInteger());
+  EXPECT_EQ(std::vector<int>({4, 1, 0, 2, 3}), ids);
+}
+
+TEST(TestSortUtils, Sort_LargeList)
+{
+  const int count = 100000;
+  SortItems items;
+  items.reserve(count);
+  std::mt19937 random(42);
+  for (int i = 0; i < count; i++)
+  {
+    // plenty of duplicates to check that the sort is stable
+    std::string label = StringUtils::Format("Artist %u - Song %u", random() % 1000, random() % 50);
+    items.push_back(CreateItem(label, i));
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  SortUtils::Sort(SortByLabel, SortOrderAscending, SortAttributeNone, items);
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+  std::cout << "sorted " << count << " items in " << elapsed.count() << "ms\n";
+
+  ASSERT_EQ((size_t)count, items.size());
+  for (int i = 1; i < count; i++)
+  {
+    std::wstring left = items[i - 1]->at(FieldSort).asWideString();
+    std::wstring right = items[i]->at(FieldSort).asWideString();
+    int64_t result = StringUtils::AlphaNumericCompare(left.c_str(), right.c_str());
+    ASSERT_LE(result, 0) << "at " << i;
+    if (result == 0)
+    {
+      ASSERT_LT(items[i - 1]->at(FieldId).asInteger(), items[i]->at(FieldId).asInteger()) << "at " << i;
+    }
+  }
+}
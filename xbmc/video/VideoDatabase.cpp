@@ -124,6 +124,9 @@ void CVideoDatabase::CreateTables()
   CLog::Log(LOGINFO, "create path table");
   m_pDS->exec("CREATE TABLE path ( idPath integer primary key, strPath text, strContent text, strScraper text, strHash text, scanRecursive integer, useFolderNames bool, strSettings text, noUpdate bool, exclude bool, dateAdded text, idParentPath integer)");
 
+  CLog::Log(LOGINFO, "create dirtypath table");
+  m_pDS->exec("CREATE TABLE dirtypath ( idDirtyPath integer primary key, strPath text, scanRecursive bool)");
+
   CLog::Log(LOGINFO, "create files table");
   m_pDS->exec("CREATE TABLE files ( idFile integer primary key, idPath integer, strFilename text, playCount integer, lastPlayed text, dateAdded text)");
 
@@ -1728,8 +1731,8 @@ void CVideoDatabase::AddLinkToActor(int mediaId, const char *mediaType, int acto
 
   if (GetSingleValue(sql).empty())
   { // doesnt exists, add it
-    sql = PrepareSQL("INSERT INTO actor_link (actor_id, media_id, media_type, role, cast_order) VALUES(%i,%i,'%s','%s',%i)", actorId, mediaId, mediaType, role.c_str(), order);
-    ExecuteQuery(sql);
+    ExecuteStatement("INSERT INTO actor_link (actor_id, media_id, media_type, role, cast_order) VALUES(?,?,?,?,?)",
+      { field_value(actorId), field_value(mediaId), field_value(mediaType), field_value(role), field_value(order) });
   }
 }
 
@@ -1740,8 +1743,8 @@ void CVideoDatabase::AddToLinkTable(int mediaId, const std::string& mediaType, c
 
   if (GetSingleValue(sql).empty())
   { // doesnt exists, add it
-    sql = PrepareSQL("INSERT INTO %s_link (%s_id,media_id,media_type) VALUES(%i,%i,'%s')", table.c_str(), key, valueId, mediaId, mediaType.c_str());
-    ExecuteQuery(sql);
+    sql = PrepareSQL("INSERT INTO %s_link (%s_id,media_id,media_type) VALUES(?,?,?)", table.c_str(), key);
+    ExecuteStatement(sql, { field_value(valueId), field_value(mediaId), field_value(mediaType) });
   }
 }
 
@@ -5677,11 +5680,14 @@ void CVideoDatabase::UpdateTables(int iVersion)
     }
     m_pDS->close();
   }
+
+  if (iVersion < 117)
+    m_pDS->exec("CREATE TABLE dirtypath ( idDirtyPath integer primary key, strPath text, scanRecursive bool)");
 }
 
 int CVideoDatabase::GetSchemaVersion() const
 {
-  return 116;
+  return 117;
 }
 
 bool CVideoDatabase::LookupByFolders(const std::string &path, bool shows)
@@ -10292,7 +10298,11 @@ void CVideoDatabase::InvalidatePathHash(const std::string& strPath)
 bool CVideoDatabase::CommitTransaction()
 {
   if (CDatabase::CommitTransaction())
-  { // number of items in the db has likely changed, so recalculate
+  {
+    if (InBulkInsert())
+      return true; // recalculated once the bulk insert is committed
+
+    // number of items in the db has likely changed, so recalculate
     GUIINFO::CLibraryGUIInfo& guiInfo = CServiceBroker::GetGUI()->GetInfoManager().GetInfoProviders().GetLibraryInfoProvider();
     guiInfo.SetLibraryBool(LIBRARY_HAS_MOVIES, HasContent(VIDEODB_CONTENT_MOVIES));
     guiInfo.SetLibraryBool(LIBRARY_HAS_TVSHOWS, HasContent(VIDEODB_CONTENT_TVSHOWS));
@@ -11,6 +11,7 @@
 #include "FileItem.h"
 #include "GUIInfoManager.h"
 #include "GUIUserMessages.h"
+#include "LibraryMonitor.h"
 #include "NfoFile.h"
 #include "ServiceBroker.h"
 #include "TextureCache.h"
@@ -57,6 +58,12 @@ using namespace KODI::MESSAGING;
 using KODI::MESSAGING::HELPERS::DialogResponse;
 using KODI::UTILITY::CDigest;
 
+namespace
+{
+// maximum time a batch of items keeps the database locked for other writers
+const unsigned int BULK_INSERT_BATCH_MS = 500;
+}
+
 namespace VIDEO
 {
 
@@ -142,6 +149,9 @@ namespace VIDEO
 
       if (!bCancelled)
       {
+        if (m_dirtyPathId >= 0)
+          m_database.ClearDirtyPaths(m_dirtyPathId);
+
         if (m_bClean)
           CVideoLibraryQueue::GetInstance().CleanLibrary(m_pathsToClean, false, m_handle);
         else
@@ -178,11 +188,15 @@ namespace VIDEO
     m_pathsToScan.clear();
     m_pathsToClean.clear();
 
+    m_dirtyPathId = -1;
+
     m_database.Open();
     if (strDirectory.empty())
     { // scan all paths in the database.  We do this by scanning all paths in the db, and crossing them off the list as
       // we go.
       m_database.GetPaths(m_pathsToScan);
+      // paths in sources watched for changes only need to be scanned if something changed
+      m_dirtyPathId = CLibraryMonitor::GetInstance().GetPathsToScan("video", m_database, m_pathsToScan);
     }
     else
     { // scan all the paths of this subtree that is in the database
@@ -412,6 +426,7 @@ namespace VIDEO
 
     bool FoundSomeInfo = false;
     std::vector<int> seenPaths;
+    m_batchWrites = true;
     for (int i = 0; i < items.Size(); ++i)
     {
       CFileItemPtr pItem = items[i];
@@ -483,7 +498,12 @@ namespace VIDEO
       // Keep track of directories we've seen
       if (m_bClean && pItem->m_bIsFolder)
         seenPaths.push_back(m_database.GetPathId(pItem->GetPath()));
+
+      if (m_batchTimer.IsTimePast())
+        CommitBatchedWrites();
     }
+    CommitBatchedWrites();
+    m_batchWrites = false;
 
     if (content == CONTENT_TVSHOWS && ! seenPaths.empty())
     {
@@ -812,6 +832,8 @@ namespace VIDEO
 
       if (updateSeasonArt)
       {
+        // fetching and caching the art takes long
+        CommitBatchedWrites();
         if (!item->IsPlugin() || scraper->ID() != "metadata.local")
         {
           CVideoInfoDownloader loader(scraper);
@@ -1294,6 +1316,10 @@ namespace VIDEO
     if (art.empty())
       art["thumb"] = "";
 
+    // only the writes below are batched, anything reaching out to the network before commits
+    if (m_batchWrites && !m_database.InBulkInsert() && m_database.BeginBulkInsert())
+      m_batchTimer.Set(BULK_INSERT_BATCH_MS);
+
     CVideoInfoTag &movieDetails = *pItem->GetVideoInfoTag();
     if (movieDetails.m_basePath.empty())
       movieDetails.m_basePath = pItem->GetBaseMoviePath(videoFolder);
@@ -1354,7 +1380,10 @@ namespace VIDEO
         std::map<int, std::map<std::string, std::string> > seasonArt;
 
         if (!libraryImport)
+        {
+          CommitBatchedWrites(); // caches the thumbs
           GetSeasonThumbs(movieDetails, seasonArt, CVideoThumbLoader::GetArtTypes(MediaTypeSeason), useLocal && !pItem->IsPlugin());
+        }
 
         lResult = m_database.SetDetailsForTvShow(paths, movieDetails, art, seasonArt);
         movieDetails.m_iDbId = lResult;
@@ -1517,6 +1546,7 @@ namespace VIDEO
         if (!image.empty())
         { // cache the image and determine sizing
           CTextureDetails details;
+          CommitBatchedWrites();
           if (CTextureCache::GetInstance().CacheImage(image, details))
           {
             std::string type = GetArtTypeFromSize(details.width, details.height);
@@ -1683,6 +1713,7 @@ namespace VIDEO
             pDlgProgress->Progress();
           }
 
+          CommitBatchedWrites();
           CVideoInfoDownloader imdb(scraper);
           if (!imdb.GetEpisodeList(url, episodes))
             return INFO_NOT_FOUND;
@@ -1781,6 +1812,7 @@ namespace VIDEO
 
       if (bFound)
       {
+        CommitBatchedWrites();
         CVideoInfoDownloader imdb(scraper);
         CFileItem item;
         item.SetPath(file->strPath);
@@ -1816,6 +1848,7 @@ namespace VIDEO
     if (m_handle && !url.strTitle.empty())
       m_handle->SetText(url.strTitle);
 
+    CommitBatchedWrites();
     CVideoInfoDownloader imdb(scraper);
     bool ret = imdb.GetDetails(url, movieDetails, pDialog);
 
@@ -2074,6 +2107,12 @@ namespace VIDEO
     }
   }
 
+  void CVideoInfoScanner::CommitBatchedWrites()
+  {
+    if (m_database.InBulkInsert())
+      m_database.CommitBulkInsert();
+  }
+
   bool CVideoInfoScanner::DownloadFailed(CGUIDialogProgress* pDialog)
   {
     if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bVideoScannerIgnoreErrors)
@@ -2103,6 +2142,7 @@ namespace VIDEO
   int CVideoInfoScanner::FindVideo(const std::string &title, int year, const ScraperPtr &scraper, CScraperUrl &url, CGUIDialogProgress *progress)
   {
     MOVIELIST movielist;
+    CommitBatchedWrites();
     CVideoInfoDownloader imdb(scraper);
     int returncode = imdb.FindMovie(title, year, movielist, progress);
     if (returncode < 0 || (returncode == 0 && (m_bStop || !DownloadFailed(progress))))
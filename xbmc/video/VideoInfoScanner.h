@@ -11,6 +11,7 @@
 #include "InfoScanner.h"
 #include "VideoDatabase.h"
 #include "addons/Scraper.h"
+#include "threads/SystemClock.h"
 
 #include <set>
 #include <string>
@@ -227,12 +228,20 @@ namespace VIDEO
     bool EnumerateSeriesFolder(CFileItem* item, EPISODELIST& episodeList);
     bool ProcessItemByVideoInfoTag(const CFileItem *item, EPISODELIST &episodeList);
 
+    /*! \brief Commit the database writes of the items added so far
+     Called before anything that can take long, like a request to a scraper, so other writers
+     don't have to wait for the database meanwhile.
+     */
+    void CommitBatchedWrites();
+
     bool m_bStop;
     bool m_scanAll;
     std::string m_strStartDir;
     CVideoDatabase m_database;
     std::set<std::string> m_pathsToCount;
     std::set<int> m_pathsToClean;
+    bool m_batchWrites = false; ///< AddVideo() writes to the database in batches
+    XbmcThreads::EndTime m_batchTimer;
 
   private:
     void GetLocalMovieSetArtwork(CGUIListItem::ArtMap& art,
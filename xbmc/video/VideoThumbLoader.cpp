@@ -558,7 +558,7 @@ bool CVideoThumbLoader::FillLibraryArt(CFileItem &item)
     m_videoDatabase->Close();
   }
   item.SetProperty("libraryartfilled", true);
-  return !item.GetArt().empty();
+  return item.HasArt();
 }
 
 bool CVideoThumbLoader::FillThumb(CFileItem &item)
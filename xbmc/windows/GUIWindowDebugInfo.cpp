@@ -20,6 +20,7 @@
 #include "guilib/GUITextLayout.h"
 #include "guilib/GUIWindowManager.h"
 #include "input/WindowTranslator.h"
+#include "rendering/RenderSystem.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
 #include "utils/CPUInfo.h"
@@ -143,6 +144,8 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
       point.y *= CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleY();
       CServiceBroker::GetWinSystem()->GetGfxContext().SetRenderingResolution(CServiceBroker::GetWinSystem()->GetGfxContext().GetResInfo(), false);
     }
+    info += StringUtils::Format("Conditions: %u/frame\n", CServiceBroker::GetGUI()->GetInfoManager().GetConditionEvaluations());
+    info += StringUtils::Format("Draw calls: %u/frame\n", CServiceBroker::GetRenderSystem()->GetDrawCalls());
     info += StringUtils::Format("Mouse: (%d,%d)  ", static_cast<int>(point.x), static_cast<int>(point.y));
     if (window)
     {